@@ -41,6 +41,9 @@
 #define PDUMP_RING_SIZE_ARG "ring-size"
 #define PDUMP_MSIZE_ARG "mbuf-size"
 #define PDUMP_NUM_MBUFS_ARG "total-num-mbufs"
+#define PDUMP_SNAPLEN_ARG "snaplen"
+#define PDUMP_SAMPLE_RATE_ARG "sample-rate"
+#define PDUMP_SAMPLE_MODE_ARG "sample-mode"
 
 #define VDEV_NAME_FMT "net_pcap_%s_%d"
 #define VDEV_PCAP_ARGS_FMT "tx_pcap=%s"
@@ -97,6 +100,9 @@ static const char * const valid_pdump_arguments[] = {
 	PDUMP_RING_SIZE_ARG,
 	PDUMP_MSIZE_ARG,
 	PDUMP_NUM_MBUFS_ARG,
+	PDUMP_SNAPLEN_ARG,
+	PDUMP_SAMPLE_RATE_ARG,
+	PDUMP_SAMPLE_MODE_ARG,
 	NULL
 };
 
@@ -119,6 +125,7 @@ struct pdump_tuples {
 
 	/* params for library API call */
 	uint32_t dir;
+	struct rte_pdump_sample_conf sample;
 	struct rte_mempool *mp;
 	struct rte_ring *rx_ring;
 	struct rte_ring *tx_ring;
@@ -160,7 +167,10 @@ pdump_usage(const char *prgname)
 			" tx-dev=<iface or pcap file>,"
 			"[ring-size=<ring size>default:16384],"
 			"[mbuf-size=<mbuf data size>default:2176],"
-			"[total-num-mbufs=<number of mbufs>default:65535]'\n",
+			"[total-num-mbufs=<number of mbufs>default:65535],"
+			"[snaplen=<bytes per packet>default:0 (all)],"
+			"[sample-rate=<1 in N>default:1 (all)],"
+			"[sample-mode=<count|flow>default:count]'\n",
 			prgname);
 }
 
@@ -212,6 +222,25 @@ parse_rxtxdev(const char *key, const char *value, void *extra_args)
 	return 0;
 }
 
+static int
+parse_sample_mode(const char *key __rte_unused, const char *value,
+		void *extra_args)
+{
+	struct pdump_tuples *pt = extra_args;
+
+	if (!strcmp(value, "count"))
+		pt->sample.mode = RTE_PDUMP_SAMPLE_COUNT;
+	else if (!strcmp(value, "flow"))
+		pt->sample.mode = RTE_PDUMP_SAMPLE_FLOW_HASH;
+	else {
+		printf("invalid value:\"%s\" for key:\"%s\", "
+			"value must be count or flow\n", value, key);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
 static int
 parse_uint_value(const char *key, const char *value, void *extra_args)
 {
@@ -370,6 +399,39 @@ parse_pdump(const char *optarg)
 	} else
 		pt->total_num_mbufs = MBUFS_PER_POOL;
 
+	/* snaplen parsing and validation */
+	cnt1 = rte_kvargs_count(kvlist, PDUMP_SNAPLEN_ARG);
+	if (cnt1 == 1) {
+		v.min = 0;
+		v.max = UINT32_MAX;
+		ret = rte_kvargs_process(kvlist, PDUMP_SNAPLEN_ARG,
+						&parse_uint_value, &v);
+		if (ret < 0)
+			goto free_kvlist;
+		pt->sample.snaplen = (uint32_t) v.val;
+	}
+
+	/* sample_rate parsing and validation */
+	cnt1 = rte_kvargs_count(kvlist, PDUMP_SAMPLE_RATE_ARG);
+	if (cnt1 == 1) {
+		v.min = 1;
+		v.max = UINT32_MAX;
+		ret = rte_kvargs_process(kvlist, PDUMP_SAMPLE_RATE_ARG,
+						&parse_uint_value, &v);
+		if (ret < 0)
+			goto free_kvlist;
+		pt->sample.rate = (uint32_t) v.val;
+	}
+
+	/* sample_mode parsing */
+	cnt1 = rte_kvargs_count(kvlist, PDUMP_SAMPLE_MODE_ARG);
+	if (cnt1 == 1) {
+		ret = rte_kvargs_process(kvlist, PDUMP_SAMPLE_MODE_ARG,
+						&parse_sample_mode, pt);
+		if (ret < 0)
+			goto free_kvlist;
+	}
+
 	num_tuples++;
 
 free_kvlist:
@@ -832,48 +894,54 @@ enable_pdump(void)
 		pt = &pdump_t[i];
 		if (pt->dir == RTE_PDUMP_FLAG_RXTX) {
 			if (pt->dump_by_type == DEVICE_ID) {
-				ret = rte_pdump_enable_by_deviceid(
+				ret = rte_pdump_enable_sample_by_deviceid(
 						pt->device_id,
 						pt->queue,
 						RTE_PDUMP_FLAG_RX,
-						pt->rx_ring,
-						pt->mp, NULL);
-				ret1 = rte_pdump_enable_by_deviceid(
+						&pt->sample,
+						pt->rx_ring, pt->mp);
+				ret1 = rte_pdump_enable_sample_by_deviceid(
 						pt->device_id,
 						pt->queue,
 						RTE_PDUMP_FLAG_TX,
-						pt->tx_ring,
-						pt->mp, NULL);
+						&pt->sample,
+						pt->tx_ring, pt->mp);
 			} else if (pt->dump_by_type == PORT_ID) {
-				ret = rte_pdump_enable(pt->port, pt->queue,
+				ret = rte_pdump_enable_sample(pt->port,
+						pt->queue,
 						RTE_PDUMP_FLAG_RX,
-						pt->rx_ring, pt->mp, NULL);
-				ret1 = rte_pdump_enable(pt->port, pt->queue,
+						&pt->sample,
+						pt->rx_ring, pt->mp);
+				ret1 = rte_pdump_enable_sample(pt->port,
+						pt->queue,
 						RTE_PDUMP_FLAG_TX,
-						pt->tx_ring, pt->mp, NULL);
+						&pt->sample,
+						pt->tx_ring, pt->mp);
 			}
 		} else if (pt->dir == RTE_PDUMP_FLAG_RX) {
 			if (pt->dump_by_type == DEVICE_ID)
-				ret = rte_pdump_enable_by_deviceid(
+				ret = rte_pdump_enable_sample_by_deviceid(
 						pt->device_id,
 						pt->queue,
-						pt->dir, pt->rx_ring,
-						pt->mp, NULL);
+						pt->dir, &pt->sample,
+						pt->rx_ring, pt->mp);
 			else if (pt->dump_by_type == PORT_ID)
-				ret = rte_pdump_enable(pt->port, pt->queue,
-						pt->dir,
-						pt->rx_ring, pt->mp, NULL);
+				ret = rte_pdump_enable_sample(pt->port,
+						pt->queue,
+						pt->dir, &pt->sample,
+						pt->rx_ring, pt->mp);
 		} else if (pt->dir == RTE_PDUMP_FLAG_TX) {
 			if (pt->dump_by_type == DEVICE_ID)
-				ret = rte_pdump_enable_by_deviceid(
+				ret = rte_pdump_enable_sample_by_deviceid(
 						pt->device_id,
 						pt->queue,
-						pt->dir,
-						pt->tx_ring, pt->mp, NULL);
+						pt->dir, &pt->sample,
+						pt->tx_ring, pt->mp);
 			else if (pt->dump_by_type == PORT_ID)
-				ret = rte_pdump_enable(pt->port, pt->queue,
-						pt->dir,
-						pt->tx_ring, pt->mp, NULL);
+				ret = rte_pdump_enable_sample(pt->port,
+						pt->queue,
+						pt->dir, &pt->sample,
+						pt->tx_ring, pt->mp);
 		}
 		if (ret < 0 || ret1 < 0) {
 			cleanup_pdump_resources();
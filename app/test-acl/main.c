@@ -35,6 +35,7 @@
 #define	OPT_TRACE_NUM		"tracenum"
 #define	OPT_TRACE_STEP		"tracestep"
 #define	OPT_SEARCH_ALG		"alg"
+#define	OPT_CMP_ALG		"cmpalg"
 #define	OPT_BLD_CATEGORIES	"bldcat"
 #define	OPT_RUN_CATEGORIES	"runcat"
 #define	OPT_MAX_SIZE		"maxsize"
@@ -81,6 +82,10 @@ static const struct acl_alg acl_alg[] = {
 		.name = "altivec",
 		.alg = RTE_ACL_CLASSIFY_ALTIVEC,
 	},
+	{
+		.name = "avx512",
+		.alg = RTE_ACL_CLASSIFY_AVX512,
+	},
 };
 
 static struct {
@@ -98,6 +103,7 @@ static struct {
 	uint32_t            verbose;
 	uint32_t            ipv6;
 	struct acl_alg      alg;
+	struct acl_alg      cmp_alg;
 	uint32_t            used_traces;
 	void               *traces;
 	struct rte_acl_ctx *acx;
@@ -113,6 +119,10 @@ static struct {
 		.name = "default",
 		.alg = RTE_ACL_CLASSIFY_DEFAULT,
 	},
+	.cmp_alg = {
+		.name = "none",
+		.alg = RTE_ACL_CLASSIFY_DEFAULT,
+	},
 	.ipv6 = 0
 };
 
@@ -814,8 +824,23 @@ acx_init(void)
 		rte_exit(ret, "failed to build search context\n");
 }
 
+/*
+ * RTE_ACL_CLASSIFY_DEFAULT means the method selected for the ACL context.
+ */
+static int
+classify_ip5tuples(const uint8_t **data, uint32_t *results, uint32_t num,
+	uint32_t categories, enum rte_acl_classify_alg alg)
+{
+	if (alg == RTE_ACL_CLASSIFY_DEFAULT)
+		return rte_acl_classify(config.acx, data, results, num,
+			categories);
+	return rte_acl_classify_alg(config.acx, data, results, num,
+		categories, alg);
+}
+
 static uint32_t
-search_ip5tuples_once(uint32_t categories, uint32_t step, const char *alg)
+search_ip5tuples_once(uint32_t categories, uint32_t step,
+	const struct acl_alg *alg)
 {
 	int ret;
 	uint32_t i, j, k, n, r;
@@ -832,8 +857,8 @@ search_ip5tuples_once(uint32_t categories, uint32_t step, const char *alg)
 			v += config.trace_sz;
 		}
 
-		ret = rte_acl_classify(config.acx, data, results,
-			n, categories);
+		ret = classify_ip5tuples(data, results, n, categories,
+			alg->alg);
 
 		if (ret != 0)
 			rte_exit(ret, "classify for ipv%c_5tuples returns %d\n",
@@ -853,33 +878,116 @@ search_ip5tuples_once(uint32_t categories, uint32_t step, const char *alg)
 
 	dump_verbose(DUMP_SEARCH, stdout,
 		"%s(%u, %u, %s) returns %u\n", __func__,
-		categories, step, alg, i);
+		categories, step, alg->name, i);
 	return i;
 }
 
-static int
-search_ip5tuples(__rte_unused void *arg)
+/*
+ * Classify all traces with both the search and the compare methods
+ * and check that they produce identical results.
+ * Returns number of traces with mismatched results.
+ */
+static uint32_t
+verify_ip5tuples(uint32_t categories, uint32_t step)
 {
-	uint64_t pkt, start, tm;
-	uint32_t i, lcore;
+	int ret;
+	uint32_t i, j, k, n, r, rc;
+	const uint8_t *data[step], *v;
+	uint32_t res1[step * categories], res2[step * categories];
 
-	lcore = rte_lcore_id();
+	rc = 0;
+	v = config.traces;
+	for (i = 0; i != config.used_traces; i += n) {
+
+		n = RTE_MIN(step, config.used_traces - i);
+
+		for (j = 0; j != n; j++) {
+			data[j] = v;
+			v += config.trace_sz;
+		}
+
+		ret = classify_ip5tuples(data, res1, n, categories,
+			config.alg.alg);
+		if (ret != 0)
+			rte_exit(ret, "%s classify returns %d\n",
+				config.alg.name, ret);
+
+		ret = classify_ip5tuples(data, res2, n, categories,
+			config.cmp_alg.alg);
+		if (ret != 0)
+			rte_exit(ret, "%s classify returns %d\n",
+				config.cmp_alg.name, ret);
+
+		for (r = 0, j = 0; j != n; j++, r += categories) {
+			for (k = 0; k != categories &&
+					res1[r + k] == res2[r + k]; k++)
+				;
+			if (k == categories)
+				continue;
+
+			rc++;
+			dump_verbose(DUMP_NONE, stdout,
+				"ipv%c_5tuple: %u, category: %u, "
+				"%s result: %u, %s result: %u\n",
+				config.ipv6 ? '6' : '4', i + j + 1, k,
+				config.alg.name, res1[r + k] - 1,
+				config.cmp_alg.name, res2[r + k] - 1);
+		}
+	}
+
+	return rc;
+}
+
+static uint64_t
+search_ip5tuples_alg(const struct acl_alg *alg, uint64_t *pkt)
+{
+	uint32_t i;
+	uint64_t start;
+
+	*pkt = 0;
 	start = rte_rdtsc();
-	pkt = 0;
 
 	for (i = 0; i != config.iter_num; i++) {
-		pkt += search_ip5tuples_once(config.run_categories,
-			config.trace_step, config.alg.name);
+		*pkt += search_ip5tuples_once(config.run_categories,
+			config.trace_step, alg);
 	}
 
-	tm = rte_rdtsc() - start;
+	return rte_rdtsc() - start;
+}
+
+static int
+search_ip5tuples(__rte_unused void *arg)
+{
+	uint64_t pkt, tm, cmp_pkt, cmp_tm;
+	uint32_t lcore, rc;
+	long double cpp, cmp_cpp;
+
+	lcore = rte_lcore_id();
+
+	tm = search_ip5tuples_alg(&config.alg, &pkt);
+	cpp = (pkt == 0) ? 0 : (long double)tm / pkt;
+
 	dump_verbose(DUMP_NONE, stdout,
 		"%s  @lcore %u: %" PRIu32 " iterations, %" PRIu64 " pkts, %"
 		PRIu32 " categories, %" PRIu64 " cycles, %#Lf cycles/pkt\n",
-		__func__, lcore, i, pkt, config.run_categories,
-		tm, (pkt == 0) ? 0 : (long double)tm / pkt);
+		__func__, lcore, config.iter_num, pkt, config.run_categories,
+		tm, cpp);
 
-	return 0;
+	if (config.cmp_alg.alg == RTE_ACL_CLASSIFY_DEFAULT)
+		return 0;
+
+	rc = verify_ip5tuples(config.run_categories, config.trace_step);
+
+	cmp_tm = search_ip5tuples_alg(&config.cmp_alg, &cmp_pkt);
+	cmp_cpp = (cmp_pkt == 0) ? 0 : (long double)cmp_tm / cmp_pkt;
+
+	dump_verbose(DUMP_NONE, stdout,
+		"%s  @lcore %u: %s vs %s: %#Lf vs %#Lf cycles/pkt, "
+		"speedup: %#Lf, %u mismatched results\n",
+		__func__, lcore, config.alg.name, config.cmp_alg.name,
+		cpp, cmp_cpp, (cpp == 0) ? 0 : cmp_cpp / cpp, rc);
+
+	return (rc == 0) ? 0 : -EINVAL;
 }
 
 static unsigned long
@@ -897,13 +1005,13 @@ get_ulong_opt(const char *opt, const char *name, size_t min, size_t max)
 }
 
 static void
-get_alg_opt(const char *opt, const char *name)
+get_alg_opt(const char *opt, const char *name, struct acl_alg *alg)
 {
 	uint32_t i;
 
 	for (i = 0; i != RTE_DIM(acl_alg); i++) {
 		if (strcmp(opt, acl_alg[i].name) == 0) {
-			config.alg = acl_alg[i];
+			*alg = acl_alg[i];
 			return;
 		}
 	}
@@ -953,6 +1061,9 @@ print_usage(const char *prgname)
 		"[--" OPT_ITER_NUM "=<number of iterations to perform>]\n"
 		"[--" OPT_VERBOSE "=<verbose level>]\n"
 		"[--" OPT_SEARCH_ALG "=%s]\n"
+		"[--" OPT_CMP_ALG "=<method to verify results and "
+			"compare performance against, same values as for "
+			"--" OPT_SEARCH_ALG ">]\n"
 		"[--" OPT_IPV6 "=<IPv6 rules and trace files>]\n",
 		prgname, RTE_ACL_RESULTS_MULTIPLIER,
 		(uint32_t)RTE_ACL_MAX_CATEGORIES,
@@ -975,6 +1086,8 @@ dump_config(FILE *f)
 	fprintf(f, "%s:%u\n", OPT_VERBOSE, config.verbose);
 	fprintf(f, "%s:%u(%s)\n", OPT_SEARCH_ALG, config.alg.alg,
 		config.alg.name);
+	fprintf(f, "%s:%u(%s)\n", OPT_CMP_ALG, config.cmp_alg.alg,
+		config.cmp_alg.name);
 	fprintf(f, "%s:%u\n", OPT_IPV6, config.ipv6);
 }
 
@@ -1004,6 +1117,7 @@ get_input_opts(int argc, char **argv)
 		{OPT_ITER_NUM, 1, 0, 0},
 		{OPT_VERBOSE, 1, 0, 0},
 		{OPT_SEARCH_ALG, 1, 0, 0},
+		{OPT_CMP_ALG, 1, 0, 0},
 		{OPT_IPV6, 0, 0, 0},
 		{NULL, 0, 0, 0}
 	};
@@ -1051,7 +1165,11 @@ get_input_opts(int argc, char **argv)
 				lgopts[opt_idx].name, DUMP_NONE, DUMP_MAX);
 		} else if (strcmp(lgopts[opt_idx].name,
 				OPT_SEARCH_ALG) == 0) {
-			get_alg_opt(optarg, lgopts[opt_idx].name);
+			get_alg_opt(optarg, lgopts[opt_idx].name,
+				&config.alg);
+		} else if (strcmp(lgopts[opt_idx].name, OPT_CMP_ALG) == 0) {
+			get_alg_opt(optarg, lgopts[opt_idx].name,
+				&config.cmp_alg);
 		} else if (strcmp(lgopts[opt_idx].name, OPT_IPV6) == 0) {
 			config.ipv6 = 1;
 		}
@@ -1088,10 +1206,10 @@ main(int argc, char **argv)
 	RTE_LCORE_FOREACH_SLAVE(lcore)
 		 rte_eal_remote_launch(search_ip5tuples, NULL, lcore);
 
-	search_ip5tuples(NULL);
+	ret = search_ip5tuples(NULL);
 
 	rte_eal_mp_wait_lcore();
 
 	rte_acl_free(config.acx);
-	return 0;
+	return ret;
 }
@@ -717,6 +717,12 @@
         "Func":    default_autotest,
         "Report":  None,
     },
+    {
+        "Name":    "Timer backend performance autotest",
+        "Command": "timer_backend_perf_autotest",
+        "Func":    default_autotest,
+        "Report":  None,
+    },
     {
 
         "Name":    "Pmd perf autotest",
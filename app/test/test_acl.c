@@ -13,6 +13,7 @@
 #include <rte_ip.h>
 #include <rte_acl.h>
 #include <rte_common.h>
+#include <rte_cpuflags.h>
 
 #include "test_acl.h"
 
@@ -265,15 +266,57 @@ rte_acl_ipv4vlan_build(struct rte_acl_ctx *ctx,
 	return rte_acl_build(ctx, &cfg);
 }
 
+/* classify methods checked against the default one */
+static const struct {
+	enum rte_acl_classify_alg alg;
+	const char *name;
+} test_classify_algs[] = {
+	{ RTE_ACL_CLASSIFY_SCALAR, "scalar" },
+	{ RTE_ACL_CLASSIFY_SSE, "SSE" },
+	{ RTE_ACL_CLASSIFY_AVX2, "AVX2" },
+	{ RTE_ACL_CLASSIFY_AVX512, "AVX512" },
+	{ RTE_ACL_CLASSIFY_NEON, "NEON" },
+	{ RTE_ACL_CLASSIFY_ALTIVEC, "ALTIVEC" },
+};
+
 /*
- * Test scalar and SSE ACL lookup.
+ * Check that the CPU has the features the classify method requires.
+ */
+static int
+test_classify_alg_supported(enum rte_acl_classify_alg alg)
+{
+	switch (alg) {
+	case RTE_ACL_CLASSIFY_SCALAR:
+		return 1;
+#if defined(RTE_ARCH_X86)
+	case RTE_ACL_CLASSIFY_SSE:
+		return rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE4_1) > 0;
+	case RTE_ACL_CLASSIFY_AVX2:
+		return rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2) > 0;
+	case RTE_ACL_CLASSIFY_AVX512:
+		return rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) > 0 &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW) > 0;
+#elif defined(RTE_ARCH_ARM64)
+	case RTE_ACL_CLASSIFY_NEON:
+		return 1;
+#elif defined(RTE_ARCH_PPC_64)
+	case RTE_ACL_CLASSIFY_ALTIVEC:
+		return 1;
+#endif
+	default:
+		return 0;
+	}
+}
+
+/*
+ * Test ACL lookup with the default and every supported classify method.
  */
 static int
 test_classify_run(struct rte_acl_ctx *acx, struct ipv4_7tuple test_data[],
 	size_t dim)
 {
 	int ret, i;
-	uint32_t result, count;
+	uint32_t alg, result, count;
 	uint32_t results[dim * RTE_ACL_MAX_CATEGORIES];
 	const uint8_t *data[dim];
 	/* swap all bytes in the data to network order */
@@ -323,38 +366,54 @@ test_classify_run(struct rte_acl_ctx *acx, struct ipv4_7tuple test_data[],
 		}
 	}
 
-	/* make a quick check for scalar */
-	ret = rte_acl_classify_alg(acx, data, results,
-			dim, RTE_ACL_MAX_CATEGORIES,
-			RTE_ACL_CLASSIFY_SCALAR);
-	if (ret != 0) {
-		printf("Line %i: scalar classify failed!\n", __LINE__);
-		goto err;
-	}
+	/* make a quick check for every other supported classify method */
+	for (alg = 0; alg < RTE_DIM(test_classify_algs); alg++) {
+		if (!test_classify_alg_supported(test_classify_algs[alg].alg)) {
+			printf("Line %i: %s classify not supported by the CPU, "
+				"skipping\n", __LINE__,
+				test_classify_algs[alg].name);
+			continue;
+		}
 
-	/* check if we allow everything we should allow */
-	for (i = 0; i < (int) dim; i++) {
-		result = results[i * RTE_ACL_MAX_CATEGORIES + ACL_ALLOW];
-		if (result != test_data[i].allow) {
-			printf("Line %i: Error in allow results at %i "
-					"(expected %"PRIu32" got %"PRIu32")!\n",
-					__LINE__, i, test_data[i].allow,
-					result);
-			ret = -EINVAL;
+		ret = rte_acl_classify_alg(acx, data, results,
+				dim, RTE_ACL_MAX_CATEGORIES,
+				test_classify_algs[alg].alg);
+		if (ret == -ENOTSUP) {
+			printf("Line %i: %s classify not built, skipping\n",
+				__LINE__, test_classify_algs[alg].name);
+			continue;
+		}
+		if (ret != 0) {
+			printf("Line %i: %s classify failed!\n", __LINE__,
+				test_classify_algs[alg].name);
 			goto err;
 		}
-	}
 
-	/* check if we deny everything we should deny */
-	for (i = 0; i < (int) dim; i++) {
-		result = results[i * RTE_ACL_MAX_CATEGORIES + ACL_DENY];
-		if (result != test_data[i].deny) {
-			printf("Line %i: Error in deny results at %i "
+		/* check if we allow everything we should allow */
+		for (i = 0; i < (int) dim; i++) {
+			result =
+				results[i * RTE_ACL_MAX_CATEGORIES + ACL_ALLOW];
+			if (result != test_data[i].allow) {
+				printf("Line %i: Error in %s allow results at %i "
 					"(expected %"PRIu32" got %"PRIu32")!\n",
-					__LINE__, i, test_data[i].deny,
-					result);
-			ret = -EINVAL;
-			goto err;
+					__LINE__, test_classify_algs[alg].name, i,
+					test_data[i].allow, result);
+				ret = -EINVAL;
+				goto err;
+			}
+		}
+
+		/* check if we deny everything we should deny */
+		for (i = 0; i < (int) dim; i++) {
+			result = results[i * RTE_ACL_MAX_CATEGORIES + ACL_DENY];
+			if (result != test_data[i].deny) {
+				printf("Line %i: Error in %s deny results at %i "
+					"(expected %"PRIu32" got %"PRIu32")!\n",
+					__LINE__, test_classify_algs[alg].name, i,
+					test_data[i].deny, result);
+				ret = -EINVAL;
+				goto err;
+			}
 		}
 	}
 
@@ -6,7 +6,9 @@
 
 #include <rte_hexdump.h>
 #include <rte_malloc.h>
+#include <rte_mbuf.h>
 #include <rte_memcpy.h>
+#include <rte_random.h>
 #include <rte_net_crc.h>
 
 #define CRC_VEC_LEN        32
@@ -15,6 +17,10 @@
 #define CRC16_VEC_LEN1     12
 #define CRC16_VEC_LEN2     2
 #define LINE_LEN           75
+#define CRC_CMP_MAX_LEN    2100
+#define CRC_MBUF_NUM       8
+#define CRC_MBUF_SEG_NUM   4
+#define CRC_MBUF_SEG_LEN   700
 
 /* CRC test vector */
 static const uint8_t crc_vec[CRC_VEC_LEN] = {
@@ -128,6 +134,124 @@ test_crc_calc(void)
 	return error;
 }
 
+/* Compare the CRC of the current algorithm with the scalar one */
+static int
+test_crc_cmp_scalar(enum rte_net_crc_alg alg)
+{
+	enum rte_net_crc_type type;
+	uint32_t i, len, res[RTE_NET_CRC_REQS];
+	uint8_t *test_data;
+	int error = 0;
+
+	test_data = rte_malloc(NULL, CRC_CMP_MAX_LEN + 1, 0);
+	if (test_data == NULL)
+		return -1;
+
+	for (i = 0; i < CRC_CMP_MAX_LEN + 1; i++)
+		test_data[i] = rte_rand();
+
+	/* unaligned data of all lengths, for the main loops and tails */
+	for (len = 0; len <= CRC_CMP_MAX_LEN; len++) {
+		for (type = 0; type < RTE_NET_CRC_REQS; type++) {
+			rte_net_crc_set_alg(RTE_NET_CRC_SCALAR);
+			res[type] = rte_net_crc_calc(test_data + 1, len, type);
+			rte_net_crc_set_alg(alg);
+			if (rte_net_crc_calc(test_data + 1, len, type) !=
+					res[type]) {
+				printf("CRC type %d of %u bytes mismatch\n",
+					type, len);
+				error = -1;
+				goto out;
+			}
+		}
+	}
+
+out:
+	rte_free(test_data);
+	return error;
+}
+
+/* Compare the CRC of multi-segment packets with the contiguous data */
+static int
+test_crc_mbufs(void)
+{
+	struct rte_mbuf *mbufs[CRC_MBUF_NUM] = { NULL };
+	struct rte_mempool *mp;
+	enum rte_net_crc_type type;
+	uint32_t crcs[CRC_MBUF_NUM];
+	uint32_t data_len, offset = 14;
+	uint8_t *data, *test_data;
+	uint16_t i, j, k;
+	int error = -1;
+
+	mp = rte_pktmbuf_pool_create("test_crc_mbufs",
+		CRC_MBUF_NUM * CRC_MBUF_SEG_NUM, 0, 0,
+		RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	test_data = rte_malloc(NULL, CRC_MBUF_SEG_NUM * CRC_MBUF_SEG_LEN, 0);
+	if (mp == NULL || test_data == NULL)
+		goto out;
+
+	for (i = 0; i < CRC_MBUF_SEG_NUM * CRC_MBUF_SEG_LEN; i++)
+		test_data[i] = rte_rand();
+
+	/* packet i has i % CRC_MBUF_SEG_NUM + 1 segments of random lengths,
+	 * the first one always longer than the CRC offset
+	 */
+	for (i = 0; i < CRC_MBUF_NUM; i++) {
+		struct rte_mbuf *seg;
+
+		data_len = 0;
+		for (j = 0; j <= i % CRC_MBUF_SEG_NUM; j++) {
+			seg = rte_pktmbuf_alloc(mp);
+			if (seg == NULL)
+				goto out;
+			if (j == 0)
+				k = rte_rand() % (CRC_MBUF_SEG_LEN - offset) +
+					offset + 1;
+			else
+				k = rte_rand() % CRC_MBUF_SEG_LEN + 1;
+			data = (uint8_t *)rte_pktmbuf_append(seg, k);
+			memcpy(data, test_data + data_len, k);
+			data_len += k;
+			if (mbufs[i] == NULL)
+				mbufs[i] = seg;
+			else if (rte_pktmbuf_chain(mbufs[i], seg) != 0) {
+				rte_pktmbuf_free(seg);
+				goto out;
+			}
+		}
+	}
+
+	for (type = 0; type < RTE_NET_CRC_REQS; type++) {
+		if (rte_net_crc_calc_mbufs(mbufs, CRC_MBUF_NUM, offset, crcs,
+				type) != CRC_MBUF_NUM)
+			goto out;
+
+		for (i = 0; i < CRC_MBUF_NUM; i++) {
+			data_len = rte_pktmbuf_pkt_len(mbufs[i]) - offset;
+			if (crcs[i] != rte_net_crc_calc(test_data + offset,
+					data_len, type)) {
+				printf("CRC type %d of packet %u mismatch\n",
+					type, i);
+				goto out;
+			}
+		}
+	}
+
+	/* a packet shorter than the offset stops the burst */
+	if (rte_net_crc_calc_mbufs(mbufs, CRC_MBUF_NUM, CRC_MBUF_SEG_LEN + 1,
+			crcs, RTE_NET_CRC32_ETH) != 0)
+		goto out;
+
+	error = 0;
+out:
+	for (i = 0; i < CRC_MBUF_NUM; i++)
+		rte_pktmbuf_free(mbufs[i]);
+	rte_mempool_free(mp);
+	rte_free(test_data);
+	return error;
+}
+
 static int
 test_crc(void)
 {
@@ -158,6 +282,33 @@ test_crc(void)
 		return ret;
 	}
 
+	/* set CRC avx512 mode */
+	rte_net_crc_set_alg(RTE_NET_CRC_AVX512);
+
+	ret = test_crc_calc();
+	if (ret < 0) {
+		printf("test_crc (x86_64 AVX512): failed (%d)\n", ret);
+		return ret;
+	}
+
+	/* compare the vector algorithms with the scalar one */
+	ret = test_crc_cmp_scalar(RTE_NET_CRC_SSE42);
+	if (ret == 0)
+		ret = test_crc_cmp_scalar(RTE_NET_CRC_NEON);
+	if (ret == 0)
+		ret = test_crc_cmp_scalar(RTE_NET_CRC_AVX512);
+	if (ret < 0) {
+		printf("test_crc (compare with scalar): failed (%d)\n", ret);
+		return ret;
+	}
+
+	/* multi-segment packets, with the best algorithm */
+	ret = test_crc_mbufs();
+	if (ret < 0) {
+		printf("test_crc (mbufs): failed (%d)\n", ret);
+		return ret;
+	}
+
 	return 0;
 }
 
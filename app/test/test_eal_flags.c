@@ -917,6 +917,19 @@ test_misc_flags(void)
 	const char * const argv18[] = {prgname, "--file-prefix=uiodev",
 			"--create-uio-dev"};
 
+	/* With parallel mapping of the hugepages */
+	const char * const argv19[] = {prgname, "-m", DEFAULT_MEM_SIZE,
+			"--file-prefix=parallel", "--huge-parallel=2"};
+
+	/* With invalid --huge-parallel */
+	const char * const argv20[] = {prgname, "-m", DEFAULT_MEM_SIZE,
+			"--file-prefix=parallel", "--huge-parallel=invalid"};
+
+	/* With --huge-parallel and --single-file-segments (should fail) */
+	const char * const argv21[] = {prgname, "-m", DEFAULT_MEM_SIZE,
+			"--file-prefix=parallel", "--huge-parallel=2",
+			"--single-file-segments"};
+
 	/* run all tests also applicable to FreeBSD first */
 
 	if (launch_proc(argv0) == 0) {
@@ -1008,6 +1021,21 @@ test_misc_flags(void)
 				"--create-uio-dev parameter\n");
 		return -1;
 	}
+	if (launch_proc(argv19) != 0) {
+		printf("Error - process did not run ok with "
+				"--huge-parallel parameter\n");
+		return -1;
+	}
+	if (launch_proc(argv20) == 0) {
+		printf("Error - process run ok with "
+				"invalid --huge-parallel parameter\n");
+		return -1;
+	}
+	if (launch_proc(argv21) == 0) {
+		printf("Error - process run ok with "
+				"--huge-parallel and --single-file-segments\n");
+		return -1;
+	}
 
 	return 0;
 }
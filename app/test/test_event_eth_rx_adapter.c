@@ -8,6 +8,7 @@
 #include <rte_ethdev.h>
 #include <rte_eventdev.h>
 #include <rte_bus_vdev.h>
+#include <rte_service.h>
 
 #include <rte_event_eth_rx_adapter.h>
 
@@ -458,6 +459,203 @@ adapter_queue_add_del(void)
 	return TEST_SUCCESS;
 }
 
+static int
+adapter_queue_event_vector_config(void)
+{
+	struct rte_event_eth_rx_adapter_event_vector_config vec_conf;
+	struct rte_event_eth_rx_adapter_vector_limits limits;
+	struct rte_event_eth_rx_adapter_queue_conf queue_config;
+	struct rte_event ev;
+	uint32_t cap;
+	int err;
+
+	err = rte_event_eth_rx_adapter_caps_get(TEST_DEV_ID, TEST_ETHDEV_ID,
+					 &cap);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_vector_limits_get(TEST_DEV_ID,
+						TEST_ETHDEV_ID, &limits);
+	if (cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT) {
+		TEST_ASSERT(err == -ENOTSUP, "Expected -ENOTSUP got %d", err);
+		return TEST_SKIPPED;
+	}
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	memset(&ev, 0, sizeof(ev));
+	ev.queue_id = 0;
+	ev.sched_type = RTE_SCHED_TYPE_ATOMIC;
+	ev.priority = 0;
+
+	queue_config.rx_queue_flags = 0;
+	queue_config.ev = ev;
+	queue_config.servicing_weight = 1;
+
+	vec_conf.vector_sz = limits.min_sz;
+	vec_conf.vector_timeout_ns = limits.min_timeout_ns;
+	vec_conf.vector_mp = rte_event_vector_pool_create("test_vector_pool",
+				256, 0, vec_conf.vector_sz, rte_socket_id());
+	TEST_ASSERT(vec_conf.vector_mp != NULL, "Failed to create pool");
+
+	/* Queue not added with the vector flag */
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1, &queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+						TEST_ETHDEV_ID, -1, &vec_conf);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	queue_config.rx_queue_flags =
+		RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR;
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1, &queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+						TEST_ETHDEV_ID, -1, &vec_conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	/* Vectors larger than the pool elements */
+	vec_conf.vector_sz = limits.min_sz * 2;
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+						TEST_ETHDEV_ID, -1, &vec_conf);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	vec_conf.vector_sz = limits.min_sz;
+	vec_conf.vector_timeout_ns = limits.max_timeout_ns + 1;
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+						TEST_ETHDEV_ID, -1, &vec_conf);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_del(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	rte_mempool_free(vec_conf.vector_mp);
+
+	return TEST_SUCCESS;
+}
+
+/* The Rx queues of the port are spread over the 2 shards, each shard
+ * service polls its own queues and the stats sum the shard counters
+ */
+static int
+adapter_shards_poll(void)
+{
+	struct rte_event_eth_rx_adapter_stats stats;
+	uint64_t poll_count = 0;
+	uint32_t service_id;
+	uint16_t i;
+	int err;
+
+	err = rte_event_eth_rx_adapter_start(TEST_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_stats_reset(TEST_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	for (i = 0; i < 2; i++) {
+		err = rte_event_eth_rx_adapter_shard_service_id_get(
+				TEST_INST_ID, i, &service_id);
+		TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+		err = rte_service_run_iter_on_app_lcore(service_id, 1);
+		TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+		/* The shard has queues to poll, its count is added */
+		err = rte_event_eth_rx_adapter_stats_get(TEST_INST_ID, &stats);
+		TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+		TEST_ASSERT(stats.rx_poll_count > poll_count,
+			"Shard %u did not poll its Rx queues", i);
+		poll_count = stats.rx_poll_count;
+	}
+
+	/* The counters of every shard are cleared */
+	err = rte_event_eth_rx_adapter_stats_reset(TEST_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_rx_adapter_stats_get(TEST_INST_ID, &stats);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT(stats.rx_poll_count == 0 && stats.rx_packets == 0,
+		"Expected cleared stats got %" PRIu64 " polls",
+		stats.rx_poll_count);
+
+	err = rte_event_eth_rx_adapter_stop(TEST_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	return TEST_SUCCESS;
+}
+
+static int
+adapter_shards(void)
+{
+	struct rte_event_eth_rx_adapter_queue_conf queue_config;
+	uint32_t service_id, shard_service_id;
+	struct rte_event ev;
+	uint32_t cap;
+	int err;
+
+	err = rte_event_eth_rx_adapter_caps_get(TEST_DEV_ID, TEST_ETHDEV_ID,
+					 &cap);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	if (cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT)
+		return TEST_SKIPPED;
+
+	err = rte_event_eth_rx_adapter_shards_set(TEST_INST_ID, 0);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	err = rte_event_eth_rx_adapter_shards_set(TEST_INST_ID, 2);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_shard_service_id_get(TEST_INST_ID, 1,
+						&shard_service_id);
+	TEST_ASSERT(err == -ESRCH, "Expected -ESRCH got %d", err);
+
+	memset(&ev, 0, sizeof(ev));
+	ev.queue_id = 0;
+	ev.sched_type = RTE_SCHED_TYPE_ATOMIC;
+	ev.priority = 0;
+
+	queue_config.rx_queue_flags = 0;
+	queue_config.ev = ev;
+	queue_config.servicing_weight = 1;
+
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1, &queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	/* Services created by the first queue add */
+	err = rte_event_eth_rx_adapter_shards_set(TEST_INST_ID, 1);
+	TEST_ASSERT(err == -EBUSY, "Expected -EBUSY got %d", err);
+
+	err = rte_event_eth_rx_adapter_service_id_get(TEST_INST_ID,
+						&service_id);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_rx_adapter_shard_service_id_get(TEST_INST_ID, 0,
+						&shard_service_id);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT(service_id == shard_service_id,
+		"Expected service %u got %u", service_id, shard_service_id);
+
+	err = rte_event_eth_rx_adapter_shard_service_id_get(TEST_INST_ID, 1,
+						&shard_service_id);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT(service_id != shard_service_id,
+		"Expected distinct shard services");
+
+	err = rte_event_eth_rx_adapter_shard_service_id_get(TEST_INST_ID, 2,
+						&shard_service_id);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	if (default_params.rx_rings > 1) {
+		err = adapter_shards_poll();
+		TEST_ASSERT(err == TEST_SUCCESS, "Shard polling failed");
+	}
+
+	err = rte_event_eth_rx_adapter_queue_del(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	return TEST_SUCCESS;
+}
+
 static int
 adapter_multi_eth_add_del(void)
 {
@@ -686,6 +884,9 @@ static struct unit_test_suite event_eth_rx_tests = {
 					adapter_queue_add_del),
 		TEST_CASE_ST(adapter_create, adapter_free,
 					adapter_multi_eth_add_del),
+		TEST_CASE_ST(adapter_create, adapter_free,
+					adapter_queue_event_vector_config),
+		TEST_CASE_ST(adapter_create, adapter_free, adapter_shards),
 		TEST_CASE_ST(adapter_create, adapter_free, adapter_start_stop),
 		TEST_CASE_ST(adapter_create, adapter_free, adapter_stats),
 		TEST_CASES_END() /**< NULL terminate unit test array */
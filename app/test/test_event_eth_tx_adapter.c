@@ -9,6 +9,7 @@
 #include <rte_ethdev.h>
 #include <rte_eth_ring.h>
 #include <rte_eventdev.h>
+#include <rte_event_eth_rx_adapter.h>
 #include <rte_event_eth_tx_adapter.h>
 #include <rte_mbuf.h>
 #include <rte_mempool.h>
@@ -32,6 +33,17 @@
 
 #define EDEV_RETRY		0xffff
 
+/* Event ports and queues of the vector test */
+#define VEC_WORKER_PORT		0
+#define VEC_RX_PORT		1
+#define VEC_TX_PORT		2
+#define VEC_WORKER_QUEUE	0
+#define VEC_TX_QUEUE		1
+#define VEC_SZ			4
+#define VEC_NB_PKTS		(VEC_SZ + VEC_SZ / 2)
+#define VEC_TIMEOUT_NS		(100 * 1000 * 1000)
+#define VEC_POOL_SZ		64
+
 struct event_eth_tx_adapter_test_params {
 	struct rte_mempool *mp;
 	uint16_t rx_rings, tx_rings;
@@ -631,6 +643,274 @@ tx_adapter_service(void)
 	return TEST_SUCCESS;
 }
 
+static int
+tx_adapter_vector_rx_conf_cb(uint8_t id __rte_unused,
+		uint8_t dev_id __rte_unused,
+		struct rte_event_eth_rx_adapter_conf *conf,
+		void *arg __rte_unused)
+{
+	conf->event_port_id = VEC_RX_PORT;
+	conf->max_nb_rx = RING_SIZE;
+	return 0;
+}
+
+static int
+tx_adapter_vector_tx_conf_cb(uint8_t id __rte_unused,
+		uint8_t dev_id __rte_unused,
+		struct rte_event_eth_tx_adapter_conf *conf,
+		void *arg __rte_unused)
+{
+	conf->event_port_id = VEC_TX_PORT;
+	conf->max_nb_tx = RING_SIZE;
+	return 0;
+}
+
+/* Run the Rx adapter and event device services until an event is dequeued */
+static int
+tx_adapter_vector_dequeue(uint32_t rx_sid, struct rte_event *ev,
+		unsigned int retry)
+{
+	unsigned int l;
+
+	for (l = 0; l < retry; l++) {
+		rte_service_run_iter_on_app_lcore(rx_sid, 0);
+		if (eid != ~0ULL)
+			rte_service_run_iter_on_app_lcore(eid, 0);
+		if (rte_event_dequeue_burst(TEST_DEV_ID, VEC_WORKER_PORT, ev,
+				1, 0) == 1)
+			return 1;
+	}
+
+	return 0;
+}
+
+/* Check a vector event of the Rx adapter and forward it to the Tx adapter */
+static int
+tx_adapter_vector_forward(struct rte_event *ev, struct rte_mbuf **pkts,
+		uint16_t nb_pkts)
+{
+	struct rte_mbuf *m[VEC_NB_PKTS];
+	unsigned int l;
+	uint16_t i, n;
+
+	TEST_ASSERT_EQUAL(ev->event_type, RTE_EVENT_TYPE_ETH_RX_ADAPTER_VECTOR,
+		"Expected a vector event got type %u", ev->event_type);
+	TEST_ASSERT_EQUAL(ev->vec->nb_elem, nb_pkts,
+		"Expected %u mbufs got %u", nb_pkts, ev->vec->nb_elem);
+	TEST_ASSERT(ev->vec->attr_valid &&
+		ev->vec->port == TEST_ETHDEV_PAIR_ID && ev->vec->queue == 0,
+		"Invalid vector port and queue");
+	for (i = 0; i < nb_pkts; i++)
+		TEST_ASSERT_EQUAL(ev->vec->mbufs[i], pkts[i],
+			"mbuf %u of the vector does not match", i);
+
+	ev->op = RTE_EVENT_OP_FORWARD;
+	ev->queue_id = VEC_TX_QUEUE;
+	TEST_ASSERT_EQUAL(rte_event_enqueue_burst(TEST_DEV_ID, VEC_WORKER_PORT,
+		ev, 1), 1, "Unable to enqueue to eventdev");
+
+	/* The mbufs are transmitted by the Tx adapter on the Rx port */
+	n = 0;
+	for (l = 0; l < EDEV_RETRY && n < nb_pkts; l++) {
+		if (eid != ~0ULL)
+			rte_service_run_iter_on_app_lcore(eid, 0);
+		rte_service_run_iter_on_app_lcore(tid, 0);
+		n += rte_eth_rx_burst(TEST_ETHDEV_ID, 0, &m[n], nb_pkts - n);
+	}
+	TEST_ASSERT_EQUAL(n, nb_pkts, "Expected %u mbufs got %u", nb_pkts, n);
+	for (i = 0; i < nb_pkts; i++)
+		TEST_ASSERT_EQUAL(m[i], pkts[i],
+			"mbuf %u transmitted does not match", i);
+
+	return 0;
+}
+
+static int
+tx_adapter_vector(void)
+{
+	struct rte_event_eth_rx_adapter_event_vector_config vec_conf;
+	struct rte_event_eth_rx_adapter_queue_conf queue_conf;
+	struct rte_event_eth_rx_adapter_stats rx_stats;
+	struct rte_event_eth_tx_adapter_stats tx_stats;
+	struct rte_event_queue_conf qconf;
+	struct rte_event_dev_config dev_conf;
+	struct rte_event_dev_info dev_info;
+	struct rte_mbuf *pkts[VEC_NB_PKTS];
+	struct rte_mempool *vp;
+	struct rte_event ev;
+	uint32_t rx_cap, tx_cap;
+	uint32_t rx_sid;
+	uint8_t queue;
+	uint8_t i;
+	int err;
+
+	err = rte_event_eth_rx_adapter_caps_get(TEST_DEV_ID,
+				TEST_ETHDEV_PAIR_ID, &rx_cap);
+	TEST_ASSERT(err == 0, "Failed to get Rx adapter cap err %d", err);
+	err = rte_event_eth_tx_adapter_caps_get(TEST_DEV_ID,
+				TEST_ETHDEV_PAIR_ID, &tx_cap);
+	TEST_ASSERT(err == 0, "Failed to get Tx adapter cap err %d", err);
+	if ((rx_cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT) ||
+	    (tx_cap & RTE_EVENT_ETH_TX_ADAPTER_CAP_INTERNAL_PORT))
+		return TEST_SKIPPED;
+
+	/*
+	 * Vectors of the Rx adapter port are dequeued by the worker port and
+	 * forwarded to the queue of the Tx adapter port
+	 */
+	err = rte_event_dev_info_get(TEST_DEV_ID, &dev_info);
+	TEST_ASSERT_SUCCESS(err, "Dev info failed");
+	memset(&dev_conf, 0, sizeof(dev_conf));
+	dev_conf.nb_event_queue_flows = dev_info.max_event_queue_flows;
+	dev_conf.nb_event_port_dequeue_depth =
+			dev_info.max_event_port_dequeue_depth;
+	dev_conf.nb_event_port_enqueue_depth =
+			dev_info.max_event_port_enqueue_depth;
+	dev_conf.nb_events_limit = dev_info.max_num_events;
+	dev_conf.nb_event_queues = 2;
+	dev_conf.nb_event_ports = 3;
+	err = rte_event_dev_configure(TEST_DEV_ID, &dev_conf);
+	TEST_ASSERT(err == 0, "Event device initialization failed err %d\n",
+			err);
+
+	memset(&qconf, 0, sizeof(qconf));
+	qconf.nb_atomic_flows = dev_info.max_event_queue_flows;
+	qconf.nb_atomic_order_sequences = 32;
+	qconf.schedule_type = RTE_SCHED_TYPE_ATOMIC;
+	qconf.priority = RTE_EVENT_DEV_PRIORITY_NORMAL;
+	for (i = 0; i < dev_conf.nb_event_queues; i++) {
+		err = rte_event_queue_setup(TEST_DEV_ID, i, &qconf);
+		TEST_ASSERT_SUCCESS(err, "Failed to setup queue %u", i);
+	}
+	for (i = 0; i < dev_conf.nb_event_ports; i++) {
+		err = rte_event_port_setup(TEST_DEV_ID, i, NULL);
+		TEST_ASSERT_SUCCESS(err, "Failed to setup port %u", i);
+	}
+	queue = VEC_WORKER_QUEUE;
+	err = rte_event_port_link(TEST_DEV_ID, VEC_WORKER_PORT, &queue,
+				NULL, 1);
+	TEST_ASSERT(err == 1, "Failed to link worker port");
+	queue = VEC_TX_QUEUE;
+	err = rte_event_port_link(TEST_DEV_ID, VEC_TX_PORT, &queue, NULL, 1);
+	TEST_ASSERT(err == 1, "Failed to link Tx adapter port");
+
+	err = rte_event_eth_rx_adapter_create_ext(TEST_INST_ID, TEST_DEV_ID,
+				tx_adapter_vector_rx_conf_cb, NULL);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_tx_adapter_create_ext(TEST_INST_ID, TEST_DEV_ID,
+				tx_adapter_vector_tx_conf_cb, NULL);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	vp = rte_event_vector_pool_create("tx_test_vector_pool", VEC_POOL_SZ,
+				0, VEC_SZ, rte_socket_id());
+	TEST_ASSERT(vp != NULL, "Failed to create vector pool");
+
+	memset(&queue_conf, 0, sizeof(queue_conf));
+	queue_conf.rx_queue_flags = RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR;
+	queue_conf.servicing_weight = 1;
+	queue_conf.ev.queue_id = VEC_WORKER_QUEUE;
+	queue_conf.ev.sched_type = RTE_SCHED_TYPE_ATOMIC;
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID,
+				TEST_ETHDEV_PAIR_ID, -1, &queue_conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	vec_conf.vector_sz = VEC_SZ;
+	vec_conf.vector_timeout_ns = VEC_TIMEOUT_NS;
+	vec_conf.vector_mp = vp;
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+				TEST_ETHDEV_PAIR_ID, -1, &vec_conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_tx_adapter_queue_add(TEST_INST_ID,
+				TEST_ETHDEV_PAIR_ID, -1);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	if (!(dev_info.event_dev_cap & RTE_EVENT_DEV_CAP_DISTRIBUTED_SCHED)) {
+		err = rte_event_dev_service_id_get(TEST_DEV_ID,
+				(uint32_t *)&eid);
+		TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+		err = rte_service_runstate_set(eid, 1);
+		TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+		err = rte_service_set_runstate_mapped_check(eid, 0);
+		TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	}
+
+	err = rte_event_eth_rx_adapter_service_id_get(TEST_INST_ID, &rx_sid);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_service_set_runstate_mapped_check(rx_sid, 0);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_tx_adapter_service_id_get(TEST_INST_ID, &tid);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_service_set_runstate_mapped_check(tid, 0);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_dev_start(TEST_DEV_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_rx_adapter_start(TEST_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_tx_adapter_start(TEST_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	/* The packets sent on the port are received on its pair */
+	err = rte_pktmbuf_alloc_bulk(default_params.mp, pkts, VEC_NB_PKTS);
+	TEST_ASSERT(err == 0, "Failed to allocate mbufs");
+	TEST_ASSERT_EQUAL(rte_eth_tx_burst(TEST_ETHDEV_ID, 0, pkts,
+		VEC_NB_PKTS), VEC_NB_PKTS, "Failed to send packets");
+
+	/* A full vector is enqueued as soon as its mbufs are received */
+	TEST_ASSERT(tx_adapter_vector_dequeue(rx_sid, &ev, EDEV_RETRY),
+		"Failed to dequeue the full vector");
+	err = tx_adapter_vector_forward(&ev, pkts, VEC_SZ);
+	TEST_ASSERT(err == 0, "Full vector forwarding failed");
+
+	/* The rest of the mbufs wait in a partial vector for its timeout */
+	TEST_ASSERT(!tx_adapter_vector_dequeue(rx_sid, &ev, 16),
+		"Partial vector enqueued before its timeout");
+	rte_delay_us(2 * VEC_TIMEOUT_NS / 1000);
+	TEST_ASSERT(tx_adapter_vector_dequeue(rx_sid, &ev, EDEV_RETRY),
+		"Failed to dequeue the partial vector");
+	err = tx_adapter_vector_forward(&ev, &pkts[VEC_SZ],
+				VEC_NB_PKTS - VEC_SZ);
+	TEST_ASSERT(err == 0, "Partial vector forwarding failed");
+
+	err = rte_event_eth_rx_adapter_stats_get(TEST_INST_ID, &rx_stats);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT_EQUAL(rx_stats.rx_packets, VEC_NB_PKTS,
+		"stats.rx_packets expected %u got %"PRIu64, VEC_NB_PKTS,
+		rx_stats.rx_packets);
+	err = rte_event_eth_tx_adapter_stats_get(TEST_INST_ID, &tx_stats);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT_EQUAL(tx_stats.tx_packets, VEC_NB_PKTS,
+		"stats.tx_packets expected %u got %"PRIu64, VEC_NB_PKTS,
+		tx_stats.tx_packets);
+
+	/* The Tx adapter returns the vectors to their pool */
+	TEST_ASSERT_EQUAL(rte_mempool_avail_count(vp), VEC_POOL_SZ,
+		"Vectors not freed by the Tx adapter");
+
+	rte_pktmbuf_free_bulk(pkts, VEC_NB_PKTS);
+
+	err = rte_event_eth_rx_adapter_stop(TEST_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_tx_adapter_stop(TEST_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_rx_adapter_queue_del(TEST_INST_ID,
+				TEST_ETHDEV_PAIR_ID, -1);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_tx_adapter_queue_del(TEST_INST_ID,
+				TEST_ETHDEV_PAIR_ID, -1);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_rx_adapter_free(TEST_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_tx_adapter_free(TEST_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	rte_event_dev_stop(TEST_DEV_ID);
+	rte_mempool_free(vp);
+
+	return TEST_SUCCESS;
+}
+
 static int
 tx_adapter_dynamic_device(void)
 {
@@ -688,6 +968,7 @@ static struct unit_test_suite event_eth_tx_tests = {
 					tx_adapter_start_stop),
 		TEST_CASE_ST(tx_adapter_create, tx_adapter_free,
 					tx_adapter_service),
+		TEST_CASE_ST(NULL, NULL, tx_adapter_vector),
 		TEST_CASE_ST(NULL, NULL, tx_adapter_dynamic_device),
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
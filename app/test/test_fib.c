@@ -311,6 +311,51 @@ check_fib(struct rte_fib *fib)
 	return TEST_SUCCESS;
 }
 
+/*
+ * Repeat the lookup checks for every DIR24_8 lookup function.
+ * Vector lookup is skipped if it is not supported on this machine.
+ */
+static int
+test_lookup_types(struct rte_fib_conf *config)
+{
+	static const enum rte_fib_dir24_8_lookup_type types[] = {
+		RTE_FIB_DIR24_8_SCALAR_INLINE,
+		RTE_FIB_DIR24_8_SCALAR_UNI,
+		RTE_FIB_DIR24_8_VECTOR_AVX512,
+	};
+	struct rte_fib *fib;
+	uint32_t i;
+	int nh_sz, ret;
+
+	config->type = RTE_FIB_DIR24_8;
+	for (i = 0; i < RTE_DIM(types); i++) {
+		for (nh_sz = RTE_FIB_DIR24_8_1B; nh_sz <= RTE_FIB_DIR24_8_8B;
+				nh_sz++) {
+			config->dir24_8.nh_sz = nh_sz;
+			config->dir24_8.num_tbl8 =
+				(nh_sz == RTE_FIB_DIR24_8_1B) ?
+				127 : MAX_TBL8 - 1;
+			fib = rte_fib_create(__func__, SOCKET_ID_ANY, config);
+			RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+			ret = rte_fib_set_lookup_fn(fib, types[i]);
+			if (ret != 0) {
+				rte_fib_free(fib);
+				RTE_TEST_ASSERT(types[i] ==
+					RTE_FIB_DIR24_8_VECTOR_AVX512,
+					"Failed to set lookup function\n");
+				break;
+			}
+			ret = check_fib(fib);
+			rte_fib_free(fib);
+			RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+				"Check_fib fails for lookup type %d, "
+				"nh_sz %d\n", types[i], nh_sz);
+		}
+	}
+
+	return TEST_SUCCESS;
+}
+
 int32_t
 test_lookup(void)
 {
@@ -368,7 +413,7 @@ test_lookup(void)
 		"Check_fib fails for DIR24_8_8B type\n");
 	rte_fib_free(fib);
 
-	return TEST_SUCCESS;
+	return test_lookup_types(&config);
 }
 
 static struct unit_test_suite fib_fast_tests = {
@@ -329,6 +329,37 @@ check_fib(struct rte_fib6 *fib)
 	return TEST_SUCCESS;
 }
 
+/*
+ * Repeat the lookup checks with the vector TRIE lookup function.
+ * The test is skipped if it is not supported on this machine.
+ */
+static int
+test_lookup_types(struct rte_fib6_conf *config)
+{
+	struct rte_fib6 *fib;
+	int nh_sz, ret;
+
+	config->type = RTE_FIB6_TRIE;
+	for (nh_sz = RTE_FIB6_TRIE_2B; nh_sz <= RTE_FIB6_TRIE_8B; nh_sz++) {
+		config->trie.nh_sz = nh_sz;
+		config->trie.num_tbl8 = MAX_TBL8 - 1;
+		fib = rte_fib6_create(__func__, SOCKET_ID_ANY, config);
+		RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+		ret = rte_fib6_set_lookup_fn(fib, RTE_FIB6_TRIE_VECTOR_AVX512);
+		if (ret != 0) {
+			rte_fib6_free(fib);
+			return TEST_SUCCESS;
+		}
+		ret = check_fib(fib);
+		rte_fib6_free(fib);
+		RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+			"Check_fib fails for vector lookup, nh_sz %d\n",
+			nh_sz);
+	}
+
+	return TEST_SUCCESS;
+}
+
 int32_t
 test_lookup(void)
 {
@@ -377,7 +408,7 @@ test_lookup(void)
 		"Check_fib fails for TRIE_8B type\n");
 	rte_fib6_free(fib);
 
-	return TEST_SUCCESS;
+	return test_lookup_types(&config);
 }
 
 static struct unit_test_suite fib6_fast_tests = {
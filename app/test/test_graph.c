@@ -760,6 +760,147 @@ test_print_stats(void)
 	return 0;
 }
 
+static struct rte_graph *dispatch_graph;
+static uint64_t dispatch_objs;
+
+static uint16_t
+test_dispatch_source_worker(struct rte_graph *graph, struct rte_node *node,
+			    void **objs, uint16_t nb_objs)
+{
+	void **next_stream;
+	uint16_t i;
+
+	RTE_SET_USED(objs);
+	nb_objs = RTE_GRAPH_BURST_SIZE;
+
+	next_stream = rte_node_next_stream_get(graph, node, 0, nb_objs);
+	for (i = 0; i < nb_objs; i++)
+		next_stream[i] = mbuf_p[MAX_NODES][i];
+	rte_node_next_stream_put(graph, node, 0, nb_objs);
+
+	return nb_objs;
+}
+
+static uint16_t
+test_dispatch_sink_worker(struct rte_graph *graph, struct rte_node *node,
+			  void **objs, uint16_t nb_objs)
+{
+	RTE_SET_USED(node);
+	RTE_SET_USED(objs);
+
+	dispatch_graph = graph;
+	dispatch_objs += nb_objs;
+
+	return nb_objs;
+}
+
+static struct rte_node_register test_dispatch_source = {
+	.name = "test_dispatch_source",
+	.process = test_dispatch_source_worker,
+	.flags = RTE_NODE_SOURCE_F,
+	.nb_edges = 1,
+	.next_nodes = {"test_dispatch_sink"},
+};
+RTE_NODE_REGISTER(test_dispatch_source);
+
+static struct rte_node_register test_dispatch_sink = {
+	.name = "test_dispatch_sink",
+	.process = test_dispatch_sink_worker,
+};
+RTE_NODE_REGISTER(test_dispatch_sink);
+
+static int
+test_graph_walk_dispatch(void)
+{
+	static const char *patterns[] = {
+		"test_dispatch_source", "test_dispatch_sink",
+	};
+	struct rte_graph_param gconf = {
+		.socket_id = SOCKET_ID_ANY,
+		.nb_node_patterns = 2,
+		.node_patterns = patterns,
+	};
+	struct rte_graph *graph, *clone;
+	rte_graph_t id, clone_id;
+	int rc = -1;
+
+	/* Source polled by lcore 0, sink processed by lcore 1 */
+	if (rte_node_lcore_affinity_set(test_dispatch_source.id, 0) ||
+	    rte_node_lcore_affinity_set(test_dispatch_sink.id, 1)) {
+		printf("Node lcore affinity set failed\n");
+		return -1;
+	}
+
+	id = rte_graph_create("dispatch", &gconf);
+	if (id == RTE_GRAPH_ID_INVALID) {
+		printf("Graph creation failed with error = %d\n", rte_errno);
+		return -1;
+	}
+
+	clone_id = rte_graph_clone(id, "w1");
+	if (clone_id == RTE_GRAPH_ID_INVALID) {
+		printf("Graph clone failed with error = %d\n", rte_errno);
+		goto destroy;
+	}
+
+	if (rte_graph_lcore_bind(clone_id, 1)) {
+		printf("Clone lcore bind failed\n");
+		goto destroy_clone;
+	}
+	if (rte_graph_lcore_bind(id, 1) != -EEXIST) {
+		printf("Bound two graphs to the same lcore\n");
+		goto destroy_clone;
+	}
+	if (rte_graph_lcore_bind(id, 0)) {
+		printf("Graph lcore bind failed\n");
+		goto destroy_clone;
+	}
+
+	if (rte_graph_destroy(id) != -EBUSY) {
+		printf("Destroyed a graph having clones\n");
+		goto destroy_clone;
+	}
+
+	graph = rte_graph_lookup("dispatch");
+	clone = rte_graph_lookup("dispatch-w1");
+	if (graph == NULL || clone == NULL) {
+		printf("Graph lookup failed\n");
+		goto destroy_clone;
+	}
+
+	/* The stream of the sink is handed over to the clone */
+	dispatch_objs = 0;
+	rte_graph_walk_dispatch(graph);
+	if (dispatch_objs != 0) {
+		printf("Sink processed by the lcore of the source\n");
+		goto destroy_clone;
+	}
+
+	/* The clone doesn't poll the source pinned to lcore 0 */
+	rte_graph_walk_dispatch(clone);
+	if (dispatch_objs != RTE_GRAPH_BURST_SIZE || dispatch_graph != clone) {
+		printf("Dispatch objs mismatch, expected = %u got = %" PRIu64
+		       "\n", RTE_GRAPH_BURST_SIZE, dispatch_objs);
+		goto destroy_clone;
+	}
+	rc = 0;
+
+destroy_clone:
+	if (rte_graph_destroy(clone_id)) {
+		printf("Clone destroy failed\n");
+		rc = -1;
+	}
+destroy:
+	if (rte_graph_destroy(id)) {
+		printf("Graph destroy failed\n");
+		rc = -1;
+	}
+	rte_node_lcore_affinity_set(test_dispatch_source.id, RTE_MAX_LCORE);
+	rte_node_lcore_affinity_set(test_dispatch_sink.id, RTE_MAX_LCORE);
+
+	return rc;
+}
+
 static int
 graph_setup(void)
 {
@@ -799,6 +940,7 @@ static struct unit_test_suite graph_testsuite = {
 		TEST_CASE(test_graph_lookup_functions),
 		TEST_CASE(test_graph_walk),
 		TEST_CASE(test_print_stats),
+		TEST_CASE(test_graph_walk_dispatch),
 		TEST_CASES_END(), /**< NULL terminate unit test array */
 	},
 };
@@ -18,6 +18,7 @@
 #include <rte_eal.h>
 #include <rte_ip.h>
 #include <rte_string_fns.h>
+#include <rte_errno.h>
 
 #include "test.h"
 
@@ -25,6 +26,7 @@
 #include <rte_fbk_hash.h>
 #include <rte_jhash.h>
 #include <rte_hash_crc.h>
+#include <rte_rcu_qsbr.h>
 
 /*******************************************************************************
  * Hash function performance test configuration section. Each performance test
@@ -1801,6 +1803,493 @@ test_hash_add_delete_jhash_3word(void)
 	return ret;
 }
 
+static uint32_t rcu_freed_key_data;
+
+static void
+test_hash_rcu_free_key_data(void *p, void *key_data)
+{
+	RTE_SET_USED(p);
+	RTE_SET_USED(key_data);
+	rcu_freed_key_data++;
+}
+
+/*
+ * Check the argument validation of rte_hash_rcu_qsbr_add.
+ */
+static int
+test_hash_rcu_qsbr_add(void)
+{
+	struct rte_hash_rcu_config rcu_cfg = {0};
+	struct rte_hash *handle;
+	struct rte_rcu_qsbr *qsv;
+	size_t sz;
+	int32_t status;
+
+	ut_params.name = "test_hash_rcu_qsbr_add";
+	ut_params.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF;
+	handle = rte_hash_create(&ut_params);
+	ut_params.extra_flag = 0;
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = rte_zmalloc(NULL, sz, RTE_CACHE_LINE_SIZE);
+	RETURN_IF_ERROR(qsv == NULL, "RCU QSBR allocation failed");
+	rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+
+	/* Invalid QSBR variable */
+	rcu_cfg.v = NULL;
+	status = rte_hash_rcu_qsbr_add(handle, &rcu_cfg);
+	RETURN_IF_ERROR(status == 0, "invalid QSBR variable accepted");
+
+	/* Invalid mode */
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = 2;
+	status = rte_hash_rcu_qsbr_add(handle, &rcu_cfg);
+	RETURN_IF_ERROR(status == 0, "invalid QSBR mode accepted");
+
+	rcu_cfg.mode = RTE_HASH_QSBR_MODE_DQ;
+	status = rte_hash_rcu_qsbr_add(handle, &rcu_cfg);
+	RETURN_IF_ERROR(status != 0, "attach RCU QSBR to hash failed");
+
+	/* Attach the QSBR variable a second time */
+	status = rte_hash_rcu_qsbr_add(handle, &rcu_cfg);
+	RETURN_IF_ERROR(status == 0 || rte_errno != EEXIST,
+		"duplicate RCU QSBR attach not rejected");
+
+	rte_hash_free(handle);
+	rte_free(qsv);
+	return 0;
+}
+
+/*
+ * Check that deleted keys are reclaimed through the RCU defer queue
+ * only after the reader reports quiescent state.
+ *  - attach RCU QSBR in defer queue mode, register one online reader
+ *  - add and delete a key until the table runs out of free slots
+ *  - report quiescent state, adding a key must succeed again
+ */
+static int
+test_hash_rcu_qsbr_dq_mode(uint8_t ext_bkt)
+{
+	struct rte_hash_rcu_config rcu_cfg = {0};
+	struct rte_hash *handle;
+	struct rte_rcu_qsbr *qsv;
+	uint32_t i, ip_src;
+	size_t sz;
+	int32_t pos;
+
+	ut_params.name = "test_hash_rcu_qsbr_dq_mode";
+	ut_params.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF;
+	if (ext_bkt)
+		ut_params.extra_flag |= RTE_HASH_EXTRA_FLAGS_EXT_TABLE;
+	handle = rte_hash_create(&ut_params);
+	ut_params.extra_flag = 0;
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = rte_zmalloc(NULL, sz, RTE_CACHE_LINE_SIZE);
+	RETURN_IF_ERROR(qsv == NULL, "RCU QSBR allocation failed");
+	rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+
+	rcu_freed_key_data = 0;
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_HASH_QSBR_MODE_DQ;
+	rcu_cfg.free_key_data_func = test_hash_rcu_free_key_data;
+	rcu_cfg.key_data_ptr = NULL;
+	RETURN_IF_ERROR(rte_hash_rcu_qsbr_add(handle, &rcu_cfg) != 0,
+		"attach RCU QSBR to hash failed");
+
+	/* Reader thread that never reports quiescent state */
+	rte_rcu_qsbr_thread_register(qsv, 0);
+	rte_rcu_qsbr_thread_online(qsv, 0);
+
+	ip_src = keys[0].ip_src;
+	for (i = 0; i < ut_params.entries; i++) {
+		keys[0].ip_src++;
+		pos = rte_hash_add_key_data(handle, &keys[0],
+				(void *)(uintptr_t)i);
+		print_key_info("Add", &keys[0], pos);
+		RETURN_IF_ERROR(pos < 0, "failed to add key (pos=%d)", pos);
+		pos = rte_hash_del_key(handle, &keys[0]);
+		print_key_info("Del", &keys[0], pos);
+		RETURN_IF_ERROR(pos < 0, "failed to delete key (pos=%d)", pos);
+	}
+
+	/* All slots wait for the reader, nothing can be reclaimed */
+	keys[0].ip_src++;
+	pos = rte_hash_add_key(handle, &keys[0]);
+	RETURN_IF_ERROR(pos != -ENOSPC,
+		"key slot reclaimed before quiescent state (pos=%d)", pos);
+	RETURN_IF_ERROR(rcu_freed_key_data != 0,
+		"key data freed before quiescent state");
+
+	/* Reader reports quiescent state, slots can be reclaimed */
+	rte_rcu_qsbr_quiescent(qsv, 0);
+	pos = rte_hash_add_key(handle, &keys[0]);
+	print_key_info("Add", &keys[0], pos);
+	RETURN_IF_ERROR(pos < 0, "failed to add key (pos=%d)", pos);
+	RETURN_IF_ERROR(rcu_freed_key_data == 0,
+		"key data not freed after quiescent state");
+	keys[0].ip_src = ip_src;
+
+	rte_rcu_qsbr_thread_offline(qsv, 0);
+	rte_rcu_qsbr_thread_unregister(qsv, 0);
+	rte_hash_free(handle);
+	rte_free(qsv);
+	return 0;
+}
+
+/*
+ * Check that deleted keys are freed immediately in blocking mode
+ * when no reader is online.
+ */
+static int
+test_hash_rcu_qsbr_sync_mode(void)
+{
+	struct rte_hash_rcu_config rcu_cfg = {0};
+	struct rte_hash *handle;
+	struct rte_rcu_qsbr *qsv;
+	uint32_t i;
+	size_t sz;
+	int32_t pos;
+
+	ut_params.name = "test_hash_rcu_qsbr_sync_mode";
+	ut_params.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF;
+	handle = rte_hash_create(&ut_params);
+	ut_params.extra_flag = 0;
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = rte_zmalloc(NULL, sz, RTE_CACHE_LINE_SIZE);
+	RETURN_IF_ERROR(qsv == NULL, "RCU QSBR allocation failed");
+	rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+
+	rcu_freed_key_data = 0;
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_HASH_QSBR_MODE_SYNC;
+	rcu_cfg.free_key_data_func = test_hash_rcu_free_key_data;
+	RETURN_IF_ERROR(rte_hash_rcu_qsbr_add(handle, &rcu_cfg) != 0,
+		"attach RCU QSBR to hash failed");
+
+	/* Registered reader that is offline does not block writers */
+	rte_rcu_qsbr_thread_register(qsv, 0);
+
+	/* Loop more times than there are slots to catch leaks */
+	for (i = 0; i < ut_params.entries + 1; i++) {
+		pos = rte_hash_add_key(handle, &keys[0]);
+		print_key_info("Add", &keys[0], pos);
+		RETURN_IF_ERROR(pos < 0, "failed to add key (pos=%d)", pos);
+		pos = rte_hash_del_key(handle, &keys[0]);
+		print_key_info("Del", &keys[0], pos);
+		RETURN_IF_ERROR(pos < 0, "failed to delete key (pos=%d)", pos);
+		RETURN_IF_ERROR(rcu_freed_key_data != i + 1,
+			"key data not freed on delete");
+	}
+
+	rte_rcu_qsbr_thread_unregister(qsv, 0);
+	rte_hash_free(handle);
+	rte_free(qsv);
+	return 0;
+}
+
+#define RESIZE_TEST_KEYS 256
+
+/* Look up the keys one by one and in bulk, pos[i] < 0 for deleted keys. */
+static int
+test_hash_resize_check(const struct rte_hash *handle,
+		const struct flow_key *keys, const int32_t *pos,
+		uint32_t num_keys)
+{
+	const void *key_ptrs[RTE_HASH_LOOKUP_BULK_MAX];
+	int32_t positions[RTE_HASH_LOOKUP_BULK_MAX];
+	int32_t expected, ret;
+	uint32_t i, j, n;
+
+	for (i = 0; i < num_keys; i++) {
+		expected = pos[i] < 0 ? -ENOENT : pos[i];
+		ret = rte_hash_lookup(handle, &keys[i]);
+		if (ret != expected) {
+			printf("lookup of key %u returned %d, expected %d\n",
+				i, ret, expected);
+			return -1;
+		}
+	}
+
+	for (i = 0; i < num_keys; i += n) {
+		n = RTE_MIN(num_keys - i, (uint32_t)RTE_HASH_LOOKUP_BULK_MAX);
+		for (j = 0; j < n; j++)
+			key_ptrs[j] = &keys[i + j];
+		rte_hash_lookup_bulk(handle, key_ptrs, n, positions);
+		for (j = 0; j < n; j++) {
+			expected = pos[i + j] < 0 ? -ENOENT : pos[i + j];
+			if (positions[j] != expected) {
+				printf("bulk lookup of key %u returned %d, "
+					"expected %d\n", i + j, positions[j],
+					expected);
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Check that a table grows without losing keys.
+ *  - fill the table and start a resize
+ *  - migrate one bucket at a time, look up all keys after each step
+ *  - fill the table again and start another resize
+ *  - delete half of the keys, which migrates the buckets implicitly
+ */
+static int
+test_hash_resize(uint32_t extra_flag)
+{
+	static struct flow_key resize_keys[RESIZE_TEST_KEYS];
+	int32_t pos[RESIZE_TEST_KEYS];
+	struct rte_hash *handle;
+	const void *next_key;
+	void *next_data;
+	uint32_t i, n, iter;
+	int32_t remaining, ret;
+
+	memset(resize_keys, 0, sizeof(resize_keys));
+	for (i = 0; i < RESIZE_TEST_KEYS; i++) {
+		resize_keys[i].ip_src = i;
+		resize_keys[i].ip_dst = rte_rand();
+		resize_keys[i].port_src = rte_rand();
+		pos[i] = -1;
+	}
+
+	ut_params.name = "test_hash_resize";
+	ut_params.extra_flag = extra_flag;
+	handle = rte_hash_create(&ut_params);
+	ut_params.extra_flag = 0;
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	for (n = 0; n < ut_params.entries; n++) {
+		pos[n] = rte_hash_add_key(handle, &resize_keys[n]);
+		if (pos[n] < 0)
+			break;
+	}
+
+	RETURN_IF_ERROR(rte_hash_resize(handle) != 0, "resize failed");
+	RETURN_IF_ERROR(rte_hash_resize(handle) != -EBUSY,
+		"resize in progress not reported");
+
+	/* Old bucket array of 64 / 8 buckets */
+	for (remaining = ut_params.entries / 8 - 1; remaining >= 0;
+			remaining--) {
+		ret = rte_hash_resize_step(handle, 1);
+		RETURN_IF_ERROR(ret != remaining,
+			"resize step returned %d, expected %d", ret, remaining);
+		RETURN_IF_ERROR(test_hash_resize_check(handle, resize_keys,
+			pos, RESIZE_TEST_KEYS) < 0, "keys lost on resize");
+	}
+
+	for (; n < ut_params.entries * 2; n++) {
+		pos[n] = rte_hash_add_key(handle, &resize_keys[n]);
+		if (pos[n] < 0)
+			break;
+	}
+	RETURN_IF_ERROR(n <= ut_params.entries, "table did not grow");
+
+	RETURN_IF_ERROR(rte_hash_resize(handle) != 0, "resize failed");
+
+	for (i = 0; i < n; i += 2) {
+		ret = rte_hash_del_key(handle, &resize_keys[i]);
+		RETURN_IF_ERROR(ret != pos[i], "failed to delete key %u", i);
+		pos[i] = -1;
+		RETURN_IF_ERROR(test_hash_resize_check(handle, resize_keys,
+			pos, RESIZE_TEST_KEYS) < 0, "keys lost on resize");
+	}
+
+	RETURN_IF_ERROR(rte_hash_resize_step(handle, UINT32_MAX) != 0,
+		"resize not completed");
+	RETURN_IF_ERROR(test_hash_resize_check(handle, resize_keys,
+		pos, RESIZE_TEST_KEYS) < 0, "keys lost on resize");
+
+	/* Every other key is left */
+	iter = 0;
+	i = 0;
+	while (rte_hash_iterate(handle, &next_key, &next_data, &iter) >= 0)
+		i++;
+	RETURN_IF_ERROR(i != n / 2, "iterated %u keys, expected %u", i, n / 2);
+
+	rte_hash_free(handle);
+
+	/* Resize is not supported with extendable buckets */
+	ut_params.extra_flag = RTE_HASH_EXTRA_FLAGS_EXT_TABLE;
+	handle = rte_hash_create(&ut_params);
+	ut_params.extra_flag = 0;
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+	RETURN_IF_ERROR(rte_hash_resize(handle) != -ENOTSUP,
+		"resize with ext table not rejected");
+
+	rte_hash_free(handle);
+	return 0;
+}
+
+/*
+ * Check that the defer queue grows with the table.
+ *  - attach a defer queue sized from the entries and resize twice
+ *  - with a reader that never reports quiescent state, delete more keys
+ *    than the table had entries before the resizes
+ *  - once the reader reported quiescent state, all the deleted key slots
+ *    must be reclaimed to add the keys back
+ */
+static int
+test_hash_resize_rcu_qsbr_dq(void)
+{
+	static struct flow_key resize_keys[RESIZE_TEST_KEYS];
+	struct rte_hash_rcu_config rcu_cfg = {0};
+	struct rte_hash *handle;
+	struct rte_rcu_qsbr *qsv;
+	uint32_t i, n;
+	int32_t pos;
+	size_t sz;
+
+	memset(resize_keys, 0, sizeof(resize_keys));
+	for (i = 0; i < RESIZE_TEST_KEYS; i++) {
+		resize_keys[i].ip_src = i;
+		resize_keys[i].ip_dst = rte_rand();
+		resize_keys[i].port_src = rte_rand();
+	}
+
+	ut_params.name = "test_hash_resize_rcu_qsbr_dq";
+	ut_params.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF;
+	handle = rte_hash_create(&ut_params);
+	ut_params.extra_flag = 0;
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = rte_zmalloc(NULL, sz, RTE_CACHE_LINE_SIZE);
+	RETURN_IF_ERROR(qsv == NULL, "RCU QSBR allocation failed");
+	rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_HASH_QSBR_MODE_DQ;
+	RETURN_IF_ERROR(rte_hash_rcu_qsbr_add(handle, &rcu_cfg) != 0,
+		"attach RCU QSBR to hash failed");
+
+	/* The defer queue ring of 64 entries holds 127 of them */
+	for (i = 0; i < 2; i++) {
+		RETURN_IF_ERROR(rte_hash_resize(handle) != 0, "resize failed");
+		RETURN_IF_ERROR(rte_hash_resize_step(handle, UINT32_MAX) != 0,
+			"resize not completed");
+	}
+
+	/* Reader thread that does not report quiescent state */
+	rte_rcu_qsbr_thread_register(qsv, 0);
+	rte_rcu_qsbr_thread_online(qsv, 0);
+
+	for (n = 0; n < RESIZE_TEST_KEYS; n++) {
+		pos = rte_hash_add_key(handle, &resize_keys[n]);
+		if (pos < 0)
+			break;
+	}
+	/* If the queue did not grow, more than n - 127 slots would leak,
+	 * leaving less than n free slots to add the keys back.
+	 */
+	RETURN_IF_ERROR(n < RESIZE_TEST_KEYS * 3 / 4,
+		"added %u keys, table did not grow", n);
+
+	for (i = 0; i < n; i++) {
+		pos = rte_hash_del_key(handle, &resize_keys[i]);
+		RETURN_IF_ERROR(pos < 0, "failed to delete key %u", i);
+	}
+
+	/* Every deleted slot is reclaimed after quiescent state, the same
+	 * keys fit in the buckets again.
+	 */
+	rte_rcu_qsbr_quiescent(qsv, 0);
+	for (i = 0; i < n; i++) {
+		pos = rte_hash_add_key(handle, &resize_keys[i]);
+		RETURN_IF_ERROR(pos < 0,
+			"failed to add key %u of %u, slots leaked", i, n);
+	}
+
+	rte_rcu_qsbr_thread_offline(qsv, 0);
+	rte_rcu_qsbr_thread_unregister(qsv, 0);
+	rte_hash_free(handle);
+	rte_free(qsv);
+	return 0;
+}
+
+#define STREAM_TEST_KEYS 300
+
+/*
+ * Check the streaming bulk lookup against single key lookups.
+ *  - add every other key of a list larger than RTE_HASH_LOOKUP_BULK_MAX
+ *  - look up the whole list with various pipeline depths, with and
+ *    without precomputed signatures
+ */
+static int
+test_hash_lookup_bulk_stream(uint32_t extra_flag)
+{
+	static struct flow_key stream_keys[STREAM_TEST_KEYS];
+	const void *key_ptrs[STREAM_TEST_KEYS];
+	hash_sig_t sigs[STREAM_TEST_KEYS];
+	int32_t pos[STREAM_TEST_KEYS];
+	int32_t positions[STREAM_TEST_KEYS];
+	void *data[STREAM_TEST_KEYS];
+	const uint32_t depths[] = {0, 1, 3, RTE_HASH_LOOKUP_STREAM_DEPTH_MAX};
+	struct rte_hash_parameters params = ut_params;
+	struct rte_hash *handle;
+	uint32_t i, d, with_sig, expected_hits = 0;
+	int ret;
+
+	params.name = "test_hash_lookup_bulk_stream";
+	params.entries = 1024;
+	params.extra_flag = extra_flag;
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	memset(stream_keys, 0, sizeof(stream_keys));
+	for (i = 0; i < STREAM_TEST_KEYS; i++) {
+		stream_keys[i].ip_src = i;
+		stream_keys[i].ip_dst = rte_rand();
+		key_ptrs[i] = &stream_keys[i];
+		sigs[i] = rte_hash_hash(handle, &stream_keys[i]);
+		pos[i] = -ENOENT;
+		if (i % 2 != 0)
+			continue;
+		pos[i] = rte_hash_add_key_data(handle, &stream_keys[i],
+				(void *)(uintptr_t)(i + 1));
+		RETURN_IF_ERROR(pos[i] != 0, "failed to add key %u", i);
+		pos[i] = rte_hash_lookup(handle, &stream_keys[i]);
+		expected_hits++;
+	}
+
+	for (d = 0; d < RTE_DIM(depths); d++) {
+		for (with_sig = 0; with_sig < 2; with_sig++) {
+			memset(data, 0, sizeof(data));
+			ret = rte_hash_lookup_bulk_stream(handle, key_ptrs,
+				with_sig ? sigs : NULL, STREAM_TEST_KEYS,
+				depths[d], positions, data);
+			RETURN_IF_ERROR(ret != (int)expected_hits,
+				"depth %u: %d hits, expected %u",
+				depths[d], ret, expected_hits);
+			for (i = 0; i < STREAM_TEST_KEYS; i++) {
+				RETURN_IF_ERROR(positions[i] != pos[i],
+					"depth %u: key %u at %d, expected %d",
+					depths[d], i, positions[i], pos[i]);
+				RETURN_IF_ERROR(pos[i] >= 0 &&
+					data[i] != (void *)(uintptr_t)(i + 1),
+					"depth %u: wrong data for key %u",
+					depths[d], i);
+			}
+		}
+	}
+
+	ret = rte_hash_lookup_bulk_stream(handle, key_ptrs, NULL,
+		STREAM_TEST_KEYS, RTE_HASH_LOOKUP_STREAM_DEPTH_MAX + 1,
+		positions, NULL);
+	RETURN_IF_ERROR(ret != -EINVAL, "invalid depth accepted");
+
+	rte_hash_free(handle);
+	return 0;
+}
+
 /*
  * Do all unit and performance tests.
  */
@@ -1829,6 +2318,29 @@ test_hash(void)
 		return -1;
 	if (test_add_delete_free_lf() < 0)
 		return -1;
+	if (test_hash_rcu_qsbr_add() < 0)
+		return -1;
+	if (test_hash_rcu_qsbr_dq_mode(0) < 0)
+		return -1;
+	if (test_hash_rcu_qsbr_dq_mode(1) < 0)
+		return -1;
+	if (test_hash_rcu_qsbr_sync_mode() < 0)
+		return -1;
+	if (test_hash_resize(0) < 0)
+		return -1;
+	if (test_hash_resize(RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY) < 0)
+		return -1;
+	if (test_hash_resize(RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF) < 0)
+		return -1;
+	if (test_hash_resize_rcu_qsbr_dq() < 0)
+		return -1;
+	if (test_hash_lookup_bulk_stream(0) < 0)
+		return -1;
+	if (test_hash_lookup_bulk_stream(RTE_HASH_EXTRA_FLAGS_EXT_TABLE) < 0)
+		return -1;
+	if (test_hash_lookup_bulk_stream(
+			RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF) < 0)
+		return -1;
 	if (test_five_keys() < 0)
 		return -1;
 	if (test_full_bucket() < 0)
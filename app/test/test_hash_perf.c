@@ -28,11 +28,13 @@
 #define NUM_KEYSIZES 10
 #define NUM_SHUFFLES 10
 #define BURST_SIZE 16
+#define STREAM_BURST_SIZE 256
 
 enum operations {
 	ADD = 0,
 	LOOKUP,
 	LOOKUP_MULTI,
+	LOOKUP_STREAM,
 	DELETE,
 	NUM_OPERATIONS
 };
@@ -517,6 +519,80 @@ timed_lookups_multi(unsigned int with_hash, unsigned int with_data,
 	return 0;
 }
 
+static int
+timed_lookups_stream(unsigned int with_hash, unsigned int with_data,
+		unsigned int table_index, unsigned int ext)
+{
+	unsigned int i, j, k;
+	int32_t positions_burst[STREAM_BURST_SIZE];
+	const void *keys_burst[STREAM_BURST_SIZE];
+	void *ret_data[STREAM_BURST_SIZE];
+	void *expected_data;
+	int ret;
+	unsigned int keys_to_add, num_lookups;
+
+	if (!ext) {
+		keys_to_add = KEYS_TO_ADD * ADD_PERCENT;
+		num_lookups = NUM_LOOKUPS * ADD_PERCENT;
+	} else {
+		keys_to_add = KEYS_TO_ADD;
+		num_lookups = NUM_LOOKUPS;
+	}
+
+	const uint64_t start_tsc = rte_rdtsc();
+
+	for (i = 0; i < num_lookups/keys_to_add; i++) {
+		for (j = 0; j < keys_to_add/STREAM_BURST_SIZE; j++) {
+			for (k = 0; k < STREAM_BURST_SIZE; k++)
+				keys_burst[k] = keys[j * STREAM_BURST_SIZE + k];
+
+			ret = rte_hash_lookup_bulk_stream(h[table_index],
+				(const void **)keys_burst,
+				with_hash ?
+				&signatures[j * STREAM_BURST_SIZE] : NULL,
+				STREAM_BURST_SIZE, 0, positions_burst,
+				with_data ? ret_data : NULL);
+			if (ret != STREAM_BURST_SIZE) {
+				printf("Expect to find %u keys,"
+				       " but found %d\n", STREAM_BURST_SIZE, ret);
+				return -1;
+			}
+			for (k = 0; k < STREAM_BURST_SIZE; k++) {
+				/* Positions are only stored by adds without data */
+				if (!with_data) {
+					if (positions_burst[k] != positions[j *
+							STREAM_BURST_SIZE + k]) {
+						printf("Key looked up in %d, should be in %d\n",
+							positions_burst[k],
+							positions[j *
+							STREAM_BURST_SIZE + k]);
+						return -1;
+					}
+					continue;
+				}
+				expected_data = (void *)((uintptr_t)signatures[
+						j * STREAM_BURST_SIZE + k]);
+				if (ret_data[k] != expected_data) {
+					printf("Data returned for key"
+						" number %u is %p,"
+						" but should be %p\n",
+						j * STREAM_BURST_SIZE + k,
+						ret_data[k], expected_data);
+					return -1;
+				}
+			}
+		}
+	}
+
+	const uint64_t end_tsc = rte_rdtsc();
+	const uint64_t time_taken = end_tsc - start_tsc;
+
+	cycles[table_index][LOOKUP_STREAM][with_hash][with_data] =
+		time_taken/num_lookups;
+
+	return 0;
+}
+
 static int
 timed_deletes(unsigned int with_hash, unsigned int with_data,
 				unsigned int table_index, unsigned int ext)
@@ -597,6 +673,10 @@ run_all_tbl_perf_tests(unsigned int with_pushes, unsigned int with_locks,
 						i, ext) < 0)
 					return -1;
 
+				if (timed_lookups_stream(with_hash, with_data,
+						i, ext) < 0)
+					return -1;
+
 				if (timed_deletes(with_hash, with_data, i, ext) < 0)
 					return -1;
 
@@ -623,8 +703,9 @@ run_all_tbl_perf_tests(unsigned int with_pushes, unsigned int with_locks,
 			else
 				printf("\nWithout pre-computed hash values\n");
 
-			printf("\n%-18s%-18s%-18s%-18s%-18s\n",
-			"Keysize", "Add", "Lookup", "Lookup_bulk", "Delete");
+			printf("\n%-18s%-18s%-18s%-18s%-18s%-18s\n",
+			"Keysize", "Add", "Lookup", "Lookup_bulk",
+			"Lookup_stream", "Delete");
 			for (i = 0; i < NUM_KEYSIZES; i++) {
 				printf("%-18d", hashtest_key_lens[i]);
 				for (j = 0; j < NUM_OPERATIONS; j++)
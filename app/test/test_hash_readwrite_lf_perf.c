@@ -1240,6 +1240,120 @@ test_hash_add_ks_lookup_hit_extbkt(struct rwc_perf *rwc_perf_results,
 	return -1;
 }
 
+#define RESIZE_ENTRY 1024
+#define RESIZE_KEYS (RESIZE_ENTRY / 2)
+#define RESIZE_ROUNDS 8
+
+static uint32_t resize_keys[RESIZE_KEYS];
+
+/* Look up the keys of the table being resized, they must all be found */
+static int
+test_rwc_resize_reader(void *arg)
+{
+	struct rte_hash *h = arg;
+	const void *key_ptrs[BULK_LOOKUP_SIZE];
+	int32_t pos[BULK_LOOKUP_SIZE];
+	uint32_t i, j;
+	int ret;
+
+	RTE_BUILD_BUG_ON(RESIZE_KEYS % BULK_LOOKUP_SIZE != 0);
+
+	do {
+		for (i = 0; i < RESIZE_KEYS; i++) {
+			ret = rte_hash_lookup(h, &resize_keys[i]);
+			if (ret < 0) {
+				printf("lookup failed during resize! %"PRIu32
+				       "\n", resize_keys[i]);
+				return -1;
+			}
+		}
+		for (i = 0; i < RESIZE_KEYS; i += BULK_LOOKUP_SIZE) {
+			for (j = 0; j < BULK_LOOKUP_SIZE; j++)
+				key_ptrs[j] = &resize_keys[i + j];
+			rte_hash_lookup_bulk(h, key_ptrs, BULK_LOOKUP_SIZE,
+					     pos);
+			for (j = 0; j < BULK_LOOKUP_SIZE; j++)
+				if (pos[j] < 0) {
+					printf("bulk lookup failed during "
+					       "resize! %"PRIu32"\n",
+					       resize_keys[i + j]);
+					return -1;
+				}
+		}
+	} while (!writer_done);
+
+	return 0;
+}
+
+/*
+ * Test lookup correctness:
+ * Reader(s) lookup keys present in the table while the writer resizes
+ * it several times, none of the lookups may miss.
+ */
+static int
+test_hash_resize_lookup_hit(void)
+{
+	struct rte_hash *h;
+	unsigned int n_readers, round;
+	unsigned int i;
+	int ret = 0;
+
+	struct rte_hash_parameters hash_params = {
+		.name = "tests_resize",
+		.entries = RESIZE_ENTRY,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_hash_crc,
+		.hash_func_init_val = 0,
+		.socket_id = rte_socket_id(),
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF,
+	};
+
+	printf("\nTest: Hash resize, read - hit\n");
+
+	h = rte_hash_create(&hash_params);
+	if (h == NULL) {
+		printf("hash creation failed");
+		return -1;
+	}
+
+	for (i = 0; i < RESIZE_KEYS; i++) {
+		resize_keys[i] = rte_rand();
+		if (rte_hash_add_key(h, &resize_keys[i]) < 0) {
+			printf("writer failed %u\n", i);
+			goto err;
+		}
+	}
+
+	n_readers = RTE_MIN(rte_lcore_count() - 1, 4U);
+	writer_done = 0;
+	for (i = 1; i <= n_readers; i++)
+		rte_eal_remote_launch(test_rwc_resize_reader, h,
+				      enabled_core_ids[i]);
+
+	for (round = 0; round < RESIZE_ROUNDS; round++) {
+		if (rte_hash_resize(h) != 0) {
+			printf("resize failed\n");
+			ret = -1;
+			break;
+		}
+		/* Migrate one bucket at a time to widen the race window */
+		while (rte_hash_resize_step(h, 1) > 0)
+			;
+	}
+	writer_done = 1;
+
+	for (i = 1; i <= n_readers; i++)
+		if (rte_eal_wait_lcore(enabled_core_ids[i]) < 0)
+			ret = -1;
+
+	rte_hash_free(h);
+	return ret;
+
+err:
+	rte_hash_free(h);
+	return -1;
+}
+
 static int
 test_hash_readwrite_lf_perf_main(void)
 {
@@ -1278,6 +1392,8 @@ test_hash_readwrite_lf_perf_main(void)
 		ext_bkt = 1;
 		printf("Test lookup with read-write concurrency lock free support"
 		       " enabled\n");
+		if (test_hash_resize_lookup_hit() < 0)
+			return -1;
 		if (test_hash_add_no_ks_lookup_hit(&rwc_lf_results, rwc_lf,
 							htm, ext_bkt) < 0)
 			return -1;
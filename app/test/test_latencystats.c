@@ -2,11 +2,17 @@
  * Copyright(c) 2018 Intel Corporation
  */
 
+#include <errno.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
 
+#include <rte_cycles.h>
+#include <rte_ethdev.h>
 #include <rte_latencystats.h>
+#include <rte_mbuf.h>
+#include <rte_mbuf_dyn.h>
 #include "rte_lcore.h"
 #include "rte_metrics.h"
 
@@ -16,6 +22,7 @@
 #define NUM_STATS 4
 #define LATENCY_NUM_PACKETS 10
 #define QUEUE_ID 0
+#define LATENCY_HIST_BURST 32
 
 static uint16_t portid;
 static struct rte_ring *ring;
@@ -32,12 +39,30 @@ static int test_latency_init(void)
 {
 	int ret = 0;
 
+	struct rte_latencystats_hist_conf conf = {
+		.precision = 0,
+		.max_latency_ns = RTE_LATENCYSTATS_HIST_MAX_NS_DEFAULT,
+	};
+
 	/* Metrics Initialization */
 	rte_metrics_init(rte_socket_id());
 
+	/* Failure Test: invalid histogram precision */
+	ret = rte_latencystats_hist_enable(&conf);
+	TEST_ASSERT(ret == -EINVAL, "Test Failed: invalid histogram "
+		    "precision accepted");
+
+	ret = rte_latencystats_hist_enable(NULL);
+	TEST_ASSERT(ret == 0, "Test Failed: rte_latencystats_hist_enable failed");
+
 	ret = rte_latencystats_init(1, NULL);
 	TEST_ASSERT(ret >= 0, "Test Failed: rte_latencystats_init failed");
 
+	/* Failure Test: histograms enabled after init */
+	ret = rte_latencystats_hist_enable(NULL);
+	TEST_ASSERT(ret == -EBUSY, "Test Failed: histograms enabled after "
+		    "init");
+
 	return TEST_SUCCESS;
 }
 
@@ -52,6 +77,92 @@ static int test_latency_update(void)
 	return TEST_SUCCESS;
 }
 
+/*
+ * Send packets with a known latency on the Tx queue: the timestamps set
+ * by the Rx callback are moved back by the latency of each packet.
+ */
+static int test_latency_hist_send(uint64_t latency_ns, unsigned int nb_pkts)
+{
+	struct rte_mbuf *pbuf[LATENCY_HIST_BURST];
+	struct rte_mempool *mp;
+	uint64_t latency, flag;
+	unsigned int i, n;
+	int offset, bit;
+
+	offset = rte_mbuf_dynfield_lookup(
+		"rte_latencystats_dynfield_timestamp", NULL);
+	bit = rte_mbuf_dynflag_lookup("rte_latencystats_dynflag_timestamp",
+		NULL);
+	TEST_ASSERT(offset >= 0 && bit >= 0,
+		    "Test Failed to find the timestamp field");
+	flag = 1ULL << bit;
+	latency = latency_ns * rte_get_tsc_hz() / NS_PER_S;
+
+	mp = rte_pktmbuf_pool_create("lat_hist_pool", NB_MBUF, 0, 0,
+		RTE_MBUF_DEFAULT_BUF_SIZE, rte_socket_id());
+	TEST_ASSERT_NOT_NULL(mp, "Test Failed to create mbuf pool");
+
+	while (nb_pkts > 0) {
+		n = RTE_MIN(nb_pkts, (unsigned int)LATENCY_HIST_BURST);
+		if (rte_pktmbuf_alloc_bulk(mp, pbuf, n) != 0)
+			break;
+		for (i = 0; i < n; i++) {
+			*RTE_MBUF_DYNFIELD(pbuf[i], offset, uint64_t *) =
+				rte_rdtsc() - latency;
+			pbuf[i]->ol_flags |= flag;
+		}
+		i = rte_eth_tx_burst(portid, QUEUE_ID, pbuf, n);
+		rte_pktmbuf_free_bulk(&pbuf[i], n - i);
+		/* drain the ring */
+		i = rte_eth_rx_burst(portid, QUEUE_ID, pbuf, n);
+		rte_pktmbuf_free_bulk(pbuf, i);
+		nb_pkts -= n;
+	}
+	rte_mempool_free(mp);
+	TEST_ASSERT(nb_pkts == 0, "Test Failed to allocate mbufs");
+
+	return TEST_SUCCESS;
+}
+
+/* Test case to get latency percentiles from the histograms */
+static int test_latencystats_hist_percentile(void)
+{
+	uint64_t p50 = 0, p99 = 0;
+	int ret;
+
+	/* 90% of the packets at 10us and 10% at 1ms: a bucket is no wider
+	 * than 1/2^precision of its latencies, plus the time to send
+	 */
+	ret = test_latency_hist_send(10 * 1000, 90);
+	TEST_ASSERT(ret == TEST_SUCCESS, "Test Failed to send packets");
+	ret = test_latency_hist_send(1000 * 1000, 10);
+	TEST_ASSERT(ret == TEST_SUCCESS, "Test Failed to send packets");
+
+	ret = rte_latencystats_hist_percentile(portid, QUEUE_ID, 50, &p50);
+	TEST_ASSERT(ret == 0, "Test Failed to get queue percentile");
+	TEST_ASSERT(p50 >= 10 * 1000 && p50 < 20 * 1000,
+		    "Test Failed: p50 %"PRIu64" is not 10us", p50);
+
+	ret = rte_latencystats_hist_percentile(RTE_LATENCYSTATS_ALL,
+			RTE_LATENCYSTATS_ALL, 99, &p99);
+	TEST_ASSERT(ret == 0, "Test Failed to get global percentile");
+	TEST_ASSERT(p99 >= 1000 * 1000 && p99 < 2000 * 1000,
+		    "Test Failed: p99 %"PRIu64" is not 1ms", p99);
+
+	/* Failure Test: invalid percentile */
+	ret = rte_latencystats_hist_percentile(portid, QUEUE_ID, 0, &p50);
+	TEST_ASSERT(ret == -EINVAL, "Test Failed: percentile 0 accepted");
+	ret = rte_latencystats_hist_percentile(portid, QUEUE_ID, 101, &p50);
+	TEST_ASSERT(ret == -EINVAL, "Test Failed: percentile 101 accepted");
+
+	/* Failure Test: queue of all the ports */
+	ret = rte_latencystats_hist_percentile(RTE_LATENCYSTATS_ALL,
+			QUEUE_ID, 50, &p50);
+	TEST_ASSERT(ret == -EINVAL, "Test Failed: invalid queue accepted");
+
+	return TEST_SUCCESS;
+}
+
 /* Test case to uninit latency stats */
 static int test_latency_uninit(void)
 {
@@ -194,7 +305,12 @@ unit_test_suite latencystats_testsuite = {
 		 */
 		TEST_CASE_ST(NULL, NULL, test_latencystats_get),
 
-		/* Test Case 5: To check uninit of latency test */
+		/* Test Case 5: To check whether latency percentiles
+		 * are computed from the histograms
+		 */
+		TEST_CASE_ST(NULL, NULL, test_latencystats_hist_percentile),
+
+		/* Test Case 6: To check uninit of latency test */
 		TEST_CASE_ST(NULL, NULL, test_latency_uninit),
 
 		TEST_CASES_END()
@@ -9,6 +9,7 @@
 #include <rte_ip.h>
 #include <rte_lpm.h>
 #include <rte_malloc.h>
+#include <rte_random.h>
 
 #include "test.h"
 #include "test_xmmt_ops.h"
@@ -44,6 +45,8 @@ static int32_t test18(void);
 static int32_t test19(void);
 static int32_t test20(void);
 static int32_t test21(void);
+static int32_t test22(void);
+static int32_t test23(void);
 
 rte_lpm_test tests[] = {
 /* Test Cases */
@@ -68,7 +71,9 @@ rte_lpm_test tests[] = {
 	test18,
 	test19,
 	test20,
-	test21
+	test21,
+	test22,
+	test23
 };
 
 #define MAX_DEPTH 32
@@ -1554,6 +1559,254 @@ test21(void)
 	return (status == 0) ? PASS : -1;
 }
 
+#define BULK_MAX_RULES	4096
+#define BULK_TBL8S	1024
+#define BULK_BATCH	256
+#define BULK_ROUNDS	16
+#define BULK_LOOKUPS	4096
+
+static struct rte_lpm_update added[BULK_BATCH * BULK_ROUNDS];
+static struct rte_lpm_update full[BULK_MAX_RULES];
+
+/* Random IP in 10.0.0.0/8, so that the rules overlap. */
+static uint32_t
+bulk_random_ip(void)
+{
+	return RTE_IPV4(10, 0, 0, 0) | (rte_rand() & 0xFFFFFF);
+}
+
+/* Check that two tables give the same result for an IP. */
+static int
+bulk_lookup_cmp(struct rte_lpm *lpm1, struct rte_lpm *lpm2, uint32_t ip)
+{
+	uint32_t next_hop1 = 0, next_hop2 = 0;
+	int status1, status2;
+
+	status1 = rte_lpm_lookup(lpm1, ip, &next_hop1);
+	status2 = rte_lpm_lookup(lpm2, ip, &next_hop2);
+
+	return status1 != status2 || (status1 == 0 && next_hop1 != next_hop2);
+}
+
+/*
+ * Bulk update test.
+ *  - Apply random batches of adds and deletes to one LPM table with
+ *    rte_lpm_update_bulk(), using RCU with a defer queue, and to another
+ *    table one by one with rte_lpm_add() and rte_lpm_delete().
+ *  - Check that both tables give the same lookup results and rules.
+ *  - Check that a batch which doesn't fit is rejected without changes.
+ */
+int32_t
+test22(void)
+{
+	struct rte_lpm *lpm = NULL, *lpm_bulk = NULL;
+	struct rte_lpm_config config;
+	struct rte_lpm_update updates[BULK_BATCH];
+	struct rte_lpm_rcu_config rcu_cfg = {0};
+	struct rte_rcu_qsbr *qsv;
+	uint32_t i, j, ip, nb_added = 0, next_hop1, next_hop2;
+	int32_t status1, status2;
+	size_t sz;
+
+	config.max_rules = BULK_MAX_RULES;
+	config.number_tbl8s = BULK_TBL8S;
+	config.flags = 0;
+
+	lpm = rte_lpm_create("test22_seq", SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+	lpm_bulk = rte_lpm_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm_bulk != NULL);
+
+	/* Create RCU QSBR variable */
+	sz = rte_rcu_qsbr_get_memsize(1);
+	qsv = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+				RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	TEST_LPM_ASSERT(qsv != NULL);
+	TEST_LPM_ASSERT(rte_rcu_qsbr_init(qsv, 1) == 0);
+
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_LPM_QSBR_MODE_DQ;
+	TEST_LPM_ASSERT(rte_lpm_rcu_qsbr_add(lpm_bulk, &rcu_cfg) == 0);
+
+	/* Invalid parameters */
+	updates[0].ip = RTE_IPV4(10, 0, 0, 0);
+	updates[0].next_hop = 1;
+	updates[0].depth = 24;
+	updates[0].op = RTE_LPM_UPDATE_ADD;
+	TEST_LPM_ASSERT(rte_lpm_update_bulk(NULL, updates, 1) < 0);
+	TEST_LPM_ASSERT(rte_lpm_update_bulk(lpm_bulk, NULL, 1) < 0);
+	TEST_LPM_ASSERT(rte_lpm_update_bulk(lpm_bulk, updates, 0) == 0);
+	updates[0].depth = MAX_DEPTH + 1;
+	TEST_LPM_ASSERT(rte_lpm_update_bulk(lpm_bulk, updates, 1) < 0);
+	updates[0].depth = 24;
+	updates[0].op = RTE_LPM_UPDATE_DELETE + 1;
+	TEST_LPM_ASSERT(rte_lpm_update_bulk(lpm_bulk, updates, 1) < 0);
+
+	for (i = 0; i < BULK_ROUNDS; i++) {
+		for (j = 0; j < BULK_BATCH; j++) {
+			/* Delete rules added before, or a missing rule */
+			if (nb_added > 0 && rte_rand() % 3 == 0) {
+				updates[j] = added[rte_rand() % nb_added];
+				updates[j].op = RTE_LPM_UPDATE_DELETE;
+				if (rte_rand() % 8 == 0)
+					updates[j].depth = 32;
+				continue;
+			}
+			updates[j].ip = bulk_random_ip();
+			updates[j].next_hop = rte_rand() & 0xFFFFFF;
+			updates[j].depth = 16 + rte_rand() % (MAX_DEPTH - 15);
+			updates[j].op = RTE_LPM_UPDATE_ADD;
+			added[nb_added++] = updates[j];
+		}
+
+		for (j = 0; j < BULK_BATCH; j++) {
+			if (updates[j].op == RTE_LPM_UPDATE_ADD) {
+				status1 = rte_lpm_add(lpm, updates[j].ip,
+					updates[j].depth, updates[j].next_hop);
+				TEST_LPM_ASSERT(status1 == 0);
+			} else {
+				rte_lpm_delete(lpm, updates[j].ip,
+					updates[j].depth);
+			}
+		}
+		TEST_LPM_ASSERT(rte_lpm_update_bulk(lpm_bulk, updates,
+				BULK_BATCH) == 0);
+
+		for (j = 0; j < BULK_BATCH; j++) {
+			ip = updates[j].ip;
+			TEST_LPM_ASSERT(!bulk_lookup_cmp(lpm, lpm_bulk, ip));
+			status1 = rte_lpm_is_rule_present(lpm, ip,
+				updates[j].depth, &next_hop1);
+			status2 = rte_lpm_is_rule_present(lpm_bulk, ip,
+				updates[j].depth, &next_hop2);
+			TEST_LPM_ASSERT(status1 == status2);
+			TEST_LPM_ASSERT(status1 == 0 || next_hop1 == next_hop2);
+		}
+		for (j = 0; j < BULK_LOOKUPS; j++) {
+			ip = bulk_random_ip();
+			TEST_LPM_ASSERT(!bulk_lookup_cmp(lpm, lpm_bulk, ip));
+		}
+	}
+
+	/* A batch exceeding the rules table must not change anything */
+	for (j = 0; j < BULK_MAX_RULES; j++) {
+		full[j].ip = RTE_IPV4(192, 0, 0, 0) | j;
+		full[j].next_hop = j;
+		full[j].depth = 32;
+		full[j].op = RTE_LPM_UPDATE_ADD;
+	}
+	TEST_LPM_ASSERT(rte_lpm_update_bulk(lpm_bulk, full,
+			BULK_MAX_RULES) == -ENOSPC);
+	for (j = 0; j < BULK_LOOKUPS; j++) {
+		ip = bulk_random_ip();
+		TEST_LPM_ASSERT(bulk_lookup_cmp(lpm, lpm_bulk, ip) == 0);
+	}
+	TEST_LPM_ASSERT(rte_lpm_lookup(lpm_bulk, full[0].ip,
+			&next_hop1) != 0);
+
+	/* Delete all the rules in one batch */
+	for (j = 0; j < nb_added; j++)
+		added[j].op = RTE_LPM_UPDATE_DELETE;
+	TEST_LPM_ASSERT(rte_lpm_update_bulk(lpm_bulk, added, nb_added) == 0);
+	TEST_LPM_ASSERT(rte_lpm_update_bulk(lpm_bulk, full, 1) == 0);
+	for (j = 0; j < BULK_LOOKUPS; j++) {
+		TEST_LPM_ASSERT(rte_lpm_lookup(lpm_bulk, bulk_random_ip(),
+				&next_hop1) != 0);
+	}
+	TEST_LPM_ASSERT(rte_lpm_lookup(lpm_bulk, full[0].ip,
+			&next_hop1) == 0);
+	TEST_LPM_ASSERT(next_hop1 == full[0].next_hop);
+
+	rte_lpm_free(lpm);
+	rte_lpm_free(lpm_bulk);
+	rte_free(qsv);
+
+	return PASS;
+}
+
+#define BULK_EXHAUST_TBL8S	8
+
+/*
+ * Bulk update tbl8 exhaustion test.
+ *  - Use all the tbl8 groups, then check that a batch needing one more
+ *    group fails with -ENOSPC.
+ *  - Free all the groups in a batch while a reader has not reported a
+ *    quiescent state, and check that a batch needing a group still fails
+ *    instead of waiting for the defer queue.
+ *  - Check that the batch succeeds once the reader is quiescent.
+ */
+int32_t
+test23(void)
+{
+	struct rte_lpm *lpm = NULL;
+	struct rte_lpm_config config;
+	struct rte_lpm_update updates[BULK_EXHAUST_TBL8S];
+	struct rte_lpm_update extra;
+	struct rte_lpm_rcu_config rcu_cfg = {0};
+	struct rte_rcu_qsbr *qsv;
+	uint32_t j, next_hop;
+	size_t sz;
+
+	config.max_rules = 256;
+	config.number_tbl8s = BULK_EXHAUST_TBL8S;
+	config.flags = 0;
+
+	lpm = rte_lpm_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	/* Create RCU QSBR variable with one reader online */
+	sz = rte_rcu_qsbr_get_memsize(1);
+	qsv = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+				RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	TEST_LPM_ASSERT(qsv != NULL);
+	TEST_LPM_ASSERT(rte_rcu_qsbr_init(qsv, 1) == 0);
+	TEST_LPM_ASSERT(rte_rcu_qsbr_thread_register(qsv, 0) == 0);
+	rte_rcu_qsbr_thread_online(qsv, 0);
+
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_LPM_QSBR_MODE_DQ;
+	TEST_LPM_ASSERT(rte_lpm_rcu_qsbr_add(lpm, &rcu_cfg) == 0);
+
+	/* One tbl8 group for each /24 */
+	for (j = 0; j < BULK_EXHAUST_TBL8S; j++) {
+		updates[j].ip = RTE_IPV4(10, 0, j, 1);
+		updates[j].next_hop = j;
+		updates[j].depth = 32;
+		updates[j].op = RTE_LPM_UPDATE_ADD;
+	}
+	TEST_LPM_ASSERT(rte_lpm_update_bulk(lpm, updates,
+			BULK_EXHAUST_TBL8S) == 0);
+
+	/* No group left, nothing in the defer queue */
+	extra.ip = RTE_IPV4(10, 1, 0, 1);
+	extra.next_hop = 100;
+	extra.depth = 32;
+	extra.op = RTE_LPM_UPDATE_ADD;
+	TEST_LPM_ASSERT(rte_lpm_update_bulk(lpm, &extra, 1) == -ENOSPC);
+	TEST_LPM_ASSERT(rte_lpm_lookup(lpm, extra.ip, &next_hop) != 0);
+
+	/* The freed groups wait in the defer queue for the reader */
+	for (j = 0; j < BULK_EXHAUST_TBL8S; j++)
+		updates[j].op = RTE_LPM_UPDATE_DELETE;
+	TEST_LPM_ASSERT(rte_lpm_update_bulk(lpm, updates,
+			BULK_EXHAUST_TBL8S) == 0);
+	TEST_LPM_ASSERT(rte_lpm_update_bulk(lpm, &extra, 1) == -ENOSPC);
+	TEST_LPM_ASSERT(rte_lpm_lookup(lpm, extra.ip, &next_hop) != 0);
+
+	/* The groups can be reclaimed once the reader is quiescent */
+	rte_rcu_qsbr_quiescent(qsv, 0);
+	TEST_LPM_ASSERT(rte_lpm_update_bulk(lpm, &extra, 1) == 0);
+	TEST_LPM_ASSERT(rte_lpm_lookup(lpm, extra.ip, &next_hop) == 0);
+	TEST_LPM_ASSERT(next_hop == extra.next_hop);
+
+	rte_rcu_qsbr_thread_offline(qsv, 0);
+	rte_rcu_qsbr_thread_unregister(qsv, 0);
+	rte_lpm_free(lpm);
+	rte_free(qsv);
+
+	return PASS;
+}
+
 /*
  * Do all unit tests.
  */
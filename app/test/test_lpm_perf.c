@@ -52,6 +52,7 @@ struct route_rule {
 };
 
 static struct route_rule large_route_table[MAX_RULE_NUM];
+static struct rte_lpm_update bulk_updates[MAX_RULE_NUM];
 /* Route table for routes with depth > 24 */
 struct route_rule large_ldepth_route_table[MAX_RULE_NUM];
 
@@ -813,6 +814,7 @@ test_lpm_perf(void)
 	int status = 0;
 	uint64_t cache_line_counter = 0;
 	int64_t count = 0;
+	uint32_t nb_bulk_updates;
 
 	rte_srand(rte_rdtsc());
 
@@ -830,12 +832,17 @@ test_lpm_perf(void)
 
 	for (i = 0; i < NUM_ROUTE_ENTRIES; i++) {
 		if (rte_lpm_add(lpm, large_route_table[i].ip,
-				large_route_table[i].depth, next_hop_add) == 0)
+				large_route_table[i].depth, next_hop_add) == 0) {
+			bulk_updates[status].ip = large_route_table[i].ip;
+			bulk_updates[status].depth =
+				large_route_table[i].depth;
 			status++;
+		}
 	}
 	/* End Timer. */
 	total_time = rte_rdtsc() - begin;
 
+	nb_bulk_updates = status;
 	printf("Unique added entries = %d\n", status);
 	/* Obtain add statistics. */
 	for (i = 0; i < RTE_LPM_TBL24_NUM_ENTRIES; i++) {
@@ -957,6 +964,34 @@ test_lpm_perf(void)
 	printf("Average LPM Delete: %g cycles\n",
 			(double)total_time / NUM_ROUTE_ENTRIES);
 
+	/*
+	 * Measure bulk add and delete of the routes which could be added,
+	 * since a batch is not applied if the tbl8 groups are exhausted.
+	 */
+	for (i = 0; i < nb_bulk_updates; i++) {
+		bulk_updates[i].next_hop = next_hop_add;
+		bulk_updates[i].op = RTE_LPM_UPDATE_ADD;
+	}
+
+	begin = rte_rdtsc();
+	status = rte_lpm_update_bulk(lpm, bulk_updates, nb_bulk_updates);
+	total_time = rte_rdtsc() - begin;
+	TEST_LPM_ASSERT(status == 0);
+
+	printf("Average LPM Bulk Add: %g cycles\n",
+			(double)total_time / nb_bulk_updates);
+
+	for (i = 0; i < nb_bulk_updates; i++)
+		bulk_updates[i].op = RTE_LPM_UPDATE_DELETE;
+
+	begin = rte_rdtsc();
+	status = rte_lpm_update_bulk(lpm, bulk_updates, nb_bulk_updates);
+	total_time = rte_rdtsc() - begin;
+	TEST_LPM_ASSERT(status == 0);
+
+	printf("Average LPM Bulk Delete: %g cycles\n",
+			(double)total_time / nb_bulk_updates);
+
 	rte_lpm_delete_all(lpm);
 	rte_lpm_free(lpm);
 
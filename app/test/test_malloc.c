@@ -613,6 +613,90 @@ test_realloc_numa(void)
 	return ret;
 }
 
+static int
+test_lcore_cache(void)
+{
+	int socket = rte_lcore_to_socket_id(rte_lcore_id());
+	struct rte_malloc_socket_stats pre_stats, post_stats;
+	void *ptrs[100];
+	char *p1, *p2, *p3;
+	unsigned int i;
+
+	rte_malloc_get_socket_stats(socket, &pre_stats);
+
+	if (rte_malloc_lcore_cache_enable() < 0) {
+		printf("Cannot enable lcore cache\n");
+		return -1;
+	}
+
+	/* a freed object is reused by the next allocation of its class */
+	p1 = rte_malloc(NULL, 100, 0);
+	if (p1 == NULL)
+		goto err;
+	memset(p1, 0xa5, 100);
+	rte_free(p1);
+	p2 = rte_malloc(NULL, 120, RTE_CACHE_LINE_SIZE);
+	if (p2 != p1) {
+		printf("Cached object was not reused\n");
+		goto err;
+	}
+	memset(p2, 0xa5, 120);
+	rte_free(p2);
+
+	/* cached objects are zeroed like heap free memory */
+	p2 = rte_zmalloc(NULL, 128, 0);
+	if (p2 == NULL)
+		goto err;
+	for (i = 0; i < 128; i++)
+		if (p2[i] != 0) {
+			printf("Cached object was not zeroed\n");
+			goto err;
+		}
+
+	/* a double free must not put the object twice in the cache */
+	rte_free(p2);
+	rte_free(p2);
+	p1 = rte_malloc(NULL, 100, 0);
+	p3 = rte_malloc(NULL, 100, 0);
+	if (p1 == NULL || p3 == NULL || p1 == p3) {
+		printf("Double free was cached\n");
+		goto err;
+	}
+	rte_free(p1);
+	rte_free(p3);
+
+	/* overflow the cache, so that objects are given back to the heap */
+	for (i = 0; i < RTE_DIM(ptrs); i++) {
+		ptrs[i] = rte_malloc(NULL, 64 << (i % 6), 0);
+		if (ptrs[i] == NULL)
+			goto err;
+	}
+	for (i = 0; i < RTE_DIM(ptrs); i++) {
+		if (rte_malloc_validate(ptrs[i], NULL) < 0) {
+			printf("Cached object is corrupted\n");
+			goto err;
+		}
+		rte_free(ptrs[i]);
+	}
+	rte_malloc_dump_stats(stdout, NULL);
+
+	rte_malloc_lcore_cache_disable();
+
+	/* everything was given back to the heap */
+	rte_malloc_get_socket_stats(socket, &post_stats);
+	if (post_stats.alloc_count != pre_stats.alloc_count ||
+			post_stats.heap_allocsz_bytes !=
+			pre_stats.heap_allocsz_bytes) {
+		printf("Lcore cache was not flushed\n");
+		return -1;
+	}
+	return 0;
+
+err:
+	rte_malloc_lcore_cache_disable();
+	return -1;
+}
+
 static int
 test_realloc(void)
 {
@@ -1006,6 +1090,12 @@ test_malloc(void)
 	}
 	else printf("test_realloc() passed\n");
 
+	if (test_lcore_cache() < 0){
+		printf("test_lcore_cache() failed\n");
+		return -1;
+	}
+	else printf("test_lcore_cache() passed\n");
+
 	/*----------------------------*/
 	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
 		rte_eal_remote_launch(test_align_overlap_per_lcore, NULL, lcore_id);
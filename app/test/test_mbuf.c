@@ -33,6 +33,7 @@
 #include <rte_ip.h>
 #include <rte_tcp.h>
 #include <rte_mbuf_dyn.h>
+#include <rte_mbuf_stripe.h>
 
 #include "test.h"
 
@@ -1398,6 +1399,73 @@ set_tx_offload(struct rte_mbuf *mb, uint64_t il2, uint64_t il3, uint64_t il4,
 	mb->outer_l2_len = ol2;
 }
 
+/*
+ * Test a striped pool: the mbufs come from the local stripe first, then
+ * from the other ones, and go back to their home stripe.
+ */
+static int
+test_pktmbuf_stripe_pool(void)
+{
+	struct rte_pktmbuf_stripe_pool *sp;
+	struct rte_mbuf *mbufs[NB_MBUF];
+	struct rte_mempool *local;
+	unsigned int i;
+
+	memset(mbufs, 0, sizeof(mbufs));
+
+	/* no cache, to be able to take all the mbufs of each stripe */
+	sp = rte_pktmbuf_stripe_pool_create("test_stripe", NB_MBUF, 0, 0,
+			MBUF_DATA_SIZE);
+	if (sp == NULL)
+		GOTO_FAIL("cannot create striped pool, rte_errno %d", rte_errno);
+	if (rte_pktmbuf_stripe_pool_lookup("test_stripe") != sp)
+		GOTO_FAIL("cannot lookup striped pool");
+	if (sp->nb_stripes == 0 || sp->size != NB_MBUF ||
+			rte_pktmbuf_stripe_pool_avail_count(sp) != NB_MBUF)
+		GOTO_FAIL("bad striped pool size");
+	rte_pktmbuf_stripe_pool_dump(stdout, sp);
+
+	local = rte_pktmbuf_stripe_pool_get(sp, rte_socket_id());
+	if (local == NULL || rte_pktmbuf_stripe_pool_get(sp, SOCKET_ID_ANY) !=
+			sp->stripes[0])
+		GOTO_FAIL("bad stripe of socket");
+
+	if (rte_pktmbuf_stripe_alloc_bulk(sp, mbufs, 4) != 0)
+		GOTO_FAIL("cannot allocate bulk from striped pool");
+	for (i = 0; i < 4; i++) {
+		if (mbufs[i]->pool != local)
+			GOTO_FAIL("mbuf not allocated from the local stripe");
+	}
+
+	/* all the mbufs can be allocated, whatever their stripe */
+	for (i = 4; i < NB_MBUF; i++) {
+		mbufs[i] = rte_pktmbuf_stripe_alloc(sp);
+		if (mbufs[i] == NULL)
+			GOTO_FAIL("cannot allocate mbuf %u from striped pool", i);
+	}
+	if (rte_pktmbuf_stripe_alloc(sp) != NULL)
+		GOTO_FAIL("striped pool should be empty");
+	if (rte_pktmbuf_stripe_alloc_bulk(sp, mbufs, 1) != -ENOENT)
+		GOTO_FAIL("bulk allocation should fail");
+
+	/* and go back to their stripe */
+	rte_pktmbuf_free_bulk(mbufs, NB_MBUF);
+	memset(mbufs, 0, sizeof(mbufs));
+	for (i = 0; i < sp->nb_stripes; i++) {
+		if (!rte_mempool_full(sp->stripes[i]))
+			GOTO_FAIL("stripe %u is not full", i);
+	}
+
+	rte_pktmbuf_stripe_pool_free(sp);
+	return 0;
+
+fail:
+	for (i = 0; i < NB_MBUF; i++)
+		rte_pktmbuf_free(mbufs[i]);
+	rte_pktmbuf_stripe_pool_free(sp);
+	return -1;
+}
+
 static int
 test_tx_offload(void)
 {
@@ -2730,6 +2798,12 @@ test_mbuf(void)
 		goto err;
 	}
 
+	/* test striped mbuf pools */
+	if (test_pktmbuf_stripe_pool() < 0) {
+		printf("test_pktmbuf_stripe_pool() failed\n");
+		goto err;
+	}
+
 	/* test that the pointer to the data on a packet mbuf is set properly */
 	if (test_pktmbuf_pool_ptr(pktmbuf_pool) < 0) {
 		printf("test_pktmbuf_pool_ptr() failed\n");
@@ -44,8 +44,10 @@ static size_t buf_sizes[TEST_VALUE_RANGE];
  * changed.
  */
 static int
-test_single_memcpy(unsigned int off_src, unsigned int off_dst, size_t size)
+test_single_memcpy(unsigned int off_src, unsigned int off_dst, size_t size,
+		int nt)
 {
+	const char *name = nt ? "rte_memcpy_nt()" : "rte_memcpy()";
 	unsigned int i;
 	uint8_t dest[SMALL_BUFFER_SIZE + ALIGNMENT_UNIT];
 	uint8_t src[SMALL_BUFFER_SIZE + ALIGNMENT_UNIT];
@@ -58,18 +60,21 @@ test_single_memcpy(unsigned int off_src, unsigned int off_dst, size_t size)
 	}
 
 	/* Do the copy */
-	ret = rte_memcpy(dest + off_dst, src + off_src, size);
+	if (nt)
+		ret = rte_memcpy_nt(dest + off_dst, src + off_src, size);
+	else
+		ret = rte_memcpy(dest + off_dst, src + off_src, size);
 	if (ret != (dest + off_dst)) {
-		printf("rte_memcpy() returned %p, not %p\n",
+		printf("%s returned %p, not %p\n", name,
 		       ret, dest + off_dst);
 	}
 
 	/* Check nothing before offset is affected */
 	for (i = 0; i < off_dst; i++) {
 		if (dest[i] != 0) {
-			printf("rte_memcpy() failed for %u bytes (offsets=%u,%u): "
+			printf("%s failed for %u bytes (offsets=%u,%u): "
 			       "[modified before start of dst].\n",
-			       (unsigned)size, off_src, off_dst);
+			       name, (unsigned)size, off_src, off_dst);
 			return -1;
 		}
 	}
@@ -77,9 +82,9 @@ test_single_memcpy(unsigned int off_src, unsigned int off_dst, size_t size)
 	/* Check everything was copied */
 	for (i = 0; i < size; i++) {
 		if (dest[i + off_dst] != src[i + off_src]) {
-			printf("rte_memcpy() failed for %u bytes (offsets=%u,%u): "
+			printf("%s failed for %u bytes (offsets=%u,%u): "
 			       "[didn't copy byte %u].\n",
-			       (unsigned)size, off_src, off_dst, i);
+			       name, (unsigned)size, off_src, off_dst, i);
 			return -1;
 		}
 	}
@@ -87,9 +92,9 @@ test_single_memcpy(unsigned int off_src, unsigned int off_dst, size_t size)
 	/* Check nothing after copy was affected */
 	for (i = size; i < SMALL_BUFFER_SIZE; i++) {
 		if (dest[i + off_dst] != 0) {
-			printf("rte_memcpy() failed for %u bytes (offsets=%u,%u): "
+			printf("%s failed for %u bytes (offsets=%u,%u): "
 			       "[copied too many].\n",
-			       (unsigned)size, off_src, off_dst);
+			       name, (unsigned)size, off_src, off_dst);
 			return -1;
 		}
 	}
@@ -100,7 +105,7 @@ test_single_memcpy(unsigned int off_src, unsigned int off_dst, size_t size)
  * Check functionality for various buffer sizes and data offsets/alignments.
  */
 static int
-func_test(void)
+func_test(int nt)
 {
 	unsigned int off_src, off_dst, i;
 	int ret;
@@ -109,7 +114,7 @@ func_test(void)
 		for (off_dst = 0; off_dst < ALIGNMENT_UNIT; off_dst++) {
 			for (i = 0; i < RTE_DIM(buf_sizes); i++) {
 				ret = test_single_memcpy(off_src, off_dst,
-				                         buf_sizes[i]);
+				                         buf_sizes[i], nt);
 				if (ret != 0)
 					return -1;
 			}
@@ -123,7 +128,11 @@ test_memcpy(void)
 {
 	int ret;
 
-	ret = func_test();
+	ret = func_test(0);
+	if (ret != 0)
+		return -1;
+
+	ret = func_test(1);
 	if (ret != 0)
 		return -1;
 	return 0;
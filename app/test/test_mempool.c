@@ -208,6 +208,95 @@ static int test_mempool_creation_with_exceeded_cache_size(void)
 	return 0;
 }
 
+/*
+ * Adaptive caches, the default caches of two lcores are used from the
+ * current one: lcore 1 only gets objects and lcore 0 only puts them.
+ */
+static int
+test_mempool_cache_adaptive(void)
+{
+	const unsigned int cache_size = 32;
+	struct rte_mempool_cache *prod, *cons;
+	struct rte_mempool *mp;
+	void *objs[2 * 32], *more[2 * 32];
+	void *kept[16 + 24 + 16];
+	unsigned int i, count;
+	int ret = -1;
+
+	mp = rte_mempool_create("test_cache_adaptive", 1024, 64,
+		cache_size, 0, NULL, NULL, NULL, NULL,
+		SOCKET_ID_ANY, MEMPOOL_F_CACHE_ADAPTIVE);
+	if (mp == NULL)
+		RET_ERR();
+	prod = rte_mempool_default_cache(mp, 0);
+	cons = rte_mempool_default_cache(mp, 1);
+
+	/* the consumer refills its cache from the pool */
+	if (rte_mempool_generic_get(mp, kept, 16, cons) < 0)
+		GOTO_ERR(ret, out);
+	if (cons->len != cache_size)
+		GOTO_ERR(ret, out);
+
+	/* the excess of the producer is handed over to the consumer */
+	if (rte_mempool_generic_get(mp, objs, 48, NULL) < 0)
+		GOTO_ERR(ret, out);
+	count = rte_mempool_ops_get_count(mp);
+	rte_mempool_generic_put(mp, objs, 48, prod);
+	if (prod->len != cache_size ||
+			rte_mempool_ops_get_count(mp) != count)
+		GOTO_ERR(ret, out);
+	if (rte_mempool_avail_count(mp) != mp->size - 16)
+		GOTO_ERR(ret, out);
+
+	/* and taken on the next refill, without accessing the pool */
+	if (rte_mempool_generic_get(mp, &kept[16], 24, cons) < 0 ||
+			rte_mempool_generic_get(mp, &kept[40], 16, cons) < 0)
+		GOTO_ERR(ret, out);
+	if (rte_mempool_ops_get_count(mp) != count || cons->len != 8)
+		GOTO_ERR(ret, out);
+	if (rte_mempool_avail_count(mp) != mp->size - RTE_DIM(kept))
+		GOTO_ERR(ret, out);
+
+	/* the cache of a producer grows, up to 4 times its initial size */
+	for (i = 0; i < 32; i++) {
+		if (rte_mempool_generic_get(mp, objs, 2 * cache_size,
+				NULL) < 0)
+			GOTO_ERR(ret, out);
+		rte_mempool_generic_put(mp, objs, 2 * cache_size, prod);
+	}
+	if (prod->size != 4 * cache_size || prod->len > prod->flushthresh)
+		GOTO_ERR(ret, out);
+	rte_mempool_dump(stdout, mp);
+
+	/* flushing a cache gives the objects of its mailbox back too */
+	count = cons->len + 1;
+	if (rte_mempool_generic_get(mp, objs, count, cons) < 0)
+		GOTO_ERR(ret, out);
+	for (i = 0; i < 4; i++) {
+		if (rte_mempool_generic_get(mp, more, RTE_DIM(more), NULL) < 0)
+			GOTO_ERR(ret, out);
+		rte_mempool_generic_put(mp, more, RTE_DIM(more), prod);
+	}
+	rte_mempool_cache_flush(cons, mp);
+	rte_mempool_cache_flush(prod, mp);
+	if (rte_mempool_ops_get_count(mp) !=
+			mp->size - RTE_DIM(kept) - count ||
+			rte_mempool_avail_count(mp) !=
+			rte_mempool_ops_get_count(mp))
+		GOTO_ERR(ret, out);
+	rte_mempool_generic_put(mp, objs, count, NULL);
+
+	rte_mempool_generic_put(mp, kept, RTE_DIM(kept), NULL);
+	if (rte_mempool_avail_count(mp) != mp->size)
+		GOTO_ERR(ret, out);
+	rte_mempool_audit(mp);
+	ret = 0;
+
+out:
+	rte_mempool_free(mp);
+	return ret;
+}
+
 static struct rte_mempool *mp_spsc;
 static rte_spinlock_t scsp_spinlock;
 static void *scsp_obj_table[MAX_KEEP];
@@ -640,6 +729,9 @@ test_mempool(void)
 	if (test_mempool_creation_with_exceeded_cache_size() < 0)
 		GOTO_ERR(ret, err);
 
+	if (test_mempool_cache_adaptive() < 0)
+		GOTO_ERR(ret, err);
+
 	if (test_mempool_same_name_twice_creation() < 0)
 		GOTO_ERR(ret, err);
 
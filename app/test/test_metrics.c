@@ -7,8 +7,11 @@
 #include <stdint.h>
 #include <errno.h>
 
+#include <rte_errno.h>
+#include <rte_launch.h>
 #include <rte_lcore.h>
 #include <rte_metrics.h>
+#include <rte_metrics_counter.h>
 
 #include "test.h"
 
@@ -16,6 +19,7 @@
 #define	METRIC_LESSER_COUNT	3
 #define	KEY	1
 #define	VALUE	1
+#define	COUNTER_INCS	1000
 
 /* Initializes metric module. This function must be called
  * from a primary process before metrics are used
@@ -271,6 +275,85 @@ test_metrics_get_values(void)
 	return TEST_SUCCESS;
 }
 
+static int
+test_metrics_counter_worker(void *arg)
+{
+	struct rte_metrics_counter *c = arg;
+	unsigned int i;
+
+	for (i = 0; i < COUNTER_INCS; i++)
+		rte_metrics_counter_inc(c);
+	return 0;
+}
+
+static int
+test_metrics_counters(void)
+{
+	struct rte_metrics_histogram_stats stats, prev;
+	struct rte_metrics_counter *c, *h;
+	unsigned int nb_lcores;
+	uint64_t base;
+
+	/* The counters cannot be freed, reuse the ones of a previous run */
+	c = rte_metrics_counter_lookup("test_counter");
+	if (c == NULL)
+		c = rte_metrics_counter_create("test_counter");
+	TEST_ASSERT_NOT_NULL(c, "%s, %d", __func__, __LINE__);
+	base = rte_metrics_counter_read(c);
+
+	/* Failure Test: duplicate and invalid names */
+	TEST_ASSERT_NULL(rte_metrics_counter_create("test_counter"),
+		"%s, %d", __func__, __LINE__);
+	TEST_ASSERT(rte_errno == EEXIST, "%s, %d", __func__, __LINE__);
+	TEST_ASSERT_NULL(rte_metrics_histogram_create(""),
+		"%s, %d", __func__, __LINE__);
+	TEST_ASSERT(rte_errno == EINVAL, "%s, %d", __func__, __LINE__);
+
+	TEST_ASSERT(rte_metrics_counter_lookup("test_counter") == c,
+		"%s, %d", __func__, __LINE__);
+
+	/* Successful Test: each lcore increments its own shard */
+	rte_eal_mp_remote_launch(test_metrics_counter_worker, c, CALL_MASTER);
+	rte_eal_mp_wait_lcore();
+	nb_lcores = rte_lcore_count();
+	TEST_ASSERT(rte_metrics_counter_read(c) ==
+			base + nb_lcores * COUNTER_INCS,
+		"%s, %d", __func__, __LINE__);
+	rte_metrics_counter_add(c, 10);
+	TEST_ASSERT(rte_metrics_counter_read(c) ==
+			base + nb_lcores * COUNTER_INCS + 10,
+		"%s, %d", __func__, __LINE__);
+	TEST_ASSERT(rte_metrics_histogram_read(c, &stats) == -EINVAL,
+		"%s, %d", __func__, __LINE__);
+
+	/* Successful Test: values recorded in power of 2 buckets */
+	h = rte_metrics_counter_lookup("test_histogram");
+	if (h == NULL)
+		h = rte_metrics_histogram_create("test_histogram");
+	TEST_ASSERT_NOT_NULL(h, "%s, %d", __func__, __LINE__);
+	TEST_ASSERT(rte_metrics_histogram_read(h, &prev) == 0,
+		"%s, %d", __func__, __LINE__);
+	rte_metrics_histogram_record(h, 0);
+	rte_metrics_histogram_record(h, 1);
+	rte_metrics_histogram_record(h, 2);
+	rte_metrics_histogram_record(h, 3);
+	rte_metrics_histogram_record(h, 1000);
+	TEST_ASSERT(rte_metrics_histogram_read(h, &stats) == 0,
+		"%s, %d", __func__, __LINE__);
+	TEST_ASSERT(stats.count - prev.count == 5 &&
+			stats.sum - prev.sum == 1006,
+		"%s, %d", __func__, __LINE__);
+	TEST_ASSERT(stats.buckets[0] - prev.buckets[0] == 1 &&
+			stats.buckets[1] - prev.buckets[1] == 1 &&
+			stats.buckets[2] - prev.buckets[2] == 2 &&
+			stats.buckets[10] - prev.buckets[10] == 1,
+		"%s, %d", __func__, __LINE__);
+	TEST_ASSERT(rte_metrics_counter_read(h) == prev.count + 5,
+		"%s, %d", __func__, __LINE__);
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite metrics_testsuite  = {
 	.suite_name = "Metrics Unit Test Suite",
 	.setup = NULL,
@@ -316,6 +399,9 @@ static struct unit_test_suite metrics_testsuite  = {
 		/* TEST CASE 8: Test to unregister metrics*/
 		TEST_CASE(test_metrics_deinitialize),
 
+		/* TEST CASE 9: Test per-lcore counters and histograms */
+		TEST_CASE(test_metrics_counters),
+
 		TEST_CASES_END()
 	}
 };
@@ -2,11 +2,15 @@
  * Copyright(c) 2018 Intel Corporation
  */
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <stdint.h>
 #include <limits.h>
 
+#include <rte_bpf.h>
+#include <rte_cycles.h>
 #include <rte_ethdev_driver.h>
+#include <rte_malloc.h>
 #include <rte_pdump.h>
 #include "rte_eal.h"
 #include "rte_lcore.h"
@@ -20,6 +24,15 @@
 
 #define launch_p(ARGV) process_dup(ARGV, RTE_DIM(ARGV), __func__)
 
+/* Length of the first forwarded packet, the next ones are one byte longer */
+#define PDUMP_PKT_LEN 64
+/* RSS hashes mixed below and above half of the range by flow sampling */
+#define PDUMP_RSS_SAMPLED 0
+#define PDUMP_RSS_UNSAMPLED 0x80000000
+#define PDUMP_NB_CAPTURED 32
+/* Index of the packet kept by the BPF filter */
+#define PDUMP_BPF_INDEX 3
+
 struct rte_ring *ring_server;
 uint16_t portid;
 uint16_t flag_for_send_pkts = 1;
@@ -43,6 +56,194 @@ test_pdump_init(void)
 	return ret;
 }
 
+/* Keep the packets whose first byte is PDUMP_BPF_INDEX */
+static const struct ebpf_insn pdump_filter_ins[] = {
+	{
+		.code = (BPF_LDX | BPF_MEM | BPF_B),
+		.dst_reg = EBPF_REG_2,
+		.src_reg = EBPF_REG_1,
+		.off = 0,
+	},
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_K),
+		.dst_reg = EBPF_REG_0,
+		.imm = 0,
+	},
+	{
+		.code = (BPF_JMP | EBPF_JNE | BPF_K),
+		.dst_reg = EBPF_REG_2,
+		.off = 1,
+		.imm = PDUMP_BPF_INDEX,
+	},
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_K),
+		.dst_reg = EBPF_REG_0,
+		.imm = 1,
+	},
+	{
+		.code = (BPF_JMP | EBPF_EXIT),
+	},
+};
+
+/* Index of a captured packet, written in its data by pdump_pkts_init() */
+static unsigned int
+pdump_pkt_index(struct rte_mbuf *m)
+{
+	return *rte_pktmbuf_mtod(m, uint8_t *);
+}
+
+/* Free the packets left in the capture ring */
+static void
+pdump_capture_flush(struct rte_ring *ring)
+{
+	struct rte_mbuf *m;
+
+	/* let the callbacks in progress in the primary complete */
+	rte_delay_ms(10);
+	while (rte_ring_dequeue(ring, (void **)&m) == 0)
+		rte_pktmbuf_free(m);
+}
+
+/*
+ * Capture the packets transmitted by the primary with a sampling
+ * configuration, and return the number of packets dequeued in pkts,
+ * at most PDUMP_NB_CAPTURED, or -1 on error.
+ */
+static int
+pdump_capture(const struct rte_pdump_sample_conf *sample,
+	struct rte_ring *ring, struct rte_mempool *mp, struct rte_mbuf **pkts)
+{
+	uint64_t end;
+	unsigned int nb = 0;
+	int ret;
+
+	pdump_capture_flush(ring);
+	ret = rte_pdump_enable_sample(portid, QUEUE_ID, RTE_PDUMP_FLAG_TX,
+				      sample, ring, mp);
+	if (ret < 0) {
+		printf("rte_pdump_enable_sample failed\n");
+		return -1;
+	}
+
+	end = rte_get_timer_cycles() + rte_get_timer_hz();
+	while (nb < PDUMP_NB_CAPTURED && rte_get_timer_cycles() < end)
+		nb += rte_ring_dequeue_burst(ring, (void **)&pkts[nb],
+				PDUMP_NB_CAPTURED - nb, NULL);
+
+	ret = rte_pdump_disable(portid, QUEUE_ID, RTE_PDUMP_FLAG_TX);
+	pdump_capture_flush(ring);
+	if (ret < 0) {
+		printf("rte_pdump_disable failed\n");
+		rte_pktmbuf_free_bulk(pkts, nb);
+		return -1;
+	}
+	return nb;
+}
+
+/*
+ * Check the captured packets against the packets forwarded by the primary,
+ * see pdump_pkts_init(): the k-th captured packet must be the packet
+ * expected[k % nb_expected] of a burst, truncated to snaplen.
+ */
+static int
+pdump_capture_check(const char *name, struct rte_mbuf **pkts, int nb,
+	const unsigned int *expected, unsigned int nb_expected,
+	uint32_t snaplen)
+{
+	uint32_t len;
+	int k, ret = 0;
+
+	if (nb != PDUMP_NB_CAPTURED) {
+		printf("%s: %d packets captured instead of %u\n",
+		       name, nb, PDUMP_NB_CAPTURED);
+		ret = -1;
+	}
+	for (k = 0; k < nb && ret == 0; k++) {
+		len = RTE_MIN(PDUMP_PKT_LEN + pdump_pkt_index(pkts[k]),
+			      snaplen);
+		if (pdump_pkt_index(pkts[k]) != expected[k % nb_expected]) {
+			printf("%s: packet %u captured instead of %u\n",
+			       name, pdump_pkt_index(pkts[k]),
+			       expected[k % nb_expected]);
+			ret = -1;
+		} else if (rte_pktmbuf_pkt_len(pkts[k]) != len ||
+			   rte_pktmbuf_data_len(pkts[k]) != len) {
+			printf("%s: packet of %u bytes captured instead of %u\n",
+			       name, rte_pktmbuf_pkt_len(pkts[k]), len);
+			ret = -1;
+		}
+	}
+	rte_pktmbuf_free_bulk(pkts, nb);
+	if (ret == 0)
+		printf("%s capture success\n", name);
+	return ret;
+}
+
+/* Check which packets are captured, and how much of them */
+static int
+run_pdump_capture_tests(struct rte_ring *ring, struct rte_mempool *mp)
+{
+	static const unsigned int all[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+	static const unsigned int count[] = { 0, 4, 8, 2, 6 };
+	static const unsigned int flow[] = { 0, 4, 8 };
+	static const unsigned int filtered[] = { PDUMP_BPF_INDEX };
+	struct rte_mbuf *pkts[PDUMP_NB_CAPTURED];
+	struct rte_pdump_sample_conf sample;
+	struct rte_bpf_prm *prm;
+	struct ebpf_insn *ins;
+	int nb, ret;
+
+	RTE_BUILD_BUG_ON(RTE_DIM(all) != NUM_PACKETS);
+
+	/* all the packets, the longest ones truncated */
+	memset(&sample, 0, sizeof(sample));
+	sample.snaplen = PDUMP_PKT_LEN + 4;
+	nb = pdump_capture(&sample, ring, mp, pkts);
+	if (nb < 0 || pdump_capture_check("snaplen", pkts, nb, all,
+			RTE_DIM(all), sample.snaplen) < 0)
+		return -1;
+
+	/* the first packet, then one every 4 packets */
+	memset(&sample, 0, sizeof(sample));
+	sample.mode = RTE_PDUMP_SAMPLE_COUNT;
+	sample.rate = 4;
+	nb = pdump_capture(&sample, ring, mp, pkts);
+	if (nb < 0 || pdump_capture_check("count sampling", pkts, nb, count,
+			RTE_DIM(count), UINT32_MAX) < 0)
+		return -1;
+
+	/* the flows of PDUMP_RSS_SAMPLED hash only */
+	memset(&sample, 0, sizeof(sample));
+	sample.mode = RTE_PDUMP_SAMPLE_FLOW_HASH;
+	sample.rate = 2;
+	nb = pdump_capture(&sample, ring, mp, pkts);
+	if (nb < 0 || pdump_capture_check("flow sampling", pkts, nb, flow,
+			RTE_DIM(flow), UINT32_MAX) < 0)
+		return -1;
+
+	/* the program and its instructions are read by the primary */
+	prm = rte_zmalloc(NULL, sizeof(*prm) + sizeof(pdump_filter_ins), 0);
+	if (prm == NULL) {
+		printf("rte_zmalloc BPF program failed\n");
+		return -1;
+	}
+	ins = (struct ebpf_insn *)(prm + 1);
+	memcpy(ins, pdump_filter_ins, sizeof(pdump_filter_ins));
+	prm->ins = ins;
+	prm->nb_ins = RTE_DIM(pdump_filter_ins);
+	prm->prog_arg.type = RTE_BPF_ARG_PTR;
+	prm->prog_arg.size = PDUMP_PKT_LEN;
+
+	memset(&sample, 0, sizeof(sample));
+	sample.prm = prm;
+	nb = pdump_capture(&sample, ring, mp, pkts);
+	ret = nb < 0 ? -1 : pdump_capture_check("BPF filter", pkts, nb,
+			filtered, RTE_DIM(filtered), UINT32_MAX);
+	rte_free(prm);
+
+	return ret;
+}
+
 int
 run_pdump_client_tests(void)
 {
@@ -52,6 +253,14 @@ run_pdump_client_tests(void)
 	struct rte_mempool *mp = NULL;
 	struct rte_eth_dev *eth_dev = NULL;
 	char poolname[] = "mbuf_pool_client";
+	struct rte_pdump_sample_conf sample = {
+		.mode = RTE_PDUMP_SAMPLE_COUNT,
+		.rate = 8,
+		.snaplen = 64,
+	};
+	struct rte_pdump_sample_conf bad_sample = {
+		.mode = (enum rte_pdump_sample_mode)UINT32_MAX,
+	};
 
 	ret = test_get_mempool(&mp, poolname);
 	if (ret < 0)
@@ -103,6 +312,44 @@ run_pdump_client_tests(void)
 		}
 		printf("pdump_disable_by_deviceid success\n");
 
+		ret = rte_pdump_enable_sample(portid, QUEUE_ID, flags,
+					      &sample, ring_client, mp);
+		if (ret < 0) {
+			printf("rte_pdump_enable_sample failed\n");
+			return -1;
+		}
+		printf("pdump_enable_sample success\n");
+
+		ret = rte_pdump_disable(portid, QUEUE_ID, flags);
+		if (ret < 0) {
+			printf("rte_pdump_disable failed\n");
+			return -1;
+		}
+		printf("pdump_disable success\n");
+
+		ret = rte_pdump_enable_sample_by_deviceid(deviceid, QUEUE_ID,
+				flags, &sample, ring_client, mp);
+		if (ret < 0) {
+			printf("rte_pdump_enable_sample_by_deviceid failed\n");
+			return -1;
+		}
+		printf("pdump_enable_sample_by_deviceid success\n");
+
+		ret = rte_pdump_disable_by_deviceid(deviceid, QUEUE_ID, flags);
+		if (ret < 0) {
+			printf("rte_pdump_disable_by_deviceid failed\n");
+			return -1;
+		}
+		printf("pdump_disable_by_deviceid success\n");
+
+		/* invalid sample mode */
+		ret = rte_pdump_enable_sample(portid, QUEUE_ID, flags,
+					      &bad_sample, ring_client, mp);
+		if (ret == 0) {
+			printf("rte_pdump_enable_sample invalid mode accepted\n");
+			return -1;
+		}
+
 		if (itr == 0) {
 			flags = RTE_PDUMP_FLAG_RX;
 			printf("\n***** flags = RTE_PDUMP_FLAG_RX *****\n");
@@ -111,6 +358,10 @@ run_pdump_client_tests(void)
 			printf("\n***** flags = RTE_PDUMP_FLAG_RXTX *****\n");
 		}
 	}
+
+	printf("\n***** capture *****\n");
+	ret = run_pdump_capture_tests(ring_client, mp);
+
 	if (ring_client != NULL)
 		test_ring_free(ring_client);
 	if (mp != NULL)
@@ -136,6 +387,31 @@ test_pdump_uninit(void)
 	return ret;
 }
 
+/*
+ * Give the packets forwarded during the client tests distinct lengths and
+ * contents, their index, and a sampled or unsampled RSS hash to the even
+ * ones, for the capture tests to tell which ones are captured.
+ */
+static int
+pdump_pkts_init(struct rte_mbuf **pbuf)
+{
+	unsigned int i;
+	char *data;
+
+	for (i = 0; i < NUM_PACKETS; i++) {
+		data = rte_pktmbuf_append(pbuf[i], PDUMP_PKT_LEN + i);
+		if (data == NULL)
+			return -1;
+		memset(data, i, PDUMP_PKT_LEN + i);
+		if (i % 2 != 0)
+			continue;
+		pbuf[i]->ol_flags |= PKT_RX_RSS_HASH;
+		pbuf[i]->hash.rss = i % 4 == 0 ?
+			PDUMP_RSS_SAMPLED : PDUMP_RSS_UNSAMPLED;
+	}
+	return 0;
+}
+
 void *
 send_pkts(void *empty)
 {
@@ -147,6 +423,8 @@ send_pkts(void *empty)
 	ret = test_get_mbuf_from_pool(&mp, pbuf, poolname);
 	if (ret < 0)
 		printf("get_mbuf_from_pool failed\n");
+	else if (pdump_pkts_init(pbuf) < 0)
+		printf("pdump_pkts_init failed\n");
 	do {
 		ret = test_packet_forward(pbuf, portid, QUEUE_ID);
 		if (ret < 0)
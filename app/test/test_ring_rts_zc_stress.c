@@ -0,0 +1,54 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include "test_ring_stress_impl.h"
+#include <rte_ring_elem.h>
+
+static inline uint32_t
+_st_ring_dequeue_bulk(struct rte_ring *r, void **obj, uint32_t n,
+	uint32_t *avail)
+{
+	struct rte_ring_zc_data zcd;
+	uint32_t m;
+
+	m = rte_ring_dequeue_zc_bulk_start(r, n, &zcd, avail);
+	if (m != 0) {
+		memcpy(obj, zcd.ptr1, zcd.n1 * sizeof(obj[0]));
+		if (m != zcd.n1)
+			memcpy(obj + zcd.n1, zcd.ptr2,
+				(m - zcd.n1) * sizeof(obj[0]));
+	}
+	rte_ring_dequeue_zc_finish(r, &zcd, m);
+	return m;
+}
+
+static inline uint32_t
+_st_ring_enqueue_bulk(struct rte_ring *r, void * const *obj, uint32_t n,
+	uint32_t *free)
+{
+	struct rte_ring_zc_data zcd;
+	uint32_t m;
+
+	m = rte_ring_enqueue_zc_bulk_start(r, n, &zcd, free);
+	if (m != 0) {
+		memcpy(zcd.ptr1, obj, zcd.n1 * sizeof(obj[0]));
+		if (m != zcd.n1)
+			memcpy(zcd.ptr2, obj + zcd.n1,
+				(m - zcd.n1) * sizeof(obj[0]));
+	}
+	rte_ring_enqueue_zc_finish(r, &zcd, m);
+	return m;
+}
+
+static int
+_st_ring_init(struct rte_ring *r, const char *name, uint32_t num)
+{
+	return rte_ring_init(r, name, num, RING_F_MP_RTS_ENQ | RING_F_MC_RTS_DEQ);
+}
+
+const struct test test_ring_rts_zc_stress = {
+	.name = "MT_RTS_ZC",
+	.nb_case = RTE_DIM(tests),
+	.cases = tests,
+};
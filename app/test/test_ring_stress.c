@@ -52,6 +52,12 @@ test_ring_stress(void)
 	n += test_ring_st_peek_stress.nb_case;
 	k += run_test(&test_ring_st_peek_stress);
 
+	n += test_ring_mt_zc_stress.nb_case;
+	k += run_test(&test_ring_mt_zc_stress);
+
+	n += test_ring_rts_zc_stress.nb_case;
+	k += run_test(&test_ring_rts_zc_stress);
+
 	printf("Number of tests:\t%u\nSuccess:\t%u\nFailed:\t%u\n",
 		n, k, n - k);
 	return (k != n);
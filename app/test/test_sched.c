@@ -12,6 +12,8 @@
 
 #include <rte_cycles.h>
 #include <rte_ether.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
 #include <rte_ip.h>
 #include <rte_byteorder.h>
 #include <rte_sched.h>
@@ -114,6 +116,190 @@ prepare_pkt(struct rte_sched_port *port, struct rte_mbuf *mbuf)
 }
 
 
+/*
+ * Port shared by a port dequeue and two workers, each scheduling a subport
+ * that could send at the port rate on its own.
+ */
+#define WORKERS_N_SUBPORTS  3
+#define WORKERS_RATE        10000000 /* bytes per second */
+#define WORKERS_PKTS        64
+#define WORKERS_PKT_LEN     1000
+#define WORKERS_DURATION_MS 200
+/* Port credits drawn at once by a worker, in maximum sized packets */
+#define WORKERS_CHUNK_PKTS  32
+
+static struct rte_sched_pipe_params workers_pipe_profile[] = {
+	{
+		.tb_rate = WORKERS_RATE,
+		.tb_size = 1000000,
+
+		.tc_rate = {WORKERS_RATE, WORKERS_RATE, WORKERS_RATE,
+			WORKERS_RATE, WORKERS_RATE, WORKERS_RATE, WORKERS_RATE,
+			WORKERS_RATE, WORKERS_RATE, WORKERS_RATE, WORKERS_RATE,
+			WORKERS_RATE, WORKERS_RATE},
+		.tc_period = 40,
+		.tc_ov_weight = 1,
+
+		.wrr_weights = {1, 1, 1, 1},
+	},
+};
+
+static struct rte_sched_subport_params workers_subport_param = {
+	.tb_rate = WORKERS_RATE,
+	.tb_size = 1000000,
+
+	.tc_rate = {WORKERS_RATE, WORKERS_RATE, WORKERS_RATE, WORKERS_RATE,
+		WORKERS_RATE, WORKERS_RATE, WORKERS_RATE, WORKERS_RATE,
+		WORKERS_RATE, WORKERS_RATE, WORKERS_RATE, WORKERS_RATE,
+		WORKERS_RATE},
+	.tc_period = 10,
+	.n_pipes_per_subport_enabled = 1,
+	.qsize = {64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64},
+	.pipe_profiles = workers_pipe_profile,
+	.n_pipe_profiles = 1,
+	.n_max_pipe_profiles = 1,
+};
+
+static struct rte_sched_port_params workers_port_param = {
+	.socket = 0, /* computed */
+	.rate = WORKERS_RATE,
+	.mtu = 1522,
+	.frame_overhead = RTE_SCHED_FRAME_OVERHEAD_DEFAULT,
+	.n_subports_per_port = WORKERS_N_SUBPORTS,
+	.n_pipes_per_subport = 1,
+};
+
+struct workers_ctx {
+	struct rte_sched_port *port;
+	struct rte_sched_port_worker *worker; /* NULL for the port dequeue */
+	struct rte_mbuf *pkts[WORKERS_PKTS];
+	uint64_t end;
+	uint64_t bytes;
+};
+
+static int
+workers_run(void *arg)
+{
+	struct workers_ctx *ctx = arg;
+	struct rte_mbuf *pkts[WORKERS_PKTS];
+	uint64_t bytes = 0;
+	int i, n;
+
+	/* The packets of a worker subport are enqueued by its lcore */
+	rte_sched_port_enqueue(ctx->port, ctx->pkts, WORKERS_PKTS);
+
+	while (rte_rdtsc() < ctx->end) {
+		if (ctx->worker != NULL)
+			n = rte_sched_port_worker_dequeue(ctx->worker, pkts,
+				WORKERS_PKTS);
+		else
+			n = rte_sched_port_dequeue(ctx->port, pkts,
+				WORKERS_PKTS);
+		for (i = 0; i < n; i++)
+			bytes += pkts[i]->pkt_len +
+				workers_port_param.frame_overhead;
+		rte_sched_port_enqueue(ctx->port, pkts, n);
+	}
+
+	ctx->bytes = bytes;
+	return 0;
+}
+
+/*
+ * Check that the port token bucket shared by the workers and the port
+ * dequeue keeps their total rate within the port rate, plus one chunk of
+ * credits per worker.
+ */
+static int
+test_sched_workers(void)
+{
+	static struct workers_ctx ctx[WORKERS_N_SUBPORTS];
+	uint64_t start, hz, bytes, max_bytes;
+	struct rte_sched_port *port;
+	struct rte_mempool *mp;
+	unsigned int lcore_id;
+	uint32_t i, j;
+	int err;
+
+	if (rte_lcore_count() < WORKERS_N_SUBPORTS) {
+		printf("At least %u lcores are needed, skipping workers test\n",
+			WORKERS_N_SUBPORTS);
+		return 0;
+	}
+
+	mp = rte_mempool_lookup("test_sched_workers");
+	if (mp == NULL)
+		mp = rte_pktmbuf_pool_create("test_sched_workers",
+			WORKERS_N_SUBPORTS * WORKERS_PKTS, 0, 0, MBUF_DATA_SZ,
+			SOCKET);
+	TEST_ASSERT_NOT_NULL(mp, "Error creating mempool\n");
+
+	workers_port_param.socket = 0;
+	port = rte_sched_port_config(&workers_port_param);
+	TEST_ASSERT_NOT_NULL(port, "Error config sched port\n");
+
+	for (i = 0; i < WORKERS_N_SUBPORTS; i++) {
+		err = rte_sched_subport_config(port, i, &workers_subport_param);
+		TEST_ASSERT_SUCCESS(err, "Error config sched subport %u\n", i);
+		err = rte_sched_pipe_config(port, i, 0, 0);
+		TEST_ASSERT_SUCCESS(err, "Error config sched pipe of %u\n", i);
+
+		ctx[i].port = port;
+		ctx[i].worker = NULL;
+		ctx[i].bytes = 0;
+		/* The first subport is left to the port dequeue */
+		if (i != 0) {
+			ctx[i].worker = rte_sched_port_worker_create(port, i, 1);
+			TEST_ASSERT_NOT_NULL(ctx[i].worker,
+				"Error creating sched worker %u\n", i);
+		}
+
+		err = rte_pktmbuf_alloc_bulk(mp, ctx[i].pkts, WORKERS_PKTS);
+		TEST_ASSERT_SUCCESS(err, "Packet allocation failed\n");
+		for (j = 0; j < WORKERS_PKTS; j++) {
+			rte_sched_port_pkt_write(port, ctx[i].pkts[j], i, 0,
+				RTE_SCHED_TRAFFIC_CLASS_BE, 0, RTE_COLOR_GREEN);
+			ctx[i].pkts[j]->pkt_len = WORKERS_PKT_LEN;
+			ctx[i].pkts[j]->data_len = WORKERS_PKT_LEN;
+		}
+	}
+
+	hz = rte_get_tsc_hz();
+	start = rte_rdtsc();
+	for (i = 0; i < WORKERS_N_SUBPORTS; i++)
+		ctx[i].end = start + hz * WORKERS_DURATION_MS / 1000;
+
+	i = 1;
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		if (i == WORKERS_N_SUBPORTS)
+			break;
+		rte_eal_remote_launch(workers_run, &ctx[i++], lcore_id);
+	}
+	workers_run(&ctx[0]);
+	rte_eal_mp_wait_lcore();
+
+	max_bytes = WORKERS_RATE * (rte_rdtsc() - start) / hz +
+		(uint64_t)WORKERS_N_SUBPORTS * WORKERS_CHUNK_PKTS *
+		workers_port_param.mtu;
+	bytes = 0;
+	for (i = 0; i < WORKERS_N_SUBPORTS; i++) {
+		printf("Subport %u: %"PRIu64" bytes\n", i, ctx[i].bytes);
+		TEST_ASSERT(ctx[i].bytes != 0, "Subport %u starved\n", i);
+		bytes += ctx[i].bytes;
+	}
+
+	/* The port and the subports are freed with the queued packets */
+	rte_sched_port_free(port);
+
+	TEST_ASSERT(bytes <= max_bytes,
+		"Port rate exceeded: %"PRIu64" bytes sent, at most %"PRIu64
+		" expected\n", bytes, max_bytes);
+	TEST_ASSERT(bytes >= WORKERS_RATE * WORKERS_DURATION_MS / 1000 / 2,
+		"Port rate not reached: %"PRIu64" bytes sent\n", bytes);
+
+	return 0;
+}
+
 /**
  * test main entrance for library sched
  */
@@ -190,9 +376,28 @@ test_sched(void)
 	TEST_ASSERT_EQUAL(queue_stats.n_pkts, 10, "Wrong queue stats\n");
 #endif
 
+	/* the subport of a worker is only dequeued by the worker */
+	struct rte_sched_port_worker *worker;
+
+	worker = rte_sched_port_worker_create(port, SUBPORT, 1);
+	TEST_ASSERT_NOT_NULL(worker, "Error creating sched worker\n");
+
+	err = rte_sched_subport_config(port, SUBPORT, subport_param);
+	TEST_ASSERT_EQUAL(err, -EBUSY, "Wrong subport config, err=%d\n", err);
+
+	err = rte_sched_port_enqueue(port, out_mbufs, 10);
+	TEST_ASSERT_EQUAL(err, 10, "Wrong enqueue, err=%d\n", err);
+
+	err = rte_sched_port_dequeue(port, in_mbufs, 10);
+	TEST_ASSERT_EQUAL(err, 0, "Wrong port dequeue, err=%d\n", err);
+
+	err = rte_sched_port_worker_dequeue(worker, in_mbufs, 10);
+	TEST_ASSERT_EQUAL(err, 10, "Wrong worker dequeue, err=%d\n", err);
+
+	/* the worker is freed with the port */
 	rte_sched_port_free(port);
 
-	return 0;
+	return test_sched_workers();
 }
 
 REGISTER_TEST_COMMAND(sched_autotest, test_sched);
@@ -0,0 +1,240 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_mbuf.h>
+#include <rte_sched.h>
+
+#include "test.h"
+
+/*
+ * Measure the dequeue rate of the port scheduler workers, with one subport
+ * per worker, for an increasing number of lcores. The subports and pipes
+ * use the profile of the qos_sched application: 4096 pipes of 2.4 Mbps
+ * per 10 Gbps subport. The port rate is high enough for the port token
+ * bucket shared by the workers not to limit their total rate.
+ */
+
+#define MAX_WORKERS      8U
+#define N_PIPES          4096
+#define QSIZE            64
+#define PKTS_PER_WORKER  (2 * N_PIPES)
+#define BURST_SIZE       32
+#define MBUF_DATA_SZ     (128 + RTE_PKTMBUF_HEADROOM)
+#define MEMPOOL_CACHE_SZ 256
+#define DURATION_MS      500
+
+/* 400 Gbps */
+#define PORT_RATE        50000000000ULL
+/* 10 Gbps */
+#define SUBPORT_RATE     1250000000
+/* 2.4 Mbps */
+#define PIPE_RATE        305175
+
+static struct rte_sched_pipe_params pipe_profile[] = {
+	{
+		.tb_rate = PIPE_RATE,
+		.tb_size = 1000000,
+
+		.tc_rate = {PIPE_RATE, PIPE_RATE, PIPE_RATE, PIPE_RATE,
+			PIPE_RATE, PIPE_RATE, PIPE_RATE, PIPE_RATE, PIPE_RATE,
+			PIPE_RATE, PIPE_RATE, PIPE_RATE, PIPE_RATE},
+		.tc_period = 40,
+		.tc_ov_weight = 1,
+
+		.wrr_weights = {1, 1, 1, 1},
+	},
+};
+
+static struct rte_sched_subport_params subport_param = {
+	.tb_rate = SUBPORT_RATE,
+	.tb_size = 1000000,
+
+	.tc_rate = {SUBPORT_RATE, SUBPORT_RATE, SUBPORT_RATE, SUBPORT_RATE,
+		SUBPORT_RATE, SUBPORT_RATE, SUBPORT_RATE, SUBPORT_RATE,
+		SUBPORT_RATE, SUBPORT_RATE, SUBPORT_RATE, SUBPORT_RATE,
+		SUBPORT_RATE},
+	.tc_period = 10,
+	.n_pipes_per_subport_enabled = N_PIPES,
+	.qsize = {QSIZE, QSIZE, QSIZE, QSIZE, QSIZE, QSIZE, QSIZE, QSIZE,
+		QSIZE, QSIZE, QSIZE, QSIZE, QSIZE},
+	.pipe_profiles = pipe_profile,
+	.n_pipe_profiles = 1,
+	.n_max_pipe_profiles = 1,
+};
+
+static struct rte_sched_port_params port_param = {
+	.socket = 0, /* computed */
+	.rate = PORT_RATE,
+	.mtu = 1522,
+	.frame_overhead = RTE_SCHED_FRAME_OVERHEAD_DEFAULT,
+	.n_subports_per_port = 0, /* computed */
+	.n_pipes_per_subport = N_PIPES,
+};
+
+struct sched_perf_lcore {
+	struct rte_sched_port *port;
+	struct rte_sched_port_worker *worker;
+	uint32_t subport;
+	uint64_t n_pkts;
+	uint64_t cycles;
+} __rte_cache_aligned;
+
+static struct sched_perf_lcore lcore_data[MAX_WORKERS];
+static struct rte_mempool *mp;
+static uint32_t start;
+
+static int
+sched_perf_worker(void *arg)
+{
+	struct sched_perf_lcore *data = arg;
+	struct rte_mbuf *pkts[PKTS_PER_WORKER];
+	uint64_t begin, end, n_pkts = 0;
+	uint32_t i;
+	int n;
+
+	if (rte_pktmbuf_alloc_bulk(mp, pkts, PKTS_PER_WORKER) != 0)
+		return -ENOMEM;
+
+	/* Spread the packets over all the pipes of the subport */
+	for (i = 0; i < PKTS_PER_WORKER; i++) {
+		uint32_t tc = (i / N_PIPES + i) %
+			RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE;
+		uint32_t queue = 0;
+
+		if (tc == RTE_SCHED_TRAFFIC_CLASS_BE)
+			queue = (i / RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE) %
+				RTE_SCHED_BE_QUEUES_PER_PIPE;
+
+		rte_sched_port_pkt_write(data->port, pkts[i], data->subport,
+			i % N_PIPES, tc, queue, RTE_COLOR_GREEN);
+		pkts[i]->pkt_len = 60;
+		pkts[i]->data_len = 60;
+	}
+
+	while (__atomic_load_n(&start, __ATOMIC_ACQUIRE) == 0)
+		rte_pause();
+
+	/* The packets of a worker subports are enqueued by the worker lcore */
+	rte_sched_port_enqueue(data->port, pkts, PKTS_PER_WORKER);
+
+	begin = rte_rdtsc();
+	end = begin + rte_get_tsc_hz() * DURATION_MS / 1000;
+	do {
+		n = rte_sched_port_worker_dequeue(data->worker, pkts,
+			BURST_SIZE);
+		rte_sched_port_enqueue(data->port, pkts, n);
+		n_pkts += n;
+	} while (rte_rdtsc() < end);
+
+	data->cycles = rte_rdtsc() - begin;
+	data->n_pkts = n_pkts;
+
+	return 0;
+}
+
+static int
+sched_perf_run(unsigned int n_workers)
+{
+	struct rte_sched_port *port;
+	unsigned int lcore_id, i;
+	double mpps = 0;
+	uint32_t pipe;
+	int ret = 0;
+
+	port_param.socket = rte_socket_id();
+	port_param.n_subports_per_port = n_workers;
+
+	port = rte_sched_port_config(&port_param);
+	TEST_ASSERT_NOT_NULL(port, "Error config sched port\n");
+
+	for (i = 0; i < n_workers; i++) {
+		ret = rte_sched_subport_config(port, i, &subport_param);
+		TEST_ASSERT_SUCCESS(ret, "Error config sched subport %u\n", i);
+
+		for (pipe = 0; pipe < N_PIPES; pipe++) {
+			ret = rte_sched_pipe_config(port, i, pipe, 0);
+			TEST_ASSERT_SUCCESS(ret, "Error config sched pipe %u\n",
+				pipe);
+		}
+	}
+
+	for (i = 0; i < n_workers; i++) {
+		lcore_data[i].port = port;
+		lcore_data[i].subport = i;
+		lcore_data[i].worker = rte_sched_port_worker_create(port, i, 1);
+		TEST_ASSERT_NOT_NULL(lcore_data[i].worker,
+			"Error creating sched worker %u\n", i);
+	}
+
+	__atomic_store_n(&start, 0, __ATOMIC_RELAXED);
+	i = 0;
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		if (i == n_workers)
+			break;
+		rte_eal_remote_launch(sched_perf_worker, &lcore_data[i++],
+			lcore_id);
+	}
+	__atomic_store_n(&start, 1, __ATOMIC_RELEASE);
+
+	i = 0;
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		if (i == n_workers)
+			break;
+		if (rte_eal_wait_lcore(lcore_id) < 0)
+			ret = -1;
+		else
+			mpps += (double)lcore_data[i].n_pkts *
+				rte_get_tsc_hz() / lcore_data[i].cycles / 1E6;
+		i++;
+	}
+
+	for (i = 0; i < n_workers; i++)
+		rte_sched_port_worker_free(lcore_data[i].worker);
+	rte_sched_port_free(port);
+
+	TEST_ASSERT_SUCCESS(ret, "Error running sched workers\n");
+	TEST_ASSERT(mpps > 0, "No packet dequeued\n");
+
+	printf("%u workers: %.2f Mpps, %.2f Mpps per worker\n",
+		n_workers, mpps, mpps / n_workers);
+
+	return 0;
+}
+
+static int
+test_sched_perf(void)
+{
+	unsigned int n_workers, max_workers;
+	int ret;
+
+	max_workers = RTE_MIN(rte_lcore_count() - 1, MAX_WORKERS);
+	if (max_workers == 0) {
+		printf("At least 2 lcores are needed, skipping test\n");
+		return TEST_SKIPPED;
+	}
+
+	mp = rte_pktmbuf_pool_create("sched_perf",
+		max_workers * (PKTS_PER_WORKER + MEMPOOL_CACHE_SZ * 2),
+		MEMPOOL_CACHE_SZ, 0, MBUF_DATA_SZ, rte_socket_id());
+	TEST_ASSERT_NOT_NULL(mp, "Error creating mempool\n");
+
+	for (n_workers = 1; ; n_workers = RTE_MIN(n_workers * 2, max_workers)) {
+		ret = sched_perf_run(n_workers);
+		if (ret != 0 || n_workers == max_workers)
+			break;
+	}
+
+	rte_mempool_free(mp);
+
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(sched_perf_autotest, test_sched_perf);
@@ -398,6 +398,99 @@ service_lcore_attr_get(void)
 	return unregister_all();
 }
 
+static int32_t busy_cb(void *args)
+{
+	RTE_SET_USED(args);
+	return 0;
+}
+
+static int32_t idle_cb(void *args)
+{
+	RTE_SET_USED(args);
+	return -EAGAIN;
+}
+
+/* verify adaptive scheduling backs off idle services */
+static int
+service_sched_adaptive(void)
+{
+	unregister_all();
+
+	struct rte_service_spec service;
+	uint32_t busy_id, idle_id;
+	uint64_t busy_calls, idle_calls, value;
+
+	memset(&service, 0, sizeof(struct rte_service_spec));
+	service.callback = busy_cb;
+	snprintf(service.name, sizeof(service.name), "busy_service");
+	TEST_ASSERT_EQUAL(0, rte_service_component_register(&service,
+			&busy_id), "Register of busy service failed");
+	service.callback = idle_cb;
+	snprintf(service.name, sizeof(service.name), "idle_service");
+	TEST_ASSERT_EQUAL(0, rte_service_component_register(&service,
+			&idle_id), "Register of idle service failed");
+
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_lcore_sched_mode_set(slcore_id,
+			RTE_SERVICE_SCHED_ADAPTIVE),
+			"Sched mode set on non-service core didn't fail");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_id),
+			"Service core add did not return zero");
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_lcore_sched_mode_set(slcore_id,
+			UINT32_MAX), "Invalid sched mode didn't return -EINVAL");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_sched_mode_set(slcore_id,
+			RTE_SERVICE_SCHED_ADAPTIVE), "Sched mode set failed");
+
+	rte_service_component_runstate_set(busy_id, 1);
+	rte_service_component_runstate_set(idle_id, 1);
+	rte_service_runstate_set(busy_id, 1);
+	rte_service_runstate_set(idle_id, 1);
+	rte_service_set_stats_enable(busy_id, 1);
+	rte_service_set_stats_enable(idle_id, 1);
+	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(busy_id, slcore_id, 1),
+			"Enabling busy service on core failed");
+	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(idle_id, slcore_id, 1),
+			"Enabling idle service on core failed");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_start(slcore_id),
+			"Starting service core failed");
+
+	/* wait for the service lcore to run */
+	rte_delay_ms(200);
+
+	rte_service_runstate_set(busy_id, 0);
+	rte_service_runstate_set(idle_id, 0);
+	rte_service_lcore_stop(slcore_id);
+	rte_eal_wait_lcore(slcore_id);
+
+	rte_service_attr_get(busy_id, RTE_SERVICE_ATTR_CALL_COUNT, &busy_calls);
+	rte_service_attr_get(idle_id, RTE_SERVICE_ATTR_CALL_COUNT, &idle_calls);
+	TEST_ASSERT(busy_calls > 0 && idle_calls > 0,
+			"Services were not run");
+	/* the idle service runs once every 65 loops at most */
+	TEST_ASSERT(idle_calls * 32 < busy_calls,
+			"Idle service was not backed off: %"PRIu64" calls, "
+			"busy service %"PRIu64" calls", idle_calls, busy_calls);
+
+	TEST_ASSERT_EQUAL(0, rte_service_attr_get(idle_id,
+			RTE_SERVICE_ATTR_IDLE_CALL_COUNT, &value),
+			"Valid attr_get() call didn't return success");
+	TEST_ASSERT_EQUAL(idle_calls, value, "Wrong idle call count");
+	TEST_ASSERT_EQUAL(0, rte_service_attr_get(idle_id,
+			RTE_SERVICE_ATTR_IDLE_RATIO, &value),
+			"Valid attr_get() call didn't return success");
+	TEST_ASSERT_EQUAL(1000, value, "Wrong idle ratio of idle service");
+	TEST_ASSERT_EQUAL(0, rte_service_attr_get(idle_id,
+			RTE_SERVICE_ATTR_BACKOFF, &value),
+			"Valid attr_get() call didn't return success");
+	TEST_ASSERT_EQUAL(64, value, "Wrong backoff of idle service");
+
+	rte_service_attr_get(busy_id, RTE_SERVICE_ATTR_IDLE_RATIO, &value);
+	TEST_ASSERT_EQUAL(0, value, "Wrong idle ratio of busy service");
+	rte_service_attr_get(busy_id, RTE_SERVICE_ATTR_BACKOFF, &value);
+	TEST_ASSERT_EQUAL(0, value, "Wrong backoff of busy service");
+
+	return unregister_all();
+}
+
 /* verify service dump */
 static int
 service_dump(void)
@@ -975,6 +1068,7 @@ static struct unit_test_suite service_tests  = {
 		TEST_CASE_ST(dummy_register, NULL, service_dump),
 		TEST_CASE_ST(dummy_register, NULL, service_attr_get),
 		TEST_CASE_ST(dummy_register, NULL, service_lcore_attr_get),
+		TEST_CASE_ST(dummy_register, NULL, service_sched_adaptive),
 		TEST_CASE_ST(dummy_register, NULL, service_probe_capability),
 		TEST_CASE_ST(dummy_register, NULL, service_start_stop),
 		TEST_CASE_ST(dummy_register, NULL, service_lcore_add_del),
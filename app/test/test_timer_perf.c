@@ -132,3 +132,145 @@ test_timer_perf(void)
 }
 
 REGISTER_TEST_COMMAND(timer_perf_autotest, test_timer_perf);
+
+#define BACKEND_NB_TIMERS 1000000
+#define BACKEND_EXPIRE_MS 100
+/* maximum time to run the callbacks of all the timers */
+#define BACKEND_TIMEOUT_MS 10000
+
+static int backend_outstanding;
+static int backend_early;
+
+static void
+backend_timer_cb(struct rte_timer *t, void *param __rte_unused)
+{
+	if (rte_get_timer_cycles() < t->expire)
+		backend_early++;
+	backend_outstanding--;
+}
+
+static void
+backend_manage_cb(struct rte_timer *t)
+{
+	t->f(t, t->arg);
+}
+
+static uint64_t
+per_op(uint64_t start_tsc, unsigned int n)
+{
+	return (rte_rdtsc() - start_tsc + n / 2) / n;
+}
+
+/* time the operations of the timer data instance created with params */
+static int
+timer_backend_perf(const char *name,
+		   const struct rte_timer_data_params *params,
+		   struct rte_timer *tms)
+{
+	const uint64_t hz = rte_get_timer_hz();
+	const uint64_t expire_ticks = hz * BACKEND_EXPIRE_MS / 1000;
+	unsigned int lcore_id = rte_lcore_id();
+	uint64_t arm, reset, stop, cb, poll;
+	uint64_t start_tsc, deadline;
+	uint32_t id;
+	unsigned int i;
+	int ret;
+
+	ret = rte_timer_data_alloc_ext(&id, params);
+	if (ret != 0) {
+		printf("Error: cannot allocate %s timer data: %d\n", name, ret);
+		return -1;
+	}
+
+	for (i = 0; i < BACKEND_NB_TIMERS; i++)
+		rte_timer_init(&tms[i]);
+
+	/* far away timers, to measure the cost of the pending set size */
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < BACKEND_NB_TIMERS; i++)
+		rte_timer_alt_reset(id, &tms[i], hz + rte_rand() % hz, SINGLE,
+				    lcore_id, backend_timer_cb, NULL);
+	arm = per_op(start_tsc, BACKEND_NB_TIMERS);
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < BACKEND_NB_TIMERS; i++)
+		rte_timer_alt_reset(id, &tms[i], hz + rte_rand() % hz, SINGLE,
+				    lcore_id, backend_timer_cb, NULL);
+	reset = per_op(start_tsc, BACKEND_NB_TIMERS);
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < BACKEND_NB_TIMERS; i++)
+		rte_timer_alt_stop(id, &tms[i]);
+	stop = per_op(start_tsc, BACKEND_NB_TIMERS);
+
+	for (i = 0; i < BACKEND_NB_TIMERS; i++)
+		rte_timer_alt_reset(id, &tms[i], rte_rand() % expire_ticks,
+				    SINGLE, lcore_id, backend_timer_cb, NULL);
+	backend_outstanding = BACKEND_NB_TIMERS;
+	backend_early = 0;
+	rte_delay_ms(BACKEND_EXPIRE_MS);
+
+	start_tsc = rte_rdtsc();
+	deadline = start_tsc + rte_get_tsc_hz() * BACKEND_TIMEOUT_MS / 1000;
+	while (backend_outstanding > 0) {
+		if (rte_rdtsc() > deadline) {
+			printf("Error: %d %s timers did not expire\n",
+			       backend_outstanding, name);
+			for (i = 0; i < BACKEND_NB_TIMERS; i++)
+				rte_timer_alt_stop(id, &tms[i]);
+			rte_timer_data_dealloc(id);
+			return TEST_FAILED;
+		}
+		rte_timer_alt_manage(id, NULL, 0, backend_manage_cb);
+	}
+	cb = per_op(start_tsc, BACKEND_NB_TIMERS);
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < BACKEND_NB_TIMERS; i++)
+		rte_timer_alt_manage(id, NULL, 0, backend_manage_cb);
+	poll = per_op(start_tsc, BACKEND_NB_TIMERS);
+
+	printf("%-10s %12"PRIu64" %12"PRIu64" %12"PRIu64" %12"PRIu64
+	       " %12"PRIu64"\n", name, arm, reset, stop, cb, poll);
+
+	rte_timer_data_dealloc(id);
+
+	if (backend_early != 0) {
+		printf("Error: %d %s timers expired early\n", backend_early,
+		       name);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+test_timer_backend_perf(void)
+{
+	struct rte_timer_data_params params = { 0 };
+	struct rte_timer *tms;
+	int ret = 0;
+
+	tms = rte_malloc(NULL, sizeof(*tms) * BACKEND_NB_TIMERS, 0);
+	if (tms == NULL) {
+		printf("Error: cannot allocate timers\n");
+		return -1;
+	}
+
+	printf("Cycles per operation with %u timers\n", BACKEND_NB_TIMERS);
+	printf("%-10s %12s %12s %12s %12s %12s\n", "Backend", "Arm", "Reset",
+	       "Stop", "Callback", "Empty poll");
+
+	params.backend = RTE_TIMER_BACKEND_SKIPLIST;
+	if (timer_backend_perf("skiplist", &params, tms) < 0)
+		ret = -1;
+
+	params.backend = RTE_TIMER_BACKEND_WHEEL;
+	if (timer_backend_perf("wheel", &params, tms) < 0)
+		ret = -1;
+
+	rte_free(tms);
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(timer_backend_perf_autotest, test_timer_backend_perf);
@@ -102,6 +102,7 @@
 
 /* rte_graph defines */
 #define RTE_GRAPH_BURST_SIZE 256
+#define RTE_GRAPH_DISPATCH_RING_SIZE 4096
 #define RTE_LIBRTE_GRAPH_STATS 1
 
 /****** driver defines ********/
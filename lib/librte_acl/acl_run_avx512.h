@@ -0,0 +1,363 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include "acl_run_sse.h"
+
+static const rte_zmm_t zmm_match_mask = {
+	.u32 = {
+		RTE_ACL_NODE_MATCH,
+		RTE_ACL_NODE_MATCH,
+		RTE_ACL_NODE_MATCH,
+		RTE_ACL_NODE_MATCH,
+		RTE_ACL_NODE_MATCH,
+		RTE_ACL_NODE_MATCH,
+		RTE_ACL_NODE_MATCH,
+		RTE_ACL_NODE_MATCH,
+		RTE_ACL_NODE_MATCH,
+		RTE_ACL_NODE_MATCH,
+		RTE_ACL_NODE_MATCH,
+		RTE_ACL_NODE_MATCH,
+		RTE_ACL_NODE_MATCH,
+		RTE_ACL_NODE_MATCH,
+		RTE_ACL_NODE_MATCH,
+		RTE_ACL_NODE_MATCH,
+	},
+};
+
+static const rte_zmm_t zmm_index_mask = {
+	.u32 = {
+		RTE_ACL_NODE_INDEX,
+		RTE_ACL_NODE_INDEX,
+		RTE_ACL_NODE_INDEX,
+		RTE_ACL_NODE_INDEX,
+		RTE_ACL_NODE_INDEX,
+		RTE_ACL_NODE_INDEX,
+		RTE_ACL_NODE_INDEX,
+		RTE_ACL_NODE_INDEX,
+		RTE_ACL_NODE_INDEX,
+		RTE_ACL_NODE_INDEX,
+		RTE_ACL_NODE_INDEX,
+		RTE_ACL_NODE_INDEX,
+		RTE_ACL_NODE_INDEX,
+		RTE_ACL_NODE_INDEX,
+		RTE_ACL_NODE_INDEX,
+		RTE_ACL_NODE_INDEX,
+	},
+};
+
+static const rte_zmm_t zmm_shuffle_input = {
+	.u32 = {
+		0x00000000, 0x04040404, 0x08080808, 0x0c0c0c0c,
+		0x00000000, 0x04040404, 0x08080808, 0x0c0c0c0c,
+		0x00000000, 0x04040404, 0x08080808, 0x0c0c0c0c,
+		0x00000000, 0x04040404, 0x08080808, 0x0c0c0c0c,
+	},
+};
+
+static const rte_zmm_t zmm_ones_8 = {
+	.u8 = {
+		1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+		1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+		1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+		1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	},
+};
+
+static const rte_zmm_t zmm_ones_16 = {
+	.u16 = {
+		1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+		1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	},
+};
+
+static const rte_zmm_t zmm_range_base = {
+	.u32 = {
+		0xffffff00, 0xffffff04, 0xffffff08, 0xffffff0c,
+		0xffffff00, 0xffffff04, 0xffffff08, 0xffffff0c,
+		0xffffff00, 0xffffff04, 0xffffff08, 0xffffff0c,
+		0xffffff00, 0xffffff04, 0xffffff08, 0xffffff0c,
+	},
+};
+
+/*
+ * Calculate the address of the next transition for 16 flows.
+ * Same algorithm as ACL_TR_CALC_ADDR() (see acl_vect.h), but
+ * AVX512 comparisons produce bit-masks instead of vector masks,
+ * so DFA/QUAD blending and range counting are done via mask registers.
+ */
+static __rte_always_inline __m512i
+calc_addr16(__m512i index_mask, __m512i next_input, __m512i shuffle_input,
+	__m512i ones_8, __m512i ones_16, __m512i range_base,
+	__m512i tr_lo, __m512i tr_hi)
+{
+	__mmask64 qm;
+	__mmask16 dfa_msk;
+	__m512i addr, in, node_type, r, t;
+	__m512i dfa_ofs, quad_ofs;
+
+	t = _mm512_xor_si512(index_mask, index_mask);
+	in = _mm512_shuffle_epi8(next_input, shuffle_input);
+
+	/* Calc node type and node addr */
+	node_type = _mm512_andnot_si512(index_mask, tr_lo);
+	addr = _mm512_and_si512(index_mask, tr_lo);
+
+	/* mask for DFA type(0) nodes */
+	dfa_msk = _mm512_cmpeq_epi32_mask(node_type, t);
+
+	/* DFA calculations. */
+	r = _mm512_srli_epi32(in, 30);
+	r = _mm512_add_epi8(r, range_base);
+	t = _mm512_srli_epi32(in, 24);
+	r = _mm512_shuffle_epi8(tr_hi, r);
+
+	dfa_ofs = _mm512_sub_epi32(t, r);
+
+	/* QUAD/SINGLE calculations: count boundaries less than input byte. */
+	qm = _mm512_cmpgt_epi8_mask(in, tr_hi);
+	t = _mm512_maskz_mov_epi8(qm, ones_8);
+	t = _mm512_maddubs_epi16(t, ones_8);
+	quad_ofs = _mm512_madd_epi16(t, ones_16);
+
+	/* blend DFA and QUAD/SINGLE. */
+	t = _mm512_mask_mov_epi32(quad_ofs, dfa_msk, dfa_ofs);
+
+	/* calculate address for next transitions. */
+	return _mm512_add_epi32(addr, t);
+}
+
+/*
+ * Process 16 transitions in parallel.
+ * tr_lo contains low 32 bits for 16 transitions.
+ * tr_hi contains high 32 bits for 16 transitions.
+ * next_input contains up to 4 input bytes for 16 flows.
+ */
+static __rte_always_inline __m512i
+transition16(__m512i next_input, const uint64_t *trans,
+	__m512i *tr_lo, __m512i *tr_hi)
+{
+	const int32_t *tr;
+	__m512i addr;
+
+	tr = (const int32_t *)(uintptr_t)trans;
+
+	/* Calculate the address (array index) for all 16 transitions. */
+	addr = calc_addr16(zmm_index_mask.z, next_input, zmm_shuffle_input.z,
+		zmm_ones_8.z, zmm_ones_16.z, zmm_range_base.z, *tr_lo, *tr_hi);
+
+	/* load lower 32 bits of 16 transactions at once. */
+	*tr_lo = _mm512_i32gather_epi32(addr, tr, sizeof(trans[0]));
+
+	next_input = _mm512_srli_epi32(next_input, CHAR_BIT);
+
+	/* load high 32 bits of 16 transactions at once. */
+	*tr_hi = _mm512_i32gather_epi32(addr, tr + 1, sizeof(trans[0]));
+
+	return next_input;
+}
+
+/*
+ * Process matches for 16 flows.
+ * Only flows with a bit set in the *matches* mask are touched,
+ * transitions for all other flows are kept intact.
+ */
+static inline void
+acl_process_matches_avx512x16(const struct rte_acl_ctx *ctx,
+	struct parms *parms, struct acl_flow_data *flows, uint32_t slot,
+	uint32_t matches, __m512i *tr_lo, __m512i *tr_hi)
+{
+	uint32_t i;
+	uint64_t tr;
+	rte_zmm_t lo, hi;
+
+	lo.z = *tr_lo;
+	hi.z = *tr_hi;
+
+	for (; matches != 0; matches &= matches - 1) {
+
+		i = rte_bsf32(matches);
+
+		/*
+		 * Low 32bits of the transition are enough
+		 * to process the match.
+		 */
+		tr = acl_match_check(lo.u32[i], slot + i,
+			ctx, parms, flows, resolve_priority_sse);
+
+		lo.u32[i] = (uint32_t)tr;
+		hi.u32[i] = tr >> 32;
+	}
+
+	*tr_lo = lo.z;
+	*tr_hi = hi.z;
+}
+
+static inline void
+acl_match_check_avx512x16(const struct rte_acl_ctx *ctx, struct parms *parms,
+	struct acl_flow_data *flows, uint32_t slot,
+	__m512i *tr_lo, __m512i *tr_hi, __m512i match_mask)
+{
+	uint32_t msk;
+	__m512i temp;
+
+	/* test for match node */
+	temp = _mm512_and_si512(match_mask, *tr_lo);
+	msk = _mm512_cmpeq_epi32_mask(temp, match_mask);
+
+	while (msk != 0) {
+
+		acl_process_matches_avx512x16(ctx, parms, flows, slot,
+			msk, tr_lo, tr_hi);
+		temp = _mm512_and_si512(match_mask, *tr_lo);
+		msk = _mm512_cmpeq_epi32_mask(temp, match_mask);
+	}
+}
+
+/*
+ * Fill 16 slots starting from *slot* with the first transitions
+ * of the next available tries and split them into lo/hi halves.
+ */
+static inline void
+acl_start_avx512x16(const struct rte_acl_ctx *ctx, struct parms *parms,
+	struct acl_flow_data *flows, uint32_t slot,
+	__m512i *tr_lo, __m512i *tr_hi)
+{
+	uint32_t n;
+	uint64_t tr;
+	rte_zmm_t lo, hi;
+
+	for (n = 0; n != MAX_SEARCHES_AVX512X16; n++) {
+		tr = acl_start_next_trie(flows, parms, slot + n, ctx);
+		lo.u32[n] = (uint32_t)tr;
+		hi.u32[n] = tr >> 32;
+	}
+
+	*tr_lo = lo.z;
+	*tr_hi = hi.z;
+}
+
+/*
+ * Gather 4 bytes of input data for 16 flows starting from *slot*.
+ */
+static __rte_always_inline __m512i
+acl_get_input_avx512x16(struct parms *parms, uint32_t slot)
+{
+	uint32_t n;
+	rte_zmm_t in;
+
+	for (n = 0; n != MAX_SEARCHES_AVX512X16; n++)
+		in.u32[n] = GET_NEXT_4BYTES(parms, slot + n);
+
+	return in.z;
+}
+
+/*
+ * Execute trie traversal for up to 16 flows in parallel.
+ */
+static inline int
+search_avx512x16(const struct rte_acl_ctx *ctx, const uint8_t **data,
+	uint32_t *results, uint32_t total_packets, uint32_t categories)
+{
+	uint32_t n;
+	struct acl_flow_data flows;
+	struct completion cmplt[MAX_SEARCHES_AVX512X16];
+	struct parms parms[MAX_SEARCHES_AVX512X16];
+	__m512i input, tr_lo, tr_hi;
+
+	acl_set_flow(&flows, cmplt, RTE_DIM(cmplt), data, results,
+		total_packets, categories, ctx->trans_table);
+
+	for (n = 0; n != RTE_DIM(cmplt); n++)
+		cmplt[n].count = 0;
+
+	acl_start_avx512x16(ctx, parms, &flows, 0, &tr_lo, &tr_hi);
+
+	/* Check for any matches. */
+	acl_match_check_avx512x16(ctx, parms, &flows, 0, &tr_lo, &tr_hi,
+		zmm_match_mask.z);
+
+	while (flows.started > 0) {
+
+		/* Gather 4 bytes of input data for all 16 flows. */
+		input = acl_get_input_avx512x16(parms, 0);
+
+		/* Process the 4 bytes of input on each stream. */
+		input = transition16(input, flows.trans, &tr_lo, &tr_hi);
+		input = transition16(input, flows.trans, &tr_lo, &tr_hi);
+		input = transition16(input, flows.trans, &tr_lo, &tr_hi);
+		input = transition16(input, flows.trans, &tr_lo, &tr_hi);
+
+		/* Check for any matches. */
+		acl_match_check_avx512x16(ctx, parms, &flows, 0,
+			&tr_lo, &tr_hi, zmm_match_mask.z);
+	}
+
+	return 0;
+}
+
+/*
+ * Execute trie traversal for up to 32 flows in parallel.
+ * Two sets of 16 flows are interleaved to hide gather latency.
+ */
+static inline int
+search_avx512x32(const struct rte_acl_ctx *ctx, const uint8_t **data,
+	uint32_t *results, uint32_t total_packets, uint32_t categories)
+{
+	uint32_t n;
+	struct acl_flow_data flows;
+	struct completion cmplt[MAX_SEARCHES_AVX512X32];
+	struct parms parms[MAX_SEARCHES_AVX512X32];
+	__m512i input[2], tr_lo[2], tr_hi[2];
+
+	acl_set_flow(&flows, cmplt, RTE_DIM(cmplt), data, results,
+		total_packets, categories, ctx->trans_table);
+
+	for (n = 0; n != RTE_DIM(cmplt); n++)
+		cmplt[n].count = 0;
+
+	acl_start_avx512x16(ctx, parms, &flows, 0, &tr_lo[0], &tr_hi[0]);
+	acl_start_avx512x16(ctx, parms, &flows, 16,
+		&tr_lo[1], &tr_hi[1]);
+
+	/* Check for any matches. */
+	acl_match_check_avx512x16(ctx, parms, &flows, 0,
+		&tr_lo[0], &tr_hi[0], zmm_match_mask.z);
+	acl_match_check_avx512x16(ctx, parms, &flows, 16,
+		&tr_lo[1], &tr_hi[1], zmm_match_mask.z);
+
+	while (flows.started > 0) {
+
+		/* Gather 4 bytes of input data for first and last 16 flows. */
+		input[0] = acl_get_input_avx512x16(parms, 0);
+		input[1] = acl_get_input_avx512x16(parms, 16);
+
+		input[0] = transition16(input[0], flows.trans,
+			&tr_lo[0], &tr_hi[0]);
+		input[1] = transition16(input[1], flows.trans,
+			&tr_lo[1], &tr_hi[1]);
+
+		input[0] = transition16(input[0], flows.trans,
+			&tr_lo[0], &tr_hi[0]);
+		input[1] = transition16(input[1], flows.trans,
+			&tr_lo[1], &tr_hi[1]);
+
+		input[0] = transition16(input[0], flows.trans,
+			&tr_lo[0], &tr_hi[0]);
+		input[1] = transition16(input[1], flows.trans,
+			&tr_lo[1], &tr_hi[1]);
+
+		input[0] = transition16(input[0], flows.trans,
+			&tr_lo[0], &tr_hi[0]);
+		input[1] = transition16(input[1], flows.trans,
+			&tr_lo[1], &tr_hi[1]);
+
+		/* Check for any matches. */
+		acl_match_check_avx512x16(ctx, parms, &flows, 0,
+			&tr_lo[0], &tr_hi[0], zmm_match_mask.z);
+		acl_match_check_avx512x16(ctx, parms, &flows, 16,
+			&tr_lo[1], &tr_hi[1], zmm_match_mask.z);
+	}
+
+	return 0;
+}
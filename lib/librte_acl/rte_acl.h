@@ -241,6 +241,7 @@ enum rte_acl_classify_alg {
 	RTE_ACL_CLASSIFY_AVX2 = 3,    /**< requires AVX2 support. */
 	RTE_ACL_CLASSIFY_NEON = 4,    /**< requires NEON support. */
 	RTE_ACL_CLASSIFY_ALTIVEC = 5,    /**< requires ALTIVEC support. */
+	RTE_ACL_CLASSIFY_AVX512 = 6,  /**< requires AVX512F/BW support. */
 	RTE_ACL_CLASSIFY_NUM          /* should always be the last one. */
 };
 
@@ -328,6 +329,9 @@ rte_acl_classify_alg(const struct rte_acl_ctx *ctx,
  *   New default classify algorithm for given ACL context.
  *   It is the caller responsibility to ensure that the value refers to the
  *   existing algorithm, and that it could be run on the given CPU.
+ *   RTE_ACL_CLASSIFY_DEFAULT selects the highest classify method
+ *   supported by both the build and the running CPU
+ *   (i.e. RTE_ACL_CLASSIFY_AVX512 on CPUs with AVX512F/BW support).
  * @return
  *   - -EINVAL if the parameters are invalid.
  *   - Zero if operation completed successfully.
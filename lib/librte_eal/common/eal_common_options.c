@@ -73,6 +73,7 @@ eal_long_options[] = {
 	{OPT_HELP,              0, NULL, OPT_HELP_NUM             },
 	{OPT_HUGE_DIR,          1, NULL, OPT_HUGE_DIR_NUM         },
 	{OPT_HUGE_UNLINK,       0, NULL, OPT_HUGE_UNLINK_NUM      },
+	{OPT_HUGE_PARALLEL,     1, NULL, OPT_HUGE_PARALLEL_NUM    },
 	{OPT_IOVA_MODE,	        1, NULL, OPT_IOVA_MODE_NUM        },
 	{OPT_LCORES,            1, NULL, OPT_LCORES_NUM           },
 	{OPT_LOG_LEVEL,         1, NULL, OPT_LOG_LEVEL_NUM        },
@@ -322,6 +323,7 @@ eal_reset_internal_config(struct internal_config *internal_cfg)
 		internal_cfg->hugepage_info[i].lock_descriptor = -1;
 	}
 	internal_cfg->base_virtaddr = 0;
+	internal_cfg->huge_parallel = 0;
 
 #ifdef LOG_DAEMON
 	internal_cfg->syslog_facility = LOG_DAEMON;
@@ -1884,6 +1886,22 @@ eal_check_common_options(struct internal_config *internal_cfg)
 				"with --"OPT_IN_MEMORY"\n");
 		return -1;
 	}
+	if (internal_cfg->huge_parallel && internal_cfg->legacy_mem) {
+		RTE_LOG(ERR, EAL, "Option --"OPT_HUGE_PARALLEL" is only "
+				"supported in non-legacy memory mode\n");
+		return -1;
+	}
+	if (internal_cfg->huge_parallel &&
+			internal_cfg->single_file_segments) {
+		RTE_LOG(ERR, EAL, "Option --"OPT_HUGE_PARALLEL" is not "
+				"compatible with --"OPT_SINGLE_FILE_SEGMENTS"\n");
+		return -1;
+	}
+	if (internal_cfg->huge_parallel && internal_cfg->no_hugetlbfs) {
+		RTE_LOG(ERR, EAL, "Option --"OPT_HUGE_PARALLEL" cannot "
+			"be specified together with --"OPT_NO_HUGE"\n");
+		return -1;
+	}
 	if (internal_cfg->legacy_mem && internal_cfg->match_allocations) {
 		RTE_LOG(ERR, EAL, "Option --"OPT_LEGACY_MEM" is not compatible "
 				"with --"OPT_MATCH_ALLOCATIONS"\n");
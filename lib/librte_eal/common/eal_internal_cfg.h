@@ -69,6 +69,10 @@ struct internal_config {
 	/**< true if storing all pages within single files (per-page-size,
 	 * per-node) non-legacy mode only.
 	 */
+	unsigned int huge_parallel;
+	/**< number of threads per socket mapping the hugepages at init,
+	 * 0 to map them from the initializing thread.
+	 */
 	volatile int syslog_facility;	  /**< facility passed to openlog() */
 	/** default interrupt mode for VFIO */
 	volatile enum rte_intr_mode vfio_intr_mode;
@@ -85,6 +85,8 @@ enum {
 	OPT_TELEMETRY_NUM,
 #define OPT_NO_TELEMETRY      "no-telemetry"
 	OPT_NO_TELEMETRY_NUM,
+#define OPT_HUGE_PARALLEL     "huge-parallel"
+	OPT_HUGE_PARALLEL_NUM,
 	OPT_LONG_MAX_NUM
 };
 
@@ -0,0 +1,270 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_eal.h>
+#include <rte_lcore.h>
+#include <rte_memory.h>
+
+#include "eal_memcfg.h"
+#include "eal_private.h"
+#include "malloc_elem.h"
+#include "malloc_heap.h"
+#include "malloc_cache.h"
+
+/* Size classes are RTE_CACHE_LINE_SIZE << 0 .. NUM_CLASSES - 1 */
+#define MALLOC_CACHE_NUM_CLASSES 5
+#define MALLOC_CACHE_MAX_SIZE \
+	(RTE_CACHE_LINE_SIZE << (MALLOC_CACHE_NUM_CLASSES - 1))
+
+/* Max number of elements per class and lcore, and refill/flush batch. */
+#define MALLOC_CACHE_SIZE 32
+#define MALLOC_CACHE_BATCH (MALLOC_CACHE_SIZE / 2)
+
+struct malloc_cache_class {
+	unsigned int len;
+	struct malloc_elem *objs[MALLOC_CACHE_SIZE];
+};
+
+struct malloc_lcore_cache {
+	/* heap of the lcore socket, NULL if nothing is cached */
+	struct malloc_heap *heap;
+	struct malloc_cache_class classes[MALLOC_CACHE_NUM_CLASSES];
+	uint64_t allocs;  /* allocations served by the cache */
+	uint64_t frees;   /* frees kept in the cache */
+	uint64_t refills; /* batches taken from the heap */
+	uint64_t flushes; /* batches given back to the heap */
+} __rte_cache_aligned;
+
+static struct malloc_lcore_cache lcore_caches[RTE_MAX_LCORE];
+
+static int cache_enabled;
+static void *cache_lcore_cb;
+
+static inline size_t
+class_size(unsigned int idx)
+{
+	return (size_t)RTE_CACHE_LINE_SIZE << idx;
+}
+
+/* give n elements of a class back to the heap, oldest first */
+static void
+cache_class_flush(struct malloc_lcore_cache *c, struct malloc_cache_class *cls,
+		unsigned int n)
+{
+	unsigned int i;
+
+	for (i = 0; i < n; i++)
+		cls->objs[i]->state = ELEM_BUSY;
+
+	if (malloc_heap_free_bulk(c->heap, cls->objs, n) < 0)
+		RTE_LOG(ERR, EAL, "Error: Invalid memory in malloc cache\n");
+
+	cls->len -= n;
+	memmove(cls->objs, &cls->objs[n], cls->len * sizeof(cls->objs[0]));
+	c->flushes++;
+}
+
+static void
+cache_flush(struct malloc_lcore_cache *c)
+{
+	unsigned int i;
+
+	if (c->heap == NULL)
+		return;
+
+	for (i = 0; i < MALLOC_CACHE_NUM_CLASSES; i++) {
+		struct malloc_cache_class *cls = &c->classes[i];
+
+		if (cls->len != 0)
+			cache_class_flush(c, cls, cls->len);
+	}
+	c->heap = NULL;
+}
+
+static void
+cache_lcore_uninit(unsigned int lcore_id, void *arg __rte_unused)
+{
+	/* called in the context of the thread releasing its lcore ID */
+	cache_flush(&lcore_caches[lcore_id]);
+}
+
+/* get the cache of the calling lcore, NULL if it cannot be used */
+static struct malloc_lcore_cache *
+lcore_cache_get(void)
+{
+	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
+	unsigned int lcore_id = rte_lcore_id();
+	struct malloc_lcore_cache *c;
+	int heap_id;
+
+	if (lcore_id >= RTE_MAX_LCORE)
+		return NULL;
+
+	c = &lcore_caches[lcore_id];
+	if (!__atomic_load_n(&cache_enabled, __ATOMIC_RELAXED)) {
+		/* caching was disabled, drop what is left */
+		cache_flush(c);
+		return NULL;
+	}
+
+	if (c->heap == NULL) {
+		heap_id = malloc_socket_to_heap_id(malloc_get_numa_socket());
+		if (heap_id < 0)
+			return NULL;
+		c->heap = &mcfg->malloc_heaps[heap_id];
+	}
+	return c;
+}
+
+int
+malloc_cache_enable(void)
+{
+	if (cache_lcore_cb == NULL) {
+		cache_lcore_cb = rte_lcore_callback_register("malloc_cache",
+				NULL, cache_lcore_uninit, NULL);
+		if (cache_lcore_cb == NULL) {
+			rte_errno = ENOMEM;
+			return -1;
+		}
+	}
+	__atomic_store_n(&cache_enabled, 1, __ATOMIC_RELAXED);
+	return 0;
+}
+
+void
+malloc_cache_disable(void)
+{
+	unsigned int lcore_id = rte_lcore_id();
+
+	__atomic_store_n(&cache_enabled, 0, __ATOMIC_RELAXED);
+	if (lcore_id < RTE_MAX_LCORE)
+		cache_flush(&lcore_caches[lcore_id]);
+}
+
+void
+malloc_cache_flush(void)
+{
+	unsigned int lcore_id = rte_lcore_id();
+
+	if (lcore_id < RTE_MAX_LCORE)
+		cache_flush(&lcore_caches[lcore_id]);
+}
+
+void *
+malloc_cache_alloc(size_t size, unsigned int align, int socket)
+{
+	void *objs[MALLOC_CACHE_BATCH];
+	struct malloc_lcore_cache *c;
+	struct malloc_cache_class *cls;
+	struct malloc_elem *elem;
+	unsigned int idx, i, n;
+
+	if (size > MALLOC_CACHE_MAX_SIZE || align > RTE_CACHE_LINE_SIZE)
+		return NULL;
+
+	c = lcore_cache_get();
+	if (c == NULL)
+		return NULL;
+	if (socket != SOCKET_ID_ANY && (unsigned int)socket !=
+			c->heap->socket_id)
+		return NULL;
+
+	/* smallest class holding the size */
+	idx = rte_log2_u32(RTE_CACHE_LINE_ROUNDUP(size) / RTE_CACHE_LINE_SIZE);
+	cls = &c->classes[idx];
+
+	if (cls->len == 0) {
+		n = malloc_heap_alloc_bulk(c->heap, class_size(idx), objs,
+				MALLOC_CACHE_BATCH);
+		if (n == 0)
+			return NULL;
+		for (i = 0; i < n; i++) {
+			elem = malloc_elem_from_data(objs[i]);
+			elem->state = ELEM_CACHED;
+			cls->objs[i] = elem;
+		}
+		cls->len = n;
+		c->refills++;
+	}
+
+	elem = cls->objs[--cls->len];
+	elem->state = ELEM_BUSY;
+	c->allocs++;
+
+	return RTE_PTR_ADD(elem, MALLOC_ELEM_HEADER_LEN);
+}
+
+int
+malloc_cache_free(struct malloc_elem *elem)
+{
+	struct malloc_lcore_cache *c;
+	struct malloc_cache_class *cls;
+	size_t data_len;
+	unsigned int idx;
+
+	c = lcore_cache_get();
+	if (c == NULL)
+		return -1;
+
+	/* leave invalid elements to the heap, which reports them */
+	if (!malloc_elem_cookies_ok(elem) || elem->state != ELEM_BUSY ||
+			elem->heap != c->heap || elem->pad != 0)
+		return -1;
+
+	data_len = elem->size - MALLOC_ELEM_OVERHEAD;
+	if (data_len >= 2 * MALLOC_CACHE_MAX_SIZE)
+		return -1;
+
+	/* largest class not bigger than the element */
+	idx = rte_fls_u32(data_len / RTE_CACHE_LINE_SIZE) - 1;
+	cls = &c->classes[idx];
+
+	if (cls->len == MALLOC_CACHE_SIZE)
+		cache_class_flush(c, cls, MALLOC_CACHE_BATCH);
+
+	/* keep the heap guarantee that free memory is poisoned or zeroed */
+	memset(RTE_PTR_ADD(elem, MALLOC_ELEM_HEADER_LEN), MALLOC_POISON,
+			data_len);
+	elem->state = ELEM_CACHED;
+	cls->objs[cls->len++] = elem;
+	c->frees++;
+
+	return 0;
+}
+
+void
+malloc_cache_dump_stats(FILE *f)
+{
+	unsigned int lcore_id, i, count;
+	size_t bytes;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		const struct malloc_lcore_cache *c = &lcore_caches[lcore_id];
+
+		if (c->allocs == 0 && c->frees == 0)
+			continue;
+
+		count = 0;
+		bytes = 0;
+		for (i = 0; i < MALLOC_CACHE_NUM_CLASSES; i++) {
+			count += c->classes[i].len;
+			bytes += c->classes[i].len * class_size(i);
+		}
+
+		fprintf(f, "Lcore cache:%u\n", lcore_id);
+		fprintf(f, "\tCached_count:%u,\n", count);
+		fprintf(f, "\tCached_size:%zu,\n", bytes);
+		fprintf(f, "\tAlloc_count:%" PRIu64 ",\n", c->allocs);
+		fprintf(f, "\tFree_count:%" PRIu64 ",\n", c->frees);
+		fprintf(f, "\tRefill_count:%" PRIu64 ",\n", c->refills);
+		fprintf(f, "\tFlush_count:%" PRIu64 ",\n", c->flushes);
+	}
+}
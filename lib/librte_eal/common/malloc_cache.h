@@ -0,0 +1,49 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#ifndef MALLOC_CACHE_H_
+#define MALLOC_CACHE_H_
+
+#include <stdio.h>
+
+/* dummy definition, for pointers */
+struct malloc_elem;
+
+/*
+ * Per-lcore caches of small elements, in front of the malloc heaps.
+ *
+ * Each lcore keeps a few elements of each size class, taken from the heap
+ * of its own socket. The caches are refilled from and returned to the heap
+ * in batches, so that most small allocations do not take the heap lock.
+ * They are local to the process, and only used by threads with an lcore ID.
+ */
+
+int
+malloc_cache_enable(void);
+
+void
+malloc_cache_disable(void);
+
+/* Give the elements cached by the calling lcore back to the heap. */
+void
+malloc_cache_flush(void);
+
+/*
+ * Allocate from the cache of the calling lcore. Returns NULL if the request
+ * cannot be served by the cache, the heap must then be used.
+ */
+void *
+malloc_cache_alloc(size_t size, unsigned int align, int socket);
+
+/*
+ * Put a busy element in the cache of the calling lcore. Returns -1 if the
+ * element is not cacheable, it must then be freed to the heap.
+ */
+int
+malloc_cache_free(struct malloc_elem *elem);
+
+void
+malloc_cache_dump_stats(FILE *f);
+
+#endif /* MALLOC_CACHE_H_ */
@@ -24,17 +24,6 @@
 #include "malloc_elem.h"
 #include "malloc_heap.h"
 
-/*
- * If debugging is enabled, freed memory is set to poison value
- * to catch buggy programs. Otherwise, freed memory is set to zero
- * to avoid having to zero in zmalloc
- */
-#ifdef RTE_MALLOC_DEBUG
-#define MALLOC_POISON	       0x6b
-#else
-#define MALLOC_POISON	       0
-#endif
-
 size_t
 malloc_elem_find_max_iova_contig(struct malloc_elem *elem, size_t align)
 {
@@ -677,6 +666,8 @@ elem_state_to_str(enum elem_state state)
 		return "BUSY";
 	case ELEM_FREE:
 		return "FREE";
+	case ELEM_CACHED:
+		return "CACHED";
 	}
 	return "ERROR";
 }
@@ -737,6 +737,26 @@ malloc_heap_alloc(const char *type, size_t size, int socket_arg,
 	return NULL;
 }
 
+unsigned int
+malloc_heap_alloc_bulk(struct malloc_heap *heap, size_t size, void **objs,
+		unsigned int n)
+{
+	unsigned int i;
+
+	rte_spinlock_lock(&(heap->lock));
+
+	/* only use memory already in the heap, do not expand it */
+	for (i = 0; i < n; i++) {
+		objs[i] = heap_alloc(heap, NULL, size, 0, 1, 0, false);
+		if (objs[i] == NULL)
+			break;
+	}
+
+	rte_spinlock_unlock(&(heap->lock));
+
+	return i;
+}
+
 static void *
 heap_alloc_biggest_on_heap_id(const char *type, unsigned int heap_id,
 		unsigned int flags, size_t align, bool contig)
@@ -825,52 +845,49 @@ malloc_heap_free_pages(void *aligned_start, size_t aligned_len)
 	return 0;
 }
 
-int
-malloc_heap_free(struct malloc_elem *elem)
+/*
+ * Free an element and give the pages it leaves unused back to the system.
+ * Must be called with the heap lock held.
+ */
+static void
+heap_free(struct malloc_elem *elem)
 {
 	struct malloc_heap *heap;
 	void *start, *aligned_start, *end, *aligned_end;
 	size_t len, aligned_len, page_sz;
 	struct rte_memseg_list *msl;
 	unsigned int i, n_segs, before_space, after_space;
-	int ret;
 	const struct internal_config *internal_conf =
 		eal_get_internal_configuration();
 
-	if (!malloc_elem_cookies_ok(elem) || elem->state != ELEM_BUSY)
-		return -1;
-
 	/* elem may be merged with previous element, so keep heap address */
 	heap = elem->heap;
 	msl = elem->msl;
 	page_sz = (size_t)msl->page_sz;
 
-	rte_spinlock_lock(&(heap->lock));
-
 	/* mark element as free */
 	elem->state = ELEM_FREE;
 
 	elem = malloc_elem_free(elem);
 
 	/* anything after this is a bonus */
-	ret = 0;
 
 	/* ...of which we can't avail if we are in legacy mode, or if this is an
 	 * externally allocated segment.
 	 */
 	if (internal_conf->legacy_mem || (msl->external > 0))
-		goto free_unlock;
+		return;
 
 	/* check if we can free any memory back to the system */
 	if (elem->size < page_sz)
-		goto free_unlock;
+		return;
 
 	/* if user requested to match allocations, the sizes must match - if not,
 	 * we will defer freeing these hugepages until the entire original allocation
 	 * can be freed
 	 */
 	if (internal_conf->match_allocations && elem->size != elem->orig_size)
-		goto free_unlock;
+		return;
 
 	/* probably, but let's make sure, as we may not be using up full page */
 	start = elem;
@@ -883,7 +900,7 @@ malloc_heap_free(struct malloc_elem *elem)
 
 	/* can't free anything */
 	if (aligned_len < page_sz)
-		goto free_unlock;
+		return;
 
 	/* we can free something. however, some of these pages may be marked as
 	 * unfreeable, so also check that as well
@@ -905,7 +922,7 @@ malloc_heap_free(struct malloc_elem *elem)
 
 	/* check if we can still free some pages */
 	if (n_segs == 0)
-		goto free_unlock;
+		return;
 
 	/* We're not done yet. We also have to check if by freeing space we will
 	 * be leaving free elements that are too small to store new elements.
@@ -920,7 +937,7 @@ malloc_heap_free(struct malloc_elem *elem)
 		 * move the start forward by one page.
 		 */
 		if (n_segs == 1)
-			goto free_unlock;
+			return;
 
 		/* move start */
 		aligned_start = RTE_PTR_ADD(aligned_start, page_sz);
@@ -933,7 +950,7 @@ malloc_heap_free(struct malloc_elem *elem)
 		 * move the end backwards by one page.
 		 */
 		if (n_segs == 1)
-			goto free_unlock;
+			return;
 
 		/* move end */
 		aligned_end = RTE_PTR_SUB(aligned_end, page_sz);
@@ -999,9 +1016,45 @@ malloc_heap_free(struct malloc_elem *elem)
 		msl->socket_id, aligned_len >> 20ULL);
 
 	rte_mcfg_mem_write_unlock();
-free_unlock:
+}
+
+int
+malloc_heap_free(struct malloc_elem *elem)
+{
+	struct malloc_heap *heap;
+
+	if (!malloc_elem_cookies_ok(elem) || elem->state != ELEM_BUSY)
+		return -1;
+
+	heap = elem->heap;
+
+	rte_spinlock_lock(&(heap->lock));
+
+	heap_free(elem);
+
 	rte_spinlock_unlock(&(heap->lock));
-	return ret;
+	return 0;
+}
+
+int
+malloc_heap_free_bulk(struct malloc_heap *heap, struct malloc_elem **elems,
+		unsigned int n)
+{
+	unsigned int i;
+
+	for (i = 0; i < n; i++)
+		if (!malloc_elem_cookies_ok(elems[i]) ||
+				elems[i]->state != ELEM_BUSY ||
+				elems[i]->heap != heap)
+			return -1;
+
+	rte_spinlock_lock(&(heap->lock));
+
+	for (i = 0; i < n; i++)
+		heap_free(elems[i]);
+
+	rte_spinlock_unlock(&(heap->lock));
+	return 0;
 }
 
 int
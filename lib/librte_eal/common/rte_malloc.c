@@ -26,6 +26,7 @@
 #include <rte_malloc.h>
 #include "malloc_elem.h"
 #include "malloc_heap.h"
+#include "malloc_cache.h"
 #include "eal_memalloc.h"
 #include "eal_memcfg.h"
 #include "eal_private.h"
@@ -35,11 +36,16 @@
 static void
 mem_free(void *addr, const bool trace_ena)
 {
+	struct malloc_elem *elem;
+
 	if (trace_ena)
 		rte_eal_trace_mem_free(addr);
 
 	if (addr == NULL) return;
-	if (malloc_heap_free(malloc_elem_from_data(addr)) < 0)
+	elem = malloc_elem_from_data(addr);
+	if (malloc_cache_free(elem) == 0)
+		return;
+	if (malloc_heap_free(elem) < 0)
 		RTE_LOG(ERR, EAL, "Error: Invalid memory\n");
 }
 
@@ -74,8 +80,10 @@ malloc_socket(const char *type, size_t size, unsigned int align,
 				!rte_eal_has_hugepages())
 		socket_arg = SOCKET_ID_ANY;
 
-	ptr = malloc_heap_alloc(type, size, socket_arg, 0,
-			align == 0 ? 1 : align, 0, false);
+	ptr = malloc_cache_alloc(size, align, socket_arg);
+	if (ptr == NULL)
+		ptr = malloc_heap_alloc(type, size, socket_arg, 0,
+				align == 0 ? 1 : align, 0, false);
 
 	if (trace_ena)
 		rte_eal_trace_mem_malloc(type, size, align, socket_arg, ptr);
@@ -340,9 +348,28 @@ rte_malloc_dump_stats(FILE *f, __rte_unused const char *type)
 		fprintf(f, "\tAlloc_count:%u,\n",sock_stats.alloc_count);
 		fprintf(f, "\tFree_count:%u,\n", sock_stats.free_count);
 	}
+	malloc_cache_dump_stats(f);
 	return;
 }
 
+int
+rte_malloc_lcore_cache_enable(void)
+{
+	return malloc_cache_enable();
+}
+
+void
+rte_malloc_lcore_cache_disable(void)
+{
+	malloc_cache_disable();
+}
+
+void
+rte_malloc_lcore_cache_flush(void)
+{
+	malloc_cache_flush();
+}
+
 /*
  * TODO: Set limit to memory that can be allocated to memory type
  */
@@ -34,6 +34,9 @@
 #define RUNSTATE_STOPPED 0
 #define RUNSTATE_RUNNING 1
 
+/* max number of loops an idle service is skipped in adaptive mode */
+#define SERVICE_BACKOFF_MAX 64
+
 /* internal representation of a service */
 struct rte_service_spec_impl {
 	/* public part of the struct */
@@ -57,6 +60,7 @@ struct rte_service_spec_impl {
 	 */
 	uint32_t num_mapped_cores;
 	uint64_t calls;
+	uint64_t idle_calls;
 	uint64_t cycles_spent;
 } __rte_cache_aligned;
 
@@ -66,9 +70,16 @@ struct core_state {
 	uint64_t service_mask;
 	uint8_t runstate; /* running or stopped */
 	uint8_t is_service_core; /* set if core is currently a service core */
+	uint8_t sched_mode; /* RTE_SERVICE_SCHED_* */
 	uint8_t service_active_on_lcore[RTE_SERVICE_NUM_MAX];
 	uint64_t loops;
 	uint64_t calls_per_service[RTE_SERVICE_NUM_MAX];
+	/* adaptive mode: loops to wait between two calls of an idle service,
+	 * doubled each time the service reports no work, and loops left to
+	 * wait before its next call.
+	 */
+	uint8_t backoff[RTE_SERVICE_NUM_MAX];
+	uint8_t skip[RTE_SERVICE_NUM_MAX];
 } __rte_cache_aligned;
 
 static uint32_t rte_service_count;
@@ -363,16 +374,34 @@ service_runner_do_callback(struct rte_service_spec_impl *s,
 			   struct core_state *cs, uint32_t service_idx)
 {
 	void *userdata = s->spec.callback_userdata;
+	int32_t ret;
 
 	if (service_stats_enabled(s)) {
 		uint64_t start = rte_rdtsc();
-		s->spec.callback(userdata);
+		ret = s->spec.callback(userdata);
 		uint64_t end = rte_rdtsc();
 		s->cycles_spent += end - start;
 		cs->calls_per_service[service_idx]++;
 		s->calls++;
+		if (ret == -EAGAIN)
+			s->idle_calls++;
 	} else
-		s->spec.callback(userdata);
+		ret = s->spec.callback(userdata);
+
+	if (__atomic_load_n(&cs->sched_mode, __ATOMIC_RELAXED) !=
+			RTE_SERVICE_SCHED_ADAPTIVE)
+		return;
+
+	/* back off exponentially while the service has nothing to do */
+	if (ret == -EAGAIN) {
+		uint8_t backoff = cs->backoff[service_idx];
+
+		backoff = backoff == 0 ? 1 :
+			RTE_MIN(backoff * 2, SERVICE_BACKOFF_MAX);
+		cs->backoff[service_idx] = backoff;
+		cs->skip[service_idx] = backoff;
+	} else
+		cs->backoff[service_idx] = 0;
 }
 
 
@@ -464,10 +493,17 @@ service_runner_func(void *arg)
 	while (__atomic_load_n(&cs->runstate, __ATOMIC_ACQUIRE) ==
 			RUNSTATE_RUNNING) {
 		const uint64_t service_mask = cs->service_mask;
+		const int adaptive = __atomic_load_n(&cs->sched_mode,
+			__ATOMIC_RELAXED) == RTE_SERVICE_SCHED_ADAPTIVE;
 
 		for (i = 0; i < RTE_SERVICE_NUM_MAX; i++) {
 			if (!service_valid(i))
 				continue;
+			/* idle services are skipped for a few loops */
+			if (adaptive && cs->skip[i] != 0) {
+				cs->skip[i]--;
+				continue;
+			}
 			/* return value ignored as no change to code flow */
 			service_run(i, cs, service_mask, service_get(i), 1);
 		}
@@ -664,6 +700,10 @@ rte_service_lcore_add(uint32_t lcore)
 
 	/* ensure that after adding a core the mask and state are defaults */
 	lcore_states[lcore].service_mask = 0;
+	lcore_states[lcore].sched_mode = RTE_SERVICE_SCHED_ROUND_ROBIN;
+	memset(lcore_states[lcore].backoff, 0,
+		sizeof(lcore_states[lcore].backoff));
+	memset(lcore_states[lcore].skip, 0, sizeof(lcore_states[lcore].skip));
 	/* Use store-release memory order here to synchronize with
 	 * load-acquire in runstate read functions.
 	 */
@@ -697,6 +737,23 @@ rte_service_lcore_del(uint32_t lcore)
 	return 0;
 }
 
+int32_t
+rte_service_lcore_sched_mode_set(uint32_t lcore, uint32_t mode)
+{
+	if (lcore >= RTE_MAX_LCORE || (mode != RTE_SERVICE_SCHED_ROUND_ROBIN &&
+			mode != RTE_SERVICE_SCHED_ADAPTIVE))
+		return -EINVAL;
+
+	struct core_state *cs = &lcore_states[lcore];
+	if (!cs->is_service_core)
+		return -EINVAL;
+
+	/* the service core picks the new mode on its next loop */
+	__atomic_store_n(&cs->sched_mode, mode, __ATOMIC_RELAXED);
+
+	return 0;
+}
+
 int32_t
 rte_service_lcore_start(uint32_t lcore)
 {
@@ -768,6 +825,26 @@ rte_service_lcore_stop(uint32_t lcore)
 	return 0;
 }
 
+/* smallest backoff of the service on the adaptive cores running it */
+static uint64_t
+service_backoff(uint32_t id)
+{
+	uint64_t sid_mask = UINT64_C(1) << id;
+	uint64_t backoff = UINT64_MAX;
+	uint32_t i;
+
+	for (i = 0; i < RTE_MAX_LCORE; i++) {
+		struct core_state *cs = &lcore_states[i];
+
+		if (!cs->is_service_core || !(cs->service_mask & sid_mask) ||
+				cs->sched_mode != RTE_SERVICE_SCHED_ADAPTIVE)
+			continue;
+		backoff = RTE_MIN(backoff, (uint64_t)cs->backoff[id]);
+	}
+
+	return backoff == UINT64_MAX ? 0 : backoff;
+}
+
 int32_t
 rte_service_attr_get(uint32_t id, uint32_t attr_id, uint64_t *attr_value)
 {
@@ -784,6 +861,15 @@ rte_service_attr_get(uint32_t id, uint32_t attr_id, uint64_t *attr_value)
 	case RTE_SERVICE_ATTR_CALL_COUNT:
 		*attr_value = s->calls;
 		return 0;
+	case RTE_SERVICE_ATTR_IDLE_CALL_COUNT:
+		*attr_value = s->idle_calls;
+		return 0;
+	case RTE_SERVICE_ATTR_IDLE_RATIO:
+		*attr_value = s->calls == 0 ? 0 : s->idle_calls * 1000 / s->calls;
+		return 0;
+	case RTE_SERVICE_ATTR_BACKOFF:
+		*attr_value = service_backoff(id);
+		return 0;
 	default:
 		return -EINVAL;
 	}
@@ -822,16 +908,17 @@ service_dump_one(FILE *f, struct rte_service_spec_impl *s, uint32_t reset)
 	if (reset) {
 		s->cycles_spent = 0;
 		s->calls = 0;
+		s->idle_calls = 0;
 		return;
 	}
 
 	if (f == NULL)
 		return;
 
-	fprintf(f, "  %s: stats %d\tcalls %"PRIu64"\tcycles %"
+	fprintf(f, "  %s: stats %d\tcalls %"PRIu64"\tidle %"PRIu64"\tcycles %"
 			PRIu64"\tavg: %"PRIu64"\n",
 			s->spec.name, service_stats_enabled(s), s->calls,
-			s->cycles_spent, s->cycles_spent / calls);
+			s->idle_calls, s->cycles_spent, s->cycles_spent / calls);
 }
 
 int32_t
@@ -11,6 +11,10 @@
  * Functions for vectorised implementation of memcpy().
  */
 
+#include <stddef.h>
+
+#include <rte_compat.h>
+
 /**
  * Copy 16 bytes from one location to another using optimised
  * instructions. The locations should not overlap.
@@ -109,4 +113,30 @@ rte_memcpy(void *dst, const void *src, size_t n);
 
 #endif /* __DOXYGEN__ */
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Copy bytes from one location to another with non-temporal stores.
+ * The locations must not overlap.
+ *
+ * The destination is written with streaming stores which bypass the
+ * cache, so that copying a large buffer that the calling core does not
+ * read again does not evict the working set of the other cores from the
+ * shared cache. Copies shorter than a few cache lines are done with
+ * rte_memcpy(). The best kernel supported by the CPU is selected at init.
+ *
+ * @param dst
+ *   Pointer to the destination of the data.
+ * @param src
+ *   Pointer to the source data.
+ * @param n
+ *   Number of bytes to copy.
+ * @return
+ *   Pointer to the destination data.
+ */
+__rte_experimental
+void *
+rte_memcpy_nt(void *dst, const void *src, size_t n);
+
 #endif /* _RTE_MEMCPY_H_ */
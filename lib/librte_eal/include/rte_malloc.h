@@ -510,6 +510,56 @@ rte_malloc_heap_socket_is_external(int socket_id);
 void
 rte_malloc_dump_stats(FILE *f, const char *type);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Enable the per-lcore caches of small objects.
+ *
+ * When enabled, each lcore keeps a few free objects of up to
+ * 16 cache lines, in a set of size classes, taken from the heap of its
+ * socket. rte_malloc() and rte_free() calls for such objects are served
+ * from the cache of the calling lcore without taking the heap lock, and
+ * the cache is refilled from and given back to the heap in batches.
+ * Only threads having an lcore ID use a cache, and only for allocations
+ * with default or cache line alignment, on any socket or the lcore socket.
+ *
+ * Cached objects are accounted as allocated in the heap statistics.
+ * The cache of an lcore is given back to the heap when its thread is
+ * unregistered, or by calling rte_malloc_lcore_cache_flush() from it.
+ * The caches are per process.
+ *
+ * @return
+ *   - 0 on success
+ *   - -1 on error, with rte_errno set to ENOMEM
+ */
+__rte_experimental
+int
+rte_malloc_lcore_cache_enable(void);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Disable the per-lcore caches of small objects.
+ *
+ * The cache of the calling lcore is flushed immediately, the cache of
+ * other lcores is flushed on their next call to rte_malloc() or rte_free().
+ */
+__rte_experimental
+void
+rte_malloc_lcore_cache_disable(void);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Give all objects cached by the calling lcore back to the heap.
+ */
+__rte_experimental
+void
+rte_malloc_lcore_cache_flush(void);
+
 /**
  * Dump contents of all malloc heaps to a file.
  *
@@ -32,6 +32,7 @@ extern "C" {
 #include <sys/queue.h>
 
 #include <rte_config.h>
+#include <rte_compat.h>
 #include <rte_lcore.h>
 
 #define RTE_SERVICE_NAME_MAX 32
@@ -261,6 +262,38 @@ int32_t rte_service_lcore_start(uint32_t lcore_id);
  */
 int32_t rte_service_lcore_stop(uint32_t lcore_id);
 
+/** Service core scheduling mode: run every mapped service on each loop. */
+#define RTE_SERVICE_SCHED_ROUND_ROBIN 0
+
+/**
+ * Service core scheduling mode: skip idle services for some loops.
+ *
+ * A service returning -EAGAIN is considered idle, and is skipped for 1, 2, 4
+ * and up to 64 loops of the service core while it keeps returning -EAGAIN.
+ * It is called on each loop again as soon as it reports some work, so the
+ * service core spends its time in the busy services.
+ */
+#define RTE_SERVICE_SCHED_ADAPTIVE 1
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Set the scheduling mode of a service core.
+ *
+ * The default mode of a service core is *RTE_SERVICE_SCHED_ROUND_ROBIN*.
+ * The mode can be changed while the core is running. The resulting policy
+ * for each service is available as the *RTE_SERVICE_ATTR_BACKOFF* and
+ * *RTE_SERVICE_ATTR_IDLE_RATIO* attributes.
+ *
+ * @param lcore Id of the service core.
+ * @param mode One of the RTE_SERVICE_SCHED_* modes.
+ * @retval 0 Success
+ * @retval -EINVAL Invalid *lcore* or *mode*, or *lcore* is not a service core
+ */
+__rte_experimental
+int32_t rte_service_lcore_sched_mode_set(uint32_t lcore, uint32_t mode);
+
 /**
  * Adds lcore to the list of service cores.
  *
@@ -370,6 +403,25 @@ int32_t rte_service_dump(FILE *f, uint32_t id);
  */
 #define RTE_SERVICE_ATTR_CALL_COUNT 1
 
+/**
+ * Returns the count of invocations of this service function which returned
+ * -EAGAIN, reporting that there was no work to do
+ */
+#define RTE_SERVICE_ATTR_IDLE_CALL_COUNT 2
+
+/**
+ * Returns the ratio of idle invocations over all invocations of this service
+ * function, in thousandths
+ */
+#define RTE_SERVICE_ATTR_IDLE_RATIO 3
+
+/**
+ * Returns the number of loops the service is currently skipped for by the
+ * service cores in *RTE_SERVICE_SCHED_ADAPTIVE* mode, the smallest value if
+ * several cores run the service. 0 means the service is called on each loop.
+ */
+#define RTE_SERVICE_ATTR_BACKOFF 4
+
 /**
  * Get an attribute from a service.
  *
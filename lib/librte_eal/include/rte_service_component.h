@@ -19,6 +19,11 @@ extern "C" {
 
 /**
  * Signature of callback function to run a service.
+ *
+ * A service returns -EAGAIN when an iteration found no work to do, such as
+ * no packets or events to process. Service cores in the adaptive scheduling
+ * mode run such services less often, see rte_service_lcore_sched_mode_set().
+ * Any other value is considered an iteration that did useful work.
  */
 typedef int32_t (*rte_service_func)(void *args);
 
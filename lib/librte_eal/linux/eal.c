@@ -22,6 +22,7 @@
 #include <sys/mman.h>
 #include <sys/queue.h>
 #include <sys/stat.h>
+#include <time.h>
 #if defined(RTE_ARCH_X86)
 #include <sys/io.h>
 #endif
@@ -548,6 +549,7 @@ eal_usage(const char *prgname)
 	       "  --"OPT_LEGACY_MEM"        Legacy memory mode (no dynamic allocation, contiguous segments)\n"
 	       "  --"OPT_SINGLE_FILE_SEGMENTS" Put all hugepage memory in single files\n"
 	       "  --"OPT_MATCH_ALLOCATIONS" Free hugepages exactly as allocated\n"
+	       "  --"OPT_HUGE_PARALLEL"=<int> Map hugepages at init with <int> threads per socket\n"
 	       "\n");
 	/* Allow the application to print its usage message too if hook is set */
 	if (hook) {
@@ -639,6 +641,23 @@ eal_parse_vfio_vf_token(const char *vf_token)
 	return -1;
 }
 
+static int
+eal_parse_huge_parallel(const char *arg)
+{
+	struct internal_config *cfg = eal_get_internal_configuration();
+	unsigned long nb_threads;
+	char *end = NULL;
+
+	errno = 0;
+	nb_threads = strtoul(arg, &end, 10);
+	if (errno != 0 || end == arg || *end != '\0' ||
+			nb_threads > RTE_MAX_LCORE)
+		return -1;
+
+	cfg->huge_parallel = nb_threads;
+	return 0;
+}
+
 /* Parse the arguments for --log-level only */
 static void
 eal_log_level_parse(int argc, char **argv)
@@ -815,6 +834,16 @@ eal_parse_args(int argc, char **argv)
 			internal_conf->match_allocations = 1;
 			break;
 
+		case OPT_HUGE_PARALLEL_NUM:
+			if (eal_parse_huge_parallel(optarg) < 0) {
+				RTE_LOG(ERR, EAL, "invalid parameters for --"
+						OPT_HUGE_PARALLEL "\n");
+				eal_usage(prgname);
+				ret = -1;
+				goto out;
+			}
+			break;
+
 		default:
 			if (opt < OPT_LONG_MIN_NUM && isprint(opt)) {
 				RTE_LOG(ERR, EAL, "Option %c is not supported "
@@ -927,6 +956,29 @@ static void rte_eal_init_alert(const char *msg)
 	RTE_LOG(ERR, EAL, "%s\n", msg);
 }
 
+/* start of rte_eal_init() and of its current phase */
+static struct timespec eal_init_ts;
+static struct timespec eal_init_phase_ts;
+
+static double
+eal_init_elapsed_ms(const struct timespec *from, const struct timespec *to)
+{
+	return (to->tv_sec - from->tv_sec) * 1E3 +
+		(to->tv_nsec - from->tv_nsec) / 1E6;
+}
+
+/* report the time taken by an initialization phase and start the next one */
+static void
+eal_init_phase_done(const char *phase)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	RTE_LOG(DEBUG, EAL, "Init phase '%s' took %.3f ms\n", phase,
+		eal_init_elapsed_ms(&eal_init_phase_ts, &now));
+	eal_init_phase_ts = now;
+}
+
 /*
  * On Linux 3.6+, even if VFIO is not loaded, whenever IOMMU is enabled in the
  * BIOS and in the kernel, /sys/kernel/iommu_groups path will contain kernel
@@ -983,6 +1035,9 @@ rte_eal_init(int argc, char **argv)
 		return -1;
 	}
 
+	clock_gettime(CLOCK_MONOTONIC, &eal_init_ts);
+	eal_init_phase_ts = eal_init_ts;
+
 	p = strrchr(argv[0], '/');
 	strlcpy(logid, p ? p + 1 : argv[0], sizeof(logid));
 	thread_id = pthread_self();
@@ -1028,6 +1083,8 @@ rte_eal_init(int argc, char **argv)
 		return -1;
 	}
 
+	eal_init_phase_done("options");
+
 	if (rte_config_init() < 0) {
 		rte_eal_init_alert("Cannot init config");
 		return -1;
@@ -1061,6 +1118,8 @@ rte_eal_init(int argc, char **argv)
 		return -1;
 	}
 
+	eal_init_phase_done("config");
+
 	if (rte_bus_scan()) {
 		rte_eal_init_alert("Cannot scan the buses for devices");
 		rte_errno = ENODEV;
@@ -1130,6 +1189,8 @@ rte_eal_init(int argc, char **argv)
 	RTE_LOG(INFO, EAL, "Selected IOVA mode '%s'\n",
 		rte_eal_iova_mode() == RTE_IOVA_PA ? "PA" : "VA");
 
+	eal_init_phase_done("bus scan");
+
 	if (internal_conf->no_hugetlbfs == 0) {
 		/* rte_config isn't initialized yet */
 		ret = internal_conf->process_type == RTE_PROC_PRIMARY ?
@@ -1143,6 +1204,8 @@ rte_eal_init(int argc, char **argv)
 		}
 	}
 
+	eal_init_phase_done("hugepage info");
+
 	if (internal_conf->memory == 0 && internal_conf->force_sockets == 0) {
 		if (internal_conf->no_hugetlbfs)
 			internal_conf->memory = MEMSIZE_IF_NO_HUGE_PAGE;
@@ -1193,6 +1256,8 @@ rte_eal_init(int argc, char **argv)
 	/* the directories are locked during eal_hugepage_info_init */
 	eal_hugedirs_unlock();
 
+	eal_init_phase_done("memory");
+
 	if (rte_eal_malloc_heap_init() < 0) {
 		rte_eal_init_alert("Cannot init malloc heap");
 		rte_errno = ENODEV;
@@ -1211,6 +1276,8 @@ rte_eal_init(int argc, char **argv)
 		return -1;
 	}
 
+	eal_init_phase_done("malloc heap and timers");
+
 	eal_check_mem_on_local_socket();
 
 	if (pthread_setaffinity_np(pthread_self(), sizeof(rte_cpuset_t),
@@ -1268,6 +1335,8 @@ rte_eal_init(int argc, char **argv)
 	rte_eal_mp_remote_launch(sync_func, NULL, SKIP_MASTER);
 	rte_eal_mp_wait_lcore();
 
+	eal_init_phase_done("lcores");
+
 	/* initialize services so vdevs register service during bus_probe. */
 	ret = rte_service_init();
 	if (ret) {
@@ -1283,6 +1352,8 @@ rte_eal_init(int argc, char **argv)
 		return -1;
 	}
 
+	eal_init_phase_done("device probe");
+
 #ifdef VFIO_PRESENT
 	/* Register mp action after probe() so that we got enough info */
 	if (rte_vfio_is_enabled("vfio") && vfio_mp_sync_setup() < 0)
@@ -1324,6 +1395,10 @@ rte_eal_init(int argc, char **argv)
 			RTE_LOG(NOTICE, EAL, "%s\n", error_str);
 	}
 
+	eal_init_phase_done("services and telemetry");
+	RTE_LOG(INFO, EAL, "Initialization took %.3f ms\n",
+		eal_init_elapsed_ms(&eal_init_ts, &eal_init_phase_ts));
+
 	eal_mcfg_complete();
 
 	return fctret;
@@ -16,6 +16,8 @@
 #include <sys/queue.h>
 #include <sys/file.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <time.h>
 #include <limits.h>
 #include <fcntl.h>
 #include <sys/ioctl.h>
@@ -39,12 +41,14 @@
 #include <rte_errno.h>
 #include <rte_memory.h>
 #include <rte_spinlock.h>
+#include <rte_per_lcore.h>
 
 #include "eal_filesystem.h"
 #include "eal_internal_cfg.h"
 #include "eal_memalloc.h"
 #include "eal_memcfg.h"
 #include "eal_private.h"
+#include "eal_thread.h"
 
 const int anonymous_hugepages_supported =
 #ifdef MAP_HUGE_SHIFT
@@ -105,11 +109,12 @@ static struct {
 /** local copy of a memory map, used to synchronize memory hotplug in MP */
 static struct rte_memseg_list local_memsegs[RTE_MAX_MEMSEG_LISTS];
 
-static sigjmp_buf huge_jmpenv;
+/* per thread, as SIGBUS is delivered to the thread faulting the page */
+static RTE_DEFINE_PER_LCORE(sigjmp_buf, huge_jmpenv);
 
 static void __rte_unused huge_sigbus_handler(int signo __rte_unused)
 {
-	siglongjmp(huge_jmpenv, 1);
+	siglongjmp(RTE_PER_LCORE(huge_jmpenv), 1);
 }
 
 /* Put setjmp into a wrap method to avoid compiling error. Any non-volatile,
@@ -118,7 +123,7 @@ static void __rte_unused huge_sigbus_handler(int signo __rte_unused)
  */
 static int __rte_unused huge_wrap_sigsetjmp(void)
 {
-	return sigsetjmp(huge_jmpenv, 1);
+	return sigsetjmp(RTE_PER_LCORE(huge_jmpenv), 1);
 }
 
 static struct sigaction huge_action_old;
@@ -765,6 +770,141 @@ struct alloc_walk_param {
 	int socket;
 	bool exact;
 };
+
+/* segments of a memseg list mapped by several threads */
+struct alloc_par_param {
+	struct rte_memseg_list *msl;
+	struct hugepage_info *hi;
+	unsigned int msl_idx;
+	int start_idx;
+	int socket;
+	rte_cpuset_t cpuset; /**< CPUs of the socket, may be empty */
+	unsigned int next; /**< next segment to map */
+	unsigned int limit; /**< first segment which could not be mapped */
+};
+
+static void
+alloc_seg_par_loop(struct alloc_par_param *p)
+{
+	struct rte_memseg *cur;
+	unsigned int i, limit;
+	void *map_addr;
+	int seg_idx;
+
+	for (;;) {
+		i = __atomic_fetch_add(&p->next, 1, __ATOMIC_RELAXED);
+		limit = __atomic_load_n(&p->limit, __ATOMIC_RELAXED);
+		if (i >= limit)
+			break;
+
+		seg_idx = p->start_idx + i;
+		cur = rte_fbarray_get(&p->msl->memseg_arr, seg_idx);
+		map_addr = RTE_PTR_ADD(p->msl->base_va,
+				(size_t)seg_idx * p->msl->page_sz);
+
+		if (alloc_seg(cur, map_addr, p->socket, p->hi, p->msl_idx,
+				seg_idx) == 0)
+			continue;
+
+		/* no segment is mapped past the first failure */
+		while (i < limit && !__atomic_compare_exchange_n(&p->limit,
+				&limit, i, false, __ATOMIC_RELAXED,
+				__ATOMIC_RELAXED))
+			;
+	}
+}
+
+static void *
+alloc_seg_par_thread(void *arg)
+{
+	struct alloc_par_param *p = arg;
+
+	/* fault, hence zero, the pages from a CPU of their socket */
+	if (CPU_COUNT(&p->cpuset) != 0 &&
+			pthread_setaffinity_np(pthread_self(),
+				sizeof(p->cpuset), &p->cpuset) != 0)
+		RTE_LOG(DEBUG, EAL, "%s(): cannot set affinity\n", __func__);
+
+	alloc_seg_par_loop(p);
+	return NULL;
+}
+
+/*
+ * Map need segments of a memseg list from start_idx with
+ * internal_config.huge_parallel threads. Returns the number of segments
+ * mapped contiguously from start_idx, the segments mapped past a failure
+ * are unmapped.
+ */
+static unsigned int
+alloc_seg_parallel(struct alloc_walk_param *wa, struct rte_memseg_list *msl,
+		unsigned int msl_idx, int start_idx, unsigned int need)
+{
+	const struct internal_config *internal_conf =
+		eal_get_internal_configuration();
+	struct alloc_par_param p;
+	struct timespec start, end;
+	struct rte_memseg *cur;
+	unsigned int cpu, i, n, nb_threads;
+	pthread_t *threads;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	memset(&p, 0, sizeof(p));
+	p.msl = msl;
+	p.hi = wa->hi;
+	p.msl_idx = msl_idx;
+	p.start_idx = start_idx;
+	p.socket = wa->socket;
+	p.limit = need;
+
+	CPU_ZERO(&p.cpuset);
+	for (cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+		if (eal_cpu_detected(cpu) &&
+				eal_cpu_socket_id(cpu) == (unsigned int)wa->socket)
+			CPU_SET(cpu, &p.cpuset);
+	}
+
+	/* the threads inherit the NUMA policy set for the socket */
+	nb_threads = RTE_MIN(internal_conf->huge_parallel, need);
+	threads = malloc(sizeof(*threads) * nb_threads);
+	n = 0;
+	if (threads != NULL) {
+		for (; n < nb_threads; n++) {
+			if (pthread_create(&threads[n], NULL,
+					alloc_seg_par_thread, &p) != 0)
+				break;
+		}
+	}
+	if (n == 0) {
+		RTE_LOG(DEBUG, EAL, "%s(): cannot create threads, mapping from the current thread\n",
+			__func__);
+		alloc_seg_par_loop(&p);
+	}
+	for (i = 0; i < n; i++)
+		pthread_join(threads[i], NULL);
+	free(threads);
+
+	/* alloc_seg() only fills the memsegs it could map */
+	for (i = 0; i < need; i++) {
+		cur = rte_fbarray_get(&msl->memseg_arr, start_idx + i);
+		if (i < p.limit) {
+			if (wa->ms)
+				wa->ms[i] = cur;
+			rte_fbarray_set_used(&msl->memseg_arr, start_idx + i);
+		} else if (cur->addr != NULL) {
+			if (free_seg(cur, wa->hi, msl_idx, start_idx + i))
+				RTE_LOG(DEBUG, EAL, "Cannot free page\n");
+		}
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	RTE_LOG(DEBUG, EAL, "%s(): mapped %u of %u segments of %" PRIu64 "M on socket %d with %u threads in %.3f ms\n",
+		__func__, p.limit, need, msl->page_sz >> 20, wa->socket,
+		RTE_MAX(n, 1U), (end.tv_sec - start.tv_sec) * 1E3 +
+		(end.tv_nsec - start.tv_nsec) / 1E6);
+
+	return p.limit;
+}
 static int
 alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 {
@@ -841,6 +981,20 @@ alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 		}
 	}
 
+	/* the pages preallocated at init may be mapped in parallel */
+	if (internal_conf->huge_parallel > 0 &&
+			!internal_conf->init_complete && need > 1) {
+		i = alloc_seg_parallel(wa, cur_msl, msl_idx, cur_idx, need);
+		cur_idx += i;
+		if (i == need)
+			goto out;
+		RTE_LOG(DEBUG, EAL, "attempted to allocate %i segments, but only %i were allocated\n",
+			need, i);
+		if (!wa->exact)
+			goto out;
+		goto clean_up;
+	}
+
 	for (i = 0; i < need; i++, cur_idx++) {
 		struct rte_memseg *cur;
 		void *map_addr;
@@ -857,29 +1011,7 @@ alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 			/* if exact number wasn't requested, stop */
 			if (!wa->exact)
 				goto out;
-
-			/* clean up */
-			for (j = start_idx; j < cur_idx; j++) {
-				struct rte_memseg *tmp;
-				struct rte_fbarray *arr =
-						&cur_msl->memseg_arr;
-
-				tmp = rte_fbarray_get(arr, j);
-				rte_fbarray_set_free(arr, j);
-
-				/* free_seg may attempt to create a file, which
-				 * may fail.
-				 */
-				if (free_seg(tmp, wa->hi, msl_idx, j))
-					RTE_LOG(DEBUG, EAL, "Cannot free page\n");
-			}
-			/* clear the list */
-			if (wa->ms)
-				memset(wa->ms, 0, sizeof(*wa->ms) * wa->n_segs);
-
-			if (dir_fd >= 0)
-				close(dir_fd);
-			return -1;
+			goto clean_up;
 		}
 		if (wa->ms)
 			wa->ms[i] = cur;
@@ -894,6 +1026,26 @@ alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 		close(dir_fd);
 	/* if we didn't allocate any segments, move on to the next list */
 	return i > 0;
+
+clean_up:
+	for (j = start_idx; j < cur_idx; j++) {
+		struct rte_memseg *tmp;
+		struct rte_fbarray *arr = &cur_msl->memseg_arr;
+
+		tmp = rte_fbarray_get(arr, j);
+		rte_fbarray_set_free(arr, j);
+
+		/* free_seg may attempt to create a file, which may fail. */
+		if (free_seg(tmp, wa->hi, msl_idx, j))
+			RTE_LOG(DEBUG, EAL, "Cannot free page\n");
+	}
+	/* clear the list */
+	if (wa->ms)
+		memset(wa->ms, 0, sizeof(*wa->ms) * wa->n_segs);
+
+	if (dir_fd >= 0)
+		close(dir_fd);
+	return -1;
 }
 
 struct free_walk_param {
@@ -0,0 +1,12 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <rte_memcpy.h>
+
+/* no streaming stores, use the regular copy */
+void *
+rte_memcpy_nt(void *dst, const void *src, size_t n)
+{
+	return rte_memcpy(dst, src, n);
+}
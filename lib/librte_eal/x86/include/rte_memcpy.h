@@ -16,6 +16,7 @@
 #include <string.h>
 #include <rte_vect.h>
 #include <rte_common.h>
+#include <rte_compat.h>
 #include <rte_config.h>
 
 #ifdef __cplusplus
@@ -45,6 +46,10 @@ extern "C" {
 static __rte_always_inline void *
 rte_memcpy(void *dst, const void *src, size_t n);
 
+__rte_experimental
+void *
+rte_memcpy_nt(void *dst, const void *src, size_t n);
+
 #ifdef RTE_MACHINE_CPUFLAG_AVX512F
 
 #define ALIGNMENT_MASK 0x3F
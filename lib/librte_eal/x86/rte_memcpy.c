@@ -0,0 +1,77 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <stdint.h>
+
+#include <rte_common.h>
+#include <rte_cpuflags.h>
+#include <rte_memcpy.h>
+#include <rte_vect.h>
+
+#include "rte_memcpy_nt.h"
+
+typedef void *(*memcpy_nt_t)(void *dst, const void *src, size_t n);
+
+static memcpy_nt_t memcpy_nt = rte_memcpy_nt_sse2;
+
+void *
+rte_memcpy_nt_sse2(void *dst, const void *src, size_t n)
+{
+	uint8_t *d = dst;
+	const uint8_t *s = src;
+	__m128i x0, x1, x2, x3;
+	size_t head;
+
+	if (n < MEMCPY_NT_MIN_SIZE)
+		return rte_memcpy(dst, src, n);
+
+	/* align the destination for the streaming stores */
+	head = -(uintptr_t)d & 15;
+	rte_memcpy(d, s, head);
+	d += head;
+	s += head;
+	n -= head;
+
+	for (; n >= 64; n -= 64, d += 64, s += 64) {
+		x0 = _mm_loadu_si128((const __m128i *)(const void *)s);
+		x1 = _mm_loadu_si128((const __m128i *)(const void *)(s + 16));
+		x2 = _mm_loadu_si128((const __m128i *)(const void *)(s + 32));
+		x3 = _mm_loadu_si128((const __m128i *)(const void *)(s + 48));
+		_mm_stream_si128((__m128i *)(void *)d, x0);
+		_mm_stream_si128((__m128i *)(void *)(d + 16), x1);
+		_mm_stream_si128((__m128i *)(void *)(d + 32), x2);
+		_mm_stream_si128((__m128i *)(void *)(d + 48), x3);
+	}
+	for (; n >= 16; n -= 16, d += 16, s += 16) {
+		x0 = _mm_loadu_si128((const __m128i *)(const void *)s);
+		_mm_stream_si128((__m128i *)(void *)d, x0);
+	}
+	rte_memcpy(d, s, n);
+
+	/* order the streaming stores before the following stores */
+	_mm_sfence();
+	return dst;
+}
+
+RTE_INIT(rte_memcpy_nt_init)
+{
+#ifdef CC_AVX512_SUPPORT
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F)) {
+		memcpy_nt = rte_memcpy_nt_avx512f;
+		return;
+	}
+#endif
+#ifdef CC_AVX2_SUPPORT
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2)) {
+		memcpy_nt = rte_memcpy_nt_avx2;
+		return;
+	}
+#endif
+}
+
+void *
+rte_memcpy_nt(void *dst, const void *src, size_t n)
+{
+	return memcpy_nt(dst, src, n);
+}
@@ -0,0 +1,50 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <stdint.h>
+
+#include <rte_common.h>
+#include <rte_memcpy.h>
+#include <rte_vect.h>
+
+#include "rte_memcpy_nt.h"
+
+void *
+rte_memcpy_nt_avx2(void *dst, const void *src, size_t n)
+{
+	uint8_t *d = dst;
+	const uint8_t *s = src;
+	__m256i y0, y1, y2, y3;
+	size_t head;
+
+	if (n < MEMCPY_NT_MIN_SIZE)
+		return rte_memcpy(dst, src, n);
+
+	/* align the destination for the streaming stores */
+	head = -(uintptr_t)d & 31;
+	rte_memcpy(d, s, head);
+	d += head;
+	s += head;
+	n -= head;
+
+	for (; n >= 128; n -= 128, d += 128, s += 128) {
+		y0 = _mm256_loadu_si256((const __m256i *)(const void *)s);
+		y1 = _mm256_loadu_si256((const __m256i *)(const void *)(s + 32));
+		y2 = _mm256_loadu_si256((const __m256i *)(const void *)(s + 64));
+		y3 = _mm256_loadu_si256((const __m256i *)(const void *)(s + 96));
+		_mm256_stream_si256((__m256i *)(void *)d, y0);
+		_mm256_stream_si256((__m256i *)(void *)(d + 32), y1);
+		_mm256_stream_si256((__m256i *)(void *)(d + 64), y2);
+		_mm256_stream_si256((__m256i *)(void *)(d + 96), y3);
+	}
+	for (; n >= 32; n -= 32, d += 32, s += 32) {
+		y0 = _mm256_loadu_si256((const __m256i *)(const void *)s);
+		_mm256_stream_si256((__m256i *)(void *)d, y0);
+	}
+	rte_memcpy(d, s, n);
+
+	/* order the streaming stores before the following stores */
+	_mm_sfence();
+	return dst;
+}
@@ -0,0 +1,50 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <stdint.h>
+
+#include <rte_common.h>
+#include <rte_memcpy.h>
+#include <rte_vect.h>
+
+#include "rte_memcpy_nt.h"
+
+void *
+rte_memcpy_nt_avx512f(void *dst, const void *src, size_t n)
+{
+	uint8_t *d = dst;
+	const uint8_t *s = src;
+	__m512i z0, z1, z2, z3;
+	size_t head;
+
+	if (n < MEMCPY_NT_MIN_SIZE)
+		return rte_memcpy(dst, src, n);
+
+	/* align the destination for the streaming stores */
+	head = -(uintptr_t)d & 63;
+	rte_memcpy(d, s, head);
+	d += head;
+	s += head;
+	n -= head;
+
+	for (; n >= 256; n -= 256, d += 256, s += 256) {
+		z0 = _mm512_loadu_si512((const void *)s);
+		z1 = _mm512_loadu_si512((const void *)(s + 64));
+		z2 = _mm512_loadu_si512((const void *)(s + 128));
+		z3 = _mm512_loadu_si512((const void *)(s + 192));
+		_mm512_stream_si512((void *)d, z0);
+		_mm512_stream_si512((void *)(d + 64), z1);
+		_mm512_stream_si512((void *)(d + 128), z2);
+		_mm512_stream_si512((void *)(d + 192), z3);
+	}
+	for (; n >= 64; n -= 64, d += 64, s += 64) {
+		z0 = _mm512_loadu_si512((const void *)s);
+		_mm512_stream_si512((void *)d, z0);
+	}
+	rte_memcpy(d, s, n);
+
+	/* order the streaming stores before the following stores */
+	_mm_sfence();
+	return dst;
+}
@@ -0,0 +1,27 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#ifndef _RTE_MEMCPY_NT_H_
+#define _RTE_MEMCPY_NT_H_
+
+/**
+ * @file
+ * Internal kernels of rte_memcpy_nt(), selected at init from the CPU flags.
+ */
+
+#include <stddef.h>
+
+/* below this size, the copy is not worth bypassing the cache */
+#define MEMCPY_NT_MIN_SIZE 256
+
+void *
+rte_memcpy_nt_sse2(void *dst, const void *src, size_t n);
+
+void *
+rte_memcpy_nt_avx2(void *dst, const void *src, size_t n);
+
+void *
+rte_memcpy_nt_avx512f(void *dst, const void *src, size_t n);
+
+#endif /* _RTE_MEMCPY_NT_H_ */
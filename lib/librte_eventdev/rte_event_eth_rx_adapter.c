@@ -15,6 +15,7 @@
 #include <rte_log.h>
 #include <rte_malloc.h>
 #include <rte_service_component.h>
+#include <rte_tailq.h>
 #include <rte_thash.h>
 #include <rte_interrupts.h>
 
@@ -31,6 +32,11 @@
 #define ETH_RX_ADAPTER_MEM_NAME_LEN	32
 
 #define RSS_KEY_SIZE	40
+/* Event vector limits of the SW adapter */
+#define MIN_VECTOR_SIZE	4
+#define MAX_VECTOR_SIZE	1024
+#define MIN_VECTOR_NS	1E5
+#define MAX_VECTOR_NS	1E9
 /* value written to intr thread pipe to signal thread exit */
 #define ETH_BRIDGE_INTR_THREAD_EXIT	1
 /* Sentinel value to detect initialized file handle */
@@ -59,7 +65,32 @@ struct eth_rx_poll_entry {
 	uint16_t eth_rx_qid;
 };
 
-/* Instance per adapter */
+/*
+ * Event vector being filled with the mbufs of an Rx queue, linked to the
+ * adapter list of vectors checked for timeout while not empty
+ */
+struct eth_rx_vector_data {
+	TAILQ_ENTRY(eth_rx_vector_data) next;
+	/* Eth port and Rx queue of the mbufs */
+	uint16_t port;
+	uint16_t queue;
+	/* Maximum number of mbufs per vector */
+	uint16_t max_vector_count;
+	/* Event attributes of the vectors */
+	uint64_t event;
+	/* Timestamp of the first mbuf of the vector */
+	uint64_t ts;
+	/* Timeout of the vector in TSC cycles */
+	uint64_t vector_timeout_ticks;
+	/* Pool of the vectors */
+	struct rte_mempool *vector_pool;
+	/* Vector being filled, NULL if none */
+	struct rte_event_vector *vector_ev;
+} __rte_cache_aligned;
+
+TAILQ_HEAD(eth_rx_vector_data_list, eth_rx_vector_data);
+
+/* Instance per shard */
 struct rte_eth_event_enqueue_buffer {
 	/* Count of events in this buffer */
 	uint16_t count;
@@ -67,37 +98,72 @@ struct rte_eth_event_enqueue_buffer {
 	struct rte_event events[ETH_EVENT_BUFFER_SIZE];
 };
 
-struct rte_event_eth_rx_adapter {
-	/* RSS key */
-	uint8_t rss_key_be[RSS_KEY_SIZE];
-	/* Event device identifier */
-	uint8_t eventdev_id;
-	/* Per ethernet device structure */
-	struct eth_device_info *eth_devices;
+/*
+ * There is an instance of this struct per service function of the adapter,
+ * polling a disjoint subset of the Rx queues
+ */
+struct eth_rx_shard {
+	/* Adapter of the shard */
+	struct rte_event_eth_rx_adapter *rx_adapter;
+	/* Lock to serialize config updates with service function */
+	rte_spinlock_t lock;
 	/* Event port identifier */
 	uint8_t event_port_id;
-	/* Lock to serialize config updates with service function */
-	rte_spinlock_t rx_lock;
 	/* Max mbufs processed in any service function invocation */
 	uint32_t max_nb_rx;
-	/* Receive queues that need to be polled */
+	/* Receive queues that need to be polled, in the adapter array */
 	struct eth_rx_poll_entry *eth_rx_poll;
 	/* Size of the eth_rx_poll array */
 	uint16_t num_rx_polled;
-	/* Weighted round robin schedule */
+	/* Weighted round robin schedule, in the adapter array */
 	uint32_t *wrr_sched;
 	/* wrr_sched[] size */
 	uint32_t wrr_len;
 	/* Next entry in wrr[] to begin polling */
 	uint32_t wrr_pos;
+	/* Count of Rx queues of the shard, polled or interrupt based */
+	uint32_t nb_queues;
 	/* Event burst buffer */
 	struct rte_eth_event_enqueue_buffer event_enqueue_buffer;
-	/* Per adapter stats */
+	/* Vectors being filled */
+	struct eth_rx_vector_data_list vector_list;
+	/* Smallest vector timeout of the Rx queues, in TSC cycles */
+	uint64_t vector_tmo_ticks;
+	/* Last time the vectors were checked for timeout */
+	uint64_t prev_expiry_ts;
+	/* Per shard stats */
 	struct rte_event_eth_rx_adapter_stats stats;
 	/* Block count, counts up to BLOCK_CNT_THRESHOLD */
 	uint16_t enq_block_count;
 	/* Block start ts */
 	uint64_t rx_enq_block_start_ts;
+	/* EAL service of the shard */
+	uint32_t service_id;
+} __rte_cache_aligned;
+
+struct rte_event_eth_rx_adapter {
+	/* RSS key */
+	uint8_t rss_key_be[RSS_KEY_SIZE];
+	/* Event device identifier */
+	uint8_t eventdev_id;
+	/* Per ethernet device structure */
+	struct eth_device_info *eth_devices;
+	/* Lock to serialize config updates, taken before the shard locks */
+	rte_spinlock_t rx_lock;
+	/* Receive queues that need to be polled, sliced by shard */
+	struct eth_rx_poll_entry *eth_rx_poll;
+	/* Size of the eth_rx_poll array */
+	uint16_t num_rx_polled;
+	/* Weighted round robin schedules, sliced by shard */
+	uint32_t *wrr_sched;
+	/* wrr_sched[] size */
+	uint32_t wrr_len;
+	/* Service function instances, shard 0 also serves the
+	 * interrupt based queues
+	 */
+	struct eth_rx_shard *shards;
+	/* Number of shards */
+	uint16_t nb_shards;
 	/* epoll fd used to wait for Rx interrupts */
 	int epd;
 	/* Num of interrupt driven interrupt queues */
@@ -136,8 +202,6 @@ struct rte_event_eth_rx_adapter {
 	char mem_name[ETH_RX_ADAPTER_MEM_NAME_LEN];
 	/* Socket identifier cached from eventdev */
 	int socket_id;
-	/* Per adapter EAL service */
-	uint32_t service_id;
 	/* Adapter started flag */
 	uint8_t rxa_started;
 	/* Adapter ID */
@@ -201,6 +265,13 @@ struct eth_rx_queue_info {
 	uint16_t wt;		/* Polling weight */
 	uint32_t flow_id_mask;	/* Set to ~0 if app provides flow id else 0 */
 	uint64_t event;
+	/* Set if added with RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR */
+	uint8_t vector_requested;
+	/* Set once vectorization is configured, mbufs go in vectors */
+	uint8_t ena_vector;
+	/* Shard polling the queue */
+	uint16_t shard;
+	struct eth_rx_vector_data vector_data;
 };
 
 static struct rte_event_eth_rx_adapter **event_eth_rx_adapter;
@@ -218,12 +289,6 @@ rxa_validate_id(uint8_t id)
 	} \
 } while (0)
 
-static inline int
-rxa_sw_adapter_queue_count(struct rte_event_eth_rx_adapter *rx_adapter)
-{
-	return rx_adapter->num_rx_polled + rx_adapter->num_rx_intr;
-}
-
 /* Greatest common divisor */
 static uint16_t rxa_gcd_u16(uint16_t a, uint16_t b)
 {
@@ -546,66 +611,124 @@ rxa_alloc_poll_arrays(struct rte_event_eth_rx_adapter *rx_adapter,
 	return 0;
 }
 
-/* Precalculate WRR polling sequence for all queues in rx_adapter */
+/* Precalculate WRR polling sequence of each shard, the shards use
+ * consecutive slices of the rx_poll and rx_wrr arrays
+ */
 static void
 rxa_calc_wrr_sequence(struct rte_event_eth_rx_adapter *rx_adapter,
 		struct eth_rx_poll_entry *rx_poll,
 		uint32_t *rx_wrr)
 {
+	struct eth_rx_shard *shard;
 	uint16_t d;
 	uint16_t q;
+	uint16_t s;
 	unsigned int i;
-	int prev = -1;
-	int cw = -1;
+	int prev;
+	int cw;
+
+	/* Variables for calculation of wrr schedule */
+	uint16_t max_wrr_pos;
+	unsigned int poll_q;
+	uint16_t max_wt;
+	uint16_t gcd;
+
+	RTE_ETH_FOREACH_DEV(d)
+		rx_adapter->eth_devices[d].wrr_len = 0;
+
+	for (s = 0; s < rx_adapter->nb_shards; s++) {
+		shard = &rx_adapter->shards[s];
+		max_wrr_pos = 0;
+		poll_q = 0;
+		max_wt = 0;
+		gcd = 0;
+
+		/* Generate array of the queues of the shard to poll, the
+		 * size of this array is poll_q
+		 */
+		RTE_ETH_FOREACH_DEV(d) {
+			uint16_t nb_rx_queues;
+			struct eth_device_info *dev_info =
+					&rx_adapter->eth_devices[d];
+			if (rx_poll == NULL)
+				break;
+			nb_rx_queues = dev_info->dev->data->nb_rx_queues;
+			if (dev_info->rx_queue == NULL)
+				continue;
+			if (dev_info->internal_event_port)
+				continue;
+			for (q = 0; q < nb_rx_queues; q++) {
+				struct eth_rx_queue_info *queue_info =
+					&dev_info->rx_queue[q];
+				uint16_t wt;
 
-	/* Initialize variables for calculation of wrr schedule */
-	uint16_t max_wrr_pos = 0;
-	unsigned int poll_q = 0;
-	uint16_t max_wt = 0;
-	uint16_t gcd = 0;
+				if (!rxa_polled_queue(dev_info, q) ||
+				    queue_info->shard != s)
+					continue;
+				wt = queue_info->wt;
+				rx_poll[poll_q].eth_dev_id = d;
+				rx_poll[poll_q].eth_rx_qid = q;
+				max_wrr_pos += wt;
+				dev_info->wrr_len += wt;
+				max_wt = RTE_MAX(max_wt, wt);
+				gcd = (gcd) ? rxa_gcd_u16(gcd, wt) : wt;
+				poll_q++;
+			}
+		}
 
-	if (rx_poll == NULL)
-		return;
+		/* Generate polling sequence based on weights */
+		prev = -1;
+		cw = -1;
+		for (i = 0; i < max_wrr_pos; i++) {
+			rx_wrr[i] = rxa_wrr_next(rx_adapter, poll_q, &cw,
+					     rx_poll, max_wt, gcd, prev);
+			prev = rx_wrr[i];
+		}
+
+		shard->eth_rx_poll = rx_poll;
+		shard->num_rx_polled = poll_q;
+		shard->wrr_sched = rx_wrr;
+		shard->wrr_len = max_wrr_pos;
+		shard->wrr_pos = 0;
+		if (rx_poll != NULL) {
+			rx_poll += poll_q;
+			rx_wrr += max_wrr_pos;
+		}
+	}
+}
+
+/* Calculate the smallest vector timeout of the Rx queues of each shard,
+ * the period of the vector timeout checks
+ */
+static void
+rxa_calc_vector_tmo(struct rte_event_eth_rx_adapter *rx_adapter)
+{
+	struct eth_rx_queue_info *queue_info;
+	struct eth_device_info *dev_info;
+	struct eth_rx_shard *shard;
+	uint64_t tmo_ticks;
+	uint16_t d;
+	uint16_t q;
+	uint16_t s;
+
+	for (s = 0; s < rx_adapter->nb_shards; s++)
+		rx_adapter->shards[s].vector_tmo_ticks = 0;
 
-	/* Generate array of all queues to poll, the size of this
-	 * array is poll_q
-	 */
 	RTE_ETH_FOREACH_DEV(d) {
-		uint16_t nb_rx_queues;
-		struct eth_device_info *dev_info =
-				&rx_adapter->eth_devices[d];
-		nb_rx_queues = dev_info->dev->data->nb_rx_queues;
+		dev_info = &rx_adapter->eth_devices[d];
 		if (dev_info->rx_queue == NULL)
 			continue;
-		if (dev_info->internal_event_port)
-			continue;
-		dev_info->wrr_len = 0;
-		for (q = 0; q < nb_rx_queues; q++) {
-			struct eth_rx_queue_info *queue_info =
-				&dev_info->rx_queue[q];
-			uint16_t wt;
-
-			if (!rxa_polled_queue(dev_info, q))
+		for (q = 0; q < dev_info->dev->data->nb_rx_queues; q++) {
+			queue_info = &dev_info->rx_queue[q];
+			if (!queue_info->ena_vector)
 				continue;
-			wt = queue_info->wt;
-			rx_poll[poll_q].eth_dev_id = d;
-			rx_poll[poll_q].eth_rx_qid = q;
-			max_wrr_pos += wt;
-			dev_info->wrr_len += wt;
-			max_wt = RTE_MAX(max_wt, wt);
-			gcd = (gcd) ? rxa_gcd_u16(gcd, wt) : wt;
-			poll_q++;
+			shard = &rx_adapter->shards[queue_info->shard];
+			tmo_ticks = queue_info->vector_data.vector_timeout_ticks;
+			if (shard->vector_tmo_ticks == 0 ||
+			    tmo_ticks < shard->vector_tmo_ticks)
+				shard->vector_tmo_ticks = tmo_ticks;
 		}
 	}
-
-	/* Generate polling sequence based on weights */
-	prev = -1;
-	cw = -1;
-	for (i = 0; i < max_wrr_pos; i++) {
-		rx_wrr[i] = rxa_wrr_next(rx_adapter, poll_q, &cw,
-				     rx_poll, max_wt, gcd, prev);
-		prev = rx_wrr[i];
-	}
 }
 
 static inline void
@@ -677,53 +800,54 @@ rxa_do_softrss(struct rte_mbuf *m, const uint8_t *rss_key_be)
 }
 
 static inline int
-rxa_enq_blocked(struct rte_event_eth_rx_adapter *rx_adapter)
+rxa_enq_blocked(struct eth_rx_shard *shard)
 {
-	return !!rx_adapter->enq_block_count;
+	return !!shard->enq_block_count;
 }
 
 static inline void
-rxa_enq_block_start_ts(struct rte_event_eth_rx_adapter *rx_adapter)
+rxa_enq_block_start_ts(struct eth_rx_shard *shard)
 {
-	if (rx_adapter->rx_enq_block_start_ts)
+	if (shard->rx_enq_block_start_ts)
 		return;
 
-	rx_adapter->enq_block_count++;
-	if (rx_adapter->enq_block_count < BLOCK_CNT_THRESHOLD)
+	shard->enq_block_count++;
+	if (shard->enq_block_count < BLOCK_CNT_THRESHOLD)
 		return;
 
-	rx_adapter->rx_enq_block_start_ts = rte_get_tsc_cycles();
+	shard->rx_enq_block_start_ts = rte_get_tsc_cycles();
 }
 
 static inline void
-rxa_enq_block_end_ts(struct rte_event_eth_rx_adapter *rx_adapter,
+rxa_enq_block_end_ts(struct eth_rx_shard *shard,
 		    struct rte_event_eth_rx_adapter_stats *stats)
 {
 	if (unlikely(!stats->rx_enq_start_ts))
 		stats->rx_enq_start_ts = rte_get_tsc_cycles();
 
-	if (likely(!rxa_enq_blocked(rx_adapter)))
+	if (likely(!rxa_enq_blocked(shard)))
 		return;
 
-	rx_adapter->enq_block_count = 0;
-	if (rx_adapter->rx_enq_block_start_ts) {
+	shard->enq_block_count = 0;
+	if (shard->rx_enq_block_start_ts) {
 		stats->rx_enq_end_ts = rte_get_tsc_cycles();
 		stats->rx_enq_block_cycles += stats->rx_enq_end_ts -
-		    rx_adapter->rx_enq_block_start_ts;
-		rx_adapter->rx_enq_block_start_ts = 0;
+		    shard->rx_enq_block_start_ts;
+		shard->rx_enq_block_start_ts = 0;
 	}
 }
 
 /* Enqueue buffered events to event device */
 static inline uint16_t
-rxa_flush_event_buffer(struct rte_event_eth_rx_adapter *rx_adapter)
+rxa_flush_event_buffer(struct eth_rx_shard *shard)
 {
 	struct rte_eth_event_enqueue_buffer *buf =
-	    &rx_adapter->event_enqueue_buffer;
-	struct rte_event_eth_rx_adapter_stats *stats = &rx_adapter->stats;
+	    &shard->event_enqueue_buffer;
+	struct rte_event_eth_rx_adapter_stats *stats = &shard->stats;
 
-	uint16_t n = rte_event_enqueue_new_burst(rx_adapter->eventdev_id,
-					rx_adapter->event_port_id,
+	uint16_t n = rte_event_enqueue_new_burst(
+					shard->rx_adapter->eventdev_id,
+					shard->event_port_id,
 					buf->events,
 					buf->count);
 	if (n != buf->count) {
@@ -733,8 +857,8 @@ rxa_flush_event_buffer(struct rte_event_eth_rx_adapter *rx_adapter)
 		stats->rx_enq_retry++;
 	}
 
-	n ? rxa_enq_block_end_ts(rx_adapter, stats) :
-		rxa_enq_block_start_ts(rx_adapter);
+	n ? rxa_enq_block_end_ts(shard, stats) :
+		rxa_enq_block_start_ts(shard);
 
 	buf->count -= n;
 	stats->rx_enq_count += n;
@@ -743,19 +867,102 @@ rxa_flush_event_buffer(struct rte_event_eth_rx_adapter *rx_adapter)
 }
 
 static inline void
-rxa_buffer_mbufs(struct rte_event_eth_rx_adapter *rx_adapter,
+rxa_init_vector(struct eth_rx_shard *shard,
+		struct eth_rx_vector_data *vec)
+{
+	vec->vector_ev->nb_elem = 0;
+	vec->vector_ev->port = vec->port;
+	vec->vector_ev->queue = vec->queue;
+	vec->vector_ev->attr_valid = true;
+	vec->ts = rte_rdtsc();
+	TAILQ_INSERT_TAIL(&shard->vector_list, vec, next);
+}
+
+/* Move the vector being filled to an event */
+static inline void
+rxa_vector_event(struct eth_rx_shard *shard,
+		struct eth_rx_vector_data *vec, struct rte_event *ev)
+{
+	ev->event = vec->event;
+	ev->vec = vec->vector_ev;
+	vec->vector_ev = NULL;
+	TAILQ_REMOVE(&shard->vector_list, vec, next);
+}
+
+/* Aggregate mbufs into vectors, returns the number of full vector events */
+static inline uint16_t
+rxa_create_event_vector(struct eth_rx_shard *shard,
+			struct eth_rx_queue_info *queue_info,
+			struct rte_eth_event_enqueue_buffer *buf,
+			struct rte_mbuf **mbufs, uint16_t num)
+{
+	struct rte_event *ev = &buf->events[buf->count];
+	struct eth_rx_vector_data *vec;
+	uint16_t filled, space, sz;
+
+	filled = 0;
+	vec = &queue_info->vector_data;
+
+	while (num) {
+		if (vec->vector_ev == NULL) {
+			if (unlikely(rte_mempool_get(vec->vector_pool,
+					(void **)&vec->vector_ev) < 0)) {
+				rte_pktmbuf_free_bulk(mbufs, num);
+				shard->stats.rx_dropped += num;
+				return filled;
+			}
+			rxa_init_vector(shard, vec);
+		}
+
+		space = vec->max_vector_count - vec->vector_ev->nb_elem;
+		sz = RTE_MIN(num, space);
+		memcpy(vec->vector_ev->mbufs + vec->vector_ev->nb_elem, mbufs,
+		       sizeof(void *) * sz);
+		vec->vector_ev->nb_elem += sz;
+		num -= sz;
+		mbufs += sz;
+
+		if (vec->vector_ev->nb_elem == vec->max_vector_count) {
+			/* Event ready */
+			rxa_vector_event(shard, vec, ev);
+			ev++;
+			filled++;
+		}
+	}
+
+	return filled;
+}
+
+/* Free a vector being filled and its mbufs */
+static void
+rxa_vector_free(struct eth_rx_shard *shard,
+		struct eth_rx_vector_data *vec)
+{
+	if (vec->vector_ev == NULL)
+		return;
+
+	rte_pktmbuf_free_bulk(vec->vector_ev->mbufs,
+			      vec->vector_ev->nb_elem);
+	rte_mempool_put(vec->vector_pool, vec->vector_ev);
+	vec->vector_ev = NULL;
+	TAILQ_REMOVE(&shard->vector_list, vec, next);
+}
+
+static inline void
+rxa_buffer_mbufs(struct eth_rx_shard *shard,
 		uint16_t eth_dev_id,
 		uint16_t rx_queue_id,
 		struct rte_mbuf **mbufs,
 		uint16_t num)
 {
 	uint32_t i;
+	struct rte_event_eth_rx_adapter *rx_adapter = shard->rx_adapter;
 	struct eth_device_info *dev_info =
 					&rx_adapter->eth_devices[eth_dev_id];
 	struct eth_rx_queue_info *eth_rx_queue_info =
 					&dev_info->rx_queue[rx_queue_id];
 	struct rte_eth_event_enqueue_buffer *buf =
-					&rx_adapter->event_enqueue_buffer;
+					&shard->event_enqueue_buffer;
 	struct rte_event *ev = &buf->events[buf->count];
 	uint64_t event = eth_rx_queue_info->event;
 	uint32_t flow_id_mask = eth_rx_queue_info->flow_id_mask;
@@ -781,6 +988,12 @@ rxa_buffer_mbufs(struct rte_event_eth_rx_adapter *rx_adapter,
 		}
 	}
 
+	if (eth_rx_queue_info->ena_vector) {
+		buf->count += rxa_create_event_vector(shard,
+				eth_rx_queue_info, buf, mbufs, num);
+		return;
+	}
+
 	for (i = 0; i < num; i++) {
 		m = mbufs[i];
 
@@ -806,7 +1019,7 @@ rxa_buffer_mbufs(struct rte_event_eth_rx_adapter *rx_adapter,
 		else
 			num = nb_cb;
 		if (dropped)
-			rx_adapter->stats.rx_dropped += dropped;
+			shard->stats.rx_dropped += dropped;
 	}
 
 	buf->count += num;
@@ -814,7 +1027,7 @@ rxa_buffer_mbufs(struct rte_event_eth_rx_adapter *rx_adapter,
 
 /* Enqueue packets from  <port, q>  to event buffer */
 static inline uint32_t
-rxa_eth_rx(struct rte_event_eth_rx_adapter *rx_adapter,
+rxa_eth_rx(struct eth_rx_shard *shard,
 	uint16_t port_id,
 	uint16_t queue_id,
 	uint32_t rx_count,
@@ -823,9 +1036,9 @@ rxa_eth_rx(struct rte_event_eth_rx_adapter *rx_adapter,
 {
 	struct rte_mbuf *mbufs[BATCH_SIZE];
 	struct rte_eth_event_enqueue_buffer *buf =
-					&rx_adapter->event_enqueue_buffer;
+					&shard->event_enqueue_buffer;
 	struct rte_event_eth_rx_adapter_stats *stats =
-					&rx_adapter->stats;
+					&shard->stats;
 	uint16_t n;
 	uint32_t nb_rx = 0;
 
@@ -836,7 +1049,7 @@ rxa_eth_rx(struct rte_event_eth_rx_adapter *rx_adapter,
 	 */
 	while (BATCH_SIZE <= (RTE_DIM(buf->events) - buf->count)) {
 		if (buf->count >= BATCH_SIZE)
-			rxa_flush_event_buffer(rx_adapter);
+			rxa_flush_event_buffer(shard);
 
 		stats->rx_poll_count++;
 		n = rte_eth_rx_burst(port_id, queue_id, mbufs, BATCH_SIZE);
@@ -845,14 +1058,14 @@ rxa_eth_rx(struct rte_event_eth_rx_adapter *rx_adapter,
 				*rxq_empty = 1;
 			break;
 		}
-		rxa_buffer_mbufs(rx_adapter, port_id, queue_id, mbufs, n);
+		rxa_buffer_mbufs(shard, port_id, queue_id, mbufs, n);
 		nb_rx += n;
 		if (rx_count + nb_rx > max_rx)
 			break;
 	}
 
 	if (buf->count > 0)
-		rxa_flush_event_buffer(rx_adapter);
+		rxa_flush_event_buffer(shard);
 
 	return nb_rx;
 }
@@ -973,8 +1186,9 @@ rxa_intr_thread(void *arg)
  * mbufs to eventdev
  */
 static inline uint32_t
-rxa_intr_ring_dequeue(struct rte_event_eth_rx_adapter *rx_adapter)
+rxa_intr_ring_dequeue(struct eth_rx_shard *shard)
 {
+	struct rte_event_eth_rx_adapter *rx_adapter = shard->rx_adapter;
 	uint32_t n;
 	uint32_t nb_rx = 0;
 	int rxq_empty;
@@ -989,11 +1203,11 @@ rxa_intr_ring_dequeue(struct rte_event_eth_rx_adapter *rx_adapter)
 		&& !rx_adapter->qd_valid)
 		return 0;
 
-	buf = &rx_adapter->event_enqueue_buffer;
+	buf = &shard->event_enqueue_buffer;
 	ring_lock = &rx_adapter->intr_ring_lock;
 
 	if (buf->count >= BATCH_SIZE)
-		rxa_flush_event_buffer(rx_adapter);
+		rxa_flush_event_buffer(shard);
 
 	while (BATCH_SIZE <= (RTE_DIM(buf->events) - buf->count)) {
 		struct eth_device_info *dev_info;
@@ -1043,13 +1257,13 @@ rxa_intr_ring_dequeue(struct rte_event_eth_rx_adapter *rx_adapter)
 
 				if (!rxa_intr_queue(dev_info, i))
 					continue;
-				n = rxa_eth_rx(rx_adapter, port, i, nb_rx,
-					rx_adapter->max_nb_rx,
+				n = rxa_eth_rx(shard, port, i, nb_rx,
+					shard->max_nb_rx,
 					&rxq_empty);
 				nb_rx += n;
 
 				enq_buffer_full = !rxq_empty && n == 0;
-				max_done = nb_rx > rx_adapter->max_nb_rx;
+				max_done = nb_rx > shard->max_nb_rx;
 
 				if (enq_buffer_full || max_done) {
 					dev_info->next_q_idx = i;
@@ -1064,18 +1278,18 @@ rxa_intr_ring_dequeue(struct rte_event_eth_rx_adapter *rx_adapter)
 						RTE_MAX_RXTX_INTR_VEC_ID - 1 :
 						0;
 		} else {
-			n = rxa_eth_rx(rx_adapter, port, queue, nb_rx,
-				rx_adapter->max_nb_rx,
+			n = rxa_eth_rx(shard, port, queue, nb_rx,
+				shard->max_nb_rx,
 				&rxq_empty);
 			rx_adapter->qd_valid = !rxq_empty;
 			nb_rx += n;
-			if (nb_rx > rx_adapter->max_nb_rx)
+			if (nb_rx > shard->max_nb_rx)
 				break;
 		}
 	}
 
 done:
-	rx_adapter->stats.rx_intr_packets += nb_rx;
+	shard->stats.rx_intr_packets += nb_rx;
 	return nb_rx;
 }
 
@@ -1093,7 +1307,7 @@ rxa_intr_ring_dequeue(struct rte_event_eth_rx_adapter *rx_adapter)
  * it.
  */
 static inline uint32_t
-rxa_poll(struct rte_event_eth_rx_adapter *rx_adapter)
+rxa_poll(struct eth_rx_shard *shard)
 {
 	uint32_t num_queue;
 	uint32_t nb_rx = 0;
@@ -1101,58 +1315,99 @@ rxa_poll(struct rte_event_eth_rx_adapter *rx_adapter)
 	uint32_t wrr_pos;
 	uint32_t max_nb_rx;
 
-	wrr_pos = rx_adapter->wrr_pos;
-	max_nb_rx = rx_adapter->max_nb_rx;
-	buf = &rx_adapter->event_enqueue_buffer;
+	wrr_pos = shard->wrr_pos;
+	max_nb_rx = shard->max_nb_rx;
+	buf = &shard->event_enqueue_buffer;
 
 	/* Iterate through a WRR sequence */
-	for (num_queue = 0; num_queue < rx_adapter->wrr_len; num_queue++) {
-		unsigned int poll_idx = rx_adapter->wrr_sched[wrr_pos];
-		uint16_t qid = rx_adapter->eth_rx_poll[poll_idx].eth_rx_qid;
-		uint16_t d = rx_adapter->eth_rx_poll[poll_idx].eth_dev_id;
+	for (num_queue = 0; num_queue < shard->wrr_len; num_queue++) {
+		unsigned int poll_idx = shard->wrr_sched[wrr_pos];
+		uint16_t qid = shard->eth_rx_poll[poll_idx].eth_rx_qid;
+		uint16_t d = shard->eth_rx_poll[poll_idx].eth_dev_id;
 
 		/* Don't do a batch dequeue from the rx queue if there isn't
 		 * enough space in the enqueue buffer.
 		 */
 		if (buf->count >= BATCH_SIZE)
-			rxa_flush_event_buffer(rx_adapter);
+			rxa_flush_event_buffer(shard);
 		if (BATCH_SIZE > (ETH_EVENT_BUFFER_SIZE - buf->count)) {
-			rx_adapter->wrr_pos = wrr_pos;
+			shard->wrr_pos = wrr_pos;
 			return nb_rx;
 		}
 
-		nb_rx += rxa_eth_rx(rx_adapter, d, qid, nb_rx, max_nb_rx,
+		nb_rx += rxa_eth_rx(shard, d, qid, nb_rx, max_nb_rx,
 				NULL);
 		if (nb_rx > max_nb_rx) {
-			rx_adapter->wrr_pos =
-				    (wrr_pos + 1) % rx_adapter->wrr_len;
+			shard->wrr_pos =
+				    (wrr_pos + 1) % shard->wrr_len;
 			break;
 		}
 
-		if (++wrr_pos == rx_adapter->wrr_len)
+		if (++wrr_pos == shard->wrr_len)
 			wrr_pos = 0;
 	}
 	return nb_rx;
 }
 
+/* Enqueue the vectors which have waited for their timeout */
+static void
+rxa_vectors_expire(struct eth_rx_shard *shard)
+{
+	struct rte_eth_event_enqueue_buffer *buf =
+					&shard->event_enqueue_buffer;
+	struct eth_rx_vector_data *vec, *tmp;
+	uint64_t now = rte_rdtsc();
+
+	if (now - shard->prev_expiry_ts < shard->vector_tmo_ticks)
+		return;
+
+	TAILQ_FOREACH_SAFE(vec, &shard->vector_list, next, tmp) {
+		if (now - vec->ts < vec->vector_timeout_ticks)
+			continue;
+		if (buf->count == ETH_EVENT_BUFFER_SIZE &&
+		    rxa_flush_event_buffer(shard) == 0)
+			break;
+		rxa_vector_event(shard, vec, &buf->events[buf->count]);
+		buf->count++;
+	}
+
+	if (buf->count > 0)
+		rxa_flush_event_buffer(shard);
+	shard->prev_expiry_ts = now;
+}
+
 static int
 rxa_service_func(void *args)
 {
-	struct rte_event_eth_rx_adapter *rx_adapter = args;
+	struct eth_rx_shard *shard = args;
 	struct rte_event_eth_rx_adapter_stats *stats;
+	uint32_t nb_rx;
+	int idle;
 
-	if (rte_spinlock_trylock(&rx_adapter->rx_lock) == 0)
-		return 0;
-	if (!rx_adapter->rxa_started) {
-		rte_spinlock_unlock(&rx_adapter->rx_lock);
+	if (rte_spinlock_trylock(&shard->lock) == 0)
 		return 0;
-	}
+	if (!shard->rx_adapter->rxa_started) {
+		rte_spinlock_unlock(&shard->lock);
+		return -EAGAIN;
+	}
+
+	stats = &shard->stats;
+	if (!TAILQ_EMPTY(&shard->vector_list))
+		rxa_vectors_expire(shard);
+	/* The interrupt based queues belong to the first shard */
+	nb_rx = shard == shard->rx_adapter->shards ?
+		rxa_intr_ring_dequeue(shard) : 0;
+	nb_rx += rxa_poll(shard);
+	stats->rx_packets += nb_rx;
+	/* Events the event device did not accept yet and vectors waiting
+	 * for their timeout are not delayed by a back off.
+	 */
+	idle = nb_rx == 0 && shard->event_enqueue_buffer.count == 0 &&
+		TAILQ_EMPTY(&shard->vector_list);
+	rte_spinlock_unlock(&shard->lock);
 
-	stats = &rx_adapter->stats;
-	stats->rx_packets += rxa_intr_ring_dequeue(rx_adapter);
-	stats->rx_packets += rxa_poll(rx_adapter);
-	rte_spinlock_unlock(&rx_adapter->rx_lock);
-	return 0;
+	/* let the service core back off when there is no traffic */
+	return idle ? -EAGAIN : 0;
 }
 
 static int
@@ -1582,45 +1837,142 @@ static int
 rxa_init_service(struct rte_event_eth_rx_adapter *rx_adapter, uint8_t id)
 {
 	int ret;
+	uint16_t i;
+	struct eth_rx_shard *shard;
 	struct rte_service_spec service;
 	struct rte_event_eth_rx_adapter_conf rx_adapter_conf;
 
 	if (rx_adapter->service_inited)
 		return 0;
 
-	memset(&service, 0, sizeof(service));
-	snprintf(service.name, ETH_RX_ADAPTER_SERVICE_NAME_LEN,
-		"rte_event_eth_rx_adapter_%d", id);
-	service.socket_id = rx_adapter->socket_id;
-	service.callback = rxa_service_func;
-	service.callback_userdata = rx_adapter;
-	/* Service function handles locking for queue add/del updates */
-	service.capabilities = RTE_SERVICE_CAP_MT_SAFE;
-	ret = rte_service_component_register(&service, &rx_adapter->service_id);
-	if (ret) {
-		RTE_EDEV_LOG_ERR("failed to register service %s err = %" PRId32,
-			service.name, ret);
-		return ret;
-	}
+	rx_adapter->shards = rte_zmalloc_socket(rx_adapter->mem_name,
+				rx_adapter->nb_shards *
+				sizeof(struct eth_rx_shard),
+				RTE_CACHE_LINE_SIZE,
+				rx_adapter->socket_id);
+	if (rx_adapter->shards == NULL)
+		return -ENOMEM;
 
-	ret = rx_adapter->conf_cb(id, rx_adapter->eventdev_id,
-		&rx_adapter_conf, rx_adapter->conf_arg);
-	if (ret) {
-		RTE_EDEV_LOG_ERR("configuration callback failed err = %" PRId32,
-			ret);
-		goto err_done;
+	for (i = 0; i < rx_adapter->nb_shards; i++) {
+		shard = &rx_adapter->shards[i];
+		shard->rx_adapter = rx_adapter;
+		rte_spinlock_init(&shard->lock);
+		TAILQ_INIT(&shard->vector_list);
+
+		memset(&service, 0, sizeof(service));
+		/* The other shards use a shorter prefix, so that the
+		 * adapter and shard ids always fit in the service name
+		 */
+		if (i == 0)
+			ret = snprintf(service.name,
+				ETH_RX_ADAPTER_SERVICE_NAME_LEN,
+				"rte_event_eth_rx_adapter_%d", id);
+		else
+			ret = snprintf(service.name,
+				ETH_RX_ADAPTER_SERVICE_NAME_LEN,
+				"rte_event_eth_rxa_%d_%u", id, i);
+		if (ret < 0 || ret >= ETH_RX_ADAPTER_SERVICE_NAME_LEN) {
+			RTE_EDEV_LOG_ERR("service name too long for shard %u",
+				i);
+			ret = -ENAMETOOLONG;
+			goto err_done;
+		}
+		service.socket_id = rx_adapter->socket_id;
+		service.callback = rxa_service_func;
+		service.callback_userdata = shard;
+		/* Service function handles locking for queue add/del updates */
+		service.capabilities = RTE_SERVICE_CAP_MT_SAFE;
+		ret = rte_service_component_register(&service,
+						&shard->service_id);
+		if (ret) {
+			RTE_EDEV_LOG_ERR("failed to register service %s err = %"
+				PRId32, service.name, ret);
+			goto err_done;
+		}
+
+		/* Invoked once per shard, each one has its event port */
+		ret = rx_adapter->conf_cb(id, rx_adapter->eventdev_id,
+			&rx_adapter_conf, rx_adapter->conf_arg);
+		if (ret) {
+			RTE_EDEV_LOG_ERR("configuration callback failed err = %"
+				PRId32, ret);
+			rte_service_component_unregister(shard->service_id);
+			goto err_done;
+		}
+		shard->event_port_id = rx_adapter_conf.event_port_id;
+		shard->max_nb_rx = rx_adapter_conf.max_nb_rx;
 	}
-	rx_adapter->event_port_id = rx_adapter_conf.event_port_id;
-	rx_adapter->max_nb_rx = rx_adapter_conf.max_nb_rx;
 	rx_adapter->service_inited = 1;
 	rx_adapter->epd = INIT_FD;
 	return 0;
 
 err_done:
-	rte_service_component_unregister(rx_adapter->service_id);
+	while (i--)
+		rte_service_component_unregister(
+				rx_adapter->shards[i].service_id);
+	rte_free(rx_adapter->shards);
+	rx_adapter->shards = NULL;
 	return ret;
 }
 
+/* Serialize a config update with the service functions, the caller
+ * holds the adapter lock
+ */
+static void
+rxa_shards_lock(struct rte_event_eth_rx_adapter *rx_adapter)
+{
+	uint16_t i;
+
+	if (rx_adapter->shards == NULL)
+		return;
+
+	for (i = 0; i < rx_adapter->nb_shards; i++)
+		rte_spinlock_lock(&rx_adapter->shards[i].lock);
+}
+
+static void
+rxa_shards_unlock(struct rte_event_eth_rx_adapter *rx_adapter)
+{
+	uint16_t i;
+
+	if (rx_adapter->shards == NULL)
+		return;
+
+	for (i = rx_adapter->nb_shards; i > 0; i--)
+		rte_spinlock_unlock(&rx_adapter->shards[i - 1].lock);
+}
+
+/* Run the service functions of the shards having Rx queues */
+static void
+rxa_shards_runstate_set(struct rte_event_eth_rx_adapter *rx_adapter)
+{
+	uint16_t i;
+
+	for (i = 0; i < rx_adapter->nb_shards; i++)
+		rte_service_component_runstate_set(
+				rx_adapter->shards[i].service_id,
+				rx_adapter->shards[i].nb_queues != 0);
+}
+
+/* Shard with the fewest Rx queues, the interrupt based queues are
+ * serviced by the first shard
+ */
+static uint16_t
+rxa_select_shard(struct rte_event_eth_rx_adapter *rx_adapter, uint16_t wt)
+{
+	uint16_t i;
+	uint16_t s = 0;
+
+	if (wt == 0)
+		return 0;
+
+	for (i = 1; i < rx_adapter->nb_shards; i++)
+		if (rx_adapter->shards[i].nb_queues <
+		    rx_adapter->shards[s].nb_queues)
+			s = i;
+	return s;
+}
+
 static void
 rxa_update_queue(struct rte_event_eth_rx_adapter *rx_adapter,
 		struct eth_device_info *dev_info,
@@ -1656,6 +2008,8 @@ rxa_sw_del(struct rte_event_eth_rx_adapter *rx_adapter,
 	struct eth_device_info *dev_info,
 	int32_t rx_queue_id)
 {
+	struct eth_rx_queue_info *queue_info;
+	struct eth_rx_shard *shard;
 	int pollq;
 	int intrq;
 	int sintrq;
@@ -1677,6 +2031,12 @@ rxa_sw_del(struct rte_event_eth_rx_adapter *rx_adapter,
 	pollq = rxa_polled_queue(dev_info, rx_queue_id);
 	intrq = rxa_intr_queue(dev_info, rx_queue_id);
 	sintrq = rxa_shared_intr(dev_info, rx_queue_id);
+	queue_info = &dev_info->rx_queue[rx_queue_id];
+	shard = &rx_adapter->shards[queue_info->shard];
+	rxa_vector_free(shard, &queue_info->vector_data);
+	queue_info->vector_requested = 0;
+	queue_info->ena_vector = 0;
+	shard->nb_queues -= pollq || intrq;
 	rxa_update_queue(rx_adapter, dev_info, rx_queue_id, 0);
 	rx_adapter->num_rx_polled -= pollq;
 	dev_info->nb_rx_poll -= pollq;
@@ -1685,6 +2045,24 @@ rxa_sw_del(struct rte_event_eth_rx_adapter *rx_adapter,
 	dev_info->nb_shared_intr -= intrq && sintrq;
 }
 
+/* Event attributes of the vectors from the queue event */
+static void
+rxa_set_vector_event(struct eth_rx_queue_info *queue_info,
+		uint16_t port_id, uint16_t rx_queue_id)
+{
+	struct eth_rx_vector_data *vec = &queue_info->vector_data;
+	struct rte_event *ev = (struct rte_event *)&vec->event;
+
+	vec->event = queue_info->event;
+	ev->event_type = RTE_EVENT_TYPE_ETH_RX_ADAPTER_VECTOR;
+	/* Keep the vectors of a queue in a single flow */
+	if (!queue_info->flow_id_mask)
+		ev->flow_id = (rx_queue_id & 0xFFF) |
+			((uint32_t)(port_id & 0xFF) << 12);
+	vec->port = port_id;
+	vec->queue = rx_queue_id;
+}
+
 static void
 rxa_add_queue(struct rte_event_eth_rx_adapter *rx_adapter,
 	struct eth_device_info *dev_info,
@@ -1693,6 +2071,7 @@ rxa_add_queue(struct rte_event_eth_rx_adapter *rx_adapter,
 {
 	struct eth_rx_queue_info *queue_info;
 	const struct rte_event *ev = &conf->ev;
+	struct eth_rx_shard *shard;
 	int pollq;
 	int intrq;
 	int sintrq;
@@ -1713,6 +2092,23 @@ rxa_add_queue(struct rte_event_eth_rx_adapter *rx_adapter,
 	sintrq = rxa_shared_intr(dev_info, rx_queue_id);
 
 	queue_info = &dev_info->rx_queue[rx_queue_id];
+
+	/* A queue keeps its shard unless it switches between poll and
+	 * interrupt mode
+	 */
+	shard = &rx_adapter->shards[queue_info->shard];
+	if (!(pollq && conf->servicing_weight) &&
+	    !(intrq && !conf->servicing_weight)) {
+		if (pollq || intrq) {
+			rxa_vector_free(shard, &queue_info->vector_data);
+			shard->nb_queues--;
+		}
+		queue_info->shard = rxa_select_shard(rx_adapter,
+						conf->servicing_weight);
+		shard = &rx_adapter->shards[queue_info->shard];
+		shard->nb_queues++;
+	}
+
 	queue_info->wt = conf->servicing_weight;
 
 	qi_ev = (struct rte_event *)&queue_info->event;
@@ -1727,6 +2123,17 @@ rxa_add_queue(struct rte_event_eth_rx_adapter *rx_adapter,
 	} else
 		qi_ev->flow_id = 0;
 
+	/* Vectorization is enabled by the vector configuration */
+	queue_info->vector_requested = !!(conf->rx_queue_flags &
+			RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR);
+	if (!queue_info->vector_requested) {
+		rxa_vector_free(shard, &queue_info->vector_data);
+		queue_info->ena_vector = 0;
+	} else if (queue_info->ena_vector) {
+		rxa_set_vector_event(queue_info,
+			dev_info->dev->data->port_id, rx_queue_id);
+	}
+
 	rxa_update_queue(rx_adapter, dev_info, rx_queue_id, 1);
 	if (rxa_polled_queue(dev_info, rx_queue_id)) {
 		rx_adapter->num_rx_polled += !pollq;
@@ -1859,6 +2266,7 @@ static int rxa_sw_add(struct rte_event_eth_rx_adapter *rx_adapter,
 
 	rxa_add_queue(rx_adapter, dev_info, rx_queue_id, queue_conf);
 	rxa_calc_wrr_sequence(rx_adapter, rx_poll, rx_wrr);
+	rxa_calc_vector_tmo(rx_adapter);
 
 	rte_free(rx_adapter->eth_rx_poll);
 	rte_free(rx_adapter->wrr_sched);
@@ -1918,8 +2326,12 @@ rxa_ctrl(uint8_t id, int start)
 
 	if (use_service) {
 		rte_spinlock_lock(&rx_adapter->rx_lock);
+		rxa_shards_lock(rx_adapter);
 		rx_adapter->rxa_started = start;
-		rte_service_runstate_set(rx_adapter->service_id, start);
+		for (i = 0; i < rx_adapter->nb_shards; i++)
+			rte_service_runstate_set(
+				rx_adapter->shards[i].service_id, start);
+		rxa_shards_unlock(rx_adapter);
 		rte_spinlock_unlock(&rx_adapter->rx_lock);
 	}
 
@@ -1993,6 +2405,7 @@ rte_event_eth_rx_adapter_create_ext(uint8_t id, uint8_t dev_id,
 		return -ENOMEM;
 	}
 	rte_spinlock_init(&rx_adapter->rx_lock);
+	rx_adapter->nb_shards = 1;
 	for (i = 0; i < RTE_MAX_ETHPORTS; i++)
 		rx_adapter->eth_devices[i].dev = &rte_eth_devices[i];
 
@@ -2046,6 +2459,7 @@ rte_event_eth_rx_adapter_free(uint8_t id)
 
 	if (rx_adapter->default_cb_arg)
 		rte_free(rx_adapter->conf_arg);
+	rte_free(rx_adapter->shards);
 	rte_free(rx_adapter->eth_devices);
 	rte_free(rx_adapter);
 	event_eth_rx_adapter[id] = NULL;
@@ -2092,6 +2506,15 @@ rte_event_eth_rx_adapter_queue_add(uint8_t id,
 		return -EINVAL;
 	}
 
+	if ((cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT) &&
+		(queue_conf->rx_queue_flags &
+			RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR)) {
+		RTE_EDEV_LOG_ERR("Event vectorization is not supported,"
+				" eth port: %" PRIu16 " adapter id: %" PRIu8,
+				eth_dev_id, id);
+		return -ENOTSUP;
+	}
+
 	if ((cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_MULTI_EVENTQ) == 0 &&
 		(rx_queue_id != -1)) {
 		RTE_EDEV_LOG_ERR("Rx queues can only be connected to single "
@@ -2137,11 +2560,11 @@ rte_event_eth_rx_adapter_queue_add(uint8_t id,
 		dev_info->internal_event_port = 0;
 		ret = rxa_init_service(rx_adapter, id);
 		if (ret == 0) {
-			uint32_t service_id = rx_adapter->service_id;
+			rxa_shards_lock(rx_adapter);
 			ret = rxa_sw_add(rx_adapter, eth_dev_id, rx_queue_id,
 					queue_conf);
-			rte_service_component_runstate_set(service_id,
-				rxa_sw_adapter_queue_count(rx_adapter));
+			rxa_shards_unlock(rx_adapter);
+			rxa_shards_runstate_set(rx_adapter);
 		}
 		rte_spinlock_unlock(&rx_adapter->rx_lock);
 	}
@@ -2219,6 +2642,7 @@ rte_event_eth_rx_adapter_queue_del(uint8_t id, uint16_t eth_dev_id,
 			return ret;
 
 		rte_spinlock_lock(&rx_adapter->rx_lock);
+		rxa_shards_lock(rx_adapter);
 
 		num_intr_vec = 0;
 		if (rx_adapter->num_rx_intr > nb_rx_intr) {
@@ -2239,6 +2663,7 @@ rte_event_eth_rx_adapter_queue_del(uint8_t id, uint16_t eth_dev_id,
 
 		rxa_sw_del(rx_adapter, dev_info, rx_queue_id);
 		rxa_calc_wrr_sequence(rx_adapter, rx_poll, rx_wrr);
+		rxa_calc_vector_tmo(rx_adapter);
 
 		rte_free(rx_adapter->eth_rx_poll);
 		rte_free(rx_adapter->wrr_sched);
@@ -2258,15 +2683,15 @@ rte_event_eth_rx_adapter_queue_del(uint8_t id, uint16_t eth_dev_id,
 			dev_info->rx_queue = NULL;
 		}
 unlock_ret:
+		rxa_shards_unlock(rx_adapter);
+		if (ret == 0)
+			rxa_shards_runstate_set(rx_adapter);
 		rte_spinlock_unlock(&rx_adapter->rx_lock);
 		if (ret) {
 			rte_free(rx_poll);
 			rte_free(rx_wrr);
 			return ret;
 		}
-
-		rte_service_component_runstate_set(rx_adapter->service_id,
-				rxa_sw_adapter_queue_count(rx_adapter));
 	}
 
 	rte_eventdev_trace_eth_rx_adapter_queue_del(id, eth_dev_id,
@@ -2288,6 +2713,26 @@ rte_event_eth_rx_adapter_stop(uint8_t id)
 	return rxa_ctrl(id, 0);
 }
 
+/* Aggregate the stats of a shard */
+static void
+rxa_stats_add(struct rte_event_eth_rx_adapter_stats *stats,
+	const struct rte_event_eth_rx_adapter_stats *shard_stats)
+{
+	stats->rx_poll_count += shard_stats->rx_poll_count;
+	stats->rx_packets += shard_stats->rx_packets;
+	stats->rx_enq_count += shard_stats->rx_enq_count;
+	stats->rx_enq_retry += shard_stats->rx_enq_retry;
+	stats->rx_dropped += shard_stats->rx_dropped;
+	if (shard_stats->rx_enq_start_ts != 0 &&
+	    (stats->rx_enq_start_ts == 0 ||
+	     shard_stats->rx_enq_start_ts < stats->rx_enq_start_ts))
+		stats->rx_enq_start_ts = shard_stats->rx_enq_start_ts;
+	stats->rx_enq_block_cycles += shard_stats->rx_enq_block_cycles;
+	stats->rx_enq_end_ts = RTE_MAX(stats->rx_enq_end_ts,
+				shard_stats->rx_enq_end_ts);
+	stats->rx_intr_packets += shard_stats->rx_intr_packets;
+}
+
 int
 rte_event_eth_rx_adapter_stats_get(uint8_t id,
 			       struct rte_event_eth_rx_adapter_stats *stats)
@@ -2322,8 +2767,9 @@ rte_event_eth_rx_adapter_stats_get(uint8_t id,
 		dev_stats_sum.rx_enq_count += dev_stats.rx_enq_count;
 	}
 
-	if (rx_adapter->service_inited)
-		*stats = rx_adapter->stats;
+	for (i = 0; rx_adapter->service_inited &&
+			i < rx_adapter->nb_shards; i++)
+		rxa_stats_add(stats, &rx_adapter->shards[i].stats);
 
 	stats->rx_packets += dev_stats_sum.rx_packets;
 	stats->rx_enq_count += dev_stats_sum.rx_enq_count;
@@ -2354,7 +2800,10 @@ rte_event_eth_rx_adapter_stats_reset(uint8_t id)
 							&rte_eth_devices[i]);
 	}
 
-	memset(&rx_adapter->stats, 0, sizeof(rx_adapter->stats));
+	for (i = 0; rx_adapter->service_inited &&
+			i < rx_adapter->nb_shards; i++)
+		memset(&rx_adapter->shards[i].stats, 0,
+			sizeof(rx_adapter->shards[i].stats));
 	return 0;
 }
 
@@ -2370,7 +2819,50 @@ rte_event_eth_rx_adapter_service_id_get(uint8_t id, uint32_t *service_id)
 		return -EINVAL;
 
 	if (rx_adapter->service_inited)
-		*service_id = rx_adapter->service_id;
+		*service_id = rx_adapter->shards[0].service_id;
+
+	return rx_adapter->service_inited ? 0 : -ESRCH;
+}
+
+int
+rte_event_eth_rx_adapter_shards_set(uint8_t id, uint16_t nb_shards)
+{
+	struct rte_event_eth_rx_adapter *rx_adapter;
+	int ret = 0;
+
+	RTE_EVENT_ETH_RX_ADAPTER_ID_VALID_OR_ERR_RET(id, -EINVAL);
+
+	rx_adapter = rxa_id_to_adapter(id);
+	if (rx_adapter == NULL || nb_shards == 0 || nb_shards > RTE_MAX_LCORE)
+		return -EINVAL;
+
+	rte_spinlock_lock(&rx_adapter->rx_lock);
+	if (rx_adapter->service_inited) {
+		RTE_EDEV_LOG_ERR("Rx adapter %" PRIu8 " service already"
+				" initialized", id);
+		ret = -EBUSY;
+	} else
+		rx_adapter->nb_shards = nb_shards;
+	rte_spinlock_unlock(&rx_adapter->rx_lock);
+
+	return ret;
+}
+
+int
+rte_event_eth_rx_adapter_shard_service_id_get(uint8_t id, uint16_t shard_id,
+					uint32_t *service_id)
+{
+	struct rte_event_eth_rx_adapter *rx_adapter;
+
+	RTE_EVENT_ETH_RX_ADAPTER_ID_VALID_OR_ERR_RET(id, -EINVAL);
+
+	rx_adapter = rxa_id_to_adapter(id);
+	if (rx_adapter == NULL || service_id == NULL ||
+	    shard_id >= rx_adapter->nb_shards)
+		return -EINVAL;
+
+	if (rx_adapter->service_inited)
+		*service_id = rx_adapter->shards[shard_id].service_id;
 
 	return rx_adapter->service_inited ? 0 : -ESRCH;
 }
@@ -2413,9 +2905,152 @@ rte_event_eth_rx_adapter_cb_register(uint8_t id,
 	}
 
 	rte_spinlock_lock(&rx_adapter->rx_lock);
+	rxa_shards_lock(rx_adapter);
 	dev_info->cb_fn = cb_fn;
 	dev_info->cb_arg = cb_arg;
+	rxa_shards_unlock(rx_adapter);
 	rte_spinlock_unlock(&rx_adapter->rx_lock);
 
 	return 0;
 }
+
+int
+rte_event_eth_rx_adapter_vector_limits_get(
+	uint8_t dev_id, uint16_t eth_port_id,
+	struct rte_event_eth_rx_adapter_vector_limits *limits)
+{
+	uint32_t cap;
+	int ret;
+
+	RTE_EVENTDEV_VALID_DEVID_OR_ERR_RET(dev_id, -EINVAL);
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(eth_port_id, -EINVAL);
+
+	if (limits == NULL)
+		return -EINVAL;
+
+	ret = rte_event_eth_rx_adapter_caps_get(dev_id, eth_port_id, &cap);
+	if (ret) {
+		RTE_EDEV_LOG_ERR("Failed to get adapter caps edev %" PRIu8
+				 "eth port %" PRIu16,
+				 dev_id, eth_port_id);
+		return ret;
+	}
+
+	if (cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT)
+		return -ENOTSUP;
+
+	limits->max_sz = MAX_VECTOR_SIZE;
+	limits->min_sz = MIN_VECTOR_SIZE;
+	limits->max_timeout_ns = MAX_VECTOR_NS;
+	limits->min_timeout_ns = MIN_VECTOR_NS;
+	limits->log2_sz = 0;
+
+	return 0;
+}
+
+static void
+rxa_config_vector(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct eth_device_info *dev_info, uint16_t rx_queue_id,
+		const struct rte_event_eth_rx_adapter_event_vector_config *config)
+{
+	struct eth_rx_queue_info *queue_info;
+	struct eth_rx_vector_data *vec;
+	struct eth_rx_shard *shard;
+
+	queue_info = &dev_info->rx_queue[rx_queue_id];
+	vec = &queue_info->vector_data;
+	shard = &rx_adapter->shards[queue_info->shard];
+
+	/* Enqueued with the previous configuration */
+	rxa_vector_free(shard, vec);
+
+	vec->max_vector_count = config->vector_sz;
+	vec->vector_timeout_ticks = RTE_MAX(config->vector_timeout_ns *
+			rte_get_timer_hz() / 1E9, 1);
+	vec->vector_pool = config->vector_mp;
+	rxa_set_vector_event(queue_info, dev_info->dev->data->port_id,
+			     rx_queue_id);
+	queue_info->ena_vector = 1;
+}
+
+int
+rte_event_eth_rx_adapter_queue_event_vector_config(
+	uint8_t id, uint16_t eth_dev_id, int32_t rx_queue_id,
+	struct rte_event_eth_rx_adapter_event_vector_config *config)
+{
+	struct rte_event_eth_rx_adapter_vector_limits limits;
+	struct rte_event_eth_rx_adapter *rx_adapter;
+	struct eth_device_info *dev_info;
+	uint16_t nb_rx_queues, i;
+	int ret;
+
+	RTE_EVENT_ETH_RX_ADAPTER_ID_VALID_OR_ERR_RET(id, -EINVAL);
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(eth_dev_id, -EINVAL);
+
+	rx_adapter = rxa_id_to_adapter(id);
+	if ((rx_adapter == NULL) || (config == NULL))
+		return -EINVAL;
+
+	ret = rte_event_eth_rx_adapter_vector_limits_get(
+		rx_adapter->eventdev_id, eth_dev_id, &limits);
+	if (ret) {
+		RTE_EDEV_LOG_ERR("Event vectorization is not supported,"
+				 " eth port: %" PRIu16 " adapter id: %" PRIu8,
+				 eth_dev_id, id);
+		return ret;
+	}
+
+	if (config->vector_sz < limits.min_sz ||
+	    config->vector_sz > limits.max_sz ||
+	    config->vector_timeout_ns < limits.min_timeout_ns ||
+	    config->vector_timeout_ns > limits.max_timeout_ns ||
+	    config->vector_mp == NULL) {
+		RTE_EDEV_LOG_ERR("Invalid event vector configuration,"
+				 " eth port: %" PRIu16 " adapter id: %" PRIu8,
+				 eth_dev_id, id);
+		return -EINVAL;
+	}
+	if (config->vector_mp->elt_size <
+	    (sizeof(struct rte_event_vector) +
+	     (sizeof(uintptr_t) * config->vector_sz))) {
+		RTE_EDEV_LOG_ERR("Invalid event vector mempool element size,"
+				 " eth port: %" PRIu16 " adapter id: %" PRIu8,
+				 eth_dev_id, id);
+		return -EINVAL;
+	}
+
+	dev_info = &rx_adapter->eth_devices[eth_dev_id];
+	nb_rx_queues = dev_info->dev->data->nb_rx_queues;
+	if (dev_info->rx_queue == NULL ||
+	    (rx_queue_id != -1 && (uint16_t)rx_queue_id >= nb_rx_queues))
+		return -EINVAL;
+
+	rte_spinlock_lock(&rx_adapter->rx_lock);
+	rxa_shards_lock(rx_adapter);
+
+	if (rx_queue_id == -1) {
+		for (i = 0; i < nb_rx_queues; i++)
+			if (!dev_info->rx_queue[i].vector_requested) {
+				ret = -EINVAL;
+				goto unlock;
+			}
+		for (i = 0; i < nb_rx_queues; i++)
+			rxa_config_vector(rx_adapter, dev_info, i, config);
+	} else {
+		if (!dev_info->rx_queue[rx_queue_id].vector_requested) {
+			ret = -EINVAL;
+			goto unlock;
+		}
+		rxa_config_vector(rx_adapter, dev_info, rx_queue_id, config);
+	}
+	rxa_calc_vector_tmo(rx_adapter);
+
+unlock:
+	rxa_shards_unlock(rx_adapter);
+	rte_spinlock_unlock(&rx_adapter->rx_lock);
+	if (ret)
+		RTE_EDEV_LOG_ERR("Rx queue not added with event vector flag,"
+				 " eth port: %" PRIu16 " adapter id: %" PRIu8,
+				 eth_dev_id, id);
+	return ret;
+}
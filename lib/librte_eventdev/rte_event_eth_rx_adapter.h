@@ -37,6 +37,10 @@
  *  - rte_event_eth_rx_adapter_stop()
  *  - rte_event_eth_rx_adapter_stats_get()
  *  - rte_event_eth_rx_adapter_stats_reset()
+ *  - rte_event_eth_rx_adapter_vector_limits_get()
+ *  - rte_event_eth_rx_adapter_queue_event_vector_config()
+ *  - rte_event_eth_rx_adapter_shards_set()
+ *  - rte_event_eth_rx_adapter_shard_service_id_get()
  *
  * The application creates an ethernet to event adapter using
  * rte_event_eth_rx_adapter_create_ext() or rte_event_eth_rx_adapter_create()
@@ -77,6 +81,26 @@
  * allows the application to register a callback that selects which packets are
  * enqueued to the event device by the SW adapter. The callback interface is
  * event based so the callback can also modify the event data if it needs to.
+ *
+ * For SW based packet transfers, the adapter can also aggregate the mbufs of
+ * an Rx queue into event vectors, so that the event device schedules up to
+ * vector size mbufs at the cost of a single event. The Rx queue is added with
+ * the RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR flag, then configured with
+ * rte_event_eth_rx_adapter_queue_event_vector_config() before the adapter is
+ * started. A vector is enqueued when it is full or when its oldest mbuf has
+ * waited for the vector timeout. The Rx callback is not invoked for the
+ * queues aggregating vectors.
+ *
+ * A single service function may not keep up with the Rx queues of several
+ * high speed ethernet devices. The SW adapter can be split into shards with
+ * rte_event_eth_rx_adapter_shards_set() before its first Rx queue is added.
+ * Each shard is a service function with its own event port, event buffer
+ * and statistics, polling a disjoint subset of the Rx queues, so that the
+ * shards run on different service cores without contention. A new Rx queue
+ * is assigned to the shard with the fewest queues, the interrupt driven
+ * queues are serviced by the first shard. The
+ * rte_event_eth_rx_adapter_shard_service_id_get() function retrieves the
+ * service function ID of each shard.
  */
 
 #ifdef __cplusplus
@@ -96,6 +120,10 @@ extern "C" {
 /**< This flag indicates the flow identifier is valid
  * @see rte_event_eth_rx_adapter_queue_conf::rx_queue_flags
  */
+#define RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR	0x2
+/**< This flag indicates that mbufs arriving on the queue need to be vectorized
+ * @see rte_event_eth_rx_adapter_queue_event_vector_config()
+ */
 
 /**
  * Adapter configuration structure that the adapter configuration callback
@@ -120,7 +148,9 @@ struct rte_event_eth_rx_adapter_conf {
  * callback is invoked when creating a SW service for packet transfer from
  * ethdev queues to the event device. The SW service is created within the
  * rte_event_eth_rx_adapter_queue_add() function if SW based packet transfers
- * from ethdev queues to the event device are required.
+ * from ethdev queues to the event device are required. The callback is
+ * invoked once per shard of the adapter and must provide a distinct event
+ * port on each invocation.
  *
  * @param id
  *  Adapter identifier.
@@ -146,6 +176,7 @@ struct rte_event_eth_rx_adapter_queue_conf {
 	uint32_t rx_queue_flags;
 	 /**< Flags for handling received packets
 	  * @see RTE_EVENT_ETH_RX_ADAPTER_QUEUE_FLOW_ID_VALID
+	  * @see RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR
 	  */
 	uint16_t servicing_weight;
 	/**< Relative polling frequency of ethernet receive queue when the
@@ -173,8 +204,58 @@ struct rte_event_eth_rx_adapter_queue_conf {
 	 */
 };
 
+/**
+ * Rx queue event vector configuration structure
+ */
+struct rte_event_eth_rx_adapter_event_vector_config {
+	uint16_t vector_sz;
+	/**< Indicates the maximum number for mbufs to combine and form a vector.
+	 * Should be within vectorization limits of the adapter.
+	 * @see rte_event_eth_rx_adapter_vector_limits_get()
+	 */
+	uint64_t vector_timeout_ns;
+	/**< Maximum number of nanoseconds to wait for aggregating mbufs.
+	 * Should be within vectorization limits of the adapter.
+	 * @see rte_event_eth_rx_adapter_vector_limits_get()
+	 */
+	struct rte_mempool *vector_mp;
+	/**< Indicates the mempool that should be used for allocating
+	 * rte_event_vector container.
+	 * @see rte_event_vector_pool_create()
+	 */
+};
+
+/**
+ * A structure used to retrieve event vectorization limits of an Rx adapter.
+ */
+struct rte_event_eth_rx_adapter_vector_limits {
+	uint16_t min_sz;
+	/**< Minimum vector limit configurable.
+	 * @see rte_event_eth_rx_adapter_event_vector_config::vector_sz
+	 */
+	uint16_t max_sz;
+	/**< Maximum vector limit configurable.
+	 * @see rte_event_eth_rx_adapter_event_vector_config::vector_sz
+	 */
+	uint8_t log2_sz;
+	/**< True if the size configured should be in log2.
+	 * @see rte_event_eth_rx_adapter_event_vector_config::vector_sz
+	 */
+	uint64_t min_timeout_ns;
+	/**< Minimum vector timeout configurable.
+	 * @see rte_event_eth_rx_adapter_event_vector_config::vector_timeout_ns
+	 */
+	uint64_t max_timeout_ns;
+	/**< Maximum vector timeout configurable.
+	 * @see rte_event_eth_rx_adapter_event_vector_config::vector_timeout_ns
+	 */
+};
+
 /**
  * A structure used to retrieve statistics for an eth rx adapter instance.
+ * The statistics of the shards of a SW adapter are aggregated: the counts
+ * and blocked cycles are summed, the start timestamp is the earliest one
+ * and the end timestamp the latest one.
  */
 struct rte_event_eth_rx_adapter_stats {
 	uint64_t rx_poll_count;
@@ -435,7 +516,8 @@ int rte_event_eth_rx_adapter_stats_reset(uint8_t id);
 
 /**
  * Retrieve the service ID of an adapter. If the adapter doesn't use
- * a rte_service function, this function returns -ESRCH.
+ * a rte_service function, this function returns -ESRCH. The service ID of
+ * the first shard is returned if the adapter has several shards.
  *
  * @param id
  *  Adapter identifier.
@@ -450,6 +532,55 @@ int rte_event_eth_rx_adapter_stats_reset(uint8_t id);
  */
 int rte_event_eth_rx_adapter_service_id_get(uint8_t id, uint32_t *service_id);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Set the number of shards, i.e. service functions, of a SW adapter. The
+ * Rx queues of the adapter are distributed among the shards. This function
+ * must be called before the first Rx queue using SW based packet transfer
+ * is added, an adapter has a single shard by default.
+ *
+ * @param id
+ *  Adapter identifier.
+ *
+ * @param nb_shards
+ *  Number of shards, up to RTE_MAX_LCORE.
+ *
+ * @return
+ *  - 0: Success
+ *  - -EINVAL: Invalid adapter identifier or number of shards.
+ *  - -EBUSY: The service functions of the adapter are already created.
+ */
+__rte_experimental
+int rte_event_eth_rx_adapter_shards_set(uint8_t id, uint16_t nb_shards);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Retrieve the service ID of a shard of an adapter. If the adapter doesn't
+ * use a rte_service function, this function returns -ESRCH.
+ *
+ * @param id
+ *  Adapter identifier.
+ *
+ * @param shard_id
+ *  Shard index, less than the number of shards of the adapter.
+ *
+ * @param [out] service_id
+ *  A pointer to a uint32_t, to be filled in with the service id.
+ *
+ * @return
+ *  - 0: Success
+ *  - <0: Error code on failure, if the adapter doesn't use a rte_service
+ * function, this function returns -ESRCH.
+ */
+__rte_experimental
+int rte_event_eth_rx_adapter_shard_service_id_get(uint8_t id,
+						uint16_t shard_id,
+						uint32_t *service_id);
+
 /**
  * Register callback to process Rx packets, this is supported for
  * SW based packet transfers.
@@ -471,6 +602,66 @@ int rte_event_eth_rx_adapter_cb_register(uint8_t id, uint16_t eth_dev_id,
 					 rte_event_eth_rx_adapter_cb_fn cb_fn,
 					 void *cb_arg);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Retrieve vector limits for a given event dev and eth dev pair.
+ * @see rte_event_eth_rx_adapter_vector_limits
+ *
+ * @param dev_id
+ *  Event device identifier.
+ * @param eth_port_id
+ *  Port identifier of the ethernet device.
+ * @param [out] limits
+ *  A pointer to rte_event_eth_rx_adapter_vector_limits structure that has to
+ *  be filled.
+ *
+ * @return
+ *  - 0: Success.
+ *  - -EINVAL: Invalid parameters.
+ *  - -ENOTSUP: The packet transfer of the ethernet device uses an internal
+ *    event port, which doesn't support vectorization.
+ */
+__rte_experimental
+int rte_event_eth_rx_adapter_vector_limits_get(
+	uint8_t dev_id, uint16_t eth_port_id,
+	struct rte_event_eth_rx_adapter_vector_limits *limits);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Configure event vectorization for a given ethernet device queue, that has
+ * been added to an event eth Rx adapter with the
+ * RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR flag.
+ *
+ * The mbufs of the queue are then enqueued in events of type
+ * RTE_EVENT_TYPE_ETH_RX_ADAPTER_VECTOR, with the attributes of the queue
+ * event, and the port and queue of the vector set. If the flow identifier of
+ * the queue isn't valid, the flow identifier of the vectors is derived from
+ * the port and queue identifiers, keeping the vectors of a queue in order.
+ *
+ * @param id
+ *  The identifier of the ethernet Rx event adapter.
+ * @param eth_dev_id
+ *  The identifier of the ethernet device.
+ * @param rx_queue_id
+ *  Ethernet device receive queue index.
+ *  If rx_queue_id is -1, then all Rx queues configured for the ethernet device
+ *  are configured with event vectorization.
+ * @param config
+ *  Event vector configuration structure.
+ *
+ * @return
+ *  - 0: Success, Receive queue configured correctly.
+ *  - <0: Error code on failure.
+ */
+__rte_experimental
+int rte_event_eth_rx_adapter_queue_event_vector_config(
+	uint8_t id, uint16_t eth_dev_id, int32_t rx_queue_id,
+	struct rte_event_eth_rx_adapter_event_vector_config *config);
+
 #ifdef __cplusplus
 }
 #endif
@@ -510,6 +510,45 @@ txa_service_buffer_retry(struct rte_mbuf **pkts, uint16_t unsent,
 	stats->tx_dropped += unsent - sent;
 }
 
+static uint16_t
+txa_service_tx_mbuf(struct txa_service_data *txa, struct rte_mbuf *m,
+	uint16_t port, uint16_t queue)
+{
+	struct txa_service_queue_info *tqi;
+
+	tqi = txa_service_queue(txa, port, queue);
+	if (unlikely(tqi == NULL || !tqi->added)) {
+		rte_pktmbuf_free(m);
+		return 0;
+	}
+
+	return rte_eth_tx_buffer(port, queue, tqi->tx_buf, m);
+}
+
+/* Transmit the mbufs of a vector and free the vector */
+static uint16_t
+txa_service_tx_vector(struct txa_service_data *txa,
+	struct rte_event_vector *vec)
+{
+	uint16_t nb_tx;
+	uint16_t i;
+
+	nb_tx = 0;
+	for (i = 0; i < vec->nb_elem; i++) {
+		struct rte_mbuf *m = vec->mbufs[i];
+
+		if (vec->attr_valid)
+			nb_tx += txa_service_tx_mbuf(txa, m, vec->port,
+						vec->queue);
+		else
+			nb_tx += txa_service_tx_mbuf(txa, m, m->port,
+					rte_event_eth_tx_adapter_txq_get(m));
+	}
+
+	rte_mempool_put(rte_mempool_from_obj(vec), vec);
+	return nb_tx;
+}
+
 static void
 txa_service_tx(struct txa_service_data *txa, struct rte_event *ev,
 	uint32_t n)
@@ -523,26 +562,43 @@ txa_service_tx(struct txa_service_data *txa, struct rte_event *ev,
 	nb_tx = 0;
 	for (i = 0; i < n; i++) {
 		struct rte_mbuf *m;
-		uint16_t port;
-		uint16_t queue;
-		struct txa_service_queue_info *tqi;
-
-		m = ev[i].mbuf;
-		port = m->port;
-		queue = rte_event_eth_tx_adapter_txq_get(m);
 
-		tqi = txa_service_queue(txa, port, queue);
-		if (unlikely(tqi == NULL || !tqi->added)) {
-			rte_pktmbuf_free(m);
+		if (ev[i].event_type & RTE_EVENT_TYPE_VECTOR) {
+			nb_tx += txa_service_tx_vector(txa, ev[i].vec);
 			continue;
 		}
 
-		nb_tx += rte_eth_tx_buffer(port, queue, tqi->tx_buf, m);
+		m = ev[i].mbuf;
+		nb_tx += txa_service_tx_mbuf(txa, m, m->port,
+				rte_event_eth_tx_adapter_txq_get(m));
 	}
 
 	stats->tx_packets += nb_tx;
 }
 
+/* Check if packets are waiting in the tx buffers for the next flush */
+static int
+txa_service_tx_buffered(struct txa_service_data *txa)
+{
+	struct txa_service_ethdev *tdi;
+	struct txa_service_queue_info *tqi;
+	uint16_t i, q;
+
+	tdi = txa->txa_ethdev;
+	for (i = 0; i < txa->dev_count; i++) {
+		if (tdi[i].nb_queues == 0)
+			continue;
+		for (q = 0; q < tdi[i].dev->data->nb_tx_queues; q++) {
+			tqi = txa_service_queue(txa, i, q);
+			if (tqi != NULL && tqi->added &&
+					tqi->tx_buf->length != 0)
+				return 1;
+		}
+	}
+
+	return 0;
+}
+
 static int32_t
 txa_service_func(void *args)
 {
@@ -552,13 +608,14 @@ txa_service_func(void *args)
 	uint16_t n;
 	uint32_t nb_tx, max_nb_tx;
 	struct rte_event ev[TXA_BATCH_SIZE];
+	int ret;
 
 	dev_id = txa->eventdev_id;
 	max_nb_tx = txa->max_nb_tx;
 	port = txa->port_id;
 
 	if (txa->nb_queues == 0)
-		return 0;
+		return -EAGAIN;
 
 	if (!rte_spinlock_trylock(&txa->tx_lock))
 		return 0;
@@ -570,6 +627,7 @@ txa_service_func(void *args)
 			break;
 		txa_service_tx(txa, ev, n);
 	}
+	ret = nb_tx == 0 ? -EAGAIN : 0;
 
 	if ((txa->loop_cnt++ & (TXA_FLUSH_THRESHOLD - 1)) == 0) {
 
@@ -603,8 +661,13 @@ txa_service_func(void *args)
 
 		txa->stats.tx_packets += nb_tx;
 	}
+
+	/* Keep polling until the buffered packets are flushed */
+	if (ret == -EAGAIN && txa_service_tx_buffered(txa))
+		ret = 0;
+
 	rte_spinlock_unlock(&txa->tx_lock);
-	return 0;
+	return ret;
 }
 
 static int
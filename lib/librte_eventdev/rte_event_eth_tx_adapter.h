@@ -68,6 +68,11 @@
  * and rte_event_eth_tx_adapter_txq_get() functions to access the transmit
  * queue index, using these macros will help with minimizing application
  * impact due to a change in how the transmit queue index is specified.
+ *
+ * The common implementation also transmits the mbufs of the events with
+ * #RTE_EVENT_TYPE_VECTOR set in their event type. The port and queue of the
+ * vector are used when its attr_valid field is set, else the ones of each
+ * mbuf. The vector is then returned to its mempool.
  */
 
 #ifdef __cplusplus
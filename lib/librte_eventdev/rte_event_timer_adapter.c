@@ -564,6 +564,10 @@ struct swtim {
 	struct rte_timer *expired_timers[EXP_TIM_BUF_SZ];
 	/* The number of timers that can be returned to a mempool */
 	size_t n_expired_timers;
+	/* The number of armed timers, the service is idle without any */
+	uint64_t n_armed;
+	/* The number of timers expired in the current tick */
+	uint64_t n_tick_expired;
 };
 
 static inline struct swtim *
@@ -628,6 +632,7 @@ swtim_callback(struct rte_timer *tim)
 
 		sw->expired_timers[sw->n_expired_timers++] = tim;
 		sw->stats.evtim_exp_count++;
+		sw->n_tick_expired++;
 
 		__atomic_store_n(&evtim->state, RTE_EVENT_TIMER_NOT_ARMED,
 				__ATOMIC_RELEASE);
@@ -733,10 +738,13 @@ swtim_service_func(void *arg)
 	uint16_t nb_evs_invalid = 0;
 
 	if (swtim_did_tick(sw)) {
+		sw->n_tick_expired = 0;
 		rte_timer_alt_manage(sw->timer_data_id,
 				     sw->poll_lcores,
 				     sw->n_poll_lcores,
 				     swtim_callback);
+		__atomic_fetch_sub(&sw->n_armed, sw->n_tick_expired,
+				   __ATOMIC_RELAXED);
 
 		/* Return expired timer objects back to mempool */
 		rte_mempool_put_bulk(sw->tim_pool, (void **)sw->expired_timers,
@@ -754,6 +762,11 @@ swtim_service_func(void *arg)
 		sw->stats.adapter_tick_count++;
 	}
 
+	/* Timers expiring in a later tick still need the service to run */
+	if (__atomic_load_n(&sw->n_armed, __ATOMIC_RELAXED) == 0 &&
+	    sw->buffer.head == sw->buffer.tail)
+		return -EAGAIN;
+
 	return 0;
 }
 
@@ -1061,6 +1074,9 @@ __swtim_arm_burst(const struct rte_event_timer_adapter *adapter,
 		return 0;
 	}
 
+	/* Counted before being armed, the service cannot miss them */
+	__atomic_fetch_add(&sw->n_armed, nb_evtims, __ATOMIC_RELAXED);
+
 	for (i = 0; i < nb_evtims; i++) {
 		n_state = __atomic_load_n(&evtims[i]->state, __ATOMIC_ACQUIRE);
 		if (n_state == RTE_EVENT_TIMER_ARMED) {
@@ -1121,9 +1137,12 @@ __swtim_arm_burst(const struct rte_event_timer_adapter *adapter,
 				__ATOMIC_RELEASE);
 	}
 
-	if (i < nb_evtims)
+	if (i < nb_evtims) {
 		rte_mempool_put_bulk(sw->tim_pool,
 				     (void **)&tims[i], nb_evtims - i);
+		__atomic_fetch_sub(&sw->n_armed, nb_evtims - i,
+				   __ATOMIC_RELAXED);
+	}
 
 	return i;
 }
@@ -1190,6 +1209,9 @@ swtim_cancel_burst(const struct rte_event_timer_adapter *adapter,
 				__ATOMIC_RELEASE);
 	}
 
+	if (i > 0)
+		__atomic_fetch_sub(&sw->n_armed, i, __ATOMIC_RELAXED);
+
 	return i;
 }
 
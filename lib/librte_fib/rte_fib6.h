@@ -59,6 +59,16 @@ enum rte_fib_trie_nh_sz {
 	RTE_FIB6_TRIE_8B
 };
 
+/** Type of lookup function implementation */
+enum rte_fib_trie_lookup_type {
+	RTE_FIB6_TRIE_SCALAR,
+	/**< Scalar lookup function implementation */
+	RTE_FIB6_TRIE_VECTOR_AVX512,
+	/**< Vector implementation using AVX512 */
+	RTE_FIB6_TRIE_ANY,
+	/**< Fastest implementation supported by the build and the CPU */
+};
+
 /** FIB configuration structure */
 struct rte_fib6_conf {
 	enum rte_fib6_type type; /**< Type of FIB struct */
@@ -175,6 +185,26 @@ rte_fib6_lookup_bulk(struct rte_fib6 *fib,
 	uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
 	uint64_t *next_hops, int n);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Set lookup function based on type
+ *
+ * @param fib
+ *   FIB object handle
+ * @param type
+ *   type of lookup function
+ *
+ * @return
+ *    -EINVAL on failure
+ *    0 on success
+ */
+__rte_experimental
+int
+rte_fib6_set_lookup_fn(struct rte_fib6 *fib,
+	enum rte_fib_trie_lookup_type type);
+
 /**
  * Get pointer to the dataplane specific struct
  *
@@ -0,0 +1,240 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <limits.h>
+
+#include <rte_vect.h>
+#include <rte_fib6.h>
+
+#include "trie.h"
+#include "trie_avx512.h"
+
+/*
+ * Byte swap 16 32-bit values. Rotations are used instead of
+ * the byte shuffle to stay within the AVX512F instruction set.
+ */
+static __rte_always_inline __m512i
+bswap_x16(__m512i v)
+{
+	return _mm512_or_si512(
+		_mm512_and_si512(_mm512_rol_epi32(v, 8),
+			_mm512_set1_epi32(0x00ff00ff)),
+		_mm512_and_si512(_mm512_ror_epi32(v, 8),
+			_mm512_set1_epi32(0xff00ff00)));
+}
+
+/*
+ * Load 16 IPv6 addresses and transpose them into 4 registers,
+ * so that register k keeps bytes [4 * k, 4 * k + 3] of every address
+ * as a host order 32-bit value, i.e. the first byte of the chunk
+ * is the most significant one.
+ */
+static __rte_always_inline void
+transpose_x16(uint8_t ips[16][RTE_FIB6_IPV6_ADDR_SIZE], __m512i chunk[4])
+{
+	__m512i tmp1, tmp2, tmp3, tmp4;
+	__m512i tmp5, tmp6, tmp7, tmp8;
+	const rte_zmm_t perm_idxes = {
+		.u32 = { 0, 4, 8, 12, 2, 6, 10, 14,
+			1, 5, 9, 13, 3, 7, 11, 15
+		},
+	};
+	/* load all ip addresses, one address per 128-bit lane */
+	tmp1 = _mm512_loadu_si512(&ips[0][0]);
+	tmp2 = _mm512_loadu_si512(&ips[4][0]);
+	tmp3 = _mm512_loadu_si512(&ips[8][0]);
+	tmp4 = _mm512_loadu_si512(&ips[12][0]);
+
+	/* transpose 4 byte chunks of 16 ips */
+	tmp5 = _mm512_unpacklo_epi32(tmp1, tmp2);
+	tmp7 = _mm512_unpackhi_epi32(tmp1, tmp2);
+	tmp6 = _mm512_unpacklo_epi32(tmp3, tmp4);
+	tmp8 = _mm512_unpackhi_epi32(tmp3, tmp4);
+
+	tmp1 = _mm512_unpacklo_epi32(tmp5, tmp6);
+	tmp3 = _mm512_unpackhi_epi32(tmp5, tmp6);
+	tmp2 = _mm512_unpacklo_epi32(tmp7, tmp8);
+	tmp4 = _mm512_unpackhi_epi32(tmp7, tmp8);
+
+	/* restore the order of ips and convert chunks to host byte order */
+	chunk[0] = bswap_x16(_mm512_permutexvar_epi32(perm_idxes.z, tmp1));
+	chunk[1] = bswap_x16(_mm512_permutexvar_epi32(perm_idxes.z, tmp3));
+	chunk[2] = bswap_x16(_mm512_permutexvar_epi32(perm_idxes.z, tmp2));
+	chunk[3] = bswap_x16(_mm512_permutexvar_epi32(perm_idxes.z, tmp4));
+}
+
+/*
+ * Get byte number *pos* of every ip from the transposed chunks.
+ */
+static __rte_always_inline __m512i
+get_byte_x16(const __m512i chunk[4], uint32_t pos)
+{
+	const __m512i lsbyte_msk = _mm512_set1_epi32(0xff);
+	__m128i shift;
+
+	shift = _mm_cvtsi32_si128((3 - (pos & 3)) * CHAR_BIT);
+	return _mm512_and_si512(_mm512_srl_epi32(chunk[pos >> 2], shift),
+		lsbyte_msk);
+}
+
+/*
+ * Lookup 16 IPv6 addresses at once for 2 and 4 byte next hops.
+ */
+static __rte_always_inline void
+trie_vec_lookup_x16(void *p, uint8_t ips[16][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, int size)
+{
+	struct rte_trie_tbl *dp = (struct rte_trie_tbl *)p;
+	const __m512i zero = _mm512_set1_epi32(0);
+	const __m512i lsb = _mm512_set1_epi32(1);
+	__m512i chunk[4];
+	__m512i idxes, res, tmp, res_msk;
+	__mmask16 msk_ext;
+	uint32_t pos;
+
+	if (size == sizeof(uint16_t))
+		res_msk = _mm512_set1_epi32(UINT16_MAX);
+	else
+		res_msk = _mm512_set1_epi32(UINT32_MAX);
+
+	transpose_x16(ips, chunk);
+
+	/* first 3 bytes of every ip are the tbl24 index */
+	idxes = _mm512_srli_epi32(chunk[0], 8);
+
+	/*
+	 * lookup in tbl24
+	 * scale has to be a compile time constant,
+	 * so keep every gather inside its own branch.
+	 */
+	if (size == sizeof(uint16_t))
+		res = _mm512_i32gather_epi32(idxes,
+			(const int *)dp->tbl24, 2);
+	else
+		res = _mm512_i32gather_epi32(idxes,
+			(const int *)dp->tbl24, 4);
+	res = _mm512_and_si512(res, res_msk);
+
+	/* walk tbl8 strides only for the ips with extended entries */
+	msk_ext = _mm512_test_epi32_mask(res, lsb);
+	for (pos = 3; msk_ext != 0; pos++) {
+		idxes = _mm512_srli_epi32(res, 1);
+		idxes = _mm512_slli_epi32(idxes, 8);
+		idxes = _mm512_maskz_add_epi32(msk_ext, idxes,
+			get_byte_x16(chunk, pos));
+		if (size == sizeof(uint16_t))
+			tmp = _mm512_mask_i32gather_epi32(zero, msk_ext,
+				idxes, (const int *)dp->tbl8, 2);
+		else
+			tmp = _mm512_mask_i32gather_epi32(zero, msk_ext,
+				idxes, (const int *)dp->tbl8, 4);
+		tmp = _mm512_and_si512(tmp, res_msk);
+
+		res = _mm512_mask_blend_epi32(msk_ext, res, tmp);
+		msk_ext = _mm512_test_epi32_mask(res, lsb);
+	}
+
+	res = _mm512_srli_epi32(res, 1);
+
+	/* zero extend 32-bit next hops to 64 bits and store them */
+	_mm512_storeu_si512(next_hops,
+		_mm512_cvtepu32_epi64(_mm512_castsi512_si256(res)));
+	_mm512_storeu_si512(next_hops + 8,
+		_mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(res, 1)));
+}
+
+/*
+ * Lookup 8 IPv6 addresses for 8 byte next hops.
+ * chunk[] keeps the transposed ips, *half* selects which 8 of them.
+ */
+static __rte_always_inline void
+trie_vec_lookup_x8_8b(void *p, const __m512i chunk[4], uint32_t half,
+	uint64_t *next_hops)
+{
+	struct rte_trie_tbl *dp = (struct rte_trie_tbl *)p;
+	const __m512i zero = _mm512_set1_epi32(0);
+	const __m512i lsb = _mm512_set1_epi64(1);
+	__m512i chunk64[4];
+	__m512i idxes, res, tmp;
+	__m256i idxes_256;
+	__mmask8 msk_ext;
+	uint32_t i, pos;
+
+	/* get 8 ips out of 16, one per 64-bit lane */
+	for (i = 0; i != RTE_DIM(chunk64); i++)
+		chunk64[i] = _mm512_cvtepu32_epi64((half == 0) ?
+			_mm512_castsi512_si256(chunk[i]) :
+			_mm512_extracti64x4_epi64(chunk[i], 1));
+
+	/* first 3 bytes of every ip are the tbl24 index */
+	idxes_256 = _mm512_cvtepi64_epi32(_mm512_srli_epi64(chunk64[0], 8));
+
+	/* lookup in tbl24 */
+	res = _mm512_i32gather_epi64(idxes_256, (const void *)dp->tbl24, 8);
+
+	/* walk tbl8 strides only for the ips with extended entries */
+	msk_ext = _mm512_test_epi64_mask(res, lsb);
+	for (pos = 3; msk_ext != 0; pos++) {
+		idxes = _mm512_srli_epi64(res, 1);
+		idxes = _mm512_slli_epi64(idxes, 8);
+		idxes = _mm512_maskz_add_epi64(msk_ext, idxes,
+			_mm512_and_si512(_mm512_srl_epi64(chunk64[pos >> 2],
+				_mm_cvtsi32_si128((3 - (pos & 3)) *
+				CHAR_BIT)), _mm512_set1_epi64(0xff)));
+		tmp = _mm512_mask_i32gather_epi64(zero, msk_ext,
+			_mm512_cvtepi64_epi32(idxes),
+			(const void *)dp->tbl8, 8);
+
+		res = _mm512_mask_blend_epi64(msk_ext, res, tmp);
+		msk_ext = _mm512_test_epi64_mask(res, lsb);
+	}
+
+	res = _mm512_srli_epi64(res, 1);
+	_mm512_storeu_si512(next_hops, res);
+}
+
+void
+rte_trie_vec_lookup_bulk_2b(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+
+	for (i = 0; i < (n / 16); i++)
+		trie_vec_lookup_x16(p, (uint8_t (*)[16])&ips[i * 16][0],
+			next_hops + i * 16, sizeof(uint16_t));
+
+	rte_trie_lookup_bulk_2b(p, (uint8_t (*)[16])&ips[i * 16][0],
+		next_hops + i * 16, n - i * 16);
+}
+
+void
+rte_trie_vec_lookup_bulk_4b(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+
+	for (i = 0; i < (n / 16); i++)
+		trie_vec_lookup_x16(p, (uint8_t (*)[16])&ips[i * 16][0],
+			next_hops + i * 16, sizeof(uint32_t));
+
+	rte_trie_lookup_bulk_4b(p, (uint8_t (*)[16])&ips[i * 16][0],
+		next_hops + i * 16, n - i * 16);
+}
+
+void
+rte_trie_vec_lookup_bulk_8b(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+	__m512i chunk[4];
+
+	for (i = 0; i < (n / 16); i++) {
+		transpose_x16((uint8_t (*)[16])&ips[i * 16][0], chunk);
+		trie_vec_lookup_x8_8b(p, chunk, 0, next_hops + i * 16);
+		trie_vec_lookup_x8_8b(p, chunk, 1, next_hops + i * 16 + 8);
+	}
+
+	rte_trie_lookup_bulk_8b(p, (uint8_t (*)[16])&ips[i * 16][0],
+		next_hops + i * 16, n - i * 16);
+}
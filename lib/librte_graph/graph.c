@@ -332,9 +332,13 @@ rte_graph_create(const char *name, struct rte_graph_param *prm)
 	if (graph_fp_mem_create(graph))
 		goto graph_cleanup;
 
+	/* Create the dispatch queues of the pinned nodes */
+	if (graph_dispatch_rings_setup(graph))
+		goto graph_mem_destroy;
+
 	/* Call init() of the all the nodes in the graph */
 	if (graph_node_init(graph))
-		goto graph_mem_destroy;
+		goto graph_rings_free;
 
 	/* All good, Lets add the graph to the list */
 	graph_id++;
@@ -343,6 +347,8 @@ rte_graph_create(const char *name, struct rte_graph_param *prm)
 	graph_spinlock_unlock();
 	return graph->id;
 
+graph_rings_free:
+	graph_dispatch_rings_free(graph);
 graph_mem_destroy:
 	graph_fp_mem_destroy(graph);
 graph_cleanup:
@@ -354,6 +360,93 @@ rte_graph_create(const char *name, struct rte_graph_param *prm)
 	return RTE_GRAPH_ID_INVALID;
 }
 
+rte_graph_t
+rte_graph_clone(rte_graph_t id, const char *name)
+{
+	struct graph_node *graph_node;
+	struct graph *graph, *parent = NULL;
+	char clone_name[RTE_GRAPH_NAMESIZE];
+
+	graph_spinlock_lock();
+
+	/* Check arguments sanity */
+	if (name == NULL)
+		SET_ERR_JMP(EINVAL, fail, "Clone name should not be NULL");
+
+	STAILQ_FOREACH(graph, &graph_list, next)
+		if (graph->id == id)
+			parent = graph;
+	if (parent == NULL)
+		SET_ERR_JMP(ENOENT, fail, "Graph %u not found", id);
+
+	/* Don't allow to clone a graph from a cloned graph */
+	if (parent->parent != NULL)
+		SET_ERR_JMP(EEXIST, fail, "Graph %s is a clone", parent->name);
+
+	/* Naming ceremony of the new graph. name is parent + "-" + name */
+	if (snprintf(clone_name, sizeof(clone_name), "%s-%s", parent->name,
+		     name) >= (int)sizeof(clone_name))
+		SET_ERR_JMP(E2BIG, fail, "Too big name=%s-%s", parent->name,
+			    name);
+
+	/* Check for existence of duplicate graph */
+	STAILQ_FOREACH(graph, &graph_list, next)
+		if (strncmp(clone_name, graph->name, RTE_GRAPH_NAMESIZE) == 0)
+			SET_ERR_JMP(EEXIST, fail, "Found duplicate graph %s",
+				    clone_name);
+
+	/* Create graph object */
+	graph = calloc(1, sizeof(*graph));
+	if (graph == NULL)
+		SET_ERR_JMP(ENOMEM, fail, "Failed to calloc graph object");
+
+	/* Initialize the graph object with the nodes of the parent */
+	STAILQ_INIT(&graph->node_list);
+	rte_strscpy(graph->name, clone_name, RTE_GRAPH_NAMESIZE);
+	STAILQ_FOREACH(graph_node, &parent->node_list, next)
+		if (graph_node_add(graph, graph_node->node))
+			goto graph_cleanup;
+
+	/* Update adjacency list of all nodes in the graph */
+	if (graph_adjacency_list_update(graph))
+		goto graph_cleanup;
+
+	graph->socket = parent->socket;
+	graph->src_node_count = parent->src_node_count;
+	graph->node_count = parent->node_count;
+	graph->parent = parent;
+	graph->id = graph_id;
+
+	/* Allocate the Graph fast path memory and populate the data */
+	if (graph_fp_mem_create(graph))
+		goto graph_cleanup;
+
+	/* Share the dispatch queues of the parent */
+	if (graph_dispatch_rings_setup(graph))
+		goto graph_mem_destroy;
+
+	/* Call init() of the all the nodes in the graph */
+	if (graph_node_init(graph))
+		goto graph_mem_destroy;
+
+	/* All good, Lets add the graph to the list */
+	graph_id++;
+	parent->nb_clones++;
+	STAILQ_INSERT_TAIL(&graph_list, graph, next);
+
+	graph_spinlock_unlock();
+	return graph->id;
+
+graph_mem_destroy:
+	graph_fp_mem_destroy(graph);
+graph_cleanup:
+	graph_cleanup(graph);
+	free(graph);
+fail:
+	graph_spinlock_unlock();
+	return RTE_GRAPH_ID_INVALID;
+}
+
 int
 rte_graph_destroy(rte_graph_t id)
 {
@@ -366,8 +459,15 @@ rte_graph_destroy(rte_graph_t id)
 	while (graph != NULL) {
 		tmp = STAILQ_NEXT(graph, next);
 		if (graph->id == id) {
+			/* Clones use the dispatch queues of their parent */
+			if (graph->nb_clones != 0) {
+				rc = -EBUSY;
+				SET_ERR_JMP(EBUSY, done,
+					    "Graph %s has clones", graph->name);
+			}
 			/* Call fini() of the all the nodes in the graph */
 			graph_node_fini(graph);
+			graph_dispatch_rings_free(graph);
 			/* Destroy graph fast path memory */
 			rc = graph_fp_mem_destroy(graph);
 			if (rc)
@@ -375,6 +475,8 @@ rte_graph_destroy(rte_graph_t id)
 					    graph->name);
 
 			graph_cleanup(graph);
+			if (graph->parent != NULL)
+				graph->parent->nb_clones--;
 			STAILQ_REMOVE(&graph_list, graph, graph, next);
 			free(graph);
 			graph_id--;
@@ -22,6 +22,9 @@ graph_dump(FILE *f, struct graph *g)
 	fprintf(f, "  mem_sz=%zu\n", g->mem_sz);
 	fprintf(f, "  node_count=%" PRIu32 "\n", g->node_count);
 	fprintf(f, "  src_node_count=%" PRIu32 "\n", g->src_node_count);
+	if (g->parent != NULL)
+		fprintf(f, "  parent=%s\n", g->parent->name);
+	fprintf(f, "  nb_clones=%" PRIu32 "\n", g->nb_clones);
 
 	STAILQ_FOREACH(graph_node, &g->node_list, next)
 		fprintf(f, "     node[%d] <%s>\n", i++, graph_node->node->name);
@@ -38,6 +41,7 @@ node_dump(FILE *f, struct node *n)
 	fprintf(f, "  addr=%p\n", n);
 	fprintf(f, "  process=%p\n", n->process);
 	fprintf(f, "  nb_edges=%d\n", n->nb_edges);
+	fprintf(f, "  lcore_id=%u\n", n->lcore_id);
 
 	for (i = 0; i < n->nb_edges; i++)
 		fprintf(f, "     edge[%d] <%s>\n", i, n->next_nodes[i]);
@@ -58,6 +62,8 @@ rte_graph_obj_dump(FILE *f, struct rte_graph *g, bool all)
 	fprintf(f, "  cir_mask=0x%" PRIx32 "\n", g->cir_mask);
 	fprintf(f, "  nb_nodes=%" PRId32 "\n", g->nb_nodes);
 	fprintf(f, "  socket=%d\n", g->socket);
+	fprintf(f, "  lcore_id=%u\n", g->lcore_id);
+	fprintf(f, "  nb_dispatch=%" PRIu32 "\n", g->nb_dispatch);
 	fprintf(f, "  fence=0x%" PRIx64 "\n", g->fence);
 	fprintf(f, "  nodes_start=0x%" PRIx32 "\n", g->nodes_start);
 	fprintf(f, "  cir_start=%p\n", g->cir_start);
@@ -77,6 +83,14 @@ rte_graph_obj_dump(FILE *f, struct rte_graph *g, bool all)
 		fprintf(f, "       idx=%d\n", n->idx);
 		fprintf(f, "       total_objs=%" PRId64 "\n", n->total_objs);
 		fprintf(f, "       total_calls=%" PRId64 "\n", n->total_calls);
+		if (n->ring != NULL) {
+			fprintf(f, "       lcore_id=%u\n", n->lcore_id);
+			fprintf(f, "       ring=%p\n", n->ring);
+			fprintf(f, "       dispatch_objs=%" PRId64 "\n",
+				n->dispatch_objs);
+			fprintf(f, "       dispatch_fallback_objs=%" PRId64 "\n",
+				n->dispatch_fallback_objs);
+		}
 		for (i = 0; i < n->nb_edges; i++)
 			fprintf(f, "          edge[%d] <%s>\n", i,
 				n->nodes[i]->name);
@@ -0,0 +1,141 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2020 Marvell International Ltd.
+ */
+
+#include <stdio.h>
+
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_lcore.h>
+#include <rte_ring.h>
+
+#include "graph_private.h"
+
+/* Unique suffix of the dispatch ring names */
+static uint32_t dispatch_ring_id;
+
+static int
+graph_dispatch_rings_create(struct graph *graph)
+{
+	char name[RTE_RING_NAMESIZE];
+	struct rte_node *node;
+	rte_graph_off_t off;
+	rte_node_t count;
+
+	rte_graph_foreach_node(count, off, graph->graph, node) {
+		if (node->lcore_id == RTE_MAX_LCORE)
+			continue;
+
+		snprintf(name, sizeof(name), "graph_dq_%u",
+			 dispatch_ring_id++);
+		/* Any lcore enqueues, only the pinned one dequeues */
+		node->ring = rte_ring_create(name, RTE_GRAPH_DISPATCH_RING_SIZE,
+					     graph->socket, RING_F_SC_DEQ);
+		if (node->ring == NULL)
+			SET_ERR_JMP(rte_errno, fail,
+				    "Failed to create dispatch ring of %s",
+				    node->name);
+	}
+
+	return 0;
+fail:
+	graph_dispatch_rings_free(graph);
+	return -rte_errno;
+}
+
+static int
+graph_dispatch_rings_attach(struct graph *graph)
+{
+	struct rte_node *node, *parent_node;
+	rte_graph_off_t off;
+	rte_node_t count;
+
+	rte_graph_foreach_node(count, off, graph->graph, node) {
+		parent_node = graph_node_id_to_ptr(graph->parent->graph,
+						   node->id);
+		if (parent_node == NULL)
+			SET_ERR_JMP(ENOENT, fail, "Node %s not found in %s",
+				    node->name, graph->parent->name);
+		node->ring = parent_node->ring;
+		node->lcore_id = parent_node->lcore_id;
+	}
+
+	return 0;
+fail:
+	return -rte_errno;
+}
+
+int
+graph_dispatch_rings_setup(struct graph *graph)
+{
+	if (graph->parent != NULL)
+		return graph_dispatch_rings_attach(graph);
+
+	return graph_dispatch_rings_create(graph);
+}
+
+void
+graph_dispatch_rings_free(struct graph *graph)
+{
+	struct rte_node *node;
+	rte_graph_off_t off;
+	rte_node_t count;
+
+	if (graph->parent != NULL)
+		return;
+
+	rte_graph_foreach_node(count, off, graph->graph, node) {
+		rte_ring_free(node->ring);
+		node->ring = NULL;
+	}
+}
+
+int
+rte_graph_lcore_bind(rte_graph_t id, unsigned int lcore_id)
+{
+	struct graph_head *graph_head = graph_list_head_get();
+	struct graph *graph = NULL, *tmp, *root;
+	struct rte_graph *graph_fp;
+	struct rte_node *node;
+	rte_graph_off_t off;
+	rte_node_t count;
+	int rc = -EINVAL;
+
+	if (lcore_id > RTE_MAX_LCORE)
+		return rc;
+
+	graph_spinlock_lock();
+
+	STAILQ_FOREACH(tmp, graph_head, next)
+		if (tmp->id == id)
+			graph = tmp;
+	if (graph == NULL)
+		goto done;
+
+	/* Only one graph of a parent and its clones drains a queue */
+	root = graph->parent != NULL ? graph->parent : graph;
+	if (lcore_id != RTE_MAX_LCORE) {
+		STAILQ_FOREACH(tmp, graph_head, next) {
+			if (tmp == graph || (tmp != root && tmp->parent != root))
+				continue;
+			if (tmp->graph->lcore_id == lcore_id) {
+				graph_err("Graph %s is already bound to lcore %u",
+					  tmp->name, lcore_id);
+				rc = -EEXIST;
+				goto done;
+			}
+		}
+	}
+
+	graph_fp = graph->graph;
+	graph_fp->lcore_id = lcore_id;
+	graph_fp->nb_dispatch = 0;
+	rte_graph_foreach_node(count, off, graph_fp, node)
+		if (node->ring != NULL && node->lcore_id == lcore_id)
+			graph_fp->dispatch_start[graph_fp->nb_dispatch++] = off;
+	rc = 0;
+
+done:
+	graph_spinlock_unlock();
+	return rc;
+}
@@ -31,6 +31,9 @@ graph_fp_mem_calc_size(struct graph *graph)
 	sz += val;
 	/* Fence */
 	sz += sizeof(RTE_GRAPH_FENCE);
+	/* Nodes whose dispatch queue is drained by the graph */
+	graph->dispatch_start = sz;
+	sz += sizeof(rte_graph_off_t) * graph->node_count;
 	sz = RTE_ALIGN(sz, RTE_CACHE_LINE_SIZE);
 	graph->nodes_start = sz;
 	/* For 0..N node objects with fence */
@@ -57,6 +60,9 @@ graph_header_popluate(struct graph *_graph)
 	graph->cir_start = RTE_PTR_ADD(graph, _graph->cir_start);
 	graph->nodes_start = _graph->nodes_start;
 	graph->socket = _graph->socket;
+	graph->lcore_id = RTE_MAX_LCORE;
+	graph->nb_dispatch = 0;
+	graph->dispatch_start = RTE_PTR_ADD(graph, _graph->dispatch_start);
 	graph->id = _graph->id;
 	memcpy(graph->name, _graph->name, RTE_GRAPH_NAMESIZE);
 	graph->fence = RTE_GRAPH_FENCE;
@@ -88,6 +94,7 @@ graph_nodes_populate(struct graph *_graph)
 		node->parent_id = pid;
 		nb_edges = graph_node->node->nb_edges;
 		node->nb_edges = nb_edges;
+		node->lcore_id = graph_node->node->lcore_id;
 		off += sizeof(struct rte_node);
 		/* Copy the name in first pass to replace with rte_node* later*/
 		for (count = 0; count < nb_edges; count++)
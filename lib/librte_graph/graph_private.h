@@ -55,6 +55,7 @@ struct node {
 	rte_node_t id;		      /**< Allocated identifier for the node. */
 	rte_node_t parent_id;	      /**< Parent node identifier. */
 	rte_edge_t nb_edges;	      /**< Number of edges from this node. */
+	unsigned int lcore_id;	      /**< Lcore the node is pinned to. */
 	char next_nodes[][RTE_NODE_NAMESIZE]; /**< Names of next nodes. */
 };
 
@@ -94,6 +95,12 @@ struct graph {
 	/**< Circular buffer start offset in graph reel. */
 	uint32_t cir_mask;
 	/**< Circular buffer mask for wrap around. */
+	rte_graph_off_t dispatch_start;
+	/**< Dispatch node list start offset in graph reel. */
+	struct graph *parent;
+	/**< Graph this one is cloned from, NULL if not a clone. */
+	uint32_t nb_clones;
+	/**< Number of clones of this graph. */
 	rte_graph_t id;
 	/**< Graph identifier. */
 	size_t mem_sz;
@@ -286,6 +293,33 @@ int graph_fp_mem_create(struct graph *graph);
  */
 int graph_fp_mem_destroy(struct graph *graph);
 
+/* Dispatch functions */
+
+/**
+ * @internal
+ *
+ * Create the dispatch queues of the pinned nodes of a graph, or attach
+ * the ones of its parent for a clone.
+ *
+ * @param graph
+ *   Pointer to the internal graph object.
+ *
+ * @return
+ *   - 0: Success.
+ *   - <0: Ring creation error.
+ */
+int graph_dispatch_rings_setup(struct graph *graph);
+
+/**
+ * @internal
+ *
+ * Free the dispatch queues of a graph which is not a clone.
+ *
+ * @param graph
+ *   Pointer to the internal graph object.
+ */
+void graph_dispatch_rings_free(struct graph *graph);
+
 /* Lookup functions */
 /**
  * @internal
@@ -8,6 +8,7 @@
 #include <rte_common.h>
 #include <rte_errno.h>
 #include <rte_malloc.h>
+#include <rte_ring.h>
 
 #include "graph_private.h"
 
@@ -42,15 +43,17 @@ struct rte_graph_cluster_stats {
 #define boarder()                                                              \
 	fprintf(f, "+-------------------------------+---------------+--------" \
 		   "-------+---------------+---------------+---------------+-" \
-		   "----------+\n")
+		   "----------+---------------+---------------+----------" \
+		   "+\n")
 
 static inline void
 print_banner(FILE *f)
 {
 	boarder();
-	fprintf(f, "%-32s%-16s%-16s%-16s%-16s%-16s%-16s\n", "|Node", "|calls",
-		"|objs", "|realloc_count", "|objs/call", "|objs/sec(10E6)",
-		"|cycles/call|");
+	fprintf(f, "%-32s%-16s%-16s%-16s%-16s%-16s%-12s%-16s%-16s%-12s\n",
+		"|Node", "|calls", "|objs", "|realloc_count", "|objs/call",
+		"|objs/sec(10E6)", "|cycles/call", "|dispatch_objs",
+		"|fallback_objs", "|disp_depth|");
 	boarder();
 }
 
@@ -77,9 +80,11 @@ print_node(FILE *f, const struct rte_graph_cluster_node_stats *stat)
 
 	fprintf(f,
 		"|%-31s|%-15" PRIu64 "|%-15" PRIu64 "|%-15" PRIu64
-		"|%-15.3f|%-15.6f|%-11.4f|\n",
+		"|%-15.3f|%-15.6f|%-11.4f|%-15" PRIu64 "|%-15" PRIu64
+		"|%-10" PRIu32 "|\n",
 		stat->name, calls, objs, stat->realloc_count, objs_per_call,
-		objs_per_sec, cycles_per_call);
+		objs_per_sec, cycles_per_call, stat->dispatch_objs,
+		stat->dispatch_fallback_objs, stat->dispatch_depth);
 }
 
 static int
@@ -90,7 +95,7 @@ graph_cluster_stats_cb(bool is_first, bool is_last, void *cookie,
 
 	if (unlikely(is_first))
 		print_banner(f);
-	if (stat->objs)
+	if (stat->objs || stat->dispatch_objs)
 		print_node(f, stat);
 	if (unlikely(is_last))
 		boarder();
@@ -325,11 +330,29 @@ rte_graph_cluster_stats_destroy(struct rte_graph_cluster_stats *stat)
 	return rte_free(stat);
 }
 
+/* Count the dispatch queue of the node once, clones share it */
+static inline uint32_t
+cluster_node_dispatch_depth(struct cluster_node *cluster, rte_node_t count)
+{
+	struct rte_ring *ring = cluster->nodes[count]->ring;
+	rte_node_t i;
+
+	if (ring == NULL)
+		return 0;
+	for (i = 0; i < count; i++)
+		if (cluster->nodes[i]->ring == ring)
+			return 0;
+
+	return rte_ring_count(ring);
+}
+
 static inline void
 cluster_node_arregate_stats(struct cluster_node *cluster)
 {
 	uint64_t calls = 0, cycles = 0, objs = 0, realloc_count = 0;
+	uint64_t dispatch_objs = 0, dispatch_fallback_objs = 0;
 	struct rte_graph_cluster_node_stats *stat = &cluster->stat;
+	uint32_t dispatch_depth = 0;
 	struct rte_node *node;
 	rte_node_t count;
 
@@ -340,6 +363,9 @@ cluster_node_arregate_stats(struct cluster_node *cluster)
 		objs += node->total_objs;
 		cycles += node->total_cycles;
 		realloc_count += node->realloc_count;
+		dispatch_objs += node->dispatch_objs;
+		dispatch_fallback_objs += node->dispatch_fallback_objs;
+		dispatch_depth += cluster_node_dispatch_depth(cluster, count);
 	}
 
 	stat->calls = calls;
@@ -347,6 +373,9 @@ cluster_node_arregate_stats(struct cluster_node *cluster)
 	stat->cycles = cycles;
 	stat->ts = rte_get_timer_cycles();
 	stat->realloc_count = realloc_count;
+	stat->dispatch_objs = dispatch_objs;
+	stat->dispatch_fallback_objs = dispatch_fallback_objs;
+	stat->dispatch_depth = dispatch_depth;
 }
 
 static inline void
@@ -401,6 +430,9 @@ rte_graph_cluster_stats_reset(struct rte_graph_cluster_stats *stat)
 		node->prev_objs = 0;
 		node->prev_cycles = 0;
 		node->realloc_count = 0;
+		node->dispatch_objs = 0;
+		node->dispatch_fallback_objs = 0;
+		node->dispatch_depth = 0;
 		cluster = RTE_PTR_ADD(cluster, stat->cluster_node_size);
 	}
 }
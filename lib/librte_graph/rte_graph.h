@@ -21,6 +21,11 @@
  * edge update, and edge shrink, etc. The API also allows to create the stats
  * cluster to monitor per graph and per node stats.
  *
+ * A graph is either walked run-to-completion by a single worker, or shared
+ * by several workers in the dispatch model: each worker walks its own clone
+ * of the graph, bound to its lcore, and the nodes pinned to an lcore are
+ * only processed by the clone bound to that lcore.
+ *
  */
 
 #include <stdbool.h>
@@ -206,6 +211,11 @@ struct rte_graph_cluster_node_stats {
 
 	uint64_t realloc_count; /**< Realloc count. */
 
+	uint64_t dispatch_objs; /**< Objs handed over to the pinned lcore. */
+	/** Objs processed by another lcore, the dispatch queue being full. */
+	uint64_t dispatch_fallback_objs;
+	uint32_t dispatch_depth; /**< Objs waiting in the dispatch queue. */
+
 	rte_node_t id;	/**< Node identifier of stats. */
 	uint64_t hz;	/**< Cycles per seconds. */
 	char name[RTE_NODE_NAMESIZE];	/**< Name of the node. */
@@ -242,6 +252,52 @@ rte_graph_t rte_graph_create(const char *name, struct rte_graph_param *prm);
 __rte_experimental
 int rte_graph_destroy(rte_graph_t id);
 
+/**
+ * Clone Graph.
+ *
+ * Create a graph with the same nodes as a parent graph, to be walked by
+ * another worker. The nodes of the clone are initialized as the ones of a
+ * new graph. The clone shares the dispatch queues of its parent, so that a
+ * graph and its clones walked with rte_graph_walk_dispatch() hand over
+ * the streams of the pinned nodes to the graph bound to their lcore.
+ *
+ * The clones must be destroyed before their parent.
+ *
+ * @param id
+ *   id of the graph to clone, which cannot be a clone itself.
+ * @param name
+ *   Name of the clone. The final graph name will be,
+ *   "parent graph name" + "-" + name.
+ *
+ * @return
+ *   Unique graph id on success, RTE_GRAPH_ID_INVALID otherwise.
+ *
+ * @see rte_graph_lcore_bind(), rte_node_lcore_affinity_set()
+ */
+__rte_experimental
+rte_graph_t rte_graph_clone(rte_graph_t id, const char *name);
+
+/**
+ * Bind a graph to the lcore walking it in the dispatch model.
+ *
+ * The graph then drains the dispatch queues of the nodes pinned to this
+ * lcore. A single graph among a parent and its clones can be bound to an
+ * lcore. The graph must not be walked while being bound.
+ *
+ * @param id
+ *   id of the graph to bind.
+ * @param lcore_id
+ *   The lcore walking the graph, or RTE_MAX_LCORE to unbind it.
+ *
+ * @return
+ *   0 on success, -EINVAL on invalid parameters, -EEXIST if another graph
+ *   of the same parent is bound to this lcore.
+ *
+ * @see rte_graph_walk_dispatch()
+ */
+__rte_experimental
+int rte_graph_lcore_bind(rte_graph_t id, unsigned int lcore_id);
+
 /**
  * Get graph id from graph name.
  *
@@ -485,6 +541,27 @@ rte_node_t __rte_node_register(const struct rte_node_register *node);
 __rte_experimental
 rte_node_t rte_node_clone(rte_node_t id, const char *name);
 
+/**
+ * Pin a node to an lcore for the dispatch model.
+ *
+ * Each graph created afterwards with this node gets a dispatch queue for
+ * it: when walked with rte_graph_walk_dispatch(), the graphs not bound to
+ * this lcore enqueue the streams of the node to the queue, drained by the
+ * graph bound to the lcore. A pinned source node is only polled by the
+ * graph bound to its lcore. The nodes which are not pinned are processed
+ * by the graph walking them, run-to-completion.
+ *
+ * @param id
+ *   Node id.
+ * @param lcore_id
+ *   The lcore processing the node, or RTE_MAX_LCORE for any lcore.
+ *
+ * @return
+ *   0 on success, -EINVAL on invalid parameters.
+ */
+__rte_experimental
+int rte_node_lcore_affinity_set(rte_node_t id, unsigned int lcore_id);
+
 /**
  * Get node id from node name.
  *
@@ -21,6 +21,7 @@
 #include <rte_prefetch.h>
 #include <rte_memcpy.h>
 #include <rte_memory.h>
+#include <rte_ring.h>
 
 #include "rte_graph.h"
 
@@ -42,6 +43,9 @@ struct rte_graph {
 	rte_graph_off_t nodes_start; /**< Offset at which node memory starts. */
 	rte_graph_t id;	/**< Graph identifier. */
 	int socket;	/**< Socket ID where memory is allocated. */
+	unsigned int lcore_id;	/**< Lcore the graph is bound to. */
+	rte_node_t nb_dispatch;	/**< Number of dispatch queues to drain. */
+	rte_graph_off_t *dispatch_start; /**< Nodes of the dispatch queues. */
 	char name[RTE_GRAPH_NAMESIZE];	/**< Name of the graph. */
 	uint64_t fence;			/**< Fence. */
 } __rte_cache_aligned;
@@ -63,6 +67,12 @@ struct rte_node {
 	char parent[RTE_NODE_NAMESIZE];	/**< Parent node name. */
 	char name[RTE_NODE_NAMESIZE];	/**< Name of the node. */
 
+	/* Dispatch area */
+	unsigned int lcore_id;	/**< Lcore the node is pinned to. */
+	struct rte_ring *ring;	/**< Streams handed over to that lcore. */
+	uint64_t dispatch_objs;	/**< Objects handed over to that lcore. */
+	uint64_t dispatch_fallback_objs; /**< Objects processed, ring full. */
+
 	/* Fast path area  */
 #define RTE_NODE_CTX_SZ 16
 	uint8_t ctx[RTE_NODE_CTX_SZ] __rte_cache_aligned; /**< Node Context. */
@@ -118,6 +128,40 @@ __rte_experimental
 void __rte_node_stream_alloc_size(struct rte_graph *graph,
 				  struct rte_node *node, uint16_t req_size);
 
+/**
+ * @internal
+ *
+ * Invoke the process function of a node on its stream and collect the
+ * stats.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ * @param node
+ *   Pointer to the node object.
+ */
+static __rte_always_inline void
+__rte_node_process(struct rte_graph *graph, struct rte_node *node)
+{
+	uint64_t start;
+	uint16_t rc;
+	void **objs;
+
+	RTE_ASSERT(node->fence == RTE_GRAPH_FENCE);
+	objs = node->objs;
+	rte_prefetch0(objs);
+
+	if (rte_graph_has_stats_feature()) {
+		start = rte_rdtsc();
+		rc = node->process(graph, node, objs, node->idx);
+		node->total_cycles += rte_rdtsc() - start;
+		node->total_calls++;
+		node->total_objs += rc;
+	} else {
+		node->process(graph, node, objs, node->idx);
+	}
+	node->idx = 0;
+}
+
 /**
  * Perform graph walk on the circular buffer and invoke the process function
  * of the nodes and collect the stats.
@@ -135,9 +179,6 @@ rte_graph_walk(struct rte_graph *graph)
 	const rte_node_t mask = graph->cir_mask;
 	uint32_t head = graph->head;
 	struct rte_node *node;
-	uint64_t start;
-	uint16_t rc;
-	void **objs;
 
 	/*
 	 * Walk on the source node(s) ((cir_start - head) -> cir_start) and then
@@ -156,20 +197,7 @@ rte_graph_walk(struct rte_graph *graph)
 	 */
 	while (likely(head != graph->tail)) {
 		node = RTE_PTR_ADD(graph, cir_start[(int32_t)head++]);
-		RTE_ASSERT(node->fence == RTE_GRAPH_FENCE);
-		objs = node->objs;
-		rte_prefetch0(objs);
-
-		if (rte_graph_has_stats_feature()) {
-			start = rte_rdtsc();
-			rc = node->process(graph, node, objs, node->idx);
-			node->total_cycles += rte_rdtsc() - start;
-			node->total_calls++;
-			node->total_objs += rc;
-		} else {
-			node->process(graph, node, objs, node->idx);
-		}
-		node->idx = 0;
+		__rte_node_process(graph, node);
 		head = likely((int32_t)head > 0) ? head & mask : head;
 	}
 	graph->tail = 0;
@@ -504,6 +532,120 @@ rte_node_next_stream_move(struct rte_graph *graph, struct rte_node *src,
 	}
 }
 
+/**
+ * @internal
+ *
+ * Hand over the stream of a node to the lcore it is pinned to.
+ *
+ * @param node
+ *   Pointer to the node object.
+ *
+ * @return
+ *   1 if the whole stream is handed over, 0 if the dispatch queue is full
+ *   and the remaining objects must be processed by the caller.
+ */
+static __rte_always_inline int
+__rte_node_dispatch(struct rte_node *node)
+{
+	uint16_t idx = node->idx;
+	unsigned int n;
+
+	n = rte_ring_mp_enqueue_burst(node->ring, node->objs, idx, NULL);
+	if (rte_graph_has_stats_feature())
+		node->dispatch_objs += n;
+	if (likely(n == idx)) {
+		node->idx = 0;
+		return 1;
+	}
+
+	memmove(node->objs, &node->objs[n], (idx - n) * sizeof(void *));
+	node->idx = idx - n;
+	if (rte_graph_has_stats_feature())
+		node->dispatch_fallback_objs += idx - n;
+	return 0;
+}
+
+/**
+ * @internal
+ *
+ * Move the streams handed over by other lcores to the nodes pinned to the
+ * lcore of the graph, and put these nodes to pending state.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ */
+static __rte_always_inline void
+__rte_graph_dispatch_drain(struct rte_graph *graph)
+{
+	struct rte_node *node;
+	unsigned int n;
+	rte_node_t i;
+	uint16_t idx;
+
+	for (i = 0; i < graph->nb_dispatch; i++) {
+		node = RTE_PTR_ADD(graph, graph->dispatch_start[i]);
+		idx = node->idx;
+		if (unlikely(node->size - idx < RTE_GRAPH_BURST_SIZE))
+			__rte_node_stream_alloc_size(graph, node,
+						     idx + RTE_GRAPH_BURST_SIZE);
+		n = rte_ring_sc_dequeue_burst(node->ring, &node->objs[idx],
+					      RTE_GRAPH_BURST_SIZE, NULL);
+		if (n == 0)
+			continue;
+		if (idx == 0)
+			__rte_node_enqueue_tail_update(graph, node);
+		node->idx = idx + n;
+	}
+}
+
+/**
+ * Perform graph walk in the dispatch model.
+ *
+ * Same as rte_graph_walk(), except for the nodes pinned to an lcore with
+ * rte_node_lcore_affinity_set(). The graph first takes the streams handed
+ * over by the other graphs of the same parent to the nodes pinned to the
+ * lcore it is bound to. Then, walking the pending streams, it processes
+ * the nodes pinned to its lcore and the nodes not pinned, and hands over
+ * the streams of the nodes pinned to other lcores. The source nodes pinned
+ * to other lcores are not polled.
+ *
+ * When the dispatch queue of a node is full, the objects which do not fit
+ * are processed by the graph walking them rather than waiting, so that
+ * lcores handing over streams to each other cannot deadlock.
+ *
+ * @param graph
+ *   Graph pointer returned from rte_graph_lookup function.
+ *
+ * @see rte_graph_lcore_bind(), rte_graph_clone()
+ */
+__rte_experimental
+static inline void
+rte_graph_walk_dispatch(struct rte_graph *graph)
+{
+	const rte_graph_off_t *cir_start = graph->cir_start;
+	const rte_node_t mask = graph->cir_mask;
+	uint32_t head;
+	struct rte_node *node;
+
+	__rte_graph_dispatch_drain(graph);
+
+	head = graph->head;
+	while (likely(head != graph->tail)) {
+		node = RTE_PTR_ADD(graph, cir_start[(int32_t)head++]);
+		if (node->ring != NULL && node->lcore_id != graph->lcore_id) {
+			/* Source nodes are only polled by their own lcore */
+			if ((int32_t)head <= 0)
+				continue;
+			if (__rte_node_dispatch(node))
+				goto next;
+		}
+		__rte_node_process(graph, node);
+next:
+		head = likely((int32_t)head > 0) ? head & mask : head;
+	}
+	graph->tail = 0;
+}
+
 #ifdef __cplusplus
 }
 #endif
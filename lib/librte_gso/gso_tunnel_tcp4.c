@@ -15,17 +15,18 @@ update_tunnel_ipv4_tcp_headers(struct rte_mbuf *pkt, uint8_t ipid_delta,
 	uint16_t outer_id, inner_id, tail_idx, i;
 	uint16_t outer_ipv4_offset, inner_ipv4_offset;
 	uint16_t udp_gre_offset, tcp_offset;
-	uint8_t update_udp_hdr;
+	uint8_t update_udp_hdr, outer_ipv6;
 
 	outer_ipv4_offset = pkt->outer_l2_len;
 	udp_gre_offset = outer_ipv4_offset + pkt->outer_l3_len;
 	inner_ipv4_offset = udp_gre_offset + pkt->l2_len;
 	tcp_offset = inner_ipv4_offset + pkt->l3_len;
 
-	/* Outer IPv4 header. */
+	/* Outer IPv4 header. IPv6 doesn't have the ID field. */
+	outer_ipv6 = (pkt->ol_flags & PKT_TX_OUTER_IPV6) ? 1 : 0;
 	ipv4_hdr = (struct rte_ipv4_hdr *)(rte_pktmbuf_mtod(pkt, char *) +
 			outer_ipv4_offset);
-	outer_id = rte_be_to_cpu_16(ipv4_hdr->packet_id);
+	outer_id = outer_ipv6 ? 0 : rte_be_to_cpu_16(ipv4_hdr->packet_id);
 
 	/* Inner IPv4 header. */
 	ipv4_hdr = (struct rte_ipv4_hdr *)(rte_pktmbuf_mtod(pkt, char *) +
@@ -40,7 +41,11 @@ update_tunnel_ipv4_tcp_headers(struct rte_mbuf *pkt, uint8_t ipid_delta,
 	update_udp_hdr = (pkt->ol_flags & PKT_TX_TUNNEL_VXLAN) ? 1 : 0;
 
 	for (i = 0; i < nb_segs; i++) {
-		update_ipv4_header(segs[i], outer_ipv4_offset, outer_id);
+		if (outer_ipv6)
+			update_ipv6_header(segs[i], outer_ipv4_offset);
+		else
+			update_ipv4_header(segs[i], outer_ipv4_offset,
+					outer_id);
 		if (update_udp_hdr)
 			update_udp_header(segs[i], udp_gre_offset);
 		update_ipv4_header(segs[i], inner_ipv4_offset, inner_id);
@@ -64,6 +69,13 @@ gso_tunnel_tcp4_segment(struct rte_mbuf *pkt,
 	uint16_t pyld_unit_size, hdr_offset, frag_off;
 	int ret = 1;
 
+	/* Don't process the packet with outer IPv6 extension headers */
+	if ((pkt->ol_flags & PKT_TX_OUTER_IPV6) &&
+			pkt->outer_l3_len != sizeof(struct rte_ipv6_hdr)) {
+		pkts_out[0] = pkt;
+		return 1;
+	}
+
 	hdr_offset = pkt->outer_l2_len + pkt->outer_l3_len + pkt->l2_len;
 	inner_ipv4_hdr = (struct rte_ipv4_hdr *)(rte_pktmbuf_mtod(pkt, char *) +
 			hdr_offset);
@@ -83,6 +95,9 @@ gso_tunnel_tcp4_segment(struct rte_mbuf *pkt,
 		pkts_out[0] = pkt;
 		return 1;
 	}
+	/* The headers must leave room for payload in a GSO segment */
+	if (unlikely(hdr_offset >= gso_size))
+		return -EINVAL;
 	pyld_unit_size = gso_size - hdr_offset;
 
 	/* Segment the payload */
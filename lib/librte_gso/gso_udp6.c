@@ -0,0 +1,120 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <rte_random.h>
+
+#include "gso_common.h"
+#include "gso_udp6.h"
+
+#define IPV6_FRAG_HDR_MF_BIT 1U
+#define IPV6_FRAG_OFFSET_ALIGN 8U
+
+/* IPv6 fragment extension header */
+struct ipv6_frag_hdr {
+	uint8_t next_header;
+	uint8_t reserved;
+	rte_be16_t frag_data;
+	rte_be32_t id;
+} __rte_packed;
+
+static int
+update_ipv6_udp_headers(struct rte_mbuf *pkt, struct rte_mbuf **segs,
+		uint16_t nb_segs)
+{
+	struct rte_ipv6_hdr *ipv6_hdr;
+	struct ipv6_frag_hdr *frag_hdr;
+	uint16_t hdr_len = pkt->l2_len + pkt->l3_len;
+	uint16_t tail_idx = nb_segs - 1, frag_offset = 0, is_mf, i;
+	rte_be32_t id;
+	char *hdr;
+
+	/* The IPv6 header is copied before the fragment header is inserted */
+	for (i = 0; i < nb_segs; i++) {
+		if (rte_pktmbuf_headroom(segs[i]) < RTE_IPV6_FRAG_HDR_SIZE)
+			return -EINVAL;
+	}
+
+	id = rte_cpu_to_be_32((uint32_t)rte_rand());
+
+	/*
+	 * Insert a fragment header with the same ID in all output
+	 * segments, which updates fragment offset and payload length.
+	 */
+	for (i = 0; i < nb_segs; i++) {
+		hdr = rte_pktmbuf_prepend(segs[i], RTE_IPV6_FRAG_HDR_SIZE);
+		memmove(hdr, hdr + RTE_IPV6_FRAG_HDR_SIZE, hdr_len);
+		segs[i]->l3_len += RTE_IPV6_FRAG_HDR_SIZE;
+
+		ipv6_hdr = (struct rte_ipv6_hdr *)(hdr + pkt->l2_len);
+		frag_hdr = (struct ipv6_frag_hdr *)(hdr + hdr_len);
+		frag_hdr->next_header = ipv6_hdr->proto;
+		frag_hdr->reserved = 0;
+		is_mf = i < tail_idx ? IPV6_FRAG_HDR_MF_BIT : 0;
+		frag_hdr->frag_data = rte_cpu_to_be_16(frag_offset | is_mf);
+		frag_hdr->id = id;
+		ipv6_hdr->proto = IPPROTO_FRAGMENT;
+		update_ipv6_header(segs[i], pkt->l2_len);
+
+		frag_offset += segs[i]->pkt_len - segs[i]->data_len;
+	}
+
+	return 0;
+}
+
+int
+gso_udp6_segment(struct rte_mbuf *pkt,
+		uint16_t gso_size,
+		struct rte_mempool *direct_pool,
+		struct rte_mempool *indirect_pool,
+		struct rte_mbuf **pkts_out,
+		uint16_t nb_pkts_out)
+{
+	struct rte_ipv6_hdr *ipv6_hdr;
+	uint16_t pyld_unit_size, hdr_offset;
+	int ret, i;
+
+	/* Don't process the packet with extension headers */
+	ipv6_hdr = rte_pktmbuf_mtod_offset(pkt, struct rte_ipv6_hdr *,
+			pkt->l2_len);
+	if (unlikely(ipv6_hdr->proto != IPPROTO_UDP ||
+			pkt->l3_len != sizeof(struct rte_ipv6_hdr))) {
+		pkts_out[0] = pkt;
+		return 1;
+	}
+
+	/*
+	 * As for IPv4, UDP fragmentation is the same as IP fragmentation.
+	 * Except the first one, other output packets just have l2 and l3
+	 * headers, followed by the inserted fragment header.
+	 */
+	hdr_offset = pkt->l2_len + pkt->l3_len;
+
+	/* Don't process the packet without data. */
+	if (unlikely(hdr_offset + pkt->l4_len >= pkt->pkt_len)) {
+		pkts_out[0] = pkt;
+		return 1;
+	}
+
+	/* Fragment payloads, except the last one, are multiples of 8 */
+	if (unlikely(hdr_offset + RTE_IPV6_FRAG_HDR_SIZE +
+				IPV6_FRAG_OFFSET_ALIGN > gso_size))
+		return -EINVAL;
+
+	pyld_unit_size = RTE_ALIGN_FLOOR(gso_size - hdr_offset -
+			RTE_IPV6_FRAG_HDR_SIZE, IPV6_FRAG_OFFSET_ALIGN);
+
+	/* Segment the payload */
+	ret = gso_do_segment(pkt, hdr_offset, pyld_unit_size, direct_pool,
+			indirect_pool, pkts_out, nb_pkts_out);
+	if (ret > 1 && update_ipv6_udp_headers(pkt, pkts_out, ret) < 0) {
+		for (i = 0; i < ret; i++)
+			rte_pktmbuf_free(pkts_out[i]);
+		return -EINVAL;
+	}
+
+	return ret;
+}
@@ -151,6 +151,7 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	unsigned int no_free_on_del = 0;
 	uint32_t *ext_bkt_to_free = NULL;
 	uint32_t *tbl_chng_cnt = NULL;
+	uint32_t *key_sigs = NULL;
 	struct lcore_cache *local_free_slots = NULL;
 	unsigned int readwrite_concur_lf_support = 0;
 	uint32_t i;
@@ -344,6 +345,14 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		goto err_unlock;
 	}
 
+	key_sigs = rte_zmalloc_socket(NULL, sizeof(uint32_t) * num_key_slots,
+			RTE_CACHE_LINE_SIZE, params->socket_id);
+
+	if (key_sigs == NULL) {
+		RTE_LOG(ERR, HASH, "memory allocation failed\n");
+		goto err_unlock;
+	}
+
 /*
  * If x86 architecture is used, select appropriate compare function,
  * which may use x86 intrinsics, otherwise use memcmp
@@ -419,6 +428,8 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	h->ext_bkt_to_free = ext_bkt_to_free;
 	h->tbl_chng_cnt = tbl_chng_cnt;
 	*h->tbl_chng_cnt = 0;
+	h->key_sigs = key_sigs;
+	h->socket_id = params->socket_id;
 	h->hw_trans_mem_support = hw_trans_mem_support;
 	h->use_local_cache = use_local_cache;
 	h->local_free_slots = local_free_slots;
@@ -474,6 +485,7 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	rte_free(k);
 	rte_free(tbl_chng_cnt);
 	rte_free(ext_bkt_to_free);
+	rte_free(key_sigs);
 	return NULL;
 }
 
@@ -482,6 +494,7 @@ rte_hash_free(struct rte_hash *h)
 {
 	struct rte_tailq_entry *te;
 	struct rte_hash_list *hash_list;
+	struct __rte_hash_retired *r;
 
 	if (h == NULL)
 		return;
@@ -505,6 +518,9 @@ rte_hash_free(struct rte_hash *h)
 
 	rte_mcfg_tailq_write_unlock();
 
+	if (h->dq)
+		rte_rcu_qsbr_dq_delete(h->dq);
+
 	if (h->use_local_cache)
 		rte_free(h->local_free_slots);
 	if (h->writer_takes_lock)
@@ -516,6 +532,15 @@ rte_hash_free(struct rte_hash *h)
 	rte_free(h->buckets_ext);
 	rte_free(h->tbl_chng_cnt);
 	rte_free(h->ext_bkt_to_free);
+	rte_free(h->hash_rcu_cfg);
+	rte_free(h->key_sigs);
+	rte_free(h->old_buckets);
+	while (h->retired != NULL) {
+		r = h->retired;
+		h->retired = r->next;
+		rte_free(r->ptr);
+		rte_free(r);
+	}
 	rte_free(h);
 	rte_free(te);
 }
@@ -603,19 +628,88 @@ __hash_rw_reader_unlock(const struct rte_hash *h)
 		rte_rwlock_read_unlock(h->readwrite_lock);
 }
 
+/*
+ * Free memory replaced by a resize. With lock free readers, it is kept
+ * until the readers report quiescent state on the attached QSBR variable,
+ * or until the table is freed if none is attached.
+ */
+static void
+__hash_retire(struct rte_hash *h, void *ptr)
+{
+	struct __rte_hash_retired *r;
+
+	if (!h->readwrite_concur_lf_support) {
+		rte_free(ptr);
+		return;
+	}
+
+	r = rte_zmalloc(NULL, sizeof(*r), 0);
+	if (r == NULL) {
+		if (h->hash_rcu_cfg != NULL) {
+			/* Wait for the readers and free immediately. */
+			rte_rcu_qsbr_synchronize(h->hash_rcu_cfg->v,
+				RTE_QSBR_THRID_INVALID);
+			rte_free(ptr);
+		} else
+			RTE_LOG(ERR, HASH, "%s: memory allocation failed, "
+				"leaking retired memory\n", __func__);
+		return;
+	}
+
+	r->ptr = ptr;
+	if (h->hash_rcu_cfg != NULL) {
+		r->v = h->hash_rcu_cfg->v;
+		r->token = rte_rcu_qsbr_start(r->v);
+	}
+	r->next = h->retired;
+	h->retired = r;
+}
+
+/* Free the retired memory the readers no longer reference. */
+static void
+__hash_reclaim_retired(struct rte_hash *h)
+{
+	struct __rte_hash_retired *r, **prev = &h->retired;
+
+	while ((r = *prev) != NULL) {
+		if (r->v != NULL &&
+				rte_rcu_qsbr_check(r->v, r->token, false) == 1) {
+			*prev = r->next;
+			rte_free(r->ptr);
+			rte_free(r);
+		} else
+			prev = &r->next;
+	}
+}
+
 void
 rte_hash_reset(struct rte_hash *h)
 {
 	uint32_t tot_ring_cnt, i;
+	unsigned int pending;
+	struct rte_hash_bucket *old_buckets;
 
 	if (h == NULL)
 		return;
 
 	__hash_rw_writer_lock(h);
+
+	if (h->dq) {
+		/* Reclaim all the resources */
+		rte_rcu_qsbr_dq_reclaim(h->dq, ~0, NULL, &pending, NULL);
+		if (pending != 0)
+			RTE_LOG(ERR, HASH, "RCU reclaim all resources failed\n");
+	}
+
 	memset(h->buckets, 0, h->num_buckets * sizeof(struct rte_hash_bucket));
 	memset(h->key_store, 0, h->key_entry_size * (h->entries + 1));
+	memset(h->key_sigs, 0, sizeof(uint32_t) * (h->entries + 1));
 	*h->tbl_chng_cnt = 0;
 
+	/* Drop the bucket array of an ongoing resize */
+	old_buckets = h->old_buckets;
+	__atomic_store_n(&h->old_buckets, NULL, __ATOMIC_RELEASE);
+
 	/* reset the free ring */
 	rte_ring_reset(h->free_slots);
 
@@ -649,6 +743,9 @@ rte_hash_reset(struct rte_hash *h)
 			h->local_free_slots[i].len = 0;
 	}
 	__hash_rw_writer_unlock(h);
+
+	if (old_buckets != NULL)
+		__hash_retire(h, old_buckets);
 }
 
 /*
@@ -665,10 +762,46 @@ enqueue_slot_back(const struct rte_hash *h,
 		cached_free_slots->objs[cached_free_slots->len] = slot_id;
 		cached_free_slots->len++;
 	} else
-		rte_ring_sp_enqueue_elem(h->free_slots, &slot_id,
+		rte_ring_mp_enqueue_elem(h->free_slots, &slot_id,
 						sizeof(uint32_t));
 }
 
+/*
+ * Get a free key store slot from the lcore cache or the global ring.
+ * Returns EMPTY_SLOT if none is available.
+ */
+static inline uint32_t
+alloc_slot(const struct rte_hash *h, struct lcore_cache *cached_free_slots)
+{
+	unsigned int n_slots;
+	uint32_t slot_id;
+
+	if (h->use_local_cache) {
+		/* Try to get a free slot from the local cache */
+		if (cached_free_slots->len == 0) {
+			/* Need to get another burst of free slots from global ring */
+			n_slots = rte_ring_mc_dequeue_burst_elem(h->free_slots,
+					cached_free_slots->objs,
+					sizeof(uint32_t),
+					LCORE_CACHE_SIZE, NULL);
+			if (n_slots == 0)
+				return EMPTY_SLOT;
+
+			cached_free_slots->len += n_slots;
+		}
+
+		/* Get a free slot from the local cache */
+		cached_free_slots->len--;
+		slot_id = cached_free_slots->objs[cached_free_slots->len];
+	} else {
+		if (rte_ring_sc_dequeue_elem(h->free_slots, &slot_id,
+						sizeof(uint32_t)) != 0)
+			return EMPTY_SLOT;
+	}
+
+	return slot_id;
+}
+
 /* Search a key from bucket and update its data.
  * Writer holds the lock before calling this.
  */
@@ -704,6 +837,28 @@ search_and_update(const struct rte_hash *h, void *data, const void *key,
 	return -1;
 }
 
+/* Search a key in the bucket array being migrated by a resize and update
+ * its data. Writer holds the lock before calling this.
+ */
+static inline int32_t
+search_old_and_update(const struct rte_hash *h, void *data, const void *key,
+	hash_sig_t sig)
+{
+	uint32_t mask = h->old_bucket_bitmask;
+	uint16_t short_sig = get_short_sig(sig);
+	uint32_t prim_bucket_idx = sig & mask;
+	uint32_t sec_bucket_idx = (prim_bucket_idx ^ short_sig) & mask;
+	int32_t ret;
+
+	ret = search_and_update(h, data, key,
+			&h->old_buckets[prim_bucket_idx], short_sig);
+	if (ret != -1)
+		return ret;
+
+	return search_and_update(h, data, key,
+			&h->old_buckets[sec_bucket_idx], short_sig);
+}
+
 /* Only tries to insert at one bucket (@prim_bkt) without trying to push
  * buckets around.
  * return 1 if matching existing key, return 0 if succeeds, return -1 for no
@@ -843,7 +998,7 @@ rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
 			 * tbl_chng_cnt are not required.
 			 */
 			__atomic_store_n(h->tbl_chng_cnt,
-					 *h->tbl_chng_cnt + 1,
+					 *h->tbl_chng_cnt + 2,
 					 __ATOMIC_RELEASE);
 			/* The store to sig_current should not
 			 * move above the store to tbl_chng_cnt.
@@ -875,7 +1030,7 @@ rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
 		 * tbl_chng_cnt are not required.
 		 */
 		__atomic_store_n(h->tbl_chng_cnt,
-				 *h->tbl_chng_cnt + 1,
+				 *h->tbl_chng_cnt + 2,
 				 __ATOMIC_RELEASE);
 		/* The store to sig_current should not
 		 * move above the store to tbl_chng_cnt.
@@ -952,6 +1107,282 @@ rte_hash_cuckoo_make_space_mw(const struct rte_hash *h,
 	return -ENOSPC;
 }
 
+/*
+ * Move the keys of one bucket of the old array to the current array.
+ * The key index is inserted in its new location before being removed
+ * from the old one, so that lookups always find it in either array.
+ */
+static int
+__hash_migrate_bucket(const struct rte_hash *h,
+			struct rte_hash_bucket *old_bkt)
+{
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	struct rte_hash_bucket *prim_bkt, *sec_bkt;
+	struct rte_hash_key *k;
+	const void *key;
+	unsigned int i;
+	uint32_t key_idx;
+	hash_sig_t sig;
+	uint16_t short_sig;
+	int32_t ret_val;
+	int ret;
+
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+		key_idx = old_bkt->key_idx[i];
+		if (key_idx == EMPTY_SLOT)
+			continue;
+
+		sig = h->key_sigs[key_idx];
+		short_sig = get_short_sig(sig);
+		prim_bucket_idx = get_prim_bucket_index(h, sig);
+		sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx,
+							short_sig);
+		prim_bkt = &h->buckets[prim_bucket_idx];
+		sec_bkt = &h->buckets[sec_bucket_idx];
+		k = (struct rte_hash_key *)((char *)h->key_store +
+				key_idx * h->key_entry_size);
+		key = k->key;
+
+		ret = rte_hash_cuckoo_insert_mw(h, prim_bkt, sec_bkt, key,
+				k->pdata, short_sig, key_idx, &ret_val);
+		if (ret == -1)
+			ret = rte_hash_cuckoo_make_space_mw(h, prim_bkt,
+					sec_bkt, key, k->pdata, short_sig,
+					prim_bucket_idx, key_idx, &ret_val);
+		if (ret == -ENOSPC)
+			ret = rte_hash_cuckoo_make_space_mw(h, sec_bkt,
+					prim_bkt, key, k->pdata, short_sig,
+					sec_bucket_idx, key_idx, &ret_val);
+		if (ret == -ENOSPC)
+			return ret;
+
+		__hash_rw_writer_lock(h);
+		if (h->readwrite_concur_lf_support) {
+			/* Inform the readers that the key moved, the ones
+			 * which searched the current array before the
+			 * insertion must retry. Since there is one writer,
+			 * load acquire on tbl_chng_cnt is not required.
+			 */
+			__atomic_store_n(h->tbl_chng_cnt,
+					 *h->tbl_chng_cnt + 2,
+					 __ATOMIC_RELEASE);
+			/* The store to sig_current should not
+			 * move above the store to tbl_chng_cnt.
+			 */
+			__atomic_thread_fence(__ATOMIC_RELEASE);
+		}
+		old_bkt->sig_current[i] = NULL_SIGNATURE;
+		__atomic_store_n(&old_bkt->key_idx[i],
+				 EMPTY_SLOT,
+				 __ATOMIC_RELEASE);
+		__hash_rw_writer_unlock(h);
+	}
+
+	return 0;
+}
+
+/*
+ * Migrate up to @num_buckets buckets of an ongoing resize.
+ * Return the number of old buckets left to migrate, or -ENOSPC.
+ */
+static int
+__hash_resize_step(const struct rte_hash *h, uint32_t num_buckets)
+{
+	struct rte_hash *hw = (struct rte_hash *)((uintptr_t)h);
+	const uint32_t old_num_buckets = h->num_buckets >> 1;
+	struct rte_hash_bucket *old_buckets = h->old_buckets;
+	int ret;
+
+	if (old_buckets == NULL)
+		return 0;
+
+	while (num_buckets-- > 0 && hw->resize_next < old_num_buckets) {
+		ret = __hash_migrate_bucket(h, &old_buckets[hw->resize_next]);
+		if (ret != 0)
+			return ret;
+		hw->resize_next++;
+	}
+
+	if (hw->resize_next < old_num_buckets)
+		return old_num_buckets - hw->resize_next;
+
+	/* All the keys moved, readers can stop searching the old array */
+	__hash_rw_writer_lock(h);
+	__atomic_store_n(&hw->old_buckets, NULL, __ATOMIC_RELEASE);
+	__hash_rw_writer_unlock(h);
+
+	__hash_retire(hw, old_buckets);
+
+	return 0;
+}
+
+static void
+__hash_rcu_qsbr_free_resource(void *p, void *e, unsigned int n);
+
+int
+rte_hash_resize(struct rte_hash *h)
+{
+	struct rte_hash_bucket *buckets = NULL;
+	struct rte_ring *r = NULL, *old_r;
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+	struct rte_rcu_qsbr_dq *dq = NULL, *old_dq = NULL;
+	void *k = NULL, *old_k;
+	uint32_t *key_sigs = NULL, *old_key_sigs;
+	char ring_name[RTE_RING_NAMESIZE];
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+	uint32_t num_buckets, entries, i;
+	unsigned int pending;
+
+	RETURN_IF_TRUE((h == NULL), -EINVAL);
+
+	/* The extendable buckets and the lcore caches of free slots
+	 * are sized at creation time.
+	 */
+	if (h->ext_table_support || h->use_local_cache)
+		return -ENOTSUP;
+
+	if (h->old_buckets != NULL)
+		return -EBUSY;
+
+	if (h->entries > RTE_HASH_ENTRIES_MAX / 2)
+		return -ENOSPC;
+
+	entries = h->entries << 1;
+	num_buckets = h->num_buckets << 1;
+
+	buckets = rte_zmalloc_socket(NULL,
+			num_buckets * sizeof(struct rte_hash_bucket),
+			RTE_CACHE_LINE_SIZE, h->socket_id);
+	k = rte_zmalloc_socket(NULL,
+			(uint64_t)h->key_entry_size * (entries + 1),
+			RTE_CACHE_LINE_SIZE, h->socket_id);
+	key_sigs = rte_zmalloc_socket(NULL, sizeof(uint32_t) * (entries + 1),
+			RTE_CACHE_LINE_SIZE, h->socket_id);
+	/* Ring names must be unique, use the resize count */
+	snprintf(ring_name, sizeof(ring_name), "HT%u_%s",
+			h->resize_gen + 1, h->name);
+	r = rte_ring_create_elem(ring_name, sizeof(uint32_t),
+			rte_align32pow2(entries + 1), h->socket_id, 0);
+	/* A defer queue sized from the entries must grow with the table,
+	 * otherwise the key indexes failing to fit in it are leaked.
+	 */
+	if (h->dq != NULL && h->dq_auto_size) {
+		snprintf(rcu_dq_name, sizeof(rcu_dq_name), "HASH_RCU%u_%s",
+				h->resize_gen + 1, h->name);
+		params.name = rcu_dq_name;
+		params.size = entries;
+		params.trigger_reclaim_limit =
+			h->hash_rcu_cfg->trigger_reclaim_limit;
+		params.max_reclaim_size = h->hash_rcu_cfg->max_reclaim_size;
+		params.esize = sizeof(struct __rte_hash_rcu_dq_entry);
+		params.free_fn = __hash_rcu_qsbr_free_resource;
+		params.p = h;
+		params.v = h->hash_rcu_cfg->v;
+		dq = rte_rcu_qsbr_dq_create(&params);
+	}
+	if (buckets == NULL || k == NULL || key_sigs == NULL || r == NULL ||
+			(h->dq != NULL && h->dq_auto_size && dq == NULL)) {
+		RTE_LOG(ERR, HASH, "resize memory allocation failed\n");
+		rte_free(buckets);
+		rte_free(k);
+		rte_free(key_sigs);
+		rte_ring_free(r);
+		rte_rcu_qsbr_dq_delete(dq);
+		return -ENOMEM;
+	}
+
+	__hash_rw_writer_lock(h);
+
+	/* Grow the key store. The new store must be visible to the readers
+	 * before any of the new slots is used.
+	 */
+	memcpy(k, h->key_store, (size_t)h->key_entry_size * (h->entries + 1));
+	memcpy(key_sigs, h->key_sigs, sizeof(uint32_t) * (h->entries + 1));
+	old_k = h->key_store;
+	__atomic_store_n(&h->key_store, k, __ATOMIC_RELEASE);
+	old_key_sigs = h->key_sigs;
+	h->key_sigs = key_sigs;
+
+	/* Move the free slots to the new ring and add the new ones */
+	old_r = h->free_slots;
+	while (rte_ring_sc_dequeue_elem(old_r, &i, sizeof(uint32_t)) == 0)
+		rte_ring_sp_enqueue_elem(r, &i, sizeof(uint32_t));
+	for (i = h->entries + 1; i <= entries; i++)
+		rte_ring_sp_enqueue_elem(r, &i, sizeof(uint32_t));
+	h->free_slots = r;
+	h->entries = entries;
+
+	/* Deleted key indexes are queued to the new defer queue */
+	if (dq != NULL) {
+		old_dq = h->dq;
+		h->dq = dq;
+		h->hash_rcu_cfg->dq_size = entries;
+	}
+
+	/* The table change counter is odd while the arrays and masks are
+	 * published, the lock-free readers retry until it is even again.
+	 * Since there is one writer, load acquire on tbl_chng_cnt is not
+	 * required.
+	 */
+	if (h->readwrite_concur_lf_support)
+		__atomic_store_n(h->tbl_chng_cnt, *h->tbl_chng_cnt + 1,
+				 __ATOMIC_RELEASE);
+
+	/* Readers load the bucket mask first, then the bucket array and then
+	 * the old bucket array and its mask. Publish them in the reverse
+	 * order so that the arrays a reader sees are always large enough
+	 * for its masks.
+	 */
+	h->old_bucket_bitmask = h->bucket_bitmask;
+	__atomic_store_n(&h->old_buckets, h->buckets, __ATOMIC_RELEASE);
+	__atomic_store_n(&h->buckets, buckets, __ATOMIC_RELEASE);
+	h->num_buckets = num_buckets;
+	__atomic_store_n(&h->bucket_bitmask, num_buckets - 1,
+			 __ATOMIC_RELEASE);
+	h->resize_next = 0;
+	h->resize_gen++;
+
+	if (h->readwrite_concur_lf_support)
+		/* Inform the readers that the table has changed */
+		__atomic_store_n(h->tbl_chng_cnt, *h->tbl_chng_cnt + 1,
+				 __ATOMIC_RELEASE);
+
+	__hash_rw_writer_unlock(h);
+
+	rte_ring_free(old_r);
+	rte_free(old_key_sigs);
+	__hash_retire(h, old_k);
+
+	if (old_dq != NULL) {
+		/* Return the key indexes of the old defer queue to the free
+		 * slots, waiting for the readers if some are still in use.
+		 */
+		rte_rcu_qsbr_dq_reclaim(old_dq, ~0, NULL, &pending, NULL);
+		if (pending != 0)
+			rte_rcu_qsbr_synchronize(h->hash_rcu_cfg->v,
+				RTE_QSBR_THRID_INVALID);
+		if (rte_rcu_qsbr_dq_delete(old_dq) != 0)
+			RTE_LOG(ERR, HASH,
+				"RCU reclaim all resources failed\n");
+	}
+	__hash_reclaim_retired(h);
+
+	return 0;
+}
+
+int
+rte_hash_resize_step(struct rte_hash *h, uint32_t num_buckets)
+{
+	int ret;
+
+	RETURN_IF_TRUE((h == NULL), -EINVAL);
+
+	ret = __hash_resize_step(h, num_buckets);
+	__hash_reclaim_retired(h);
+
+	return ret;
+}
+
 static inline int32_t
 __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 						hash_sig_t sig, void *data)
@@ -963,13 +1394,16 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	uint32_t ext_bkt_id = 0;
 	uint32_t slot_id;
 	int ret;
-	unsigned n_slots;
 	unsigned lcore_id;
 	unsigned int i;
 	struct lcore_cache *cached_free_slots = NULL;
 	int32_t ret_val;
 	struct rte_hash_bucket *last;
 
+	/* Move a few buckets of an ongoing resize */
+	if (unlikely(h->old_buckets != NULL))
+		__hash_resize_step(h, RTE_HASH_RESIZE_BATCH);
+
 	short_sig = get_short_sig(sig);
 	prim_bucket_idx = get_prim_bucket_index(h, sig);
 	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
@@ -995,36 +1429,36 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 		}
 	}
 
+	/* Check if key is still in the bucket array being migrated */
+	if (unlikely(h->old_buckets != NULL)) {
+		ret = search_old_and_update(h, data, key, sig);
+		if (ret != -1) {
+			__hash_rw_writer_unlock(h);
+			return ret;
+		}
+	}
+
 	__hash_rw_writer_unlock(h);
 
 	/* Did not find a match, so get a new slot for storing the new key */
 	if (h->use_local_cache) {
 		lcore_id = rte_lcore_id();
 		cached_free_slots = &h->local_free_slots[lcore_id];
-		/* Try to get a free slot from the local cache */
-		if (cached_free_slots->len == 0) {
-			/* Need to get another burst of free slots from global ring */
-			n_slots = rte_ring_mc_dequeue_burst_elem(h->free_slots,
-					cached_free_slots->objs,
-					sizeof(uint32_t),
-					LCORE_CACHE_SIZE, NULL);
-			if (n_slots == 0) {
-				return -ENOSPC;
-			}
-
-			cached_free_slots->len += n_slots;
-		}
-
-		/* Get a free slot from the local cache */
-		cached_free_slots->len--;
-		slot_id = cached_free_slots->objs[cached_free_slots->len];
-	} else {
-		if (rte_ring_sc_dequeue_elem(h->free_slots, &slot_id,
-						sizeof(uint32_t)) != 0) {
-			return -ENOSPC;
-		}
 	}
+	slot_id = alloc_slot(h, cached_free_slots);
+	if (slot_id == EMPTY_SLOT && h->dq != NULL) {
+		/* Try to reclaim the entries deleted by now */
+		__hash_rw_writer_lock(h);
+		rte_rcu_qsbr_dq_reclaim(h->dq,
+				h->hash_rcu_cfg->max_reclaim_size,
+				NULL, NULL, NULL);
+		__hash_rw_writer_unlock(h);
+		slot_id = alloc_slot(h, cached_free_slots);
+	}
+	if (slot_id == EMPTY_SLOT)
+		return -ENOSPC;
 
+	h->key_sigs[slot_id] = sig;
 	new_k = RTE_PTR_ADD(keys, slot_id * h->key_entry_size);
 	/* The store to application data (by the application) at *data should
 	 * not leak after the store of pdata in the key store. i.e. pdata is
@@ -1118,8 +1552,16 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	if (rte_ring_sc_dequeue_elem(h->free_ext_bkts, &ext_bkt_id,
 						sizeof(uint32_t)) != 0 ||
 					ext_bkt_id == 0) {
-		ret = -ENOSPC;
-		goto failure;
+		if (h->dq == NULL ||
+				rte_rcu_qsbr_dq_reclaim(h->dq,
+					h->hash_rcu_cfg->max_reclaim_size,
+					NULL, NULL, NULL) != 0 ||
+				rte_ring_sc_dequeue_elem(h->free_ext_bkts,
+					&ext_bkt_id, sizeof(uint32_t)) != 0 ||
+				ext_bkt_id == 0) {
+			ret = -ENOSPC;
+			goto failure;
+		}
 	}
 
 	/* Use the first location of the new bucket */
@@ -1222,7 +1664,7 @@ search_one_bucket_lf(const struct rte_hash *h, const void *key, uint16_t sig,
 {
 	int i;
 	uint32_t key_idx;
-	struct rte_hash_key *k, *keys = h->key_store;
+	struct rte_hash_key *k, *keys;
 
 	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
 		/* Signature comparison is done before the acquire-load
@@ -1236,6 +1678,12 @@ search_one_bucket_lf(const struct rte_hash *h, const void *key, uint16_t sig,
 			key_idx = __atomic_load_n(&bkt->key_idx[i],
 					  __ATOMIC_ACQUIRE);
 			if (key_idx != EMPTY_SLOT) {
+				/* The key store is loaded after the key
+				 * index, a resize might have grown it to
+				 * hold that index.
+				 */
+				keys = __atomic_load_n(&h->key_store,
+						__ATOMIC_ACQUIRE);
 				k = (struct rte_hash_key *) ((char *)keys +
 						key_idx * h->key_entry_size);
 
@@ -1263,17 +1711,19 @@ __rte_hash_lookup_with_hash_l(const struct rte_hash *h, const void *key,
 {
 	uint32_t prim_bucket_idx, sec_bucket_idx;
 	struct rte_hash_bucket *bkt, *cur_bkt;
+	uint32_t mask;
 	int ret;
 	uint16_t short_sig;
 
 	short_sig = get_short_sig(sig);
+
+	__hash_rw_reader_lock(h);
+
 	prim_bucket_idx = get_prim_bucket_index(h, sig);
 	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
 
 	bkt = &h->buckets[prim_bucket_idx];
 
-	__hash_rw_reader_lock(h);
-
 	/* Check if key is in primary location */
 	ret = search_one_bucket_l(h, key, short_sig, data, bkt);
 	if (ret != -1) {
@@ -1293,6 +1743,25 @@ __rte_hash_lookup_with_hash_l(const struct rte_hash *h, const void *key,
 		}
 	}
 
+	/* Check the keys not migrated yet by an ongoing resize, the old
+	 * array has half as many buckets as the current one.
+	 */
+	if (unlikely(h->old_buckets != NULL)) {
+		mask = h->old_bucket_bitmask;
+		prim_bucket_idx = sig & mask;
+		sec_bucket_idx = (prim_bucket_idx ^ short_sig) & mask;
+
+		ret = search_one_bucket_l(h, key, short_sig, data,
+					&h->old_buckets[prim_bucket_idx]);
+		if (ret == -1)
+			ret = search_one_bucket_l(h, key, short_sig, data,
+					&h->old_buckets[sec_bucket_idx]);
+		if (ret != -1) {
+			__hash_rw_reader_unlock(h);
+			return ret;
+		}
+	}
+
 	__hash_rw_reader_unlock(h);
 
 	return -ENOENT;
@@ -1303,14 +1772,13 @@ __rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
 					hash_sig_t sig, void **data)
 {
 	uint32_t prim_bucket_idx, sec_bucket_idx;
-	struct rte_hash_bucket *bkt, *cur_bkt;
+	struct rte_hash_bucket *buckets, *old_buckets, *bkt, *cur_bkt;
 	uint32_t cnt_b, cnt_a;
+	uint32_t mask;
 	int ret;
 	uint16_t short_sig;
 
 	short_sig = get_short_sig(sig);
-	prim_bucket_idx = get_prim_bucket_index(h, sig);
-	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
 
 	do {
 		/* Load the table change counter before the lookup
@@ -1320,13 +1788,21 @@ __rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
 		cnt_b = __atomic_load_n(h->tbl_chng_cnt,
 				__ATOMIC_ACQUIRE);
 
+		/* A resize publishes the bucket array before its mask,
+		 * so the array loaded after the mask is large enough.
+		 */
+		mask = __atomic_load_n(&h->bucket_bitmask, __ATOMIC_ACQUIRE);
+		buckets = __atomic_load_n(&h->buckets, __ATOMIC_ACQUIRE);
+		prim_bucket_idx = sig & mask;
+		sec_bucket_idx = (prim_bucket_idx ^ short_sig) & mask;
+
 		/* Check if key is in primary location */
-		bkt = &h->buckets[prim_bucket_idx];
+		bkt = &buckets[prim_bucket_idx];
 		ret = search_one_bucket_lf(h, key, short_sig, data, bkt);
 		if (ret != -1)
 			return ret;
 		/* Calculate secondary hash */
-		bkt = &h->buckets[sec_bucket_idx];
+		bkt = &buckets[sec_bucket_idx];
 
 		/* Check if key is in secondary location */
 		FOR_EACH_BUCKET(cur_bkt, bkt) {
@@ -1336,6 +1812,29 @@ __rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
 				return ret;
 		}
 
+		/* Check the keys not migrated yet by an ongoing resize.
+		 * The old array is searched after the current one, as
+		 * keys are inserted in the current array before being
+		 * removed from the old one.
+		 */
+		old_buckets = __atomic_load_n(&h->old_buckets,
+					__ATOMIC_ACQUIRE);
+		if (unlikely(old_buckets != NULL)) {
+			/* Stored before old_buckets by the resize */
+			mask = __atomic_load_n(&h->old_bucket_bitmask,
+					__ATOMIC_RELAXED);
+			prim_bucket_idx = sig & mask;
+			sec_bucket_idx = (prim_bucket_idx ^ short_sig) & mask;
+
+			ret = search_one_bucket_lf(h, key, short_sig, data,
+					&old_buckets[prim_bucket_idx]);
+			if (ret == -1)
+				ret = search_one_bucket_lf(h, key, short_sig,
+					data, &old_buckets[sec_bucket_idx]);
+			if (ret != -1)
+				return ret;
+		}
+
 		/* The loads of sig_current in search_one_bucket
 		 * should not move below the load from tbl_chng_cnt.
 		 */
@@ -1350,7 +1849,10 @@ __rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
 		 */
 		cnt_a = __atomic_load_n(h->tbl_chng_cnt,
 					__ATOMIC_ACQUIRE);
-	} while (cnt_b != cnt_a);
+		/* An odd counter means that a resize was publishing its
+		 * arrays, the masks and arrays loaded might not match.
+		 */
+	} while (cnt_b != cnt_a || (cnt_b & 1));
 
 	return -ENOENT;
 }
@@ -1395,6 +1897,142 @@ rte_hash_lookup_data(const struct rte_hash *h, const void *key, void **data)
 	return __rte_hash_lookup_with_hash(h, key, rte_hash_hash(h, key), data);
 }
 
+/*
+ * Put a key store slot back into the lcore cache or the global ring.
+ */
+static inline int
+free_slot(const struct rte_hash *h, uint32_t slot_id)
+{
+	unsigned int lcore_id, n_slots;
+	struct lcore_cache *cached_free_slots;
+
+	if (h->use_local_cache) {
+		lcore_id = rte_lcore_id();
+		cached_free_slots = &h->local_free_slots[lcore_id];
+		/* Cache full, need to free it. */
+		if (cached_free_slots->len == LCORE_CACHE_SIZE) {
+			/* Need to enqueue the free slots in global ring. */
+			n_slots = rte_ring_mp_enqueue_burst_elem(h->free_slots,
+						cached_free_slots->objs,
+						sizeof(uint32_t),
+						LCORE_CACHE_SIZE, NULL);
+			RETURN_IF_TRUE((n_slots == 0), -EFAULT);
+			cached_free_slots->len -= n_slots;
+		}
+		/* Put index of new free slot in cache. */
+		cached_free_slots->objs[cached_free_slots->len] = slot_id;
+		cached_free_slots->len++;
+	} else {
+		rte_ring_mp_enqueue_elem(h->free_slots, &slot_id,
+						sizeof(uint32_t));
+	}
+
+	return 0;
+}
+
+/*
+ * Release the resources of a deleted key once no reader references them:
+ * the application key data, the empty extendable bucket and the key index.
+ */
+static void
+__hash_rcu_qsbr_free_resource(void *p, void *e, unsigned int n)
+{
+	struct rte_hash *h = (struct rte_hash *)p;
+	struct __rte_hash_rcu_dq_entry *rcu_dq_entry = e;
+	struct rte_hash_key *k, *keys = h->key_store;
+
+	RTE_SET_USED(n);
+
+	if (h->hash_rcu_cfg->free_key_data_func) {
+		k = (struct rte_hash_key *)((char *)keys +
+			rcu_dq_entry->key_idx * h->key_entry_size);
+		h->hash_rcu_cfg->free_key_data_func(
+			h->hash_rcu_cfg->key_data_ptr, k->pdata);
+	}
+
+	if (rcu_dq_entry->ext_bkt_idx != EMPTY_SLOT)
+		/* Recycle empty ext bkt to free list. */
+		rte_ring_mp_enqueue_elem(h->free_ext_bkts,
+			&rcu_dq_entry->ext_bkt_idx, sizeof(uint32_t));
+
+	/* Return key index to free slot ring */
+	if (free_slot(h, rcu_dq_entry->key_idx) != 0)
+		RTE_LOG(ERR, HASH, "%s: could not free key index %u\n",
+			__func__, rcu_dq_entry->key_idx);
+}
+
+/* Associate QSBR variable with a Hash object. */
+int
+rte_hash_rcu_qsbr_add(struct rte_hash *h, struct rte_hash_rcu_config *cfg)
+{
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+	struct rte_hash_rcu_config *hash_rcu_cfg = NULL;
+
+	if (h == NULL || cfg == NULL || cfg->v == NULL) {
+		rte_errno = EINVAL;
+		return 1;
+	}
+
+	if (h->hash_rcu_cfg) {
+		rte_errno = EEXIST;
+		return 1;
+	}
+
+	hash_rcu_cfg = rte_zmalloc(NULL, sizeof(struct rte_hash_rcu_config), 0);
+	if (hash_rcu_cfg == NULL) {
+		RTE_LOG(ERR, HASH, "memory allocation failed\n");
+		rte_errno = ENOMEM;
+		return 1;
+	}
+
+	if (cfg->mode == RTE_HASH_QSBR_MODE_SYNC) {
+		/* No other things to do. */
+	} else if (cfg->mode == RTE_HASH_QSBR_MODE_DQ) {
+		/* Init QSBR defer queue. */
+		snprintf(rcu_dq_name, sizeof(rcu_dq_name),
+					"HASH_RCU_%s", h->name);
+		params.name = rcu_dq_name;
+		params.size = cfg->dq_size;
+		if (params.size == 0) {
+			params.size = h->use_local_cache ?
+				h->entries + (RTE_MAX_LCORE - 1) *
+				(LCORE_CACHE_SIZE - 1) : h->entries;
+			h->dq_auto_size = 1;
+		}
+		params.trigger_reclaim_limit = cfg->trigger_reclaim_limit;
+		params.max_reclaim_size = cfg->max_reclaim_size;
+		if (params.max_reclaim_size == 0)
+			params.max_reclaim_size = RTE_HASH_RCU_DQ_RECLAIM_MAX;
+		params.esize = sizeof(struct __rte_hash_rcu_dq_entry);
+		params.free_fn = __hash_rcu_qsbr_free_resource;
+		params.p = h;
+		params.v = cfg->v;
+		h->dq = rte_rcu_qsbr_dq_create(&params);
+		if (h->dq == NULL) {
+			rte_free(hash_rcu_cfg);
+			RTE_LOG(ERR, HASH, "HASH defer queue creation failed\n");
+			return 1;
+		}
+	} else {
+		rte_free(hash_rcu_cfg);
+		rte_errno = EINVAL;
+		return 1;
+	}
+
+	hash_rcu_cfg->v = cfg->v;
+	hash_rcu_cfg->mode = cfg->mode;
+	hash_rcu_cfg->dq_size = params.size;
+	hash_rcu_cfg->trigger_reclaim_limit = params.trigger_reclaim_limit;
+	hash_rcu_cfg->max_reclaim_size = params.max_reclaim_size;
+	hash_rcu_cfg->free_key_data_func = cfg->free_key_data_func;
+	hash_rcu_cfg->key_data_ptr = cfg->key_data_ptr;
+
+	h->hash_rcu_cfg = hash_rcu_cfg;
+
+	return 0;
+}
+
 static inline void
 remove_entry(const struct rte_hash *h, struct rte_hash_bucket *bkt, unsigned i)
 {
@@ -1452,7 +2090,7 @@ __rte_hash_compact_ll(const struct rte_hash *h,
 				 * tbl_chng_cnt is not required.
 				 */
 				__atomic_store_n(h->tbl_chng_cnt,
-					 *h->tbl_chng_cnt + 1,
+					 *h->tbl_chng_cnt + 2,
 					 __ATOMIC_RELEASE);
 				/* The store to sig_current should
 				 * not move above the store to tbl_chng_cnt.
@@ -1490,9 +2128,10 @@ search_and_remove(const struct rte_hash *h, const void *key,
 			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
 				bkt->sig_current[i] = NULL_SIGNATURE;
 				/* Free the key store index if
-				 * no_free_on_del is disabled.
+				 * no_free_on_del is disabled and the
+				 * index is not reclaimed through RCU.
 				 */
-				if (!h->no_free_on_del)
+				if (!h->no_free_on_del && h->hash_rcu_cfg == NULL)
 					remove_entry(h, bkt, i);
 
 				__atomic_store_n(&bkt->key_idx[i],
@@ -1521,6 +2160,13 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 	int pos;
 	int32_t ret, i;
 	uint16_t short_sig;
+	uint32_t index = EMPTY_SLOT;
+	struct __rte_hash_rcu_dq_entry rcu_dq_entry;
+	uint32_t mask;
+
+	/* Move a few buckets of an ongoing resize */
+	if (unlikely(h->old_buckets != NULL))
+		__hash_resize_step(h, RTE_HASH_RESIZE_BATCH);
 
 	short_sig = get_short_sig(sig);
 	prim_bucket_idx = get_prim_bucket_index(h, sig);
@@ -1550,15 +2196,33 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 		}
 	}
 
+	/* Check the keys not migrated yet by an ongoing resize. There are
+	 * no extendable buckets to compact when resizing.
+	 */
+	if (unlikely(h->old_buckets != NULL)) {
+		mask = h->old_bucket_bitmask;
+		prim_bucket_idx = sig & mask;
+		sec_bucket_idx = (prim_bucket_idx ^ short_sig) & mask;
+
+		ret = search_and_remove(h, key,
+				&h->old_buckets[prim_bucket_idx],
+				short_sig, &pos);
+		if (ret == -1)
+			ret = search_and_remove(h, key,
+					&h->old_buckets[sec_bucket_idx],
+					short_sig, &pos);
+		if (ret != -1)
+			goto return_key;
+	}
+
 	__hash_rw_writer_unlock(h);
 	return -ENOENT;
 
 /* Search last bucket to see if empty to be recycled */
 return_bkt:
-	if (!last_bkt) {
-		__hash_rw_writer_unlock(h);
-		return ret;
-	}
+	if (!last_bkt)
+		goto return_key;
+
 	while (last_bkt->next) {
 		prev_bkt = last_bkt;
 		last_bkt = last_bkt->next;
@@ -1571,11 +2235,13 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 	/* found empty bucket and recycle */
 	if (i == RTE_HASH_BUCKET_ENTRIES) {
 		prev_bkt->next = NULL;
-		uint32_t index = last_bkt - h->buckets_ext + 1;
+		index = last_bkt - h->buckets_ext + 1;
 		/* Recycle the empty bkt if
 		 * no_free_on_del is disabled.
+		 * When RCU is attached, the bkt is recycled together
+		 * with the key index once the grace period is over.
 		 */
-		if (h->no_free_on_del)
+		if (h->no_free_on_del) {
 			/* Store index of an empty ext bkt to be recycled
 			 * on calling rte_hash_del_xxx APIs.
 			 * When lock free read-write concurrency is enabled,
@@ -1584,12 +2250,37 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 			 * Hence freeing of the ext bkt is piggy-backed to
 			 * freeing of the key index.
 			 */
-			h->ext_bkt_to_free[ret] = index;
-		else
+			if (h->hash_rcu_cfg == NULL)
+				h->ext_bkt_to_free[ret] = index;
+		} else if (h->hash_rcu_cfg == NULL)
 			rte_ring_sp_enqueue_elem(h->free_ext_bkts, &index,
 							sizeof(uint32_t));
 	}
-	__hash_rw_writer_unlock(h);
+
+return_key:
+	if (h->hash_rcu_cfg == NULL) {
+		__hash_rw_writer_unlock(h);
+		return ret;
+	}
+
+	/* Key index where key is stored, adding the first dummy index */
+	rcu_dq_entry.key_idx = ret + 1;
+	rcu_dq_entry.ext_bkt_idx = index;
+
+	if (h->dq != NULL) {
+		/* Push into QSBR FIFO, to be reclaimed later. */
+		if (rte_rcu_qsbr_dq_enqueue(h->dq, &rcu_dq_entry) != 0)
+			RTE_LOG(ERR, HASH, "Failed to push QSBR FIFO\n");
+		__hash_rw_writer_unlock(h);
+	} else {
+		__hash_rw_writer_unlock(h);
+		/* Wait for quiescent state change and free immediately. */
+		rte_rcu_qsbr_synchronize(h->hash_rcu_cfg->v,
+			RTE_QSBR_THRID_INVALID);
+		__hash_rcu_qsbr_free_resource((void *)((uintptr_t)h),
+			&rcu_dq_entry, 1);
+	}
+
 	return ret;
 }
 
@@ -1637,8 +2328,6 @@ rte_hash_free_key_with_position(const struct rte_hash *h,
 
 	RETURN_IF_TRUE(((h == NULL) || (key_idx == EMPTY_SLOT)), -EINVAL);
 
-	unsigned int lcore_id, n_slots;
-	struct lcore_cache *cached_free_slots;
 	const uint32_t total_entries = h->use_local_cache ?
 		h->entries + (RTE_MAX_LCORE - 1) * (LCORE_CACHE_SIZE - 1) + 1
 							: h->entries + 1;
@@ -1656,28 +2345,7 @@ rte_hash_free_key_with_position(const struct rte_hash *h,
 		}
 	}
 
-	if (h->use_local_cache) {
-		lcore_id = rte_lcore_id();
-		cached_free_slots = &h->local_free_slots[lcore_id];
-		/* Cache full, need to free it. */
-		if (cached_free_slots->len == LCORE_CACHE_SIZE) {
-			/* Need to enqueue the free slots in global ring. */
-			n_slots = rte_ring_mp_enqueue_burst_elem(h->free_slots,
-						cached_free_slots->objs,
-						sizeof(uint32_t),
-						LCORE_CACHE_SIZE, NULL);
-			RETURN_IF_TRUE((n_slots == 0), -EFAULT);
-			cached_free_slots->len -= n_slots;
-		}
-		/* Put index of new free slot in cache. */
-		cached_free_slots->objs[cached_free_slots->len] = key_idx;
-		cached_free_slots->len++;
-	} else {
-		rte_ring_sp_enqueue_elem(h->free_slots, &key_idx,
-						sizeof(uint32_t));
-	}
-
-	return 0;
+	return free_slot(h, key_idx);
 }
 
 static inline void
@@ -1733,11 +2401,74 @@ compare_signatures(uint32_t *prim_hash_matches, uint32_t *sec_hash_matches,
 	}
 }
 
+/*
+ * Snapshot the bucket array and mask used to compute the bucket pointers
+ * of a bulk lookup. @tbl is set to the array, or to NULL while a resize is
+ * in progress, to be checked by __bulk_lookup_changed().
+ */
+static inline const struct rte_hash_bucket *
+__bulk_lookup_buckets(const struct rte_hash *h, uint32_t *mask,
+			const struct rte_hash_bucket **tbl)
+{
+	const struct rte_hash_bucket *buckets;
+
+	/* A resize publishes the bucket array before its mask */
+	*mask = __atomic_load_n(&h->bucket_bitmask, __ATOMIC_ACQUIRE);
+	buckets = __atomic_load_n(&h->buckets, __ATOMIC_ACQUIRE);
+	if (unlikely(__atomic_load_n(&h->old_buckets,
+				__ATOMIC_ACQUIRE) != NULL))
+		*tbl = NULL;
+	else
+		*tbl = buckets;
+
+	return buckets;
+}
+
+/*
+ * Check if a resize started since __bulk_lookup_buckets(), or was in
+ * progress. Then some keys might not be in the snapshot array.
+ */
+static inline int
+__bulk_lookup_changed(const struct rte_hash *h,
+			const struct rte_hash_bucket *tbl)
+{
+	return tbl == NULL ||
+		tbl != __atomic_load_n(&h->buckets, __ATOMIC_ACQUIRE);
+}
+
+/*
+ * Look up again one by one the keys a bulk lookup missed because of a
+ * resize, searching both the current and the old bucket arrays.
+ */
+static inline uint64_t
+__bulk_lookup_resized(const struct rte_hash *h, const void **keys,
+		const hash_sig_t *prim_hash, int32_t num_keys,
+		int32_t *positions, uint64_t hits, void *data[])
+{
+	int32_t i;
+	int32_t ret;
+
+	for (i = 0; i < num_keys; i++) {
+		if ((hits & (1ULL << i)) != 0)
+			continue;
+		ret = __rte_hash_lookup_with_hash(h, keys[i], prim_hash[i],
+				data != NULL ? &data[i] : NULL);
+		if (ret >= 0) {
+			positions[i] = ret;
+			hits |= 1ULL << i;
+		}
+	}
+
+	return hits;
+}
+
 static inline void
 __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 		const struct rte_hash_bucket **primary_bkt,
 		const struct rte_hash_bucket **secondary_bkt,
-		uint16_t *sig, int32_t num_keys, int32_t *positions,
+		uint16_t *sig, const hash_sig_t *prim_hash,
+		const struct rte_hash_bucket *tbl,
+		int32_t num_keys, int32_t *positions,
 		uint64_t *hit_mask, void *data[])
 {
 	uint64_t hits = 0;
@@ -1749,6 +2480,20 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 
 	__hash_rw_reader_lock(h);
 
+	/* The bucket pointers were computed before taking the lock,
+	 * they might belong to an array replaced by a resize.
+	 */
+	if (unlikely(__bulk_lookup_changed(h, tbl))) {
+		__hash_rw_reader_unlock(h);
+		for (i = 0; i < num_keys; i++)
+			positions[i] = -ENOENT;
+		hits = __bulk_lookup_resized(h, keys, prim_hash, num_keys,
+				positions, 0, data);
+		if (hit_mask != NULL)
+			*hit_mask = hits;
+		return;
+	}
+
 	/* Compare signatures and prefetch key slot of first hit */
 	for (i = 0; i < num_keys; i++) {
 		compare_signatures(&prim_hitmask[i], &sec_hitmask[i],
@@ -1884,7 +2629,9 @@ static inline void
 __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 		const struct rte_hash_bucket **primary_bkt,
 		const struct rte_hash_bucket **secondary_bkt,
-		uint16_t *sig, int32_t num_keys, int32_t *positions,
+		uint16_t *sig, const hash_sig_t *prim_hash,
+		const struct rte_hash_bucket *tbl,
+		int32_t num_keys, int32_t *positions,
 		uint64_t *hit_mask, void *data[])
 {
 	uint64_t hits = 0;
@@ -2055,22 +2802,30 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 					__ATOMIC_ACQUIRE);
 	} while (cnt_b != cnt_a);
 
+	/* The missed keys might have been moved by a resize */
+	if (unlikely(__bulk_lookup_changed(h, tbl)))
+		hits = __bulk_lookup_resized(h, keys, prim_hash, num_keys,
+				positions, hits, data);
+
 	if (hit_mask != NULL)
 		*hit_mask = hits;
 }
 
 #define PREFETCH_OFFSET 4
-static inline void
+static inline const struct rte_hash_bucket *
 __bulk_lookup_prefetching_loop(const struct rte_hash *h,
 	const void **keys, int32_t num_keys,
-	uint16_t *sig,
+	uint16_t *sig, hash_sig_t *prim_hash,
 	const struct rte_hash_bucket **primary_bkt,
 	const struct rte_hash_bucket **secondary_bkt)
 {
 	int32_t i;
-	uint32_t prim_hash[RTE_HASH_LOOKUP_BULK_MAX];
 	uint32_t prim_index[RTE_HASH_LOOKUP_BULK_MAX];
 	uint32_t sec_index[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_bucket *buckets, *tbl;
+	uint32_t mask;
+
+	buckets = __bulk_lookup_buckets(h, &mask, &tbl);
 
 	/* Prefetch first keys */
 	for (i = 0; i < PREFETCH_OFFSET && i < num_keys; i++)
@@ -2086,11 +2841,11 @@ __bulk_lookup_prefetching_loop(const struct rte_hash *h,
 		prim_hash[i] = rte_hash_hash(h, keys[i]);
 
 		sig[i] = get_short_sig(prim_hash[i]);
-		prim_index[i] = get_prim_bucket_index(h, prim_hash[i]);
-		sec_index[i] = get_alt_bucket_index(h, prim_index[i], sig[i]);
+		prim_index[i] = prim_hash[i] & mask;
+		sec_index[i] = (prim_index[i] ^ sig[i]) & mask;
 
-		primary_bkt[i] = &h->buckets[prim_index[i]];
-		secondary_bkt[i] = &h->buckets[sec_index[i]];
+		primary_bkt[i] = &buckets[prim_index[i]];
+		secondary_bkt[i] = &buckets[sec_index[i]];
 
 		rte_prefetch0(primary_bkt[i]);
 		rte_prefetch0(secondary_bkt[i]);
@@ -2101,15 +2856,17 @@ __bulk_lookup_prefetching_loop(const struct rte_hash *h,
 		prim_hash[i] = rte_hash_hash(h, keys[i]);
 
 		sig[i] = get_short_sig(prim_hash[i]);
-		prim_index[i] = get_prim_bucket_index(h, prim_hash[i]);
-		sec_index[i] = get_alt_bucket_index(h, prim_index[i], sig[i]);
+		prim_index[i] = prim_hash[i] & mask;
+		sec_index[i] = (prim_index[i] ^ sig[i]) & mask;
 
-		primary_bkt[i] = &h->buckets[prim_index[i]];
-		secondary_bkt[i] = &h->buckets[sec_index[i]];
+		primary_bkt[i] = &buckets[prim_index[i]];
+		secondary_bkt[i] = &buckets[sec_index[i]];
 
 		rte_prefetch0(primary_bkt[i]);
 		rte_prefetch0(secondary_bkt[i]);
 	}
+
+	return tbl;
 }
 
 
@@ -2119,14 +2876,16 @@ __rte_hash_lookup_bulk_l(const struct rte_hash *h, const void **keys,
 			uint64_t *hit_mask, void *data[])
 {
 	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
+	hash_sig_t prim_hash[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_bucket *tbl;
 
-	__bulk_lookup_prefetching_loop(h, keys, num_keys, sig,
-		primary_bkt, secondary_bkt);
+	tbl = __bulk_lookup_prefetching_loop(h, keys, num_keys, sig,
+		prim_hash, primary_bkt, secondary_bkt);
 
-	__bulk_lookup_l(h, keys, primary_bkt, secondary_bkt, sig, num_keys,
-		positions, hit_mask, data);
+	__bulk_lookup_l(h, keys, primary_bkt, secondary_bkt, sig, prim_hash,
+		tbl, num_keys, positions, hit_mask, data);
 }
 
 static inline void
@@ -2135,14 +2894,16 @@ __rte_hash_lookup_bulk_lf(const struct rte_hash *h, const void **keys,
 			uint64_t *hit_mask, void *data[])
 {
 	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
+	hash_sig_t prim_hash[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_bucket *tbl;
 
-	__bulk_lookup_prefetching_loop(h, keys, num_keys, sig,
-		primary_bkt, secondary_bkt);
+	tbl = __bulk_lookup_prefetching_loop(h, keys, num_keys, sig,
+		prim_hash, primary_bkt, secondary_bkt);
 
-	__bulk_lookup_lf(h, keys, primary_bkt, secondary_bkt, sig, num_keys,
-		positions, hit_mask, data);
+	__bulk_lookup_lf(h, keys, primary_bkt, secondary_bkt, sig, prim_hash,
+		tbl, num_keys, positions, hit_mask, data);
 }
 
 static inline void
@@ -2199,6 +2960,10 @@ __rte_hash_lookup_with_hash_bulk_l(const struct rte_hash *h,
 	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_bucket *buckets, *tbl;
+	uint32_t mask;
+
+	buckets = __bulk_lookup_buckets(h, &mask, &tbl);
 
 	/*
 	 * Prefetch keys, calculate primary and
@@ -2208,18 +2973,18 @@ __rte_hash_lookup_with_hash_bulk_l(const struct rte_hash *h,
 		rte_prefetch0(keys[i]);
 
 		sig[i] = get_short_sig(prim_hash[i]);
-		prim_index[i] = get_prim_bucket_index(h, prim_hash[i]);
-		sec_index[i] = get_alt_bucket_index(h, prim_index[i], sig[i]);
+		prim_index[i] = prim_hash[i] & mask;
+		sec_index[i] = (prim_index[i] ^ sig[i]) & mask;
 
-		primary_bkt[i] = &h->buckets[prim_index[i]];
-		secondary_bkt[i] = &h->buckets[sec_index[i]];
+		primary_bkt[i] = &buckets[prim_index[i]];
+		secondary_bkt[i] = &buckets[sec_index[i]];
 
 		rte_prefetch0(primary_bkt[i]);
 		rte_prefetch0(secondary_bkt[i]);
 	}
 
-	__bulk_lookup_l(h, keys, primary_bkt, secondary_bkt, sig, num_keys,
-		positions, hit_mask, data);
+	__bulk_lookup_l(h, keys, primary_bkt, secondary_bkt, sig, prim_hash,
+		tbl, num_keys, positions, hit_mask, data);
 }
 
 static inline void
@@ -2234,6 +2999,10 @@ __rte_hash_lookup_with_hash_bulk_lf(const struct rte_hash *h,
 	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_bucket *buckets, *tbl;
+	uint32_t mask;
+
+	buckets = __bulk_lookup_buckets(h, &mask, &tbl);
 
 	/*
 	 * Prefetch keys, calculate primary and
@@ -2243,18 +3012,18 @@ __rte_hash_lookup_with_hash_bulk_lf(const struct rte_hash *h,
 		rte_prefetch0(keys[i]);
 
 		sig[i] = get_short_sig(prim_hash[i]);
-		prim_index[i] = get_prim_bucket_index(h, prim_hash[i]);
-		sec_index[i] = get_alt_bucket_index(h, prim_index[i], sig[i]);
+		prim_index[i] = prim_hash[i] & mask;
+		sec_index[i] = (prim_index[i] ^ sig[i]) & mask;
 
-		primary_bkt[i] = &h->buckets[prim_index[i]];
-		secondary_bkt[i] = &h->buckets[sec_index[i]];
+		primary_bkt[i] = &buckets[prim_index[i]];
+		secondary_bkt[i] = &buckets[sec_index[i]];
 
 		rte_prefetch0(primary_bkt[i]);
 		rte_prefetch0(secondary_bkt[i]);
 	}
 
-	__bulk_lookup_lf(h, keys, primary_bkt, secondary_bkt, sig, num_keys,
-		positions, hit_mask, data);
+	__bulk_lookup_lf(h, keys, primary_bkt, secondary_bkt, sig, prim_hash,
+		tbl, num_keys, positions, hit_mask, data);
 }
 
 static inline void
@@ -2303,17 +3072,225 @@ rte_hash_lookup_with_hash_bulk_data(const struct rte_hash *h,
 	return __builtin_popcountl(*hit_mask);
 }
 
+/*
+ * Compare a key with the keys of the bucket entries matching its signature.
+ * Compiled for the lock free case (@lf) or for the reader lock case.
+ */
+static __rte_always_inline int32_t
+__stream_compare_keys(const struct rte_hash *h, const void *key,
+		const struct rte_hash_bucket *bkt, uint32_t hitmask,
+		void **data, const int lf)
+{
+	const struct rte_hash_key *key_slot;
+	uint32_t hit_index, key_idx;
+	const void *keys;
+
+	while (hitmask) {
+		hit_index = __builtin_ctzl(hitmask) >> 1;
+		if (lf) {
+			key_idx = __atomic_load_n(&bkt->key_idx[hit_index],
+					__ATOMIC_ACQUIRE);
+			keys = __atomic_load_n(&h->key_store,
+					__ATOMIC_ACQUIRE);
+		} else {
+			key_idx = bkt->key_idx[hit_index];
+			keys = h->key_store;
+		}
+		key_slot = (const struct rte_hash_key *)(
+				(const char *)keys +
+				key_idx * h->key_entry_size);
+
+		/*
+		 * If key index is 0, do not compare key,
+		 * as it is checking the dummy slot
+		 */
+		if (!!key_idx & !rte_hash_cmp_eq(key_slot->key, key, h)) {
+			if (data != NULL)
+				*data = lf ? __atomic_load_n(&key_slot->pdata,
+							__ATOMIC_ACQUIRE) :
+					key_slot->pdata;
+			return key_idx - 1;
+		}
+		hitmask &= ~(3ULL << (hit_index << 1));
+	}
+
+	return -1;
+}
+
+/*
+ * Software pipelined lookup of any number of keys. At iteration i,
+ * key i is prefetched, key i - depth is hashed and its buckets are
+ * prefetched, the signatures of key i - 2 * depth are compared and
+ * its first matching key slot is prefetched, and key i - 3 * depth
+ * is compared.
+ */
+static __rte_always_inline int
+__rte_hash_lookup_bulk_stream(const struct rte_hash *h, const void **keys,
+		const hash_sig_t *sig, uint32_t num_keys, uint32_t depth,
+		int32_t *positions, void *data[], const int lf)
+{
+	struct rte_hash_stream_key ring[RTE_HASH_STREAM_RING_SIZE];
+	struct rte_hash_stream_key *sk;
+	const struct rte_hash_bucket *buckets, *tbl;
+	const struct rte_hash_bucket *bkt;
+	uint32_t mask, prim_index, sec_index, key_idx, hitmask;
+	uint32_t cnt_b = 0;
+	uint32_t i, j;
+	hash_sig_t hash;
+	int32_t ret;
+	int hits = 0;
+	int retry;
+
+	if (lf)
+		/* Load the table change counter before the lookup
+		 * starts. Acquire semantics will make sure that
+		 * loads in compare_signatures are not hoisted.
+		 */
+		cnt_b = __atomic_load_n(h->tbl_chng_cnt, __ATOMIC_ACQUIRE);
+	else
+		__hash_rw_reader_lock(h);
+
+	buckets = __bulk_lookup_buckets(h, &mask, &tbl);
+
+	for (i = 0; i < num_keys + 3 * depth; i++) {
+		/* Prefetch the key */
+		if (i < num_keys)
+			rte_prefetch0(keys[i]);
+
+		/* Hash the key and prefetch its buckets */
+		j = i - depth;
+		if (i >= depth && j < num_keys) {
+			hash = sig != NULL ? sig[j] : rte_hash_hash(h, keys[j]);
+			sk = &ring[j & (RTE_HASH_STREAM_RING_SIZE - 1)];
+			sk->sig = get_short_sig(hash);
+			prim_index = hash & mask;
+			sec_index = (prim_index ^ sk->sig) & mask;
+			sk->prim_bkt = &buckets[prim_index];
+			sk->sec_bkt = &buckets[sec_index];
+			rte_prefetch0(sk->prim_bkt);
+			rte_prefetch0(sk->sec_bkt);
+		}
+
+		/* Compare signatures and prefetch key slot of first hit */
+		j = i - 2 * depth;
+		if (i >= 2 * depth && j < num_keys) {
+			sk = &ring[j & (RTE_HASH_STREAM_RING_SIZE - 1)];
+			sk->prim_hitmask = 0;
+			sk->sec_hitmask = 0;
+			compare_signatures(&sk->prim_hitmask, &sk->sec_hitmask,
+				sk->prim_bkt, sk->sec_bkt, sk->sig,
+				h->sig_cmp_fn);
+
+			if (sk->prim_hitmask) {
+				bkt = sk->prim_bkt;
+				hitmask = sk->prim_hitmask;
+			} else {
+				bkt = sk->sec_bkt;
+				hitmask = sk->sec_hitmask;
+			}
+			if (hitmask) {
+				key_idx = bkt->key_idx[
+					__builtin_ctzl(hitmask) >> 1];
+				rte_prefetch0((const char *)h->key_store +
+					key_idx * h->key_entry_size);
+			}
+		}
+
+		/* Compare keys, first hits in primary first */
+		j = i - 3 * depth;
+		if (i >= 3 * depth) {
+			sk = &ring[j & (RTE_HASH_STREAM_RING_SIZE - 1)];
+			ret = __stream_compare_keys(h, keys[j], sk->prim_bkt,
+				sk->prim_hitmask,
+				data != NULL ? &data[j] : NULL, lf);
+			if (ret == -1)
+				ret = __stream_compare_keys(h, keys[j],
+					sk->sec_bkt, sk->sec_hitmask,
+					data != NULL ? &data[j] : NULL, lf);
+			if (ret != -1) {
+				positions[j] = ret;
+				hits++;
+			} else
+				positions[j] = -ENOENT;
+		}
+	}
+
+	if (!lf)
+		__hash_rw_reader_unlock(h);
+
+	if (hits == (int)num_keys)
+		return hits;
+
+	/* The missed keys might be in extendable buckets, in the old
+	 * bucket array of a resize, or might have been moved while
+	 * they were looked up.
+	 */
+	retry = h->ext_table_support || __bulk_lookup_changed(h, tbl);
+	if (lf && !retry) {
+		/* The loads of sig_current in compare_signatures
+		 * should not move below the load from tbl_chng_cnt.
+		 */
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		retry = cnt_b != __atomic_load_n(h->tbl_chng_cnt,
+						__ATOMIC_ACQUIRE);
+	}
+	if (likely(!retry))
+		return hits;
+
+	for (j = 0; j < num_keys; j++) {
+		if (positions[j] >= 0)
+			continue;
+		hash = sig != NULL ? sig[j] : rte_hash_hash(h, keys[j]);
+		ret = __rte_hash_lookup_with_hash(h, keys[j], hash,
+				data != NULL ? &data[j] : NULL);
+		if (ret >= 0) {
+			positions[j] = ret;
+			hits++;
+		}
+	}
+
+	return hits;
+}
+
+int
+rte_hash_lookup_bulk_stream(const struct rte_hash *h, const void **keys,
+		const hash_sig_t *sig, uint32_t num_keys, uint32_t depth,
+		int32_t *positions, void *data[])
+{
+	RETURN_IF_TRUE(((h == NULL) || (keys == NULL) ||
+			(positions == NULL)), -EINVAL);
+
+	/* The pipeline state is kept in a fixed size ring */
+	if (depth > RTE_HASH_LOOKUP_STREAM_DEPTH_MAX)
+		return -EINVAL;
+	if (depth == 0)
+		depth = RTE_HASH_LOOKUP_STREAM_DEPTH_DEFAULT;
+
+	if (h->readwrite_concur_lf_support)
+		return __rte_hash_lookup_bulk_stream(h, keys, sig, num_keys,
+				depth, positions, data, 1);
+	else
+		return __rte_hash_lookup_bulk_stream(h, keys, sig, num_keys,
+				depth, positions, data, 0);
+}
+
 int32_t
 rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32_t *next)
 {
 	uint32_t bucket_idx, idx, position;
 	struct rte_hash_key *next_key;
+	struct rte_hash_bucket *ext_bkts;
 
 	RETURN_IF_TRUE(((h == NULL) || (next == NULL)), -EINVAL);
 
 	const uint32_t total_entries_main = h->num_buckets *
 							RTE_HASH_BUCKET_ENTRIES;
-	const uint32_t total_entries = total_entries_main << 1;
+	/* Past the main table are either the extendable buckets or, while
+	 * a resize is in progress, the old buckets of half the size.
+	 */
+	const uint32_t total_entries = h->ext_table_support ?
+		total_entries_main << 1 :
+		total_entries_main + (total_entries_main >> 1);
 
 	/* Out of bounds of all buckets (both main table and ext table) */
 	if (*next >= total_entries_main)
@@ -2350,14 +3327,15 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 
 /* Begin to iterate extendable buckets */
 extend_table:
-	/* Out of total bound or if ext bucket feature is not enabled */
-	if (*next >= total_entries || !h->ext_table_support)
+	ext_bkts = h->ext_table_support ? h->buckets_ext : h->old_buckets;
+	/* Out of total bound or if there are no buckets to iterate */
+	if (*next >= total_entries || ext_bkts == NULL)
 		return -ENOENT;
 
 	bucket_idx = (*next - total_entries_main) / RTE_HASH_BUCKET_ENTRIES;
 	idx = (*next - total_entries_main) % RTE_HASH_BUCKET_ENTRIES;
 
-	while ((position = h->buckets_ext[bucket_idx].key_idx[idx]) == EMPTY_SLOT) {
+	while ((position = ext_bkts[bucket_idx].key_idx[idx]) == EMPTY_SLOT) {
 		(*next)++;
 		if (*next == total_entries)
 			return -ENOENT;
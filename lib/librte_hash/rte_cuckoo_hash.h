@@ -122,6 +122,9 @@ const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
 
 #define RTE_HASH_TSX_MAX_RETRY  10
 
+/** Number of buckets migrated by each add/delete during a resize. */
+#define RTE_HASH_RESIZE_BATCH		4
+
 struct lcore_cache {
 	unsigned len; /**< Cache len */
 	uint32_t objs[LCORE_CACHE_SIZE]; /**< Cache objects */
@@ -219,9 +222,47 @@ struct rte_hash {
 	 */
 	uint32_t *ext_bkt_to_free;
 	uint32_t *tbl_chng_cnt;
-	/**< Indicates if the hash table changed from last read. */
+	/**< Indicates if the hash table changed from last read. The writers
+	 * add 2 on each change, it is odd only while a resize publishes its
+	 * bucket arrays.
+	 */
+	struct rte_hash_rcu_config *hash_rcu_cfg;
+	/**< HASH RCU QSBR configuration structure */
+	struct rte_rcu_qsbr_dq *dq;	/**< RCU QSBR defer queue. */
+	uint8_t dq_auto_size;
+	/**< The defer queue is sized from the entries and grows with them. */
+	int socket_id;			/**< Socket the table is allocated on. */
+	uint32_t *key_sigs;
+	/**< Full hash signature of each key store slot, used to place the
+	 * keys in the new bucket array on resize.
+	 */
+	struct rte_hash_bucket *old_buckets;
+	/**< Bucket array being migrated by an ongoing resize. It has half
+	 * as many buckets as the current array.
+	 */
+	uint32_t old_bucket_bitmask;	/**< Bucket mask of old_buckets. */
+	uint32_t resize_next;		/**< Next old bucket to migrate. */
+	uint32_t resize_gen;		/**< Number of resizes started. */
+	struct __rte_hash_retired *retired;
+	/**< Memory replaced by a resize that lock free readers may still
+	 * be accessing.
+	 */
 } __rte_cache_aligned;
 
+/* Memory retired by a resize, freed once the readers stopped using it. */
+struct __rte_hash_retired {
+	struct __rte_hash_retired *next;
+	void *ptr;			/**< Memory to free. */
+	struct rte_rcu_qsbr *v;		/**< QSBR variable, NULL if none. */
+	uint64_t token;			/**< QSBR token taken on retirement. */
+};
+
+/* Entry queued into the RCU defer queue on key deletion. */
+struct __rte_hash_rcu_dq_entry {
+	uint32_t key_idx;	/**< Key index to free. */
+	uint32_t ext_bkt_idx;	/**< Extendable bucket index to free. */
+};
+
 struct queue_node {
 	struct rte_hash_bucket *bkt; /* Current bucket on the bfs search */
 	uint32_t cur_bkt_idx;
@@ -230,4 +271,21 @@ struct queue_node {
 	int prev_slot;               /* Parent(slot) in search path */
 };
 
+/* Number of keys in flight in the bulk stream lookup pipeline */
+#define RTE_HASH_STREAM_RING_SIZE	64
+
+#if RTE_HASH_STREAM_RING_SIZE <= 2 * RTE_HASH_LOOKUP_STREAM_DEPTH_MAX || \
+	!RTE_IS_POWER_OF_2(RTE_HASH_STREAM_RING_SIZE)
+#error RTE_HASH_STREAM_RING_SIZE too small or not a power of 2
+#endif
+
+/* State of a key in the bulk stream lookup pipeline */
+struct rte_hash_stream_key {
+	const struct rte_hash_bucket *prim_bkt;
+	const struct rte_hash_bucket *sec_bkt;
+	uint32_t prim_hitmask;
+	uint32_t sec_hitmask;
+	uint16_t sig;
+};
+
 #endif
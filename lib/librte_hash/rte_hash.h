@@ -15,6 +15,7 @@
 #include <stddef.h>
 
 #include <rte_compat.h>
+#include <rte_rcu_qsbr.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -30,6 +31,11 @@ extern "C" {
 #define RTE_HASH_LOOKUP_BULK_MAX		64
 #define RTE_HASH_LOOKUP_MULTI_MAX		RTE_HASH_LOOKUP_BULK_MAX
 
+/** Maximum pipeline depth of rte_hash_lookup_bulk_stream. */
+#define RTE_HASH_LOOKUP_STREAM_DEPTH_MAX	16
+/** Pipeline depth of rte_hash_lookup_bulk_stream when 0 is given. */
+#define RTE_HASH_LOOKUP_STREAM_DEPTH_DEFAULT	4
+
 /** Enable Hardware transactional memory support. */
 #define RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT	0x01
 
@@ -54,6 +60,9 @@ extern "C" {
  */
 #define RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF 0x20
 
+/** @internal Default RCU defer queue entries to reclaim in one go. */
+#define RTE_HASH_RCU_DQ_RECLAIM_MAX	16
+
 /**
  * The type of hash value of a key.
  * It should be a value of at least 32bit with fully random pattern.
@@ -67,6 +76,17 @@ typedef uint32_t (*rte_hash_function)(const void *key, uint32_t key_len,
 /** Type of function used to compare the hash key. */
 typedef int (*rte_hash_cmp_eq_t)(const void *key1, const void *key2, size_t key_len);
 
+/**
+ * Type of function used to free the data associated with a deleted key.
+ * Called by the library once no reader references the key any more.
+ *
+ * @param p
+ *   Pointer provided in the RCU configuration (key_data_ptr).
+ * @param key_data
+ *   Data that was stored with the deleted key.
+ */
+typedef void (*rte_hash_free_key_data)(void *p, void *key_data);
+
 /**
  * Parameters used when creating the hash table.
  */
@@ -81,6 +101,39 @@ struct rte_hash_parameters {
 	uint8_t extra_flag;		/**< Indicate if additional parameters are present. */
 };
 
+/** RCU reclamation modes */
+enum rte_hash_qsbr_mode {
+	/** Create defer queue for reclaim. */
+	RTE_HASH_QSBR_MODE_DQ = 0,
+	/** Use blocking mode reclaim. No defer queue created. */
+	RTE_HASH_QSBR_MODE_SYNC
+};
+
+/** HASH RCU QSBR configuration structure. */
+struct rte_hash_rcu_config {
+	struct rte_rcu_qsbr *v;		/**< RCU QSBR variable. */
+	enum rte_hash_qsbr_mode mode;
+	/**< Mode of RCU QSBR. RTE_HASH_QSBR_MODE_xxx
+	 * '0' for default: create defer queue for reclaim.
+	 */
+	uint32_t dq_size;
+	/**< RCU defer queue size.
+	 * default: total hash table entries.
+	 */
+	uint32_t trigger_reclaim_limit;	/**< Threshold to trigger auto reclaim. */
+	uint32_t max_reclaim_size;
+	/**< Max entries to reclaim in one go.
+	 * default: RTE_HASH_RCU_DQ_RECLAIM_MAX.
+	 */
+	void *key_data_ptr;
+	/**< Pointer passed to the free function. Typically, this is the
+	 * pointer to the data structure to which the resource to free
+	 * (key-data) belongs. This can be NULL.
+	 */
+	rte_hash_free_key_data free_key_data_func;
+	/**< Function to call to free the resource (key-data). */
+};
+
 /** @internal A hash table structure. */
 struct rte_hash;
 
@@ -294,6 +347,10 @@ rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key, hash_sig_t
  * rte_hash_free_key_with_position API should be called after all
  * the readers have stopped referencing the entry corresponding to
  * this key. RCU mechanisms could be used to determine such a state.
+ * If an RCU QSBR variable is attached with rte_hash_rcu_qsbr_add(),
+ * the key index (and the extendable bucket, if any) is freed by the
+ * library once the readers report quiescent state, and
+ * rte_hash_free_key_with_position must not be called.
  *
  * @param h
  *   Hash table to remove the key from.
@@ -323,6 +380,10 @@ rte_hash_del_key(const struct rte_hash *h, const void *key);
  * rte_hash_free_key_with_position API should be called after all
  * the readers have stopped referencing the entry corresponding to
  * this key. RCU mechanisms could be used to determine such a state.
+ * If an RCU QSBR variable is attached with rte_hash_rcu_qsbr_add(),
+ * the key index (and the extendable bucket, if any) is freed by the
+ * library once the readers report quiescent state, and
+ * rte_hash_free_key_with_position must not be called.
  *
  * @param h
  *   Hash table to remove the key from.
@@ -579,6 +640,55 @@ rte_hash_lookup_with_hash_bulk_data(const struct rte_hash *h,
 		const void **keys, hash_sig_t *sig,
 		uint32_t num_keys, uint64_t *hit_mask, void *data[]);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Find any number of keys in the hash table.
+ * Unlike rte_hash_lookup_bulk(), the number of keys is not limited to
+ * RTE_HASH_LOOKUP_BULK_MAX. The keys go through a software pipeline which
+ * hashes them, prefetches their buckets, compares the signatures and
+ * prefetches the matching key slots, then compares the keys. Each stage
+ * runs depth keys ahead of the next one, so there is no prefetch bubble
+ * between groups of keys.
+ * This operation is multi-thread safe with regarding to other lookup threads.
+ * Read-write concurrency can be enabled by setting flag during
+ * table creation.
+ *
+ * @param h
+ *   Hash table to look in.
+ * @param keys
+ *   A pointer to a list of keys to look for.
+ * @param sig
+ *   A pointer to a list of precomputed hash values for keys, or NULL to
+ *   compute them with the hash function of the table. The values must be
+ *   the ones the hash function of the table returns for the keys, e.g. the
+ *   RSS hash reported by the NIC can be used if the table was created with
+ *   the same Toeplitz hash function and key.
+ * @param num_keys
+ *   How many keys are in the keys list.
+ * @param depth
+ *   Number of keys each pipeline stage runs ahead of the next one, up to
+ *   RTE_HASH_LOOKUP_STREAM_DEPTH_MAX. 0 selects
+ *   RTE_HASH_LOOKUP_STREAM_DEPTH_DEFAULT.
+ * @param positions
+ *   Output containing a list of values, corresponding to the list of keys that
+ *   can be used by the caller as an offset into an array of user data. These
+ *   values are unique for each key, and are the same values that were returned
+ *   when each key was added. If a key in the list was not found, then -ENOENT
+ *   will be the value.
+ * @param data
+ *   Output containing the data of the keys found, or NULL if not needed.
+ *   The entries of the keys not found are left untouched.
+ * @return
+ *   -EINVAL if there's an error, otherwise number of successful lookups.
+ */
+__rte_experimental
+int
+rte_hash_lookup_bulk_stream(const struct rte_hash *h, const void **keys,
+		const hash_sig_t *sig, uint32_t num_keys, uint32_t depth,
+		int32_t *positions, void *data[]);
+
 /**
  * Find multiple keys in the hash table.
  * This operation is multi-thread safe with regarding to other lookup threads.
@@ -625,6 +735,97 @@ rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
  */
 int32_t
 rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32_t *next);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Associate RCU QSBR variable with a Hash object.
+ * This API should be called to enable the integrated RCU QSBR support and
+ * should be called immediately after creating the Hash object.
+ * Once attached, deleted key indexes and empty extendable buckets are
+ * queued and reclaimed by the library after all the readers registered
+ * with the QSBR variable have reported quiescent state. In
+ * RTE_HASH_QSBR_MODE_DQ mode, additions that run out of free entries
+ * try to reclaim deferred entries before failing.
+ *
+ * @param h
+ *   the hash object to add RCU QSBR
+ * @param cfg
+ *   RCU QSBR configuration
+ * @return
+ *   On success - 0
+ *   On error - 1 with error code set in rte_errno.
+ *   Possible rte_errno codes are:
+ *   - EINVAL - invalid pointer
+ *   - EEXIST - already added QSBR
+ *   - ENOMEM - memory allocation failure
+ */
+__rte_experimental
+int rte_hash_rcu_qsbr_add(struct rte_hash *h, struct rte_hash_rcu_config *cfg);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Start growing a hash table to twice its number of entries.
+ *
+ * A bucket array twice as large is allocated and the key store is grown,
+ * then the keys are migrated from the old bucket array in bounded batches,
+ * either by rte_hash_resize_step() or by the add and delete APIs, which
+ * migrate a few buckets on each call. Lookups search both bucket arrays
+ * until the migration completes, so readers are never stopped.
+ *
+ * The table must not be created with RTE_HASH_EXTRA_FLAGS_EXT_TABLE or
+ * RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD. This is a writer API, it is not
+ * multi-thread safe with other writer APIs.
+ * When RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF is enabled, the memory
+ * replaced by the resize is freed once the readers report quiescent state
+ * on the QSBR variable attached with rte_hash_rcu_qsbr_add(). If no QSBR
+ * variable is attached, it is only freed with the table, so the memory
+ * used by the table grows with each resize: attach a QSBR variable to
+ * resize a lock free table more than a few times.
+ * A QSBR defer queue attached with a dq_size of 0 is replaced by one
+ * sized for the new number of entries. The entries of the old queue are
+ * reclaimed first, waiting for the readers to report quiescent state if
+ * some of them are still in use.
+ *
+ * @param h
+ *   Hash table to resize.
+ * @return
+ *   - 0 if the resize is started.
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOTSUP if the table was created with flags not supporting resize.
+ *   - -EBUSY if a resize is already in progress.
+ *   - -ENOSPC if the table can not grow beyond RTE_HASH_ENTRIES_MAX.
+ *   - -ENOMEM if memory allocation failed.
+ */
+__rte_experimental
+int
+rte_hash_resize(struct rte_hash *h);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Migrate buckets of an ongoing resize started by rte_hash_resize().
+ * This is a writer API, it is not multi-thread safe with other
+ * writer APIs.
+ *
+ * @param h
+ *   Hash table being resized.
+ * @param num_buckets
+ *   Maximum number of old buckets to migrate.
+ * @return
+ *   - 0 if no resize is in progress, i.e. the migration is complete.
+ *   - A positive value, the number of old buckets still to migrate.
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOSPC if a key could not be placed in the new bucket array.
+ *     The migration can be resumed after some keys are deleted.
+ */
+__rte_experimental
+int
+rte_hash_resize_step(struct rte_hash *h, uint32_t num_buckets);
 #ifdef __cplusplus
 }
 #endif
@@ -2,19 +2,24 @@
  * Copyright(c) 2018 Intel Corporation
  */
 
+#include <ctype.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <stdbool.h>
 #include <math.h>
 
 #include <rte_string_fns.h>
+#include <rte_malloc.h>
 #include <rte_mbuf.h>
+#include <rte_mbuf_dyn.h>
 #include <rte_log.h>
 #include <rte_cycles.h>
 #include <rte_ethdev.h>
 #include <rte_metrics.h>
 #include <rte_memzone.h>
 #include <rte_lcore.h>
+#include <rte_telemetry.h>
 
 #include "rte_latencystats.h"
 
@@ -32,7 +37,9 @@ latencystat_cycles_per_ns(void)
 #define RTE_LOGTYPE_LATENCY_STATS RTE_LOGTYPE_USER1
 
 static const char *MZ_RTE_LATENCY_STATS = "rte_latencystats";
+static const char *MZ_RTE_LATENCY_HIST = "rte_latencystats_hist";
 static int latency_stats_index;
+static int latency_hist_index;
 static uint64_t samp_intvl;
 static uint64_t timer_tsc;
 static uint64_t prev_tsc;
@@ -47,6 +54,245 @@ struct rte_latency_stats {
 
 static struct rte_latency_stats *glob_stats;
 
+/* Rx timestamp of the packets sampled, in TSC cycles */
+static int timestamp_dynfield_offset = -1;
+static uint64_t timestamp_dynflag;
+
+static inline uint64_t *
+timestamp_dynfield(struct rte_mbuf *mbuf)
+{
+	return RTE_MBUF_DYNFIELD(mbuf, timestamp_dynfield_offset, uint64_t *);
+}
+
+/** Latency histograms of the Tx queues, in TSC cycles */
+struct latency_hist {
+	uint64_t timer_hz; /**< Frequency of the latencies recorded */
+	uint32_t nb_buckets; /**< Number of buckets of a histogram */
+	uint32_t stride; /**< Distance between two histograms in buckets */
+	uint8_t precision; /**< Number of sub-bucket bits */
+	uint16_t nb_queues[RTE_MAX_ETHPORTS]; /**< Tx queues of each port */
+	uint32_t first[RTE_MAX_ETHPORTS]; /**< First histogram of each port */
+	/** Buckets of all histograms, each updated by one lcore only */
+	uint64_t buckets[] __rte_cache_aligned;
+};
+
+static struct rte_latencystats_hist_conf hist_conf;
+static bool hist_enabled;
+static struct latency_hist *glob_hist;
+
+static const struct {
+	const char *name;
+	double percentile;
+} lat_hist_strings[] = {
+	{"p50_latency_ns", 50},
+	{"p90_latency_ns", 90},
+	{"p99_latency_ns", 99},
+	{"p999_latency_ns", 99.9},
+};
+
+#define NUM_LATENCY_HIST_STATS RTE_DIM(lat_hist_strings)
+
+/*
+ * Log-linear bucket of a latency: the values below 2^precision have their
+ * own bucket, and each following power of 2 range is divided in
+ * 2^precision buckets.
+ */
+static inline uint32_t
+latency_hist_bucket(const struct latency_hist *h, uint64_t latency)
+{
+	unsigned int shift;
+	uint64_t bucket;
+
+	if (latency < (1ULL << h->precision)) {
+		bucket = latency;
+	} else {
+		shift = rte_fls_u64(latency) - 1 - h->precision;
+		bucket = ((uint64_t)(shift + 1) << h->precision) +
+			(latency >> shift) - (1ULL << h->precision);
+	}
+	return RTE_MIN(bucket, (uint64_t)h->nb_buckets - 1);
+}
+
+/* highest latency of a bucket */
+static uint64_t
+latency_hist_bucket_max(const struct latency_hist *h, uint32_t bucket)
+{
+	uint64_t sub_mask = (1ULL << h->precision) - 1;
+	unsigned int shift;
+
+	if (bucket <= sub_mask)
+		return bucket;
+
+	shift = (bucket >> h->precision) - 1;
+	return ((((bucket & sub_mask) + sub_mask + 1) << shift) |
+		((1ULL << shift) - 1));
+}
+
+static struct latency_hist *
+latency_hist_get(void)
+{
+	const struct rte_memzone *mz;
+
+	if (glob_hist == NULL && rte_eal_process_type() == RTE_PROC_SECONDARY) {
+		mz = rte_memzone_lookup(MZ_RTE_LATENCY_HIST);
+		if (mz != NULL)
+			glob_hist = mz->addr;
+	}
+	return glob_hist;
+}
+
+static int
+latency_hist_create(void)
+{
+	uint16_t nb_queues[RTE_MAX_ETHPORTS] = { 0 };
+	const struct rte_memzone *mz;
+	struct rte_eth_dev_info dev_info;
+	struct latency_hist tmpl;
+	uint64_t max_latency;
+	uint32_t nb_hists = 0;
+	uint16_t pid;
+
+	RTE_ETH_FOREACH_DEV(pid) {
+		if (rte_eth_dev_info_get(pid, &dev_info) != 0)
+			continue;
+		nb_queues[pid] = dev_info.nb_tx_queues;
+		nb_hists += dev_info.nb_tx_queues;
+	}
+
+	/* the bucket count is the bucket of the highest latency, plus one */
+	memset(&tmpl, 0, sizeof(tmpl));
+	tmpl.precision = hist_conf.precision;
+	tmpl.nb_buckets = UINT32_MAX;
+	max_latency = (double)hist_conf.max_latency_ns * rte_get_timer_hz() /
+		NS_PER_SEC;
+	tmpl.nb_buckets = latency_hist_bucket(&tmpl, max_latency) + 1;
+	tmpl.stride = RTE_ALIGN_CEIL(tmpl.nb_buckets,
+		RTE_CACHE_LINE_SIZE / sizeof(uint64_t));
+
+	mz = rte_memzone_reserve(MZ_RTE_LATENCY_HIST, sizeof(tmpl) +
+			sizeof(uint64_t) * tmpl.stride * nb_hists,
+			rte_socket_id(), 0);
+	if (mz == NULL) {
+		RTE_LOG(ERR, LATENCY_STATS, "Cannot reserve memory: %s:%d\n",
+			__func__, __LINE__);
+		return -ENOMEM;
+	}
+
+	glob_hist = mz->addr;
+	memset(glob_hist, 0, mz->len);
+	glob_hist->timer_hz = rte_get_timer_hz();
+	glob_hist->nb_buckets = tmpl.nb_buckets;
+	glob_hist->stride = tmpl.stride;
+	glob_hist->precision = tmpl.precision;
+	nb_hists = 0;
+	for (pid = 0; pid < RTE_MAX_ETHPORTS; pid++) {
+		glob_hist->nb_queues[pid] = nb_queues[pid];
+		glob_hist->first[pid] = nb_hists;
+		nb_hists += nb_queues[pid];
+	}
+	return 0;
+}
+
+static void
+latency_hist_free(void)
+{
+	const struct rte_memzone *mz;
+
+	mz = rte_memzone_lookup(MZ_RTE_LATENCY_HIST);
+	if (mz)
+		rte_memzone_free(mz);
+	glob_hist = NULL;
+}
+
+/* add up the histograms of a port and queue, or of all of them */
+static int
+latency_hist_sum(const struct latency_hist *h, uint16_t port_id,
+		uint16_t queue_id, uint64_t *sum)
+{
+	uint16_t pid, qid, first_pid, last_pid, first_qid, last_qid;
+	const uint64_t *buckets;
+	uint32_t i;
+
+	if (port_id == RTE_LATENCYSTATS_ALL) {
+		if (queue_id != RTE_LATENCYSTATS_ALL)
+			return -EINVAL;
+		first_pid = 0;
+		last_pid = RTE_MAX_ETHPORTS - 1;
+	} else {
+		if (port_id >= RTE_MAX_ETHPORTS || (queue_id !=
+				RTE_LATENCYSTATS_ALL &&
+				queue_id >= h->nb_queues[port_id]))
+			return -EINVAL;
+		first_pid = last_pid = port_id;
+	}
+
+	memset(sum, 0, sizeof(*sum) * h->nb_buckets);
+	for (pid = first_pid; pid <= last_pid; pid++) {
+		if (queue_id == RTE_LATENCYSTATS_ALL) {
+			first_qid = 0;
+			last_qid = h->nb_queues[pid];
+		} else {
+			first_qid = queue_id;
+			last_qid = queue_id + 1;
+		}
+		for (qid = first_qid; qid < last_qid; qid++) {
+			buckets = &h->buckets[(uint64_t)(h->first[pid] + qid) *
+				h->stride];
+			for (i = 0; i < h->nb_buckets; i++)
+				sum[i] += __atomic_load_n(&buckets[i],
+					__ATOMIC_RELAXED);
+		}
+	}
+	return 0;
+}
+
+/* latency under which a percentage of the packets fall, in ns */
+static uint64_t
+latency_hist_percentile(const struct latency_hist *h, const uint64_t *sum,
+		uint64_t count, double percentile)
+{
+	uint64_t rank, seen = 0;
+	uint32_t i;
+
+	if (count == 0)
+		return 0;
+
+	rank = RTE_MAX((uint64_t)ceil(count * percentile / 100), 1ULL);
+	for (i = 0; i < h->nb_buckets - 1; i++) {
+		seen += sum[i];
+		if (seen >= rank)
+			break;
+	}
+	return (uint64_t)ceil((double)latency_hist_bucket_max(h, i) *
+		NS_PER_SEC / h->timer_hz);
+}
+
+/* fill the percentiles of a port, or of all ports */
+static int
+latency_hist_fill_values(const struct latency_hist *h, uint16_t port_id,
+		uint64_t *count, uint64_t values[NUM_LATENCY_HIST_STATS])
+{
+	uint64_t *sum;
+	unsigned int i;
+	int ret;
+
+	sum = malloc(sizeof(*sum) * h->nb_buckets);
+	if (sum == NULL)
+		return -ENOMEM;
+
+	ret = latency_hist_sum(h, port_id, RTE_LATENCYSTATS_ALL, sum);
+	if (ret == 0) {
+		*count = 0;
+		for (i = 0; i < h->nb_buckets; i++)
+			*count += sum[i];
+		for (i = 0; i < NUM_LATENCY_HIST_STATS; i++)
+			values[i] = latency_hist_percentile(h, sum, *count,
+				lat_hist_strings[i].percentile);
+	}
+	free(sum);
+	return ret;
+}
+
 struct rxtx_cbs {
 	const struct rte_eth_rxtx_callback *cb;
 };
@@ -69,6 +315,41 @@ static const struct latency_stats_nameoff lat_stats_strings[] = {
 #define NUM_LATENCY_STATS (sizeof(lat_stats_strings) / \
 				sizeof(lat_stats_strings[0]))
 
+/* push the percentiles of each port and of all ports */
+static int
+latency_hist_update(void)
+{
+	uint64_t values[NUM_LATENCY_HIST_STATS];
+	uint64_t count;
+	uint16_t pid;
+	int ret;
+
+	for (pid = 0; pid < RTE_MAX_ETHPORTS; pid++) {
+		if (glob_hist->nb_queues[pid] == 0)
+			continue;
+		ret = latency_hist_fill_values(glob_hist, pid, &count, values);
+		if (ret == 0)
+			ret = rte_metrics_update_values(pid,
+				latency_hist_index, values,
+				NUM_LATENCY_HIST_STATS);
+		if (ret < 0)
+			goto fail;
+	}
+
+	ret = latency_hist_fill_values(glob_hist, RTE_LATENCYSTATS_ALL, &count,
+		values);
+	if (ret == 0)
+		ret = rte_metrics_update_values(RTE_METRICS_GLOBAL,
+			latency_hist_index, values, NUM_LATENCY_HIST_STATS);
+	if (ret < 0)
+		goto fail;
+	return 0;
+
+fail:
+	RTE_LOG(INFO, LATENCY_STATS, "Failed to push the percentiles\n");
+	return ret;
+}
+
 int32_t
 rte_latencystats_update(void)
 {
@@ -90,6 +371,9 @@ rte_latencystats_update(void)
 	if (ret < 0)
 		RTE_LOG(INFO, LATENCY_STATS, "Failed to push the stats\n");
 
+	if (ret >= 0 && glob_hist != NULL)
+		ret = latency_hist_update();
+
 	return ret;
 }
 
@@ -128,10 +412,9 @@ add_time_stamps(uint16_t pid __rte_unused,
 		diff_tsc = now - prev_tsc;
 		timer_tsc += diff_tsc;
 
-		if ((pkts[i]->ol_flags & PKT_RX_TIMESTAMP) == 0
-				&& (timer_tsc >= samp_intvl)) {
-			pkts[i]->timestamp = now;
-			pkts[i]->ol_flags |= PKT_RX_TIMESTAMP;
+		if (timer_tsc >= samp_intvl) {
+			*timestamp_dynfield(pkts[i]) = now;
+			pkts[i]->ol_flags |= timestamp_dynflag;
 			timer_tsc = 0;
 		}
 		prev_tsc = now;
@@ -142,14 +425,16 @@ add_time_stamps(uint16_t pid __rte_unused,
 }
 
 static uint16_t
-calc_latency(uint16_t pid __rte_unused,
-		uint16_t qid __rte_unused,
+calc_latency(uint16_t pid,
+		uint16_t qid,
 		struct rte_mbuf **pkts,
 		uint16_t nb_pkts,
 		void *_ __rte_unused)
 {
+	struct latency_hist *h = glob_hist;
+	uint64_t *buckets = NULL;
 	unsigned int i, cnt = 0;
-	uint64_t now;
+	uint64_t now, diff;
 	float latency[nb_pkts];
 	static float prev_latency;
 	/*
@@ -159,10 +444,22 @@ calc_latency(uint16_t pid __rte_unused,
 	 */
 	const float alpha = 0.2;
 
+	/* the histogram of a Tx queue is only updated by its lcore */
+	if (h != NULL && qid < h->nb_queues[pid])
+		buckets = &h->buckets[(uint64_t)(h->first[pid] + qid) *
+			h->stride];
+
 	now = rte_rdtsc();
 	for (i = 0; i < nb_pkts; i++) {
-		if (pkts[i]->ol_flags & PKT_RX_TIMESTAMP)
-			latency[cnt++] = now - pkts[i]->timestamp;
+		if ((pkts[i]->ol_flags & timestamp_dynflag) == 0)
+			continue;
+		diff = now - *timestamp_dynfield(pkts[i]);
+		latency[cnt++] = diff;
+		if (buckets != NULL) {
+			uint64_t *b = &buckets[latency_hist_bucket(h, diff)];
+
+			__atomic_store_n(b, *b + 1, __ATOMIC_RELAXED);
+		}
 	}
 
 	rte_spinlock_lock(&glob_stats->lock);
@@ -209,19 +506,46 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 	uint16_t qid;
 	struct rxtx_cbs *cbs = NULL;
 	const char *ptr_strings[NUM_LATENCY_STATS] = {0};
+	const char *hist_strings[NUM_LATENCY_HIST_STATS];
 	const struct rte_memzone *mz = NULL;
 	const unsigned int flags = 0;
+	static const struct rte_mbuf_dynfield timestamp_dynfield_desc = {
+		.name = "rte_latencystats_dynfield_timestamp",
+		.size = sizeof(uint64_t),
+		.align = __alignof__(uint64_t),
+	};
+	static const struct rte_mbuf_dynflag timestamp_dynflag_desc = {
+		.name = "rte_latencystats_dynflag_timestamp",
+	};
 	int ret;
 
 	if (rte_memzone_lookup(MZ_RTE_LATENCY_STATS))
 		return -EEXIST;
 
+	/** Register the Rx timestamp in the mbufs */
+	timestamp_dynfield_offset =
+		rte_mbuf_dynfield_register(&timestamp_dynfield_desc);
+	ret = rte_mbuf_dynflag_register(&timestamp_dynflag_desc);
+	if (timestamp_dynfield_offset < 0 || ret < 0) {
+		RTE_LOG(ERR, LATENCY_STATS,
+			"Cannot register mbuf field/flag for timestamp\n");
+		return -rte_errno;
+	}
+	timestamp_dynflag = 1ULL << ret;
+
+	if (hist_enabled) {
+		ret = latency_hist_create();
+		if (ret < 0)
+			return ret;
+	}
+
 	/** Allocate stats in shared memory fo multi process support */
 	mz = rte_memzone_reserve(MZ_RTE_LATENCY_STATS, sizeof(*glob_stats),
 					rte_socket_id(), flags);
 	if (mz == NULL) {
 		RTE_LOG(ERR, LATENCY_STATS, "Cannot reserve memory: %s:%d\n",
 			__func__, __LINE__);
+		latency_hist_free();
 		return -ENOMEM;
 	}
 
@@ -238,9 +562,23 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 	if (latency_stats_index < 0) {
 		RTE_LOG(DEBUG, LATENCY_STATS,
 			"Failed to register latency stats names\n");
+		latency_hist_free();
 		return -1;
 	}
 
+	if (glob_hist != NULL) {
+		for (i = 0; i < NUM_LATENCY_HIST_STATS; i++)
+			hist_strings[i] = lat_hist_strings[i].name;
+		latency_hist_index = rte_metrics_reg_names(hist_strings,
+			NUM_LATENCY_HIST_STATS);
+		if (latency_hist_index < 0) {
+			RTE_LOG(DEBUG, LATENCY_STATS,
+				"Failed to register latency percentiles names\n");
+			latency_hist_free();
+			return -1;
+		}
+	}
+
 	/** Register Rx/Tx callbacks */
 	RTE_ETH_FOREACH_DEV(pid) {
 		struct rte_eth_dev_info dev_info;
@@ -316,10 +654,12 @@ rte_latencystats_uninit(void)
 		}
 	}
 
-	/* free up the memzone */
+	/* free up the memzones */
 	mz = rte_memzone_lookup(MZ_RTE_LATENCY_STATS);
 	if (mz)
 		rte_memzone_free(mz);
+	latency_hist_free();
+	hist_enabled = false;
 
 	return 0;
 }
@@ -361,3 +701,94 @@ rte_latencystats_get(struct rte_metric_value *values, uint16_t size)
 
 	return NUM_LATENCY_STATS;
 }
+
+int
+rte_latencystats_hist_enable(const struct rte_latencystats_hist_conf *conf)
+{
+	static const struct rte_latencystats_hist_conf default_conf = {
+		.precision = RTE_LATENCYSTATS_HIST_PRECISION_DEFAULT,
+		.max_latency_ns = RTE_LATENCYSTATS_HIST_MAX_NS_DEFAULT,
+	};
+
+	if (conf == NULL)
+		conf = &default_conf;
+	if (conf->precision < 1 || conf->precision > 10 ||
+			conf->max_latency_ns == 0)
+		return -EINVAL;
+	if (rte_memzone_lookup(MZ_RTE_LATENCY_STATS))
+		return -EBUSY;
+
+	hist_conf = *conf;
+	hist_enabled = true;
+	return 0;
+}
+
+int
+rte_latencystats_hist_percentile(uint16_t port_id, uint16_t queue_id,
+		double percentile, uint64_t *latency_ns)
+{
+	const struct latency_hist *h = latency_hist_get();
+	uint64_t *sum, count = 0;
+	uint32_t i;
+	int ret;
+
+	if (latency_ns == NULL || !(percentile > 0 && percentile <= 100))
+		return -EINVAL;
+	if (h == NULL)
+		return -ENOENT;
+
+	sum = malloc(sizeof(*sum) * h->nb_buckets);
+	if (sum == NULL)
+		return -ENOMEM;
+
+	ret = latency_hist_sum(h, port_id, queue_id, sum);
+	if (ret == 0) {
+		for (i = 0; i < h->nb_buckets; i++)
+			count += sum[i];
+		*latency_ns = latency_hist_percentile(h, sum, count,
+			percentile);
+	}
+	free(sum);
+	return ret;
+}
+
+static int
+handle_latency_hist(const char *cmd __rte_unused,
+		const char *params,
+		struct rte_tel_data *d)
+{
+	const struct latency_hist *h = latency_hist_get();
+	uint64_t values[NUM_LATENCY_HIST_STATS];
+	uint16_t port_id = RTE_LATENCYSTATS_ALL;
+	unsigned long pid;
+	char *end_param;
+	uint64_t count;
+	unsigned int i;
+
+	if (h == NULL)
+		return -1;
+	if (params != NULL && strlen(params) != 0) {
+		if (!isdigit(*params))
+			return -1;
+		pid = strtoul(params, &end_param, 0);
+		if (*end_param != '\0' || pid >= RTE_MAX_ETHPORTS)
+			return -1;
+		port_id = pid;
+	}
+
+	if (latency_hist_fill_values(h, port_id, &count, values) != 0)
+		return -1;
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_u64(d, "count", count);
+	for (i = 0; i < NUM_LATENCY_HIST_STATS; i++)
+		rte_tel_data_add_dict_u64(d, lat_hist_strings[i].name,
+			values[i]);
+	return 0;
+}
+
+RTE_INIT(latencystats_init_telemetry)
+{
+	rte_telemetry_register_cmd("/latencystats/hist", handle_latency_hist,
+			"Returns the latency percentiles of a port, or of all ports. Parameters: int port_id (optional)");
+}
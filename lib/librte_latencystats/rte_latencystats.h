@@ -13,6 +13,7 @@
  */
 
 #include <stdint.h>
+#include <rte_compat.h>
 #include <rte_metrics.h>
 #include <rte_mbuf.h>
 
@@ -121,6 +122,76 @@ int rte_latencystats_get_names(struct rte_metric_name *names,
 int rte_latencystats_get(struct rte_metric_value *values,
 			uint16_t size);
 
+/** Default precision of the latency histograms, in bits. */
+#define RTE_LATENCYSTATS_HIST_PRECISION_DEFAULT 5
+
+/** Default highest latency tracked by the latency histograms. */
+#define RTE_LATENCYSTATS_HIST_MAX_NS_DEFAULT 1000000000
+
+/** Port or queue id selecting all the ports or queues. */
+#define RTE_LATENCYSTATS_ALL UINT16_MAX
+
+/**
+ * Configuration of the latency histograms.
+ *
+ * The histograms are log-linear: each power of 2 range of latencies is
+ * divided in 2^precision buckets of equal width, so a latency is known
+ * with a relative error lower than 2^-precision, whatever its magnitude.
+ */
+struct rte_latencystats_hist_conf {
+	/** Number of bits of precision, from 1 to 10. */
+	uint8_t precision;
+	/** Highest latency tracked, higher latencies count as this one. */
+	uint64_t max_latency_ns;
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enable the latency histograms.
+ *
+ * Must be called before rte_latencystats_init(), which creates one
+ * histogram per Tx queue of each port. A histogram is only updated by
+ * the Tx callback of its queue, hence by a single lcore, without lock.
+ *
+ * The percentiles of the latencies of each port and of all the ports are
+ * then pushed to the metrics library by rte_latencystats_update(), and
+ * returned by the /latencystats/hist telemetry command.
+ *
+ * @param conf
+ *   Configuration of the histograms, or NULL to use the default one.
+ * @return
+ *   0 on success, -EINVAL if the configuration is invalid, -EBUSY if the
+ *   latency stats are already initialized.
+ */
+__rte_experimental
+int rte_latencystats_hist_enable(const struct rte_latencystats_hist_conf *conf);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Compute a latency percentile from the histograms.
+ *
+ * @param port_id
+ *   The port id, or RTE_LATENCYSTATS_ALL to aggregate all the ports.
+ * @param queue_id
+ *   The Tx queue id, or RTE_LATENCYSTATS_ALL to aggregate all the queues
+ *   of the port. Must be RTE_LATENCYSTATS_ALL if port_id is.
+ * @param percentile
+ *   The percentile, greater than 0 and up to 100, e.g. 99.9.
+ * @param latency_ns
+ *   The latency under which this percentage of the packets fall, rounded
+ *   up to the upper bound of its bucket. 0 if no latency is recorded.
+ * @return
+ *   0 on success, -EINVAL on invalid parameters, -ENOENT if the
+ *   histograms are not enabled, -ENOMEM on allocation failure.
+ */
+__rte_experimental
+int rte_latencystats_hist_percentile(uint16_t port_id, uint16_t queue_id,
+		double percentile, uint64_t *latency_ns);
+
 #ifdef __cplusplus
 }
 #endif
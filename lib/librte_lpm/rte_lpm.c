@@ -1201,3 +1201,594 @@ rte_lpm_delete_all(struct rte_lpm *lpm)
 	/* Delete all rules form the rules table. */
 	memset(lpm->rules_tbl, 0, sizeof(lpm->rules_tbl[0]) * lpm->max_rules);
 }
+
+/* Number of tbl24 entries computed at once by a bulk update. */
+#define BULK_TBL24_WINDOW	(1 << 16)
+
+/* Number of depths stored in tbl8. */
+#define BULK_TBL8_DEPTHS	(RTE_LPM_MAX_DEPTH - MAX_DEPTH_TBL24)
+
+/* Rule update of a batch. */
+struct lpm_bulk_rule {
+	uint32_t ip;		/* Masked IP of the rule. */
+	uint32_t next_hop;	/* Next hop of the rule. */
+	uint32_t seq;		/* Position of the update in the batch. */
+	uint8_t depth;		/* Depth of the rule. */
+	uint8_t op;		/* RTE_LPM_UPDATE_xxx. */
+	uint8_t changed;	/* Set if the update changes the rules. */
+};
+
+/* Range of tbl24 entries changed by a batch, last is excluded. */
+struct lpm_bulk_range {
+	uint32_t first;
+	uint32_t last;
+};
+
+/* State of a bulk update. */
+struct lpm_bulk_ctx {
+	/* Rules after the batch, sorted by IP in each depth group. */
+	struct rte_lpm_rule *rules;
+	struct rte_lpm_rule_info rule_info[RTE_LPM_MAX_DEPTH];
+	/* Next rule of each depth > 24, while walking a tbl24 range. */
+	uint32_t cursor[BULK_TBL8_DEPTHS];
+	/* Final tbl24 entries of a window, for rules of depth <= 24. */
+	struct rte_lpm_tbl_entry *tbl24;
+	/* Final entries of a tbl8 group. */
+	struct rte_lpm_tbl_entry tbl8[RTE_LPM_TBL8_GROUP_NUM_ENTRIES];
+	/* Position of the next free tbl8 group lookup. */
+	uint32_t tbl8_next;
+	/* Start of the tbl8 groups to free after the batch. */
+	uint32_t *tbl8_freed;
+	uint32_t nb_tbl8_freed;
+};
+
+static int
+bulk_rule_cmp(const void *p1, const void *p2)
+{
+	const struct lpm_bulk_rule *r1 = p1, *r2 = p2;
+
+	if (r1->depth != r2->depth)
+		return r1->depth < r2->depth ? -1 : 1;
+	if (r1->ip != r2->ip)
+		return r1->ip < r2->ip ? -1 : 1;
+	return r1->seq < r2->seq ? -1 : r1->seq > r2->seq;
+}
+
+static int
+rule_cmp(const void *p1, const void *p2)
+{
+	const struct rte_lpm_rule *r1 = p1, *r2 = p2;
+
+	return r1->ip < r2->ip ? -1 : r1->ip > r2->ip;
+}
+
+static int
+bulk_range_cmp(const void *p1, const void *p2)
+{
+	const struct lpm_bulk_range *r1 = p1, *r2 = p2;
+
+	return r1->first < r2->first ? -1 : r1->first > r2->first;
+}
+
+/*
+ * Returns the index of the first rule of [first, last) with an IP not
+ * lower than ip. The rules must be sorted by IP.
+ */
+static uint32_t
+rule_lower_bound(const struct rte_lpm_rule *rules, uint32_t first,
+		uint32_t last, uint32_t ip)
+{
+	uint32_t mid;
+
+	while (first < last) {
+		mid = first + (last - first) / 2;
+		if (rules[mid].ip < ip)
+			first = mid + 1;
+		else
+			last = mid;
+	}
+
+	return first;
+}
+
+/*
+ * Sorts the batch and keeps the last update of each rule.
+ * Returns the number of updates left.
+ */
+static uint32_t
+bulk_rules_sort(struct lpm_bulk_rule *br, uint32_t n)
+{
+	uint32_t i, nb;
+
+	qsort(br, n, sizeof(br[0]), bulk_rule_cmp);
+
+	for (i = 0, nb = 0; i < n; i++) {
+		if (nb > 0 && br[nb - 1].depth == br[i].depth &&
+				br[nb - 1].ip == br[i].ip)
+			nb--;
+		br[nb++] = br[i];
+	}
+
+	return nb;
+}
+
+/*
+ * Merges the sorted batch with the rules table into the rules of the
+ * context. The rules table is only sorted, the batch is committed later
+ * by bulk_rules_commit().
+ */
+static int32_t
+bulk_rules_merge(struct rte_lpm *lpm, struct lpm_bulk_ctx *ctx,
+		struct lpm_bulk_rule *br, uint32_t nb_br)
+{
+	struct rte_lpm_rule *old;
+	uint32_t depth, i, j, nb_old, out = 0, b = 0;
+
+	for (depth = 1; depth <= RTE_LPM_MAX_DEPTH; depth++) {
+		old = &lpm->rules_tbl[lpm->rule_info[depth - 1].first_rule];
+		nb_old = lpm->rule_info[depth - 1].used_rules;
+
+		/* Rules of a group are kept sorted by the bulk updates. */
+		for (i = 1; i < nb_old; i++) {
+			if (old[i - 1].ip > old[i].ip) {
+				qsort(old, nb_old, sizeof(old[0]), rule_cmp);
+				break;
+			}
+		}
+
+		ctx->rule_info[depth - 1].first_rule = out;
+		i = 0;
+		for (; b < nb_br && br[b].depth == depth; b++) {
+			/* Copy the rules before the updated one. */
+			j = rule_lower_bound(old, i, nb_old, br[b].ip);
+			if (out + (j - i) > lpm->max_rules)
+				return -ENOSPC;
+			memcpy(&ctx->rules[out], &old[i],
+				(j - i) * sizeof(old[0]));
+			out += j - i;
+			i = j;
+
+			if (i < nb_old && old[i].ip == br[b].ip) {
+				if (br[b].op == RTE_LPM_UPDATE_DELETE) {
+					br[b].changed = 1;
+					i++;
+					continue;
+				}
+				br[b].changed =
+					old[i].next_hop != br[b].next_hop;
+				i++;
+			} else if (br[b].op == RTE_LPM_UPDATE_DELETE) {
+				continue;
+			} else {
+				br[b].changed = 1;
+			}
+
+			if (out == lpm->max_rules)
+				return -ENOSPC;
+			ctx->rules[out].ip = br[b].ip;
+			ctx->rules[out].next_hop = br[b].next_hop;
+			out++;
+		}
+
+		if (out + (nb_old - i) > lpm->max_rules)
+			return -ENOSPC;
+		memcpy(&ctx->rules[out], &old[i],
+			(nb_old - i) * sizeof(old[0]));
+		out += nb_old - i;
+		ctx->rule_info[depth - 1].used_rules =
+			out - ctx->rule_info[depth - 1].first_rule;
+	}
+
+	return 0;
+}
+
+static void
+bulk_rules_commit(struct rte_lpm *lpm, const struct lpm_bulk_ctx *ctx)
+{
+	const struct rte_lpm_rule_info *last =
+		&ctx->rule_info[RTE_LPM_MAX_DEPTH - 1];
+
+	memcpy(lpm->rules_tbl, ctx->rules,
+		(last->first_rule + last->used_rules) * sizeof(ctx->rules[0]));
+	memcpy(lpm->rule_info, ctx->rule_info, sizeof(lpm->rule_info));
+}
+
+/*
+ * Computes the ranges of tbl24 entries changed by the batch, sorted and
+ * merged. Returns the number of ranges.
+ */
+static uint32_t
+bulk_ranges_build(const struct lpm_bulk_rule *br, uint32_t nb_br,
+		struct lpm_bulk_range *ranges)
+{
+	uint32_t i, nb;
+
+	for (i = 0, nb = 0; i < nb_br; i++) {
+		if (!br[i].changed)
+			continue;
+		ranges[nb].first = br[i].ip >> 8;
+		ranges[nb].last = ranges[nb].first +
+			(br[i].depth <= MAX_DEPTH_TBL24 ?
+				depth_to_range(br[i].depth) : 1);
+		nb++;
+	}
+	if (nb == 0)
+		return 0;
+
+	qsort(ranges, nb, sizeof(ranges[0]), bulk_range_cmp);
+
+	for (i = 1, nb_br = nb, nb = 1; i < nb_br; i++) {
+		if (ranges[i].first <= ranges[nb - 1].last)
+			ranges[nb - 1].last = RTE_MAX(ranges[nb - 1].last,
+				ranges[i].last);
+		else
+			ranges[nb++] = ranges[i];
+	}
+
+	return nb;
+}
+
+/* Positions the rule cursors of depth > 24 on a tbl24 entry. */
+static void
+bulk_cursors_seek(struct lpm_bulk_ctx *ctx, uint32_t tbl24_index)
+{
+	const struct rte_lpm_rule_info *info;
+	uint32_t d;
+
+	for (d = 0; d < BULK_TBL8_DEPTHS; d++) {
+		info = &ctx->rule_info[MAX_DEPTH_TBL24 + d];
+		ctx->cursor[d] = rule_lower_bound(ctx->rules, info->first_rule,
+			info->first_rule + info->used_rules, tbl24_index << 8);
+	}
+}
+
+/*
+ * Checks if a tbl24 entry has rules of depth > 24 after the batch.
+ * It must be called for increasing tbl24 indexes after bulk_cursors_seek().
+ */
+static int
+bulk_has_tbl8_rules(struct lpm_bulk_ctx *ctx, uint32_t tbl24_index)
+{
+	const struct rte_lpm_rule_info *info;
+	uint32_t d, last, *k;
+	int found = 0;
+
+	for (d = 0; d < BULK_TBL8_DEPTHS; d++) {
+		info = &ctx->rule_info[MAX_DEPTH_TBL24 + d];
+		last = info->first_rule + info->used_rules;
+		k = &ctx->cursor[d];
+		while (*k < last && (ctx->rules[*k].ip >> 8) < tbl24_index)
+			(*k)++;
+		if (*k < last && (ctx->rules[*k].ip >> 8) == tbl24_index)
+			found = 1;
+	}
+
+	return found;
+}
+
+/*
+ * Counts the tbl8 groups allocated and freed by the batch, and makes sure
+ * enough groups are free, reclaiming them from the defer queue if needed.
+ */
+static int32_t
+bulk_tbl8_reserve(struct rte_lpm *lpm, struct lpm_bulk_ctx *ctx,
+		const struct lpm_bulk_range *ranges, uint32_t nb_ranges,
+		uint32_t *nb_freed)
+{
+	struct __rte_lpm *internal_lpm;
+	uint32_t i, r, nb_alloc = 0, nb_free = 0;
+	unsigned int freed;
+	int ext;
+
+	*nb_freed = 0;
+	for (r = 0; r < nb_ranges; r++) {
+		bulk_cursors_seek(ctx, ranges[r].first);
+		for (i = ranges[r].first; i < ranges[r].last; i++) {
+			ext = lpm->tbl24[i].valid && lpm->tbl24[i].valid_group;
+			if (bulk_has_tbl8_rules(ctx, i))
+				nb_alloc += !ext;
+			else
+				*nb_freed += ext;
+		}
+	}
+	if (nb_alloc == 0)
+		return 0;
+
+	internal_lpm = container_of(lpm, struct __rte_lpm, lpm);
+	for (;;) {
+		for (i = 0; i < lpm->number_tbl8s && nb_free < nb_alloc; i++)
+			nb_free += !lpm->tbl8[i *
+				RTE_LPM_TBL8_GROUP_NUM_ENTRIES].valid_group;
+		if (nb_free >= nb_alloc)
+			return 0;
+
+		/* Groups freed by the batch can only be reused after it. */
+		if (internal_lpm->dq == NULL)
+			return -ENOSPC;
+		/* Fail when nothing could be reclaimed, the readers might
+		 * still reference all the deferred groups.
+		 */
+		freed = 0;
+		if (rte_rcu_qsbr_dq_reclaim(internal_lpm->dq,
+				nb_alloc - nb_free, &freed, NULL, NULL) != 0 ||
+				freed == 0)
+			return -ENOSPC;
+		nb_free = 0;
+	}
+}
+
+static uint32_t
+bulk_tbl8_alloc(struct rte_lpm *lpm, struct lpm_bulk_ctx *ctx)
+{
+	uint32_t group_idx = ctx->tbl8_next;
+	struct rte_lpm_tbl_entry *tbl8_entry;
+
+	/* Free groups were reserved by bulk_tbl8_reserve(). */
+	for (;; group_idx++) {
+		tbl8_entry = &lpm->tbl8[group_idx *
+					RTE_LPM_TBL8_GROUP_NUM_ENTRIES];
+		if (!tbl8_entry->valid_group)
+			break;
+	}
+	ctx->tbl8_next = group_idx + 1;
+
+	return group_idx;
+}
+
+/*
+ * Computes the final tbl24 entries of [first, last) for the rules of
+ * depth <= 24, an invalid entry having no matching rule.
+ */
+static void
+bulk_tbl24_compute(struct lpm_bulk_ctx *ctx, uint32_t first, uint32_t last)
+{
+	const struct rte_lpm_rule_info *info;
+	struct rte_lpm_tbl_entry entry = {
+		.valid = VALID,
+		.valid_group = 0,
+	};
+	uint32_t depth, k, end, start, stop, j;
+
+	memset(ctx->tbl24, 0, (last - first) * sizeof(ctx->tbl24[0]));
+
+	/* Deeper rules overwrite the shorter ones. */
+	for (depth = 1; depth <= MAX_DEPTH_TBL24; depth++) {
+		info = &ctx->rule_info[depth - 1];
+		end = info->first_rule + info->used_rules;
+		k = rule_lower_bound(ctx->rules, info->first_rule, end,
+			(first << 8) & depth_to_mask(depth));
+		entry.depth = depth;
+
+		for (; k < end && (ctx->rules[k].ip >> 8) < last; k++) {
+			start = ctx->rules[k].ip >> 8;
+			stop = RTE_MIN(start + depth_to_range(depth), last);
+			start = RTE_MAX(start, first);
+			entry.next_hop = ctx->rules[k].next_hop;
+			for (j = start; j < stop; j++)
+				ctx->tbl24[j - first] = entry;
+		}
+	}
+}
+
+/*
+ * Computes the final tbl8 group of a tbl24 entry, from the final tbl24
+ * entry of the rules of depth <= 24 and the rules of depth > 24.
+ */
+static void
+bulk_tbl8_compute(struct lpm_bulk_ctx *ctx, uint32_t tbl24_index,
+		const struct rte_lpm_tbl_entry *tbl24_entry)
+{
+	struct rte_lpm_tbl_entry entry = *tbl24_entry;
+	uint32_t d, k, last, start, stop, j;
+
+	entry.valid_group = VALID;
+	for (j = 0; j < RTE_LPM_TBL8_GROUP_NUM_ENTRIES; j++)
+		ctx->tbl8[j] = entry;
+
+	entry.valid = VALID;
+	for (d = 0; d < BULK_TBL8_DEPTHS; d++) {
+		last = ctx->rule_info[MAX_DEPTH_TBL24 + d].first_rule +
+			ctx->rule_info[MAX_DEPTH_TBL24 + d].used_rules;
+		entry.depth = MAX_DEPTH_TBL24 + 1 + d;
+
+		/* The cursors are on the rules of this tbl24 entry. */
+		for (k = ctx->cursor[d]; k < last &&
+				(ctx->rules[k].ip >> 8) == tbl24_index; k++) {
+			start = ctx->rules[k].ip & 0xFF;
+			stop = start + depth_to_range(entry.depth);
+			entry.next_hop = ctx->rules[k].next_hop;
+			for (j = start; j < stop; j++)
+				ctx->tbl8[j] = entry;
+		}
+	}
+}
+
+/*
+ * Writes the final state of the tbl24 entries [first, last) and of their
+ * tbl8 groups. Only the entries which change are written.
+ */
+static void
+bulk_tbl_update(struct rte_lpm *lpm, struct lpm_bulk_ctx *ctx,
+		uint32_t first, uint32_t last)
+{
+	struct rte_lpm_tbl_entry *tbl8, entry;
+	const struct rte_lpm_tbl_entry *tbl24_entry;
+	uint32_t i, j, group_idx;
+	int ext;
+
+	bulk_tbl24_compute(ctx, first, last);
+
+	for (i = first; i < last; i++) {
+		tbl24_entry = &ctx->tbl24[i - first];
+		ext = lpm->tbl24[i].valid && lpm->tbl24[i].valid_group;
+
+		if (!bulk_has_tbl8_rules(ctx, i)) {
+			if (memcmp(&lpm->tbl24[i], tbl24_entry,
+					sizeof(*tbl24_entry)) == 0)
+				continue;
+			if (ext)
+				ctx->tbl8_freed[ctx->nb_tbl8_freed++] =
+					lpm->tbl24[i].next_hop *
+					RTE_LPM_TBL8_GROUP_NUM_ENTRIES;
+			__atomic_store(&lpm->tbl24[i], tbl24_entry,
+					__ATOMIC_RELEASE);
+			continue;
+		}
+
+		bulk_tbl8_compute(ctx, i, tbl24_entry);
+
+		if (ext) {
+			/* Update the group in place. */
+			tbl8 = &lpm->tbl8[lpm->tbl24[i].next_hop *
+				RTE_LPM_TBL8_GROUP_NUM_ENTRIES];
+			for (j = 0; j < RTE_LPM_TBL8_GROUP_NUM_ENTRIES; j++) {
+				entry = ctx->tbl8[j];
+				entry.valid_group = tbl8[j].valid_group;
+				if (memcmp(&tbl8[j], &entry,
+						sizeof(entry)) != 0)
+					__atomic_store(&tbl8[j], &entry,
+						__ATOMIC_RELAXED);
+			}
+			continue;
+		}
+
+		/* Fill a new group before making it visible. */
+		group_idx = bulk_tbl8_alloc(lpm, ctx);
+		memcpy(&lpm->tbl8[group_idx * RTE_LPM_TBL8_GROUP_NUM_ENTRIES],
+			ctx->tbl8, sizeof(ctx->tbl8));
+
+		entry = (struct rte_lpm_tbl_entry){
+			.next_hop = group_idx,
+			.valid = VALID,
+			.valid_group = 1,
+			.depth = 0,
+		};
+		__atomic_store(&lpm->tbl24[i], &entry, __ATOMIC_RELEASE);
+	}
+}
+
+/*
+ * Frees the tbl8 groups released by a batch. With RCU, the readers are
+ * waited for once for the whole batch.
+ */
+static void
+bulk_tbl8_free(struct rte_lpm *lpm, const uint32_t *groups, uint32_t n)
+{
+	struct rte_lpm_tbl_entry zero_tbl8_entry = {0};
+	struct __rte_lpm *internal_lpm;
+	uint32_t i = 0;
+
+	if (n == 0)
+		return;
+
+	internal_lpm = container_of(lpm, struct __rte_lpm, lpm);
+	if (internal_lpm->v != NULL &&
+			internal_lpm->rcu_mode == RTE_LPM_QSBR_MODE_DQ) {
+		/* Push into QSBR defer queue. */
+		for (; i < n; i++) {
+			if (rte_rcu_qsbr_dq_enqueue(internal_lpm->dq,
+					(void *)(uintptr_t)&groups[i]) != 0)
+				break;
+		}
+		if (i == n)
+			return;
+		/* Defer queue full, wait for the readers. */
+	}
+
+	if (internal_lpm->v != NULL)
+		rte_rcu_qsbr_synchronize(internal_lpm->v,
+			RTE_QSBR_THRID_INVALID);
+
+	/* Set tbl8 groups invalid */
+	for (; i < n; i++)
+		__atomic_store(&lpm->tbl8[groups[i]], &zero_tbl8_entry,
+				__ATOMIC_RELAXED);
+}
+
+/*
+ * Add and delete a batch of rules.
+ */
+int
+rte_lpm_update_bulk(struct rte_lpm *lpm, const struct rte_lpm_update *updates,
+		uint32_t n)
+{
+	struct lpm_bulk_ctx ctx = { 0 };
+	struct lpm_bulk_rule *br = NULL;
+	struct lpm_bulk_range *ranges = NULL;
+	uint32_t i, r, first, last, nb_br, nb_ranges, nb_freed;
+	int32_t status;
+
+	/* Check user arguments. */
+	if ((lpm == NULL) || (updates == NULL && n != 0))
+		return -EINVAL;
+	for (i = 0; i < n; i++) {
+		if ((updates[i].depth < 1) ||
+				(updates[i].depth > RTE_LPM_MAX_DEPTH) ||
+				(updates[i].op != RTE_LPM_UPDATE_ADD &&
+				updates[i].op != RTE_LPM_UPDATE_DELETE))
+			return -EINVAL;
+	}
+	if (n == 0)
+		return 0;
+
+	br = malloc(n * sizeof(*br));
+	ranges = malloc(n * sizeof(*ranges));
+	ctx.rules = malloc(lpm->max_rules * sizeof(*ctx.rules));
+	ctx.tbl24 = malloc(BULK_TBL24_WINDOW * sizeof(*ctx.tbl24));
+	if (br == NULL || ranges == NULL || ctx.rules == NULL ||
+			ctx.tbl24 == NULL) {
+		status = -ENOMEM;
+		goto exit;
+	}
+
+	for (i = 0; i < n; i++) {
+		br[i].ip = updates[i].ip & depth_to_mask(updates[i].depth);
+		br[i].next_hop = updates[i].next_hop;
+		br[i].seq = i;
+		br[i].depth = updates[i].depth;
+		br[i].op = updates[i].op;
+		br[i].changed = 0;
+	}
+	nb_br = bulk_rules_sort(br, n);
+
+	/* Check the rules and tbl8 groups before changing anything. */
+	status = bulk_rules_merge(lpm, &ctx, br, nb_br);
+	if (status < 0)
+		goto exit;
+
+	nb_ranges = bulk_ranges_build(br, nb_br, ranges);
+	status = bulk_tbl8_reserve(lpm, &ctx, ranges, nb_ranges, &nb_freed);
+	if (status < 0)
+		goto exit;
+
+	if (nb_freed > 0) {
+		ctx.tbl8_freed = malloc(nb_freed * sizeof(*ctx.tbl8_freed));
+		if (ctx.tbl8_freed == NULL) {
+			status = -ENOMEM;
+			goto exit;
+		}
+	}
+
+	bulk_rules_commit(lpm, &ctx);
+
+	for (r = 0; r < nb_ranges; r++) {
+		bulk_cursors_seek(&ctx, ranges[r].first);
+		for (first = ranges[r].first; first < ranges[r].last;
+				first = last) {
+			last = RTE_MIN(first + BULK_TBL24_WINDOW,
+				ranges[r].last);
+			bulk_tbl_update(lpm, &ctx, first, last);
+		}
+	}
+
+	bulk_tbl8_free(lpm, ctx.tbl8_freed, ctx.nb_tbl8_freed);
+
+exit:
+	free(ctx.tbl8_freed);
+	free(ctx.tbl24);
+	free(ctx.rules);
+	free(ranges);
+	free(br);
+
+	return status;
+}
@@ -289,6 +289,59 @@ rte_lpm_delete(struct rte_lpm *lpm, uint32_t ip, uint8_t depth);
 void
 rte_lpm_delete_all(struct rte_lpm *lpm);
 
+/** Operation of a rule update in a batch. */
+enum rte_lpm_update_op {
+	/** Add a rule, or update the next hop of an existing rule. */
+	RTE_LPM_UPDATE_ADD = 0,
+	/** Delete a rule. Deleting a missing rule is not an error. */
+	RTE_LPM_UPDATE_DELETE
+};
+
+/** Rule update of a batch, see rte_lpm_update_bulk(). */
+struct rte_lpm_update {
+	uint32_t ip;		/**< IP of the rule. */
+	uint32_t next_hop;	/**< Next hop, unused on delete. */
+	uint8_t depth;		/**< Depth of the rule. */
+	uint8_t op;		/**< Operation, RTE_LPM_UPDATE_xxx. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add and delete a batch of rules in the LPM table.
+ *
+ * The result is the same as applying the updates one by one with
+ * rte_lpm_add() and rte_lpm_delete(), in array order. The updates are
+ * sorted and the final content of the tables is computed once, so each
+ * tbl24 and tbl8 entry is written at most once for the whole batch.
+ * The batch is applied entirely, or not at all if an error is returned.
+ *
+ * The tbl8 groups freed by the batch are released together: with RCU in
+ * blocking mode, a single grace period is waited for the whole batch.
+ *
+ * This is intended for large route changes, such as a routing table
+ * download. The cost of a batch is linear in the number of rules of the
+ * table, so single updates are better done with rte_lpm_add() and
+ * rte_lpm_delete().
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param updates
+ *   Array of rule updates
+ * @param n
+ *   Number of rule updates in the array
+ * @return
+ *   0 on success, negative value otherwise:
+ *   - -EINVAL - invalid parameter
+ *   - -ENOSPC - not enough rules or tbl8 groups for the batch
+ *   - -ENOMEM - temporary memory allocation failure
+ */
+__rte_experimental
+int
+rte_lpm_update_bulk(struct rte_lpm *lpm, const struct rte_lpm_update *updates,
+		uint32_t n);
+
 /**
  * Lookup an IP into the LPM table.
  *
@@ -0,0 +1,162 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_lcore.h>
+#include <rte_log.h>
+#include <rte_memzone.h>
+#include <rte_mempool.h>
+#include <rte_mbuf.h>
+
+#include "rte_mbuf_stripe.h"
+
+#define RTE_MBUF_STRIPE_MZ_PREFIX "MBUF_STRIPE_"
+
+struct rte_pktmbuf_stripe_pool *
+rte_pktmbuf_stripe_pool_create(const char *name, unsigned int n,
+	unsigned int cache_size, uint16_t priv_size, uint16_t data_room_size)
+{
+	unsigned int socket_lcores[RTE_MAX_NUMA_NODES] = { 0 };
+	char mp_name[RTE_MEMPOOL_NAMESIZE];
+	char mz_name[RTE_MEMZONE_NAMESIZE];
+	struct rte_pktmbuf_stripe_pool *sp;
+	const struct rte_memzone *mz;
+	unsigned int lcore_id, nb_lcores = 0;
+	unsigned int socket_id, stripe_n, remainder;
+	int ret;
+
+	ret = snprintf(mz_name, sizeof(mz_name), RTE_MBUF_STRIPE_MZ_PREFIX "%s",
+		name);
+	if (ret < 0 || ret >= (int)sizeof(mz_name)) {
+		rte_errno = ENAMETOOLONG;
+		return NULL;
+	}
+
+	RTE_LCORE_FOREACH(lcore_id) {
+		socket_id = rte_lcore_to_socket_id(lcore_id);
+		if (socket_id >= RTE_MAX_NUMA_NODES)
+			socket_id = 0;
+		socket_lcores[socket_id]++;
+		nb_lcores++;
+	}
+
+	/* the first stripe takes the rounding remainder */
+	remainder = n;
+	for (socket_id = 0; socket_id < RTE_MAX_NUMA_NODES; socket_id++)
+		remainder -= (uint64_t)n * socket_lcores[socket_id] / nb_lcores;
+
+	mz = rte_memzone_reserve(mz_name, sizeof(*sp), SOCKET_ID_ANY, 0);
+	if (mz == NULL)
+		return NULL;
+	sp = mz->addr;
+	memset(sp, 0, sizeof(*sp));
+	strlcpy(sp->name, name, sizeof(sp->name));
+	sp->mz = mz;
+
+	for (socket_id = 0; socket_id < RTE_MAX_NUMA_NODES; socket_id++) {
+		if (socket_lcores[socket_id] == 0)
+			continue;
+
+		stripe_n = (uint64_t)n * socket_lcores[socket_id] / nb_lcores;
+		if (sp->nb_stripes == 0)
+			stripe_n += remainder;
+		if (stripe_n == 0) {
+			RTE_LOG(ERR, MBUF, "no mbuf left for stripe of socket %u\n",
+				socket_id);
+			rte_errno = EINVAL;
+			goto fail;
+		}
+
+		ret = snprintf(mp_name, sizeof(mp_name), "%s_s%u", name,
+			socket_id);
+		if (ret < 0 || ret >= (int)sizeof(mp_name)) {
+			rte_errno = ENAMETOOLONG;
+			goto fail;
+		}
+
+		sp->stripes[sp->nb_stripes] = rte_pktmbuf_pool_create(mp_name,
+			stripe_n, cache_size, priv_size, data_room_size,
+			socket_id);
+		if (sp->stripes[sp->nb_stripes] == NULL)
+			goto fail;
+		sp->socket_stripe[socket_id] = sp->nb_stripes;
+		sp->nb_stripes++;
+		sp->size += stripe_n;
+	}
+
+	return sp;
+
+fail:
+	ret = rte_errno;
+	rte_pktmbuf_stripe_pool_free(sp);
+	rte_errno = ret;
+	return NULL;
+}
+
+struct rte_pktmbuf_stripe_pool *
+rte_pktmbuf_stripe_pool_lookup(const char *name)
+{
+	char mz_name[RTE_MEMZONE_NAMESIZE];
+	const struct rte_memzone *mz;
+	int ret;
+
+	ret = snprintf(mz_name, sizeof(mz_name), RTE_MBUF_STRIPE_MZ_PREFIX "%s",
+		name);
+	if (ret < 0 || ret >= (int)sizeof(mz_name)) {
+		rte_errno = ENOENT;
+		return NULL;
+	}
+
+	mz = rte_memzone_lookup(mz_name);
+	if (mz == NULL) {
+		rte_errno = ENOENT;
+		return NULL;
+	}
+	return mz->addr;
+}
+
+void
+rte_pktmbuf_stripe_pool_free(struct rte_pktmbuf_stripe_pool *sp)
+{
+	unsigned int i;
+
+	if (sp == NULL)
+		return;
+
+	for (i = 0; i < sp->nb_stripes; i++)
+		rte_mempool_free(sp->stripes[i]);
+	rte_memzone_free(sp->mz);
+}
+
+unsigned int
+rte_pktmbuf_stripe_pool_avail_count(const struct rte_pktmbuf_stripe_pool *sp)
+{
+	unsigned int i, count = 0;
+
+	for (i = 0; i < sp->nb_stripes; i++)
+		count += rte_mempool_avail_count(sp->stripes[i]);
+	return count;
+}
+
+void
+rte_pktmbuf_stripe_pool_dump(FILE *f, const struct rte_pktmbuf_stripe_pool *sp)
+{
+	const struct rte_mempool *mp;
+	unsigned int i;
+
+	fprintf(f, "striped mbuf pool <%s>@%p\n", sp->name, sp);
+	fprintf(f, "  size=%u\n", sp->size);
+	fprintf(f, "  nb_stripes=%u\n", sp->nb_stripes);
+	for (i = 0; i < sp->nb_stripes; i++) {
+		mp = sp->stripes[i];
+		fprintf(f, "  stripe[%u]: <%s> socket_id=%d size=%u avail=%u\n",
+			i, mp->name, mp->socket_id, mp->size,
+			rte_mempool_avail_count(mp));
+	}
+}
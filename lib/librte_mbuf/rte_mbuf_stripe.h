@@ -0,0 +1,252 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#ifndef _RTE_MBUF_STRIPE_H_
+#define _RTE_MBUF_STRIPE_H_
+
+/**
+ * @file
+ * RTE Mbuf Striped Pools
+ *
+ * A striped pool is one logical mbuf pool backed by one mbuf pool, or
+ * stripe, per NUMA socket running lcores. The mbufs are allocated from the
+ * stripe of the socket of the calling lcore, and only taken from another
+ * stripe when the local one is empty, so the mbufs of the pool are shared
+ * by all sockets without being sized for each of them.
+ *
+ * The stripes are regular mbuf pools: rte_pktmbuf_free() returns an mbuf
+ * to its home stripe, and the stripe of a socket can be given to the Rx
+ * queues of that socket with rte_pktmbuf_stripe_pool_get().
+ */
+
+#include <rte_compat.h>
+#include <rte_common.h>
+#include <rte_lcore.h>
+#include <rte_mempool.h>
+#include <rte_mbuf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A striped mbuf pool.
+ */
+struct rte_pktmbuf_stripe_pool {
+	char name[RTE_MEMPOOL_NAMESIZE]; /**< Name of the striped pool. */
+	const struct rte_memzone *mz;    /**< Memzone of this structure. */
+	unsigned int size;               /**< Number of mbufs of all stripes. */
+	unsigned int nb_stripes;         /**< Number of stripes. */
+	/** Index of the stripe used by each socket. */
+	uint8_t socket_stripe[RTE_MAX_NUMA_NODES];
+	/** Stripes, the first nb_stripes entries are valid. */
+	struct rte_mempool *stripes[RTE_MAX_NUMA_NODES];
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Create a striped mbuf pool.
+ *
+ * One mbuf pool is created on each socket running enabled lcores, named
+ * after the striped pool and the socket ("<name>_s<socket>"). The n mbufs
+ * are divided among the stripes in proportion of the number of lcores of
+ * their socket.
+ *
+ * @param name
+ *   The name of the striped pool.
+ * @param n
+ *   The total number of mbufs of the stripes.
+ * @param cache_size
+ *   Size of the per-core object cache of each stripe. See
+ *   rte_mempool_create() for details.
+ * @param priv_size
+ *   Size of application private are between the rte_mbuf structure
+ *   and the data buffer. This value must be aligned to RTE_MBUF_PRIV_ALIGN.
+ * @param data_room_size
+ *   Size of data buffer in each mbuf, including RTE_PKTMBUF_HEADROOM.
+ * @return
+ *   The pointer to the new striped pool, on success. NULL on error
+ *   with rte_errno set appropriately. Possible rte_errno values include:
+ *    - EINVAL - n is too low to give mbufs to each stripe, cache size
+ *      provided is too large, or priv_size is not aligned.
+ *    - ENAMETOOLONG - the name of the striped pool or of a stripe is too long
+ *    - EEXIST - a striped pool or a stripe with the same name already exists
+ *    - ENOMEM - no appropriate memory area found for a stripe
+ */
+__rte_experimental
+struct rte_pktmbuf_stripe_pool *
+rte_pktmbuf_stripe_pool_create(const char *name, unsigned int n,
+	unsigned int cache_size, uint16_t priv_size, uint16_t data_room_size);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Search a striped mbuf pool from its name.
+ *
+ * @param name
+ *   The name of the striped pool.
+ * @return
+ *   The pointer to the striped pool matching the name, or NULL if not found
+ *   with rte_errno set to ENOENT.
+ */
+__rte_experimental
+struct rte_pktmbuf_stripe_pool *
+rte_pktmbuf_stripe_pool_lookup(const char *name);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Free a striped mbuf pool and its stripes.
+ *
+ * All the mbufs must have been returned to the stripes.
+ *
+ * @param sp
+ *   A pointer to the striped pool. If NULL then, the function does nothing.
+ */
+__rte_experimental
+void
+rte_pktmbuf_stripe_pool_free(struct rte_pktmbuf_stripe_pool *sp);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the stripe of a socket.
+ *
+ * This is the mbuf pool to give to the Rx queues polled from this socket.
+ *
+ * @param sp
+ *   A pointer to the striped pool.
+ * @param socket_id
+ *   The socket identifier. SOCKET_ID_ANY, or a socket without lcores, gives
+ *   the first stripe.
+ * @return
+ *   The mbuf pool of the stripe.
+ */
+__rte_experimental
+static inline struct rte_mempool *
+rte_pktmbuf_stripe_pool_get(const struct rte_pktmbuf_stripe_pool *sp,
+	int socket_id)
+{
+	if ((unsigned int)socket_id >= RTE_MAX_NUMA_NODES)
+		return sp->stripes[0];
+	return sp->stripes[sp->socket_stripe[socket_id]];
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Allocate a new mbuf from a striped pool.
+ *
+ * The mbuf is taken from the stripe of the socket of the calling lcore,
+ * or from the next stripes if it is empty.
+ *
+ * @param sp
+ *   A pointer to the striped pool.
+ * @return
+ *   - The pointer to the new mbuf on success.
+ *   - NULL if allocation failed.
+ */
+__rte_experimental
+static inline struct rte_mbuf *
+rte_pktmbuf_stripe_alloc(const struct rte_pktmbuf_stripe_pool *sp)
+{
+	unsigned int socket_id = rte_socket_id();
+	unsigned int i, s = 0;
+	struct rte_mbuf *m;
+
+	if (socket_id < RTE_MAX_NUMA_NODES)
+		s = sp->socket_stripe[socket_id];
+
+	for (i = 0; i < sp->nb_stripes; i++) {
+		m = rte_pktmbuf_alloc(sp->stripes[s]);
+		if (likely(m != NULL))
+			return m;
+		if (++s == sp->nb_stripes)
+			s = 0;
+	}
+	return NULL;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Allocate a bulk of mbufs from a striped pool.
+ *
+ * All the mbufs are taken from the same stripe: the one of the socket of
+ * the calling lcore, or the next one holding enough mbufs.
+ *
+ * @param sp
+ *   A pointer to the striped pool.
+ * @param mbufs
+ *   Array of pointers to mbufs.
+ * @param count
+ *   Array size.
+ * @return
+ *   - 0: Success.
+ *   - -ENOENT: Not enough entries in any stripe; no mbufs are retrieved.
+ */
+__rte_experimental
+static inline int
+rte_pktmbuf_stripe_alloc_bulk(const struct rte_pktmbuf_stripe_pool *sp,
+	struct rte_mbuf **mbufs, unsigned int count)
+{
+	unsigned int socket_id = rte_socket_id();
+	unsigned int i, s = 0;
+
+	if (socket_id < RTE_MAX_NUMA_NODES)
+		s = sp->socket_stripe[socket_id];
+
+	for (i = 0; i < sp->nb_stripes; i++) {
+		if (likely(rte_pktmbuf_alloc_bulk(sp->stripes[s], mbufs,
+				count) == 0))
+			return 0;
+		if (++s == sp->nb_stripes)
+			s = 0;
+	}
+	return -ENOENT;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Return the number of mbufs available in all the stripes.
+ *
+ * @param sp
+ *   A pointer to the striped pool.
+ * @return
+ *   The number of available mbufs.
+ */
+__rte_experimental
+unsigned int
+rte_pktmbuf_stripe_pool_avail_count(const struct rte_pktmbuf_stripe_pool *sp);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Dump the stripes of a striped pool to a file.
+ *
+ * @param f
+ *   A pointer to a file for output.
+ * @param sp
+ *   A pointer to the striped pool.
+ */
+__rte_experimental
+void
+rte_pktmbuf_stripe_pool_dump(FILE *f,
+	const struct rte_pktmbuf_stripe_pool *sp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_MBUF_STRIPE_H_ */
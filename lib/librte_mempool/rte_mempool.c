@@ -768,6 +768,8 @@ rte_mempool_populate_anon(struct rte_mempool *mp)
 	return 0;
 }
 
+static void mempool_adaptive_drain_all(struct rte_mempool *mp);
+
 /* free a mempool */
 void
 rte_mempool_free(struct rte_mempool *mp)
@@ -793,6 +795,7 @@ rte_mempool_free(struct rte_mempool *mp)
 	rte_mcfg_tailq_write_unlock();
 
 	rte_mempool_trace_free(mp);
+	mempool_adaptive_drain_all(mp);
 	rte_mempool_free_memchunks(mp);
 	rte_mempool_ops_free(mp);
 	rte_memzone_free(mp->mz);
@@ -847,6 +850,318 @@ rte_mempool_cache_free(struct rte_mempool_cache *cache)
 	rte_free(cache);
 }
 
+/*
+ * Adaptive caches (MEMPOOL_F_CACHE_ADAPTIVE).
+ *
+ * The size of a default cache follows the put/get imbalance of its lcore:
+ * it doubles after MEMPOOL_ADAPTIVE_TREND consecutive flushes or refills
+ * from the pool, and is halved back towards mp->cache_size when the
+ * direction changes.
+ *
+ * An lcore refilling its cache from the pool flags itself as hungry. The
+ * next lcore flushing its cache hands the excess objects over to the
+ * mailbox of a hungry lcore instead of enqueuing them in the pool, and the
+ * hungry lcore takes them on its next refill. A mailbox is only emptied by
+ * its lcore, and is filled by the producer which moved it from EMPTY to
+ * FILLING.
+ */
+#define MEMPOOL_ADAPTIVE_TREND 4
+#define MEMPOOL_ADAPTIVE_GROWTH 4
+#define MEMPOOL_ADAPTIVE_HUNGRY_WORDS ((RTE_MAX_LCORE + 63) / 64)
+
+#define MEMPOOL_HANDOFF_EMPTY 0
+#define MEMPOOL_HANDOFF_FILLING 1
+#define MEMPOOL_HANDOFF_FULL 2
+
+struct mempool_adaptive_lcore {
+	/* only written by the lcore owning the cache */
+	int32_t trend;         /* >0: consecutive flushes, <0: refills */
+	uint64_t flushes;      /* flushes of the cache */
+	uint64_t refills;      /* refills from the pool */
+	uint64_t handoffs_out; /* batches handed over to other lcores */
+	uint64_t handoffs_in;  /* batches taken from the mailbox */
+	uint64_t resizes;      /* changes of the cache size */
+
+	/* mailbox of objects handed over by another lcore */
+	uint32_t state __rte_cache_aligned;
+	uint32_t len;
+	void *objs[RTE_MEMPOOL_CACHE_MAX_SIZE];
+} __rte_cache_aligned;
+
+struct mempool_adaptive {
+	uint32_t max_size; /* upper bound of the cache sizes */
+	/* lcores which refilled their cache from the pool */
+	uint64_t hungry[MEMPOOL_ADAPTIVE_HUNGRY_WORDS] __rte_cache_aligned;
+	struct mempool_adaptive_lcore lcore[RTE_MAX_LCORE];
+};
+
+/* the state of adaptive caches is stored after the private data */
+static size_t
+mempool_adaptive_offset(const struct rte_mempool *mp,
+	unsigned int cache_size, unsigned int private_data_size)
+{
+	return RTE_ALIGN_CEIL(MEMPOOL_HEADER_SIZE(mp, cache_size) +
+		private_data_size, RTE_MEMPOOL_ALIGN);
+}
+
+static struct mempool_adaptive *
+mempool_adaptive_get(const struct rte_mempool *mp)
+{
+	if (!(mp->flags & MEMPOOL_F_CACHE_ADAPTIVE))
+		return NULL;
+	return RTE_PTR_ADD(mp, mempool_adaptive_offset(mp, mp->cache_size,
+		mp->private_data_size));
+}
+
+/* lcore of a default cache, RTE_MAX_LCORE for a user-owned cache */
+static unsigned int
+mempool_cache_lcore(const struct rte_mempool *mp,
+	const struct rte_mempool_cache *cache)
+{
+	uintptr_t idx;
+
+	if (cache < mp->local_cache)
+		return RTE_MAX_LCORE;
+	idx = cache - mp->local_cache;
+	return idx < RTE_MAX_LCORE ? idx : RTE_MAX_LCORE;
+}
+
+/* dir is 1 for a flush and -1 for a refill */
+static void
+mempool_adaptive_resize(const struct rte_mempool *mp,
+	struct rte_mempool_cache *cache, struct mempool_adaptive_lcore *al,
+	int32_t dir)
+{
+	const struct mempool_adaptive *ad = mempool_adaptive_get(mp);
+	uint32_t size;
+
+	if (al->trend != 0 && (al->trend > 0) != (dir > 0)) {
+		/* the direction changed, go back towards the default size */
+		al->trend = dir;
+		size = RTE_MAX(cache->size / 2, mp->cache_size);
+	} else {
+		al->trend += dir;
+		if (al->trend * dir < MEMPOOL_ADAPTIVE_TREND)
+			return;
+		al->trend = dir;
+		size = RTE_MIN(cache->size * 2, ad->max_size);
+	}
+
+	if (size == cache->size)
+		return;
+	cache->size = size;
+	cache->flushthresh = CALC_CACHE_FLUSHTHRESH(size);
+	al->resizes++;
+}
+
+/* hand objects over to a hungry lcore, return the number of objects given */
+static unsigned int
+mempool_adaptive_handoff(struct mempool_adaptive *ad, void * const *objs,
+	unsigned int n)
+{
+	struct mempool_adaptive_lcore *dst;
+	uint64_t word, bit;
+	uint32_t state;
+	unsigned int i;
+
+	for (i = 0; i < MEMPOOL_ADAPTIVE_HUNGRY_WORDS; i++) {
+		word = __atomic_load_n(&ad->hungry[i], __ATOMIC_RELAXED);
+		while (word != 0) {
+			bit = word & -word;
+			word &= ~bit;
+
+			/* the producer clearing the bit serves the lcore */
+			if ((__atomic_fetch_and(&ad->hungry[i], ~bit,
+					__ATOMIC_RELAXED) & bit) == 0)
+				continue;
+
+			dst = &ad->lcore[i * 64 + rte_bsf64(bit)];
+			state = MEMPOOL_HANDOFF_EMPTY;
+			if (!__atomic_compare_exchange_n(&dst->state, &state,
+					MEMPOOL_HANDOFF_FILLING, 0,
+					__ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+				continue;
+
+			if (n > RTE_MEMPOOL_CACHE_MAX_SIZE)
+				n = RTE_MEMPOOL_CACHE_MAX_SIZE;
+			memcpy(dst->objs, objs, sizeof(void *) * n);
+			dst->len = n;
+			__atomic_store_n(&dst->state, MEMPOOL_HANDOFF_FULL,
+				__ATOMIC_RELEASE);
+			return n;
+		}
+	}
+	return 0;
+}
+
+void
+rte_mempool_cache_adaptive_flush(struct rte_mempool *mp,
+	struct rte_mempool_cache *cache)
+{
+	struct mempool_adaptive *ad = mempool_adaptive_get(mp);
+	struct mempool_adaptive_lcore *al;
+	unsigned int lcore_id, n, given;
+	uint64_t bit;
+
+	lcore_id = mempool_cache_lcore(mp, cache);
+	if (lcore_id == RTE_MAX_LCORE) {
+		rte_mempool_ops_enqueue_bulk(mp, &cache->objs[cache->size],
+				cache->len - cache->size);
+		cache->len = cache->size;
+		return;
+	}
+
+	al = &ad->lcore[lcore_id];
+	al->flushes++;
+
+	/* an lcore giving objects back does not need more */
+	bit = UINT64_C(1) << (lcore_id % 64);
+	if (__atomic_load_n(&ad->hungry[lcore_id / 64], __ATOMIC_RELAXED) & bit)
+		__atomic_fetch_and(&ad->hungry[lcore_id / 64], ~bit,
+			__ATOMIC_RELAXED);
+
+	mempool_adaptive_resize(mp, cache, al, 1);
+	if (cache->len <= cache->size)
+		return;
+
+	n = cache->len - cache->size;
+	given = mempool_adaptive_handoff(ad, &cache->objs[cache->size], n);
+	if (given != 0)
+		al->handoffs_out++;
+	if (given < n)
+		rte_mempool_ops_enqueue_bulk(mp,
+				&cache->objs[cache->size + given], n - given);
+	cache->len = cache->size;
+}
+
+int
+rte_mempool_cache_adaptive_refill(struct rte_mempool *mp,
+	struct rte_mempool_cache *cache, unsigned int n)
+{
+	struct mempool_adaptive *ad = mempool_adaptive_get(mp);
+	struct mempool_adaptive_lcore *al;
+	unsigned int lcore_id, m;
+	uint32_t req;
+	uint64_t bit;
+	int ret;
+
+	lcore_id = mempool_cache_lcore(mp, cache);
+	if (lcore_id == RTE_MAX_LCORE)
+		goto pool_dequeue;
+
+	al = &ad->lcore[lcore_id];
+
+	/* take the objects handed over by other lcores first */
+	if (__atomic_load_n(&al->state, __ATOMIC_ACQUIRE) ==
+			MEMPOOL_HANDOFF_FULL) {
+		m = RTE_MIN(al->len, cache->flushthresh - cache->len);
+		al->len -= m;
+		memcpy(&cache->objs[cache->len], &al->objs[al->len],
+			sizeof(void *) * m);
+		cache->len += m;
+		if (al->len == 0) {
+			al->handoffs_in++;
+			__atomic_store_n(&al->state, MEMPOOL_HANDOFF_EMPTY,
+				__ATOMIC_RELEASE);
+		}
+		if (cache->len >= n)
+			return 0;
+	}
+
+	al->refills++;
+	mempool_adaptive_resize(mp, cache, al, -1);
+
+	/* ask the next flushing lcore for objects */
+	bit = UINT64_C(1) << (lcore_id % 64);
+	if (__atomic_load_n(&al->state, __ATOMIC_RELAXED) ==
+			MEMPOOL_HANDOFF_EMPTY &&
+			(__atomic_load_n(&ad->hungry[lcore_id / 64],
+				__ATOMIC_RELAXED) & bit) == 0)
+		__atomic_fetch_or(&ad->hungry[lcore_id / 64], bit,
+			__ATOMIC_RELAXED);
+
+pool_dequeue:
+	req = n + (cache->size - cache->len);
+	ret = rte_mempool_ops_dequeue_bulk(mp, &cache->objs[cache->len], req);
+	if (ret < 0)
+		return ret;
+	cache->len += req;
+	return 0;
+}
+
+/* give the objects of the mailbox of an lcore back to the pool */
+static void
+mempool_adaptive_drain(struct rte_mempool *mp, struct mempool_adaptive *ad,
+	unsigned int lcore_id)
+{
+	struct mempool_adaptive_lcore *al = &ad->lcore[lcore_id];
+	uint64_t bit;
+	uint32_t state;
+
+	/* no producer selects the lcore anymore */
+	bit = UINT64_C(1) << (lcore_id % 64);
+	if (__atomic_load_n(&ad->hungry[lcore_id / 64], __ATOMIC_RELAXED) & bit)
+		__atomic_fetch_and(&ad->hungry[lcore_id / 64], ~bit,
+			__ATOMIC_RELAXED);
+
+	/* wait for a producer which selected it before */
+	while ((state = __atomic_load_n(&al->state, __ATOMIC_ACQUIRE)) ==
+			MEMPOOL_HANDOFF_FILLING)
+		rte_pause();
+	if (state != MEMPOOL_HANDOFF_FULL)
+		return;
+
+	rte_mempool_ops_enqueue_bulk(mp, al->objs, al->len);
+	al->len = 0;
+	__atomic_store_n(&al->state, MEMPOOL_HANDOFF_EMPTY, __ATOMIC_RELEASE);
+}
+
+/* give the objects of all the mailboxes back before freeing the pool */
+static void
+mempool_adaptive_drain_all(struct rte_mempool *mp)
+{
+	struct mempool_adaptive *ad = mempool_adaptive_get(mp);
+	unsigned int lcore_id;
+
+	if (ad == NULL)
+		return;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		mempool_adaptive_drain(mp, ad, lcore_id);
+}
+
+void
+rte_mempool_cache_adaptive_drain(struct rte_mempool *mp,
+	struct rte_mempool_cache *cache)
+{
+	unsigned int lcore_id;
+
+	lcore_id = mempool_cache_lcore(mp, cache);
+	if (lcore_id == RTE_MAX_LCORE)
+		return;
+	mempool_adaptive_drain(mp, mempool_adaptive_get(mp), lcore_id);
+}
+
+/* number of objects in the mailboxes of the adaptive caches */
+static unsigned int
+mempool_adaptive_count(const struct rte_mempool *mp)
+{
+	const struct mempool_adaptive *ad = mempool_adaptive_get(mp);
+	unsigned int lcore_id, count = 0;
+
+	if (ad == NULL)
+		return 0;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		const struct mempool_adaptive_lcore *al = &ad->lcore[lcore_id];
+
+		if (__atomic_load_n(&al->state, __ATOMIC_ACQUIRE) ==
+				MEMPOOL_HANDOFF_FULL)
+			count += al->len;
+	}
+	return count;
+}
+
 /* create an empty mempool */
 struct rte_mempool *
 rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
@@ -895,6 +1210,10 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 	if (flags & MEMPOOL_F_NO_CACHE_ALIGN)
 		flags |= MEMPOOL_F_NO_SPREAD;
 
+	/* only default caches can adapt */
+	if (cache_size == 0)
+		flags &= ~MEMPOOL_F_CACHE_ADAPTIVE;
+
 	/* calculate mempool object sizes. */
 	if (!rte_mempool_calc_obj_size(elt_size, flags, &objsz)) {
 		rte_errno = EINVAL;
@@ -918,9 +1237,10 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 		goto exit_unlock;
 	}
 
-	mempool_size = MEMPOOL_HEADER_SIZE(mp, cache_size);
-	mempool_size += private_data_size;
-	mempool_size = RTE_ALIGN_CEIL(mempool_size, RTE_MEMPOOL_ALIGN);
+	mempool_size = mempool_adaptive_offset(mp, cache_size,
+		private_data_size);
+	if (flags & MEMPOOL_F_CACHE_ADAPTIVE)
+		mempool_size += sizeof(struct mempool_adaptive);
 
 	ret = snprintf(mz_name, sizeof(mz_name), RTE_MEMPOOL_MZ_FORMAT, name);
 	if (ret < 0 || ret >= (int)sizeof(mz_name)) {
@@ -967,6 +1287,20 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 					   cache_size);
 	}
 
+	if (flags & MEMPOOL_F_CACHE_ADAPTIVE) {
+		struct mempool_adaptive *ad;
+
+		ad = mempool_adaptive_get(mp);
+		memset(ad, 0, sizeof(*ad));
+		/* keep the flush threshold of the largest caches below n */
+		ad->max_size = RTE_MIN(cache_size * MEMPOOL_ADAPTIVE_GROWTH,
+			(unsigned int)RTE_MEMPOOL_CACHE_MAX_SIZE);
+		while (ad->max_size > cache_size &&
+				CALC_CACHE_FLUSHTHRESH(ad->max_size) > n)
+			ad->max_size /= 2;
+		ad->max_size = RTE_MAX(ad->max_size, cache_size);
+	}
+
 	te->data = mp;
 
 	rte_mcfg_tailq_write_lock();
@@ -1052,6 +1386,7 @@ rte_mempool_avail_count(const struct rte_mempool *mp)
 
 	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
 		count += mp->local_cache[lcore_id].len;
+	count += mempool_adaptive_count(mp);
 
 	/*
 	 * due to race condition (access to len is not locked), the
@@ -1073,6 +1408,7 @@ rte_mempool_in_use_count(const struct rte_mempool *mp)
 static unsigned
 rte_mempool_dump_cache(FILE *f, const struct rte_mempool *mp)
 {
+	const struct mempool_adaptive *ad = mempool_adaptive_get(mp);
 	unsigned lcore_id;
 	unsigned count = 0;
 	unsigned cache_count;
@@ -1089,6 +1425,28 @@ rte_mempool_dump_cache(FILE *f, const struct rte_mempool *mp)
 			lcore_id, cache_count);
 		count += cache_count;
 	}
+
+	if (ad != NULL) {
+		fprintf(f, "    adaptive_max_size=%"PRIu32"\n", ad->max_size);
+		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+			const struct mempool_adaptive_lcore *al;
+
+			al = &ad->lcore[lcore_id];
+			if (al->flushes == 0 && al->refills == 0 &&
+					al->handoffs_in == 0)
+				continue;
+			fprintf(f, "    adaptive[%u]: size=%"PRIu32
+				" flushes=%"PRIu64" refills=%"PRIu64
+				" handoffs_out=%"PRIu64" handoffs_in=%"PRIu64
+				" resizes=%"PRIu64"\n", lcore_id,
+				mp->local_cache[lcore_id].size, al->flushes,
+				al->refills, al->handoffs_out,
+				al->handoffs_in, al->resizes);
+		}
+		cache_count = mempool_adaptive_count(mp);
+		fprintf(f, "    handoff_count=%u\n", cache_count);
+		count += cache_count;
+	}
 	fprintf(f, "    total_cache_count=%u\n", count);
 	return count;
 }
@@ -270,6 +270,7 @@ struct rte_mempool {
 #define MEMPOOL_F_POOL_CREATED   0x0010 /**< Internal: pool is created. */
 #define MEMPOOL_F_NO_IOVA_CONTIG 0x0020 /**< Don't need IOVA contiguous objs. */
 #define MEMPOOL_F_NO_PHYS_CONTIG MEMPOOL_F_NO_IOVA_CONTIG /* deprecated */
+#define MEMPOOL_F_CACHE_ADAPTIVE 0x0040 /**< Resize and share lcore caches. */
 
 /**
  * @internal When debug is enabled, store some statistics.
@@ -1021,6 +1022,13 @@ typedef void (rte_mempool_ctor_t)(struct rte_mempool *, void *);
  *     "single-consumer". Otherwise, it is "multi-consumers".
  *   - MEMPOOL_F_NO_IOVA_CONTIG: If set, allocated objects won't
  *     necessarily be contiguous in IO memory.
+ *   - MEMPOOL_F_CACHE_ADAPTIVE: If set, the size of each default lcore
+ *     cache follows the put/get imbalance of its lcore, between
+ *     cache_size and 4 times cache_size (at most
+ *     RTE_MEMPOOL_CACHE_MAX_SIZE). The objects flushed by an lcore
+ *     which mostly puts are handed over directly to an lcore which
+ *     mostly gets, without going through the pool. Ignored if cache_size
+ *     is 0. User-owned caches keep a fixed size.
  * @return
  *   The pointer to the new allocated mempool, on success. NULL on error
  *   with rte_errno set appropriately. Possible rte_errno values include:
@@ -1281,6 +1289,54 @@ rte_mempool_default_cache(struct rte_mempool *mp, unsigned lcore_id)
 	return &mp->local_cache[lcore_id];
 }
 
+/**
+ * @internal Flush the objects above the size of a cache of a pool created
+ * with MEMPOOL_F_CACHE_ADAPTIVE; used internally.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param cache
+ *   A pointer to the mempool cache, which reached its flush threshold.
+ */
+__rte_experimental
+void
+rte_mempool_cache_adaptive_flush(struct rte_mempool *mp,
+		struct rte_mempool_cache *cache);
+
+/**
+ * @internal Refill a cache of a pool created with MEMPOOL_F_CACHE_ADAPTIVE;
+ * used internally.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param cache
+ *   A pointer to the mempool cache, holding less than n objects.
+ * @param n
+ *   The number of objects the cache must hold on success.
+ * @return
+ *   - 0: Success; the cache holds at least n objects.
+ *   - <0: Error; code of ring dequeue function.
+ */
+__rte_experimental
+int
+rte_mempool_cache_adaptive_refill(struct rte_mempool *mp,
+		struct rte_mempool_cache *cache, unsigned int n);
+
+/**
+ * @internal Give the objects handed over to the lcore of a default cache
+ * of a pool created with MEMPOOL_F_CACHE_ADAPTIVE back to the pool;
+ * used internally.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param cache
+ *   A pointer to the mempool cache.
+ */
+__rte_experimental
+void
+rte_mempool_cache_adaptive_drain(struct rte_mempool *mp,
+		struct rte_mempool_cache *cache);
+
 /**
  * Flush a user-owned mempool cache to the specified mempool.
  *
@@ -1295,7 +1351,13 @@ rte_mempool_cache_flush(struct rte_mempool_cache *cache,
 {
 	if (cache == NULL)
 		cache = rte_mempool_default_cache(mp, rte_lcore_id());
-	if (cache == NULL || cache->len == 0)
+	if (cache == NULL)
+		return;
+#ifdef ALLOW_EXPERIMENTAL_API
+	if (mp->flags & MEMPOOL_F_CACHE_ADAPTIVE)
+		rte_mempool_cache_adaptive_drain(mp, cache);
+#endif
+	if (cache->len == 0)
 		return;
 	rte_mempool_trace_cache_flush(cache, mp);
 	rte_mempool_ops_enqueue_bulk(mp, cache->objs, cache->len);
@@ -1342,6 +1404,16 @@ __mempool_generic_put(struct rte_mempool *mp, void * const *obj_table,
 	cache->len += n;
 
 	if (cache->len >= cache->flushthresh) {
+		/* gcc complains about calling these experimental functions
+		 * even when not using them. Hide them with
+		 * ALLOW_EXPERIMENTAL_API, the cache then keeps its size.
+		 */
+#ifdef ALLOW_EXPERIMENTAL_API
+		if (mp->flags & MEMPOOL_F_CACHE_ADAPTIVE) {
+			rte_mempool_cache_adaptive_flush(mp, cache);
+			return;
+		}
+#endif
 		rte_mempool_ops_enqueue_bulk(mp, &cache->objs[cache->size],
 				cache->len - cache->size);
 		cache->len = cache->size;
@@ -1453,6 +1525,14 @@ __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 	cache_objs = cache->objs;
 
 	/* Can this be satisfied from the cache? */
+#ifdef ALLOW_EXPERIMENTAL_API
+	if (cache->len < n && (mp->flags & MEMPOOL_F_CACHE_ADAPTIVE)) {
+		/* Backfill, possibly with objects handed over by other lcores */
+		ret = rte_mempool_cache_adaptive_refill(mp, cache, n);
+		if (unlikely(ret < 0))
+			goto ring_dequeue;
+	} else
+#endif
 	if (cache->len < n) {
 		/* No. Backfill the cache first, and then fill from it */
 		uint32_t req = n + (cache->size - cache->len);
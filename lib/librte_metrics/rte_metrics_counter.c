@@ -0,0 +1,230 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_spinlock.h>
+#include <rte_string_fns.h>
+#include <rte_telemetry.h>
+
+#include "rte_metrics_counter.h"
+
+/* number of shards, the last one is shared by threads without lcore id */
+#define COUNTER_SHARDS (RTE_MAX_LCORE + 1)
+
+/**
+ * Internal counters registry, local to the process.
+ *
+ * @internal
+ */
+static struct {
+	/** Shards of all lcores, RTE_METRICS_COUNTER_SLOTS slots each. */
+	uint64_t *shards;
+	/** Number of slots given to counters in each shard. */
+	unsigned int nb_slots;
+	/** Number of counters. */
+	unsigned int nb_counters;
+	/** Counters, the first nb_counters entries are valid. */
+	struct rte_metrics_counter counters[RTE_METRICS_COUNTER_MAX];
+	/** Registry lock, never taken by the updates. */
+	rte_spinlock_t lock;
+} registry = {
+	.lock = RTE_SPINLOCK_INITIALIZER,
+};
+
+static struct rte_metrics_counter *
+counter_lookup(const char *name)
+{
+	unsigned int i;
+
+	for (i = 0; i < registry.nb_counters; i++) {
+		if (strcmp(registry.counters[i].name, name) == 0)
+			return &registry.counters[i];
+	}
+	return NULL;
+}
+
+static struct rte_metrics_counter *
+counter_create(const char *name, enum rte_metrics_counter_type type,
+	unsigned int nb_slots)
+{
+	struct rte_metrics_counter *c = NULL;
+
+	if (name == NULL || name[0] == '\0' ||
+			strnlen(name, RTE_METRICS_MAX_NAME_LEN) ==
+				RTE_METRICS_MAX_NAME_LEN) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	rte_spinlock_lock(&registry.lock);
+
+	if (counter_lookup(name) != NULL) {
+		rte_errno = EEXIST;
+		goto out;
+	}
+	if (registry.nb_counters == RTE_METRICS_COUNTER_MAX ||
+			registry.nb_slots + nb_slots >
+				RTE_METRICS_COUNTER_SLOTS) {
+		rte_errno = ENOSPC;
+		goto out;
+	}
+
+	if (registry.shards == NULL) {
+		registry.shards = rte_zmalloc("metrics_counters",
+			sizeof(uint64_t) * RTE_METRICS_COUNTER_SLOTS *
+				COUNTER_SHARDS, RTE_CACHE_LINE_SIZE);
+		if (registry.shards == NULL) {
+			rte_errno = ENOMEM;
+			goto out;
+		}
+	}
+
+	c = &registry.counters[registry.nb_counters];
+	c->values = &registry.shards[registry.nb_slots];
+	c->type = type;
+	strlcpy(c->name, name, sizeof(c->name));
+	registry.nb_slots += nb_slots;
+	registry.nb_counters++;
+
+out:
+	rte_spinlock_unlock(&registry.lock);
+	return c;
+}
+
+struct rte_metrics_counter *
+rte_metrics_counter_create(const char *name)
+{
+	return counter_create(name, RTE_METRICS_COUNTER_SCALAR, 1);
+}
+
+struct rte_metrics_counter *
+rte_metrics_histogram_create(const char *name)
+{
+	/* buckets followed by the sum */
+	return counter_create(name, RTE_METRICS_COUNTER_HISTOGRAM,
+		RTE_METRICS_HISTOGRAM_BUCKETS + 1);
+}
+
+struct rte_metrics_counter *
+rte_metrics_counter_lookup(const char *name)
+{
+	struct rte_metrics_counter *c;
+
+	rte_spinlock_lock(&registry.lock);
+	c = counter_lookup(name);
+	rte_spinlock_unlock(&registry.lock);
+	return c;
+}
+
+/* add up a slot of all shards */
+static uint64_t
+counter_slot_read(const struct rte_metrics_counter *c, unsigned int slot)
+{
+	unsigned int i;
+	uint64_t sum = 0;
+
+	for (i = 0; i < COUNTER_SHARDS; i++)
+		sum += __atomic_load_n(
+			&c->values[i * RTE_METRICS_COUNTER_SLOTS + slot],
+			__ATOMIC_RELAXED);
+	return sum;
+}
+
+uint64_t
+rte_metrics_counter_read(const struct rte_metrics_counter *c)
+{
+	unsigned int i;
+	uint64_t sum = 0;
+
+	if (c->type == RTE_METRICS_COUNTER_SCALAR)
+		return counter_slot_read(c, 0);
+
+	for (i = 0; i < RTE_METRICS_HISTOGRAM_BUCKETS; i++)
+		sum += counter_slot_read(c, i);
+	return sum;
+}
+
+int
+rte_metrics_histogram_read(const struct rte_metrics_counter *h,
+	struct rte_metrics_histogram_stats *stats)
+{
+	unsigned int i;
+
+	if (h->type != RTE_METRICS_COUNTER_HISTOGRAM)
+		return -EINVAL;
+
+	stats->count = 0;
+	for (i = 0; i < RTE_METRICS_HISTOGRAM_BUCKETS; i++) {
+		stats->buckets[i] = counter_slot_read(h, i);
+		stats->count += stats->buckets[i];
+	}
+	stats->sum = counter_slot_read(h, RTE_METRICS_HISTOGRAM_BUCKETS);
+	return 0;
+}
+
+static int
+handle_counter_list(const char *cmd __rte_unused,
+		const char *params __rte_unused,
+		struct rte_tel_data *d)
+{
+	unsigned int i;
+
+	rte_tel_data_start_array(d, RTE_TEL_STRING_VAL);
+	rte_spinlock_lock(&registry.lock);
+	for (i = 0; i < registry.nb_counters; i++)
+		rte_tel_data_add_array_string(d, registry.counters[i].name);
+	rte_spinlock_unlock(&registry.lock);
+	return 0;
+}
+
+static int
+handle_counter_get(const char *cmd __rte_unused,
+		const char *params,
+		struct rte_tel_data *d)
+{
+	struct rte_metrics_histogram_stats stats;
+	struct rte_metrics_counter *c;
+	char name[RTE_TEL_MAX_STRING_LEN];
+	unsigned int i;
+
+	if (params == NULL || strlen(params) == 0)
+		return -1;
+
+	c = rte_metrics_counter_lookup(params);
+	if (c == NULL)
+		return -1;
+
+	rte_tel_data_start_dict(d);
+	if (c->type == RTE_METRICS_COUNTER_SCALAR) {
+		rte_tel_data_add_dict_u64(d, "value",
+			rte_metrics_counter_read(c));
+		return 0;
+	}
+
+	rte_metrics_histogram_read(c, &stats);
+	rte_tel_data_add_dict_u64(d, "count", stats.count);
+	rte_tel_data_add_dict_u64(d, "sum", stats.sum);
+	/* only the buckets holding values */
+	for (i = 0; i < RTE_METRICS_HISTOGRAM_BUCKETS; i++) {
+		if (stats.buckets[i] == 0)
+			continue;
+		snprintf(name, sizeof(name), "bucket_%u", i);
+		rte_tel_data_add_dict_u64(d, name, stats.buckets[i]);
+	}
+	return 0;
+}
+
+RTE_INIT(metrics_counter_init_telemetry)
+{
+	rte_telemetry_register_cmd("/counters/list", handle_counter_list,
+			"Returns list of counters and histograms. Takes no parameters");
+	rte_telemetry_register_cmd("/counters/get", handle_counter_get,
+			"Returns the value of a counter or the buckets of a histogram. Parameters: string name");
+}
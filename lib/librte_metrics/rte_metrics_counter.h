@@ -0,0 +1,244 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#ifndef _RTE_METRICS_COUNTER_H_
+#define _RTE_METRICS_COUNTER_H_
+
+/**
+ * @file
+ *
+ * DPDK Metrics per-lcore counters
+ *
+ * Counters and histograms cheap enough to be updated from the data path.
+ * Each lcore updates its own copy, or shard, of a counter with plain
+ * increments in a cache line no other lcore writes, without lock nor
+ * atomic operation. Readers aggregate the shards of all lcores when they
+ * need the value, which is the only costly operation.
+ *
+ * Threads without an lcore id share a last shard, updated with atomic
+ * operations.
+ *
+ * The counters are local to the process and can be read with the
+ * telemetry commands /counters/list and /counters/get,<name>.
+ */
+
+#include <stdint.h>
+
+#include <rte_branch_prediction.h>
+#include <rte_common.h>
+#include <rte_compat.h>
+#include <rte_lcore.h>
+#include <rte_metrics.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum number of counters and histograms. */
+#define RTE_METRICS_COUNTER_MAX RTE_METRICS_MAX_METRICS
+
+/** Number of 64-bit slots of each lcore shard, shared by all counters. */
+#define RTE_METRICS_COUNTER_SLOTS 2048
+
+/**
+ * Number of buckets of a histogram. Bucket 0 counts the values 0, and
+ * bucket i > 0 the values in [2^(i-1), 2^i - 1].
+ */
+#define RTE_METRICS_HISTOGRAM_BUCKETS 65
+
+/** Type of a counter. */
+enum rte_metrics_counter_type {
+	RTE_METRICS_COUNTER_SCALAR, /**< Sum of values. */
+	RTE_METRICS_COUNTER_HISTOGRAM, /**< Distribution of values. */
+};
+
+/**
+ * A per-lcore counter.
+ */
+struct rte_metrics_counter {
+	/** Slots of the counter in the shard of lcore 0. */
+	uint64_t *values;
+	/** Type of the counter. */
+	enum rte_metrics_counter_type type;
+	/** Name of the counter. */
+	char name[RTE_METRICS_MAX_NAME_LEN];
+};
+
+/**
+ * Aggregated values of a histogram.
+ */
+struct rte_metrics_histogram_stats {
+	uint64_t count; /**< Number of values recorded. */
+	uint64_t sum; /**< Sum of the values recorded. */
+	/** Number of values recorded in each bucket. */
+	uint64_t buckets[RTE_METRICS_HISTOGRAM_BUCKETS];
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Create a counter.
+ *
+ * The counters cannot be freed, like metric names.
+ *
+ * @param name
+ *   Name of the counter, unique among counters and histograms.
+ * @return
+ *   The counter on success, NULL otherwise with rte_errno set:
+ *    - EINVAL - the name is empty or too long
+ *    - EEXIST - a counter with the same name exists
+ *    - ENOSPC - maximum number of counters or slots reached
+ *    - ENOMEM - the shards cannot be allocated
+ */
+__rte_experimental
+struct rte_metrics_counter *
+rte_metrics_counter_create(const char *name);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Create a histogram.
+ *
+ * @param name
+ *   Name of the histogram, unique among counters and histograms.
+ * @return
+ *   The histogram on success, NULL otherwise with rte_errno set as for
+ *   rte_metrics_counter_create().
+ */
+__rte_experimental
+struct rte_metrics_counter *
+rte_metrics_histogram_create(const char *name);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Search a counter or histogram by name.
+ *
+ * @param name
+ *   Name of the counter.
+ * @return
+ *   The counter, or NULL if not found.
+ */
+__rte_experimental
+struct rte_metrics_counter *
+rte_metrics_counter_lookup(const char *name);
+
+/**
+ * @internal
+ * Add to a slot of the calling lcore shard.
+ */
+static __rte_always_inline void
+__rte_metrics_counter_slot_add(const struct rte_metrics_counter *c,
+	unsigned int slot, uint64_t n)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	uint64_t *v;
+
+	if (likely(lcore_id < RTE_MAX_LCORE)) {
+		v = &c->values[lcore_id * RTE_METRICS_COUNTER_SLOTS + slot];
+		/* only this lcore writes its shard */
+		__atomic_store_n(v, *v + n, __ATOMIC_RELAXED);
+	} else {
+		v = &c->values[RTE_MAX_LCORE * RTE_METRICS_COUNTER_SLOTS +
+			slot];
+		__atomic_fetch_add(v, n, __ATOMIC_RELAXED);
+	}
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Add a value to a counter.
+ *
+ * @param c
+ *   The counter.
+ * @param n
+ *   The value to add.
+ */
+__rte_experimental
+static inline void
+rte_metrics_counter_add(const struct rte_metrics_counter *c, uint64_t n)
+{
+	__rte_metrics_counter_slot_add(c, 0, n);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Increment a counter.
+ *
+ * @param c
+ *   The counter.
+ */
+__rte_experimental
+static inline void
+rte_metrics_counter_inc(const struct rte_metrics_counter *c)
+{
+	__rte_metrics_counter_slot_add(c, 0, 1);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Record a value in a histogram.
+ *
+ * @param h
+ *   The histogram.
+ * @param value
+ *   The value to record.
+ */
+__rte_experimental
+static inline void
+rte_metrics_histogram_record(const struct rte_metrics_counter *h,
+	uint64_t value)
+{
+	__rte_metrics_counter_slot_add(h, rte_fls_u64(value), 1);
+	__rte_metrics_counter_slot_add(h, RTE_METRICS_HISTOGRAM_BUCKETS, value);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Read a counter, adding up the shards of all lcores.
+ *
+ * @param c
+ *   The counter.
+ * @return
+ *   The value of the counter, or the number of values recorded for a
+ *   histogram.
+ */
+__rte_experimental
+uint64_t
+rte_metrics_counter_read(const struct rte_metrics_counter *c);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Read a histogram, adding up the shards of all lcores.
+ *
+ * @param h
+ *   The histogram.
+ * @param stats
+ *   The aggregated values of the histogram.
+ * @return
+ *   0 on success, -EINVAL if h is not a histogram.
+ */
+__rte_experimental
+int
+rte_metrics_histogram_read(const struct rte_metrics_counter *h,
+	struct rte_metrics_histogram_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_METRICS_COUNTER_H_ */
@@ -0,0 +1,36 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#ifndef _NET_CRC_H_
+#define _NET_CRC_H_
+
+#include <stdint.h>
+
+/*
+ * Internal CRC handlers built in a separate file, with the compiler
+ * flags of their instruction set. The update functions take and return
+ * the CRC value before the final inversion, so that a CRC can be
+ * computed over several buffers.
+ */
+
+/* AVX512 VPCLMULQDQ handlers */
+
+void
+rte_net_crc_avx512_init(void);
+
+uint32_t
+rte_crc16_ccitt_avx512_handler(const uint8_t *data, uint32_t data_len);
+
+uint32_t
+rte_crc32_eth_avx512_handler(const uint8_t *data, uint32_t data_len);
+
+uint32_t
+rte_crc16_ccitt_avx512_update(const uint8_t *data, uint32_t data_len,
+	uint32_t crc);
+
+uint32_t
+rte_crc32_eth_avx512_update(const uint8_t *data, uint32_t data_len,
+	uint32_t crc);
+
+#endif /* _NET_CRC_H_ */
@@ -0,0 +1,234 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <string.h>
+#include <stdint.h>
+
+#include <rte_common.h>
+#include <rte_branch_prediction.h>
+
+#include "net_crc.h"
+#include "net_crc_sse.h"
+
+/** CRC polynomials, with their most significant bit */
+#define CRC32_ETH_POLYNOMIAL 0x104c11db7ULL
+#define CRC16_CCITT_POLYNOMIAL 0x11021ULL
+
+/** Data processed by one iteration of the main folding loop */
+#define CRC_FOLD_4X512_BYTES 256
+#define CRC_FOLD_512_BYTES 64
+
+/** VPCLMULQDQ CRC computation context structure */
+struct crc_vpclmulqdq_ctx {
+	__m512i fold_4x512; /**< fold distance of 2048 bits */
+	__m512i fold_3x512; /**< fold distance of 1536 bits */
+	__m512i fold_2x512; /**< fold distance of 1024 bits */
+	__m512i fold_1x512; /**< fold distance of 512 bits */
+	__m512i fold_lanes; /**< 384, 256 and 128 bits, for each 128-bit lane */
+};
+
+static struct crc_vpclmulqdq_ctx crc32_eth_vpclmulqdq __rte_aligned(64);
+static struct crc_vpclmulqdq_ctx crc16_ccitt_vpclmulqdq __rte_aligned(64);
+
+/**
+ * Computes x^n modulo the polynomial, bit-reflected and shifted left by 1,
+ * as used by the reflected CRC folding.
+ *
+ * @param n
+ *   Power of x
+ * @param poly
+ *   CRC polynomial, including its most significant bit
+ * @param deg
+ *   Degree of the polynomial
+ *
+ * @return
+ *   Folding constant
+ */
+static uint64_t
+crc_xpow_mod(uint32_t n, uint64_t poly, uint32_t deg)
+{
+	uint64_t r = 1, res = 0;
+	uint32_t i;
+
+	for (i = 0; i < n; i++) {
+		r <<= 1;
+		if (r & (1ULL << deg))
+			r ^= poly;
+	}
+
+	for (i = 0; i < deg; i++)
+		if (r & (1ULL << i))
+			res |= 1ULL << (deg - 1 - i);
+
+	return res << 1;
+}
+
+/**
+ * Returns the pair of constants folding a 128-bit block forward by
+ * 'dist' bits: the low constant multiplies the high 64 bits of the
+ * block, and the high constant its low 64 bits.
+ */
+static __m128i
+crc_fold_consts(uint32_t dist, uint64_t poly, uint32_t deg)
+{
+	return _mm_set_epi64x(crc_xpow_mod(dist + deg, poly, deg),
+		crc_xpow_mod(dist - 64 + deg, poly, deg));
+}
+
+static void
+crc_vpclmulqdq_ctx_init(struct crc_vpclmulqdq_ctx *ctx, uint64_t poly,
+	uint32_t deg)
+{
+	ctx->fold_4x512 = _mm512_broadcast_i32x4(
+		crc_fold_consts(2048, poly, deg));
+	ctx->fold_3x512 = _mm512_broadcast_i32x4(
+		crc_fold_consts(1536, poly, deg));
+	ctx->fold_2x512 = _mm512_broadcast_i32x4(
+		crc_fold_consts(1024, poly, deg));
+	ctx->fold_1x512 = _mm512_broadcast_i32x4(
+		crc_fold_consts(512, poly, deg));
+
+	/* lane 3 holds the last 16 bytes, which are not folded */
+	ctx->fold_lanes = _mm512_inserti32x4(_mm512_setzero_si512(),
+		crc_fold_consts(384, poly, deg), 0);
+	ctx->fold_lanes = _mm512_inserti32x4(ctx->fold_lanes,
+		crc_fold_consts(256, poly, deg), 1);
+	ctx->fold_lanes = _mm512_inserti32x4(ctx->fold_lanes,
+		crc_fold_consts(128, poly, deg), 2);
+}
+
+/**
+ * Folds each 128-bit lane of 'fold' with the constants of 'precomp',
+ * and XORs the result with 'data'.
+ */
+static __rte_always_inline __m512i
+crcr32_folding_round_512(__m512i data, __m512i precomp, __m512i fold)
+{
+	__m512i tmp0 = _mm512_clmulepi64_epi128(fold, precomp, 0x01);
+	__m512i tmp1 = _mm512_clmulepi64_epi128(fold, precomp, 0x10);
+
+	return _mm512_ternarylogic_epi64(tmp0, tmp1, data, 0x96);
+}
+
+static __rte_always_inline uint32_t
+crc32_eth_calc_vpclmulqdq(const uint8_t *data,
+	uint32_t data_len,
+	uint32_t crc,
+	const struct crc_vpclmulqdq_ctx *params,
+	const struct crc_pclmulqdq_ctx *sse_params)
+{
+	__m512i x0, x1, x2, x3;
+	__m128i fold;
+	uint32_t n;
+
+	/* short buffers are not worth the 512-bit setup */
+	if (data_len < CRC_FOLD_4X512_BYTES)
+		return crc32_eth_calc_pclmulqdq(data, data_len, crc,
+			sse_params);
+
+	/* Apply CRC initial value to the first 256 bytes */
+	x0 = _mm512_loadu_si512((const void *)data);
+	x1 = _mm512_loadu_si512((const void *)(data + 64));
+	x2 = _mm512_loadu_si512((const void *)(data + 128));
+	x3 = _mm512_loadu_si512((const void *)(data + 192));
+	x0 = _mm512_xor_si512(x0, _mm512_inserti32x4(_mm512_setzero_si512(),
+		_mm_cvtsi32_si128(crc), 0));
+
+	/* Main folding loop, four independent 64-byte accumulators */
+	for (n = CRC_FOLD_4X512_BYTES;
+			n + CRC_FOLD_4X512_BYTES <= data_len;
+			n += CRC_FOLD_4X512_BYTES) {
+		x0 = crcr32_folding_round_512(
+			_mm512_loadu_si512((const void *)&data[n]),
+			params->fold_4x512, x0);
+		x1 = crcr32_folding_round_512(
+			_mm512_loadu_si512((const void *)&data[n + 64]),
+			params->fold_4x512, x1);
+		x2 = crcr32_folding_round_512(
+			_mm512_loadu_si512((const void *)&data[n + 128]),
+			params->fold_4x512, x2);
+		x3 = crcr32_folding_round_512(
+			_mm512_loadu_si512((const void *)&data[n + 192]),
+			params->fold_4x512, x3);
+	}
+
+	/* Fold the accumulators into one */
+	x3 = crcr32_folding_round_512(x3, params->fold_1x512, x2);
+	x3 = crcr32_folding_round_512(x3, params->fold_2x512, x1);
+	x3 = crcr32_folding_round_512(x3, params->fold_3x512, x0);
+
+	for (; n + CRC_FOLD_512_BYTES <= data_len; n += CRC_FOLD_512_BYTES)
+		x3 = crcr32_folding_round_512(
+			_mm512_loadu_si512((const void *)&data[n]),
+			params->fold_1x512, x3);
+
+	/* Fold the four 128-bit lanes into one */
+	x0 = crcr32_folding_round_512(_mm512_setzero_si512(),
+		params->fold_lanes, x3);
+	fold = _mm_xor_si128(_mm512_extracti32x4_epi32(x0, 0),
+		_mm512_extracti32x4_epi32(x0, 1));
+	fold = _mm_xor_si128(fold, _mm512_extracti32x4_epi32(x0, 2));
+	fold = _mm_xor_si128(fold, _mm512_extracti32x4_epi32(x3, 3));
+
+	/* Reduction 128 -> 32, the remaining bytes are less than 64 */
+	fold = crcr32_reduce_128_to_64(fold, sse_params->rk5_rk6);
+	crc = crcr32_reduce_64_to_32(fold, sse_params->rk7_rk8);
+	if (n < data_len)
+		crc = crc32_eth_calc_pclmulqdq(&data[n], data_len - n, crc,
+			sse_params);
+
+	return crc;
+}
+
+void
+rte_net_crc_avx512_init(void)
+{
+	/* tail and short buffers use the 128-bit folding */
+	rte_net_crc_sse42_init();
+
+	crc_vpclmulqdq_ctx_init(&crc32_eth_vpclmulqdq,
+		CRC32_ETH_POLYNOMIAL, 32);
+	crc_vpclmulqdq_ctx_init(&crc16_ccitt_vpclmulqdq,
+		CRC16_CCITT_POLYNOMIAL, 16);
+}
+
+uint32_t
+rte_crc16_ccitt_avx512_update(const uint8_t *data, uint32_t data_len,
+	uint32_t crc)
+{
+	return crc32_eth_calc_vpclmulqdq(data,
+		data_len,
+		crc,
+		&crc16_ccitt_vpclmulqdq,
+		&crc16_ccitt_pclmulqdq);
+}
+
+uint32_t
+rte_crc32_eth_avx512_update(const uint8_t *data, uint32_t data_len,
+	uint32_t crc)
+{
+	return crc32_eth_calc_vpclmulqdq(data,
+		data_len,
+		crc,
+		&crc32_eth_vpclmulqdq,
+		&crc32_eth_pclmulqdq);
+}
+
+uint32_t
+rte_crc16_ccitt_avx512_handler(const uint8_t *data, uint32_t data_len)
+{
+	/* return 16-bit CRC value */
+	return (uint16_t)~rte_crc16_ccitt_avx512_update(data,
+		data_len,
+		0xffff);
+}
+
+uint32_t
+rte_crc32_eth_avx512_handler(const uint8_t *data, uint32_t data_len)
+{
+	/* return 32-bit CRC value */
+	return ~rte_crc32_eth_avx512_update(data,
+		data_len,
+		0xffffffffUL);
+}
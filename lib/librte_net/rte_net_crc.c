@@ -8,10 +8,15 @@
 
 #include <rte_cpuflags.h>
 #include <rte_common.h>
+#include <rte_mbuf.h>
+#include <rte_prefetch.h>
 #include <rte_net_crc.h>
 
 #if defined(RTE_ARCH_X86_64) && defined(RTE_MACHINE_CPUFLAG_PCLMULQDQ)
 #define X86_64_SSE42_PCLMULQDQ     1
+#if defined(CC_AVX512_SUPPORT)
+#define X86_64_AVX512_VPCLMULQDQ   1
+#endif
 #elif defined(RTE_ARCH_ARM64) && defined(RTE_MACHINE_CPUFLAG_PMULL)
 #define ARM64_NEON_PMULL           1
 #endif
@@ -22,6 +27,10 @@
 #include <net_crc_neon.h>
 #endif
 
+#ifdef X86_64_AVX512_VPCLMULQDQ
+#include "net_crc.h"
+#endif
+
 /** CRC polynomials */
 #define CRC32_ETH_POLYNOMIAL 0x04c11db7UL
 #define CRC16_CCITT_POLYNOMIAL 0x1021U
@@ -38,26 +47,108 @@ rte_crc16_ccitt_handler(const uint8_t *data, uint32_t data_len);
 static uint32_t
 rte_crc32_eth_handler(const uint8_t *data, uint32_t data_len);
 
+static uint32_t
+rte_crc16_ccitt_update(const uint8_t *data, uint32_t data_len, uint32_t crc);
+
+static uint32_t
+rte_crc32_eth_update(const uint8_t *data, uint32_t data_len, uint32_t crc);
+
 typedef uint32_t
 (*rte_net_crc_handler)(const uint8_t *data, uint32_t data_len);
 
+/* Takes and returns the CRC value before its final inversion */
+typedef uint32_t
+(*rte_net_crc_update_handler)(const uint8_t *data, uint32_t data_len,
+	uint32_t crc);
+
 static rte_net_crc_handler *handlers;
+static rte_net_crc_update_handler *update_handlers;
+
+/* CRC initial values, also used to mask the final inversion */
+static const uint32_t crc_init_val[] = {
+	[RTE_NET_CRC16_CCITT] = 0xffff,
+	[RTE_NET_CRC32_ETH] = 0xffffffffUL,
+};
 
 static rte_net_crc_handler handlers_scalar[] = {
 	[RTE_NET_CRC16_CCITT] = rte_crc16_ccitt_handler,
 	[RTE_NET_CRC32_ETH] = rte_crc32_eth_handler,
 };
 
+static rte_net_crc_update_handler update_handlers_scalar[] = {
+	[RTE_NET_CRC16_CCITT] = rte_crc16_ccitt_update,
+	[RTE_NET_CRC32_ETH] = rte_crc32_eth_update,
+};
+
 #ifdef X86_64_SSE42_PCLMULQDQ
+static uint32_t
+rte_crc16_ccitt_sse42_update(const uint8_t *data, uint32_t data_len,
+	uint32_t crc)
+{
+	return crc32_eth_calc_pclmulqdq(data, data_len, crc,
+		&crc16_ccitt_pclmulqdq);
+}
+
+static uint32_t
+rte_crc32_eth_sse42_update(const uint8_t *data, uint32_t data_len,
+	uint32_t crc)
+{
+	return crc32_eth_calc_pclmulqdq(data, data_len, crc,
+		&crc32_eth_pclmulqdq);
+}
+
 static rte_net_crc_handler handlers_sse42[] = {
 	[RTE_NET_CRC16_CCITT] = rte_crc16_ccitt_sse42_handler,
 	[RTE_NET_CRC32_ETH] = rte_crc32_eth_sse42_handler,
 };
+
+static rte_net_crc_update_handler update_handlers_sse42[] = {
+	[RTE_NET_CRC16_CCITT] = rte_crc16_ccitt_sse42_update,
+	[RTE_NET_CRC32_ETH] = rte_crc32_eth_sse42_update,
+};
+
+#ifdef X86_64_AVX512_VPCLMULQDQ
+static rte_net_crc_handler handlers_avx512[] = {
+	[RTE_NET_CRC16_CCITT] = rte_crc16_ccitt_avx512_handler,
+	[RTE_NET_CRC32_ETH] = rte_crc32_eth_avx512_handler,
+};
+
+static rte_net_crc_update_handler update_handlers_avx512[] = {
+	[RTE_NET_CRC16_CCITT] = rte_crc16_ccitt_avx512_update,
+	[RTE_NET_CRC32_ETH] = rte_crc32_eth_avx512_update,
+};
+
+static int
+avx512_vpclmulqdq_cpu_supported(void)
+{
+	return rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) &&
+		rte_cpu_get_flag_enabled(RTE_CPUFLAG_VPCLMULQDQ);
+}
+#endif
 #elif defined ARM64_NEON_PMULL
+static uint32_t
+rte_crc16_ccitt_neon_update(const uint8_t *data, uint32_t data_len,
+	uint32_t crc)
+{
+	return crc32_eth_calc_pmull(data, data_len, crc, &crc16_ccitt_pmull);
+}
+
+static uint32_t
+rte_crc32_eth_neon_update(const uint8_t *data, uint32_t data_len,
+	uint32_t crc)
+{
+	return crc32_eth_calc_pmull(data, data_len, crc, &crc32_eth_pmull);
+}
+
 static rte_net_crc_handler handlers_neon[] = {
 	[RTE_NET_CRC16_CCITT] = rte_crc16_ccitt_neon_handler,
 	[RTE_NET_CRC32_ETH] = rte_crc32_eth_neon_handler,
 };
+
+static rte_net_crc_update_handler update_handlers_neon[] = {
+	[RTE_NET_CRC16_CCITT] = rte_crc16_ccitt_neon_update,
+	[RTE_NET_CRC32_ETH] = rte_crc32_eth_neon_update,
+};
 #endif
 
 /**
@@ -142,19 +233,42 @@ rte_crc32_eth_handler(const uint8_t *data, uint32_t data_len)
 		crc32_eth_lut);
 }
 
+static uint32_t
+rte_crc16_ccitt_update(const uint8_t *data, uint32_t data_len, uint32_t crc)
+{
+	return crc32_eth_calc_lut(data, data_len, crc, crc16_ccitt_lut);
+}
+
+static uint32_t
+rte_crc32_eth_update(const uint8_t *data, uint32_t data_len, uint32_t crc)
+{
+	return crc32_eth_calc_lut(data, data_len, crc, crc32_eth_lut);
+}
+
 void
 rte_net_crc_set_alg(enum rte_net_crc_alg alg)
 {
 	switch (alg) {
 #ifdef X86_64_SSE42_PCLMULQDQ
+	case RTE_NET_CRC_AVX512:
+#ifdef X86_64_AVX512_VPCLMULQDQ
+		if (avx512_vpclmulqdq_cpu_supported()) {
+			handlers = handlers_avx512;
+			update_handlers = update_handlers_avx512;
+			break;
+		}
+#endif
+		/* fall-through */
 	case RTE_NET_CRC_SSE42:
 		handlers = handlers_sse42;
+		update_handlers = update_handlers_sse42;
 		break;
 #elif defined ARM64_NEON_PMULL
 		/* fall-through */
 	case RTE_NET_CRC_NEON:
 		if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_PMULL)) {
 			handlers = handlers_neon;
+			update_handlers = update_handlers_neon;
 			break;
 		}
 #endif
@@ -163,6 +277,7 @@ rte_net_crc_set_alg(enum rte_net_crc_alg alg)
 		/* fall-through */
 	default:
 		handlers = handlers_scalar;
+		update_handlers = update_handlers_scalar;
 		break;
 	}
 }
@@ -181,6 +296,46 @@ rte_net_crc_calc(const void *data,
 	return ret;
 }
 
+uint16_t
+rte_net_crc_calc_mbufs(struct rte_mbuf **mbufs,
+	uint16_t nb_mbufs,
+	uint32_t offset,
+	uint32_t *crcs,
+	enum rte_net_crc_type type)
+{
+	rte_net_crc_update_handler f_update;
+	const struct rte_mbuf *seg;
+	uint32_t crc, off;
+	uint16_t i;
+
+	f_update = update_handlers[type];
+
+	for (i = 0; i < nb_mbufs; i++) {
+		if (unlikely(mbufs[i]->pkt_len < offset))
+			break;
+
+		if (i + 1 < nb_mbufs)
+			rte_prefetch0(rte_pktmbuf_mtod(mbufs[i + 1], void *));
+
+		crc = crc_init_val[type];
+		off = offset;
+		for (seg = mbufs[i]; seg != NULL; seg = seg->next) {
+			if (off >= seg->data_len) {
+				off -= seg->data_len;
+				continue;
+			}
+			crc = f_update(rte_pktmbuf_mtod_offset(seg,
+					const uint8_t *, off),
+				seg->data_len - off, crc);
+			off = 0;
+		}
+
+		crcs[i] = ~crc & crc_init_val[type];
+	}
+
+	return i;
+}
+
 /* Select highest available crc algorithm as default one */
 RTE_INIT(rte_net_crc_init)
 {
@@ -191,6 +346,12 @@ RTE_INIT(rte_net_crc_init)
 #ifdef X86_64_SSE42_PCLMULQDQ
 	alg = RTE_NET_CRC_SSE42;
 	rte_net_crc_sse42_init();
+#ifdef X86_64_AVX512_VPCLMULQDQ
+	if (avx512_vpclmulqdq_cpu_supported()) {
+		alg = RTE_NET_CRC_AVX512;
+		rte_net_crc_avx512_init();
+	}
+#endif
 #elif defined ARM64_NEON_PMULL
 	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_PMULL)) {
 		alg = RTE_NET_CRC_NEON;
@@ -7,6 +7,8 @@
 
 #include <stdint.h>
 
+#include <rte_compat.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -23,18 +25,26 @@ enum rte_net_crc_alg {
 	RTE_NET_CRC_SCALAR = 0,
 	RTE_NET_CRC_SSE42,
 	RTE_NET_CRC_NEON,
+	RTE_NET_CRC_AVX512,
 };
 
+struct rte_mbuf;
+
 /**
  * This API set the CRC computation algorithm (i.e. scalar version,
  * x86 64-bit sse4.2 intrinsic version, etc.) and internal data
  * structure.
  *
+ * If the requested algorithm isn't supported by the CPU, the best
+ * available one is used instead: AVX512 falls back to SSE4.2, and any
+ * algorithm falls back to the scalar version.
+ *
  * @param alg
  *   This parameter is used to select the CRC implementation version.
  *   - RTE_NET_CRC_SCALAR
  *   - RTE_NET_CRC_SSE42 (Use 64-bit SSE4.2 intrinsic)
  *   - RTE_NET_CRC_NEON (Use ARM Neon intrinsic)
+ *   - RTE_NET_CRC_AVX512 (Use 512-bit AVX512 VPCLMULQDQ intrinsic)
  */
 void
 rte_net_crc_set_alg(enum rte_net_crc_alg alg);
@@ -57,6 +67,39 @@ rte_net_crc_calc(const void *data,
 	uint32_t data_len,
 	enum rte_net_crc_type type);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * CRC compute API for a burst of packets
+ *
+ * The CRC of each packet is computed over its data from the given offset
+ * to its end, which may span several segments.
+ *
+ * @param mbufs
+ *   Array of packets for CRC computation
+ * @param nb_mbufs
+ *   Number of packets in the array
+ * @param offset
+ *   Offset in each packet of the first byte of CRC computation
+ * @param crcs
+ *   Array of at least nb_mbufs items, filled with the CRC values
+ * @param type
+ *   CRC type (enum rte_net_crc_type)
+ *
+ * @return
+ *   Number of CRC values filled in crcs. It is lower than nb_mbufs if a
+ *   packet is shorter than offset; the CRC of this packet and of the
+ *   following ones isn't computed.
+ */
+__rte_experimental
+uint16_t
+rte_net_crc_calc_mbufs(struct rte_mbuf **mbufs,
+	uint16_t nb_mbufs,
+	uint32_t offset,
+	uint32_t *crcs,
+	enum rte_net_crc_type type);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,246 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2020 Marvell International Ltd.
+ */
+
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include <rte_debug.h>
+#include <rte_ethdev.h>
+#include <rte_ether.h>
+#include <rte_fib6.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_ip.h>
+#include <rte_mbuf.h>
+
+#include "rte_node_ip6_api.h"
+
+#include "node_private.h"
+
+#define IPV6_L3FWD_FIB_MAX_RULES 1024
+#define IPV6_L3FWD_FIB_NUMBER_TBL8S (1 << 8)
+#define IPV6_L3FWD_FIB_NAMESIZE 64
+
+/* Number of destination addresses looked up at once */
+#define IP6_LOOKUP_BULK 32
+
+/* IP6 Lookup global data struct */
+struct ip6_lookup_node_main {
+	struct rte_fib6 *fib_tbl[RTE_MAX_NUMA_NODES];
+};
+
+static struct ip6_lookup_node_main ip6_lookup_nm;
+
+/* IP6 Lookup node context */
+struct ip6_lookup_node_ctx {
+	/* Socket FIB of the graph, NULL until a route is added */
+	struct rte_fib6 **fib6;
+};
+
+static uint16_t
+ip6_lookup_node_process(struct rte_graph *graph, struct rte_node *node,
+			void **objs, uint16_t nb_objs)
+{
+	uint8_t ips[IP6_LOOKUP_BULK][RTE_FIB6_IPV6_ADDR_SIZE];
+	uint64_t next_hops[IP6_LOOKUP_BULK];
+	struct rte_ipv6_hdr *ipv6_hdr;
+	struct rte_mbuf *mbuf, **pkts;
+	uint16_t n_left_from, n, i;
+	void **to_next, **from;
+	uint16_t last_spec = 0;
+	rte_edge_t next_index;
+	struct rte_fib6 *fib6;
+	uint16_t held = 0;
+
+	/* Speculative next */
+	next_index = RTE_NODE_IP6_LOOKUP_NEXT_REWRITE;
+
+	/* Get socket specific FIB from ctx */
+	fib6 = __atomic_load_n(((struct ip6_lookup_node_ctx *)node->ctx)->fib6,
+			       __ATOMIC_ACQUIRE);
+	if (unlikely(fib6 == NULL)) {
+		/* No route */
+		rte_node_next_stream_move(graph, node,
+					  RTE_NODE_IP6_LOOKUP_NEXT_PKT_DROP);
+		return nb_objs;
+	}
+	pkts = (struct rte_mbuf **)objs;
+	from = objs;
+	n_left_from = nb_objs;
+
+	for (i = OBJS_PER_CLINE; i < RTE_GRAPH_BURST_SIZE; i += OBJS_PER_CLINE)
+		rte_prefetch0(&objs[i]);
+
+	/* Get stream for the speculated next node */
+	to_next = rte_node_next_stream_get(graph, node, next_index, nb_objs);
+	while (n_left_from > 0) {
+		n = RTE_MIN(n_left_from, (uint16_t)IP6_LOOKUP_BULK);
+
+		for (i = 0; i < n; i++)
+			rte_prefetch0(pkts[i]);
+
+		/* Gather the DIPs of the chunk for a single bulk lookup */
+		for (i = 0; i < n; i++) {
+			mbuf = pkts[i];
+			if (likely(i + 1 < n))
+				rte_prefetch0(rte_pktmbuf_mtod_offset(pkts[i + 1],
+					void *, sizeof(struct rte_ether_hdr)));
+
+			ipv6_hdr = rte_pktmbuf_mtod_offset(mbuf,
+					struct rte_ipv6_hdr *,
+					sizeof(struct rte_ether_hdr));
+			/* Extract hop limit as ipv6 hdr is in cache */
+			node_mbuf_priv1(mbuf)->ttl = ipv6_hdr->hop_limits;
+			memcpy(ips[i], ipv6_hdr->dst_addr, sizeof(ips[i]));
+		}
+
+		/* A miss returns the default next hop, to the drop node */
+		rte_fib6_lookup_bulk(fib6, ips, next_hops, n);
+
+		for (i = 0; i < n; i++) {
+			uint32_t next_hop;
+			uint16_t next;
+
+			next_hop = (uint32_t)next_hops[i];
+			node_mbuf_priv1(pkts[i])->nh = (uint16_t)next_hop;
+			next_hop = next_hop >> 16;
+			next = (uint16_t)next_hop;
+
+			if (unlikely(next_index != next)) {
+				/* Copy things successfully speculated till now */
+				rte_memcpy(to_next, from,
+					   last_spec * sizeof(from[0]));
+				from += last_spec;
+				to_next += last_spec;
+				held += last_spec;
+				last_spec = 0;
+
+				rte_node_enqueue_x1(graph, node, next, from[0]);
+				from += 1;
+			} else {
+				last_spec += 1;
+			}
+		}
+
+		pkts += n;
+		n_left_from -= n;
+	}
+
+	/* !!! Home run !!! */
+	if (likely(last_spec == nb_objs)) {
+		rte_node_next_stream_move(graph, node, next_index);
+		return nb_objs;
+	}
+	held += last_spec;
+	rte_memcpy(to_next, from, last_spec * sizeof(from[0]));
+	rte_node_next_stream_put(graph, node, next_index, held);
+
+	return nb_objs;
+}
+
+static int
+setup_fib6(struct ip6_lookup_node_main *nm, int socket)
+{
+	struct rte_fib6_conf config_ipv6;
+	char s[IPV6_L3FWD_FIB_NAMESIZE];
+	struct rte_fib6 *fib6;
+
+	/* One FIB per socket */
+	if (nm->fib_tbl[socket])
+		return 0;
+
+	/* create the FIB, misses go to the drop node */
+	memset(&config_ipv6, 0, sizeof(config_ipv6));
+	config_ipv6.type = RTE_FIB6_TRIE;
+	config_ipv6.default_nh =
+		((uint64_t)RTE_NODE_IP6_LOOKUP_NEXT_PKT_DROP) << 16;
+	config_ipv6.max_routes = IPV6_L3FWD_FIB_MAX_RULES;
+	config_ipv6.trie.nh_sz = RTE_FIB6_TRIE_4B;
+	config_ipv6.trie.num_tbl8 = IPV6_L3FWD_FIB_NUMBER_TBL8S;
+	snprintf(s, sizeof(s), "IPV6_L3FWD_FIB_%d", socket);
+	fib6 = rte_fib6_create(s, socket, &config_ipv6);
+	if (fib6 == NULL)
+		return -rte_errno;
+	/* Vector lookup when supported by the build and the CPU */
+	if (rte_fib6_set_lookup_fn(fib6, RTE_FIB6_TRIE_ANY) != 0) {
+		rte_fib6_free(fib6);
+		return -EINVAL;
+	}
+	/* Published to the graphs of the socket */
+	__atomic_store_n(&nm->fib_tbl[socket], fib6, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+int
+rte_node_ip6_route_add(const uint8_t *ip, uint8_t depth, uint16_t next_hop,
+		       enum rte_node_ip6_lookup_next next_node)
+{
+	char abuf[INET6_ADDRSTRLEN];
+	unsigned int lcore_id;
+	uint8_t socket;
+	uint32_t val;
+	int ret;
+
+	inet_ntop(AF_INET6, ip, abuf, sizeof(abuf));
+	/* Embedded next node id into 21 bit FIB6 next hop */
+	val = ((next_node << 16) | next_hop) & ((1ull << 21) - 1);
+	node_dbg("ip6_lookup", "FIB: Adding route %s / %d nh (0x%x)", abuf,
+		 depth, val);
+
+	/* The FIBs of the sockets are created by the first route */
+	RTE_LCORE_FOREACH(lcore_id) {
+		socket = rte_lcore_to_socket_id(lcore_id);
+		ret = setup_fib6(&ip6_lookup_nm, socket);
+		if (ret) {
+			node_err("ip6_lookup",
+				 "Failed to setup fib6 for sock %u, rc=%d",
+				 socket, ret);
+			return ret;
+		}
+	}
+
+	for (socket = 0; socket < RTE_MAX_NUMA_NODES; socket++) {
+		if (!ip6_lookup_nm.fib_tbl[socket])
+			continue;
+
+		ret = rte_fib6_add(ip6_lookup_nm.fib_tbl[socket],
+				   ip, depth, val);
+		if (ret < 0) {
+			node_err("ip6_lookup",
+				 "Unable to add entry %s / %d nh (%x) to FIB on sock %d, rc=%d\n",
+				 abuf, depth, val, socket, ret);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+static int
+ip6_lookup_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	struct ip6_lookup_node_ctx *ctx = (struct ip6_lookup_node_ctx *)node->ctx;
+
+	/* The FIB is created by the first route added */
+	ctx->fib6 = &ip6_lookup_nm.fib_tbl[graph->socket];
+	node_dbg("ip6_lookup", "Initialized ip6_lookup node");
+
+	return 0;
+}
+
+static struct rte_node_register ip6_lookup_node = {
+	.process = ip6_lookup_node_process,
+	.name = "ip6_lookup",
+
+	.init = ip6_lookup_node_init,
+
+	.nb_edges = RTE_NODE_IP6_LOOKUP_NEXT_MAX,
+	.next_nodes = {
+		[RTE_NODE_IP6_LOOKUP_NEXT_REWRITE] = "ip6_rewrite",
+		[RTE_NODE_IP6_LOOKUP_NEXT_PKT_DROP] = "pkt_drop",
+	},
+};
+
+RTE_NODE_REGISTER(ip6_lookup_node);
@@ -23,10 +23,11 @@ extern int rte_node_logtype;
 /**
  *
  * Node mbuf private data to store next hop, ttl and checksum.
+ * The ttl holds the hop limit of the ipv6 packets.
  */
 struct node_mbuf_priv1 {
 	union {
-		/* IP4 rewrite */
+		/* IP4/IP6 rewrite */
 		struct {
 			uint16_t nh;
 			uint16_t ttl;
@@ -4,6 +4,7 @@
 
 #include <rte_memcpy.h>
 #include <rte_mbuf.h>
+#include <rte_bpf.h>
 #include <rte_ethdev.h>
 #include <rte_lcore.h>
 #include <rte_log.h>
@@ -30,7 +31,8 @@ enum pdump_operation {
 };
 
 enum pdump_version {
-	V1 = 1
+	V1 = 1,
+	V2 = 2
 };
 
 struct pdump_request {
@@ -45,6 +47,16 @@ struct pdump_request {
 			struct rte_mempool *mp;
 			void *filter;
 		} en_v1;
+		struct enable_v2 {
+			char device[DEVICE_ID_SIZE];
+			uint16_t queue;
+			struct rte_ring *ring;
+			struct rte_mempool *mp;
+			uint32_t sample_mode;
+			uint32_t sample_rate;
+			uint32_t snaplen;
+			const struct rte_bpf_prm *prm;
+		} en_v2;
 		struct disable_v1 {
 			char device[DEVICE_ID_SIZE];
 			uint16_t queue;
@@ -61,14 +73,105 @@ struct pdump_response {
 	int32_t err_value;
 };
 
+/* sampling parameters of a capture request */
+struct pdump_sample {
+	uint32_t mode;
+	uint32_t rate;
+	uint32_t snaplen;
+	const struct rte_bpf_prm *prm;
+};
+
 static struct pdump_rxtx_cbs {
 	struct rte_ring *ring;
 	struct rte_mempool *mp;
 	const struct rte_eth_rxtx_callback *cb;
 	void *filter;
+	/* packet selection, only done if sampled is set */
+	bool sampled;
+	bool bpf_mbuf;
+	struct rte_bpf *bpf;
+	struct rte_bpf_jit jit;
+	uint32_t sample_mode;
+	uint32_t sample_rate;
+	uint32_t sample_left;
+	uint64_t sample_threshold;
+	uint32_t snaplen;
 } rx_cbs[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT],
 tx_cbs[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT];
 
+/* check whether the flow of a packet is sampled */
+static inline int
+pdump_flow_sampled(const struct pdump_rxtx_cbs *cbs, const struct rte_mbuf *m)
+{
+	uint32_t h;
+
+	if ((m->ol_flags & PKT_RX_RSS_HASH) == 0)
+		return 0;
+	/*
+	 * The low bits of the RSS hash select the queue, they are the same
+	 * for all the packets of a queue: mix all the bits before comparing.
+	 */
+	h = ((uint64_t)m->hash.rss * 0x9e3779b97f4a7c15ULL) >> 32;
+	return h < cbs->sample_threshold;
+}
+
+/*
+ * Select the packets to capture: sample the flows, run the filter and
+ * sample the packets matching it. Cheapest checks first.
+ */
+static inline uint16_t
+pdump_select(struct pdump_rxtx_cbs *cbs, struct rte_mbuf **pkts,
+	uint16_t nb_pkts, struct rte_mbuf **sel)
+{
+	uint16_t i, n = 0;
+
+	if (cbs->sample_mode == RTE_PDUMP_SAMPLE_FLOW_HASH &&
+			cbs->sample_rate > 1) {
+		for (i = 0; i < nb_pkts; i++) {
+			if (pdump_flow_sampled(cbs, pkts[i]))
+				sel[n++] = pkts[i];
+		}
+	} else {
+		for (i = 0; i < nb_pkts; i++)
+			sel[n++] = pkts[i];
+	}
+
+	if (cbs->bpf != NULL && n != 0) {
+		uint64_t rc[n];
+		void *ctx[n];
+		uint16_t j = 0;
+
+		for (i = 0; i < n; i++)
+			ctx[i] = cbs->bpf_mbuf ? (void *)sel[i] :
+				rte_pktmbuf_mtod(sel[i], void *);
+		if (cbs->jit.func != NULL) {
+			for (i = 0; i < n; i++)
+				rc[i] = cbs->jit.func(ctx[i]);
+		} else
+			rte_bpf_exec_burst(cbs->bpf, ctx, rc, n);
+		for (i = 0; i < n; i++) {
+			if (rc[i] != 0)
+				sel[j++] = sel[i];
+		}
+		n = j;
+	}
+
+	if (cbs->sample_mode == RTE_PDUMP_SAMPLE_COUNT &&
+			cbs->sample_rate > 1) {
+		uint16_t j = 0;
+
+		/* only the lcore polling the queue updates the count */
+		for (i = 0; i < n; i++) {
+			if (--cbs->sample_left == 0) {
+				cbs->sample_left = cbs->sample_rate;
+				sel[j++] = sel[i];
+			}
+		}
+		n = j;
+	}
+
+	return n;
+}
 
 static inline void
 pdump_copy(struct rte_mbuf **pkts, uint16_t nb_pkts, void *user_params)
@@ -77,6 +180,7 @@ pdump_copy(struct rte_mbuf **pkts, uint16_t nb_pkts, void *user_params)
 	int ring_enq;
 	uint16_t d_pkts = 0;
 	struct rte_mbuf *dup_bufs[nb_pkts];
+	struct rte_mbuf *sel_bufs[nb_pkts];
 	struct pdump_rxtx_cbs *cbs;
 	struct rte_ring *ring;
 	struct rte_mempool *mp;
@@ -85,8 +189,13 @@ pdump_copy(struct rte_mbuf **pkts, uint16_t nb_pkts, void *user_params)
 	cbs  = user_params;
 	ring = cbs->ring;
 	mp = cbs->mp;
+	if (cbs->sampled) {
+		nb_pkts = pdump_select(cbs, pkts, nb_pkts, sel_bufs);
+		pkts = sel_bufs;
+	}
+	/* truncate before the copy, only the captured bytes are copied */
 	for (i = 0; i < nb_pkts; i++) {
-		p = rte_pktmbuf_copy(pkts[i], mp, 0, UINT32_MAX);
+		p = rte_pktmbuf_copy(pkts[i], mp, 0, cbs->snaplen);
 		if (p)
 			dup_bufs[d_pkts++] = p;
 	}
@@ -119,9 +228,46 @@ pdump_tx(uint16_t port __rte_unused, uint16_t qidx __rte_unused,
 	return nb_pkts;
 }
 
+/* set up the packet selection of a queue capture */
+static int
+pdump_sample_setup(struct pdump_rxtx_cbs *cbs,
+	const struct pdump_sample *sample)
+{
+	/*
+	 * The filter of a previous capture on this queue was kept when it
+	 * was disabled, as its callback could still be running then.
+	 */
+	rte_bpf_destroy(cbs->bpf);
+	cbs->bpf = NULL;
+	memset(&cbs->jit, 0, sizeof(cbs->jit));
+
+	if (sample->prm != NULL) {
+		cbs->bpf = rte_bpf_load(sample->prm);
+		if (cbs->bpf == NULL) {
+			PDUMP_LOG(ERR, "failed to load filter, errno=%d\n",
+				rte_errno);
+			return -rte_errno;
+		}
+		rte_bpf_get_jit(cbs->bpf, &cbs->jit);
+		cbs->bpf_mbuf = sample->prm->prog_arg.type ==
+			RTE_BPF_ARG_PTR_MBUF;
+	}
+
+	cbs->sample_mode = sample->mode;
+	cbs->sample_rate = sample->rate;
+	cbs->sample_left = 1;
+	if (sample->rate > 1)
+		cbs->sample_threshold = (UINT64_C(1) << 32) / sample->rate;
+	cbs->snaplen = sample->snaplen == 0 ? UINT32_MAX : sample->snaplen;
+	cbs->sampled = cbs->bpf != NULL || sample->rate > 1;
+
+	return 0;
+}
+
 static int
 pdump_register_rx_callbacks(uint16_t end_q, uint16_t port, uint16_t queue,
 				struct rte_ring *ring, struct rte_mempool *mp,
+				const struct pdump_sample *sample,
 				uint16_t operation)
 {
 	uint16_t qid;
@@ -131,6 +277,8 @@ pdump_register_rx_callbacks(uint16_t end_q, uint16_t port, uint16_t queue,
 	for (; qid < end_q; qid++) {
 		cbs = &rx_cbs[port][qid];
 		if (cbs && operation == ENABLE) {
+			int ret;
+
 			if (cbs->cb) {
 				PDUMP_LOG(ERR,
 					"failed to add rx callback for port=%d "
@@ -138,6 +286,9 @@ pdump_register_rx_callbacks(uint16_t end_q, uint16_t port, uint16_t queue,
 					port, qid);
 				return -EEXIST;
 			}
+			ret = pdump_sample_setup(cbs, sample);
+			if (ret < 0)
+				return ret;
 			cbs->ring = ring;
 			cbs->mp = mp;
 			cbs->cb = rte_eth_add_first_rx_callback(port, qid,
@@ -176,6 +327,7 @@ pdump_register_rx_callbacks(uint16_t end_q, uint16_t port, uint16_t queue,
 static int
 pdump_register_tx_callbacks(uint16_t end_q, uint16_t port, uint16_t queue,
 				struct rte_ring *ring, struct rte_mempool *mp,
+				const struct pdump_sample *sample,
 				uint16_t operation)
 {
 
@@ -186,6 +338,8 @@ pdump_register_tx_callbacks(uint16_t end_q, uint16_t port, uint16_t queue,
 	for (; qid < end_q; qid++) {
 		cbs = &tx_cbs[port][qid];
 		if (cbs && operation == ENABLE) {
+			int ret;
+
 			if (cbs->cb) {
 				PDUMP_LOG(ERR,
 					"failed to add tx callback for port=%d "
@@ -193,6 +347,9 @@ pdump_register_tx_callbacks(uint16_t end_q, uint16_t port, uint16_t queue,
 					port, qid);
 				return -EEXIST;
 			}
+			ret = pdump_sample_setup(cbs, sample);
+			if (ret < 0)
+				return ret;
 			cbs->ring = ring;
 			cbs->mp = mp;
 			cbs->cb = rte_eth_add_tx_callback(port, qid, pdump_tx,
@@ -238,10 +395,29 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 	uint16_t operation;
 	struct rte_ring *ring;
 	struct rte_mempool *mp;
+	struct pdump_sample sample = {
+		.mode = RTE_PDUMP_SAMPLE_COUNT,
+	};
 
 	flags = p->flags;
 	operation = p->op;
-	if (operation == ENABLE) {
+	if (operation == ENABLE && p->ver == V2) {
+		ret = rte_eth_dev_get_port_by_name(p->data.en_v2.device,
+				&port);
+		if (ret < 0) {
+			PDUMP_LOG(ERR,
+				"failed to get port id for device id=%s\n",
+				p->data.en_v2.device);
+			return -EINVAL;
+		}
+		queue = p->data.en_v2.queue;
+		ring = p->data.en_v2.ring;
+		mp = p->data.en_v2.mp;
+		sample.mode = p->data.en_v2.sample_mode;
+		sample.rate = p->data.en_v2.sample_rate;
+		sample.snaplen = p->data.en_v2.snaplen;
+		sample.prm = p->data.en_v2.prm;
+	} else if (operation == ENABLE) {
 		ret = rte_eth_dev_get_port_by_name(p->data.en_v1.device,
 				&port);
 		if (ret < 0) {
@@ -303,7 +479,7 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 	if (flags & RTE_PDUMP_FLAG_RX) {
 		end_q = (queue == RTE_PDUMP_ALL_QUEUES) ? nb_rx_q : queue + 1;
 		ret = pdump_register_rx_callbacks(end_q, port, queue, ring, mp,
-							operation);
+							&sample, operation);
 		if (ret < 0)
 			return ret;
 	}
@@ -312,7 +488,7 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 	if (flags & RTE_PDUMP_FLAG_TX) {
 		end_q = (queue == RTE_PDUMP_ALL_QUEUES) ? nb_tx_q : queue + 1;
 		ret = pdump_register_tx_callbacks(end_q, port, queue, ring, mp,
-							operation);
+							&sample, operation);
 		if (ret < 0)
 			return ret;
 	}
@@ -427,13 +603,46 @@ pdump_validate_port(uint16_t port, char *name)
 	return 0;
 }
 
+static int
+pdump_validate_sample(const struct rte_pdump_sample_conf *conf)
+{
+	if (conf == NULL) {
+		PDUMP_LOG(ERR, "NULL sample configuration\n");
+		rte_errno = EINVAL;
+		return -1;
+	}
+	if (conf->mode != RTE_PDUMP_SAMPLE_COUNT &&
+			conf->mode != RTE_PDUMP_SAMPLE_FLOW_HASH) {
+		PDUMP_LOG(ERR, "invalid sample mode %d\n", conf->mode);
+		rte_errno = EINVAL;
+		return -1;
+	}
+	if (conf->prm != NULL &&
+			conf->prm->prog_arg.type != RTE_BPF_ARG_PTR &&
+			conf->prm->prog_arg.type != RTE_BPF_ARG_PTR_MBUF) {
+		PDUMP_LOG(ERR, "invalid filter argument type, should be "
+			"either packet data or mbuf pointer\n");
+		rte_errno = EINVAL;
+		return -1;
+	}
+	if (conf->prm != NULL && conf->prm->nb_xsym != 0) {
+		PDUMP_LOG(ERR,
+			"filter cannot use external symbols\n");
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	return 0;
+}
+
 static int
 pdump_prepare_client_request(char *device, uint16_t queue,
 				uint32_t flags,
 				uint16_t operation,
 				struct rte_ring *ring,
 				struct rte_mempool *mp,
-				void *filter)
+				void *filter,
+				const struct rte_pdump_sample_conf *conf)
 {
 	int ret = -1;
 	struct rte_mp_msg mp_req, *mp_rep;
@@ -442,10 +651,20 @@ pdump_prepare_client_request(char *device, uint16_t queue,
 	struct pdump_request *req = (struct pdump_request *)mp_req.param;
 	struct pdump_response *resp;
 
-	req->ver = 1;
+	req->ver = conf != NULL ? V2 : V1;
 	req->flags = flags;
 	req->op = operation;
-	if ((operation & ENABLE) != 0) {
+	if ((operation & ENABLE) != 0 && conf != NULL) {
+		strlcpy(req->data.en_v2.device, device,
+			sizeof(req->data.en_v2.device));
+		req->data.en_v2.queue = queue;
+		req->data.en_v2.ring = ring;
+		req->data.en_v2.mp = mp;
+		req->data.en_v2.sample_mode = conf->mode;
+		req->data.en_v2.sample_rate = conf->rate;
+		req->data.en_v2.snaplen = conf->snaplen;
+		req->data.en_v2.prm = conf->prm;
+	} else if ((operation & ENABLE) != 0) {
 		strlcpy(req->data.en_v1.device, device,
 			sizeof(req->data.en_v1.device));
 		req->data.en_v1.queue = queue;
@@ -500,7 +719,7 @@ rte_pdump_enable(uint16_t port, uint16_t queue, uint32_t flags,
 		return ret;
 
 	ret = pdump_prepare_client_request(name, queue, flags,
-						ENABLE, ring, mp, filter);
+						ENABLE, ring, mp, filter, NULL);
 
 	return ret;
 }
@@ -522,7 +741,7 @@ rte_pdump_enable_by_deviceid(char *device_id, uint16_t queue,
 		return ret;
 
 	ret = pdump_prepare_client_request(device_id, queue, flags,
-						ENABLE, ring, mp, filter);
+						ENABLE, ring, mp, filter, NULL);
 
 	return ret;
 }
@@ -541,7 +760,7 @@ rte_pdump_disable(uint16_t port, uint16_t queue, uint32_t flags)
 		return ret;
 
 	ret = pdump_prepare_client_request(name, queue, flags,
-						DISABLE, NULL, NULL, NULL);
+						DISABLE, NULL, NULL, NULL, NULL);
 
 	return ret;
 }
@@ -557,7 +776,60 @@ rte_pdump_disable_by_deviceid(char *device_id, uint16_t queue,
 		return ret;
 
 	ret = pdump_prepare_client_request(device_id, queue, flags,
-						DISABLE, NULL, NULL, NULL);
+						DISABLE, NULL, NULL, NULL, NULL);
+
+	return ret;
+}
+
+int
+rte_pdump_enable_sample(uint16_t port, uint16_t queue, uint32_t flags,
+			const struct rte_pdump_sample_conf *conf,
+			struct rte_ring *ring,
+			struct rte_mempool *mp)
+{
+	int ret = 0;
+	char name[DEVICE_ID_SIZE];
+
+	ret = pdump_validate_port(port, name);
+	if (ret < 0)
+		return ret;
+	ret = pdump_validate_ring_mp(ring, mp);
+	if (ret < 0)
+		return ret;
+	ret = pdump_validate_flags(flags);
+	if (ret < 0)
+		return ret;
+	ret = pdump_validate_sample(conf);
+	if (ret < 0)
+		return ret;
+
+	ret = pdump_prepare_client_request(name, queue, flags,
+						ENABLE, ring, mp, NULL, conf);
+
+	return ret;
+}
+
+int
+rte_pdump_enable_sample_by_deviceid(char *device_id, uint16_t queue,
+				uint32_t flags,
+				const struct rte_pdump_sample_conf *conf,
+				struct rte_ring *ring,
+				struct rte_mempool *mp)
+{
+	int ret = 0;
+
+	ret = pdump_validate_ring_mp(ring, mp);
+	if (ret < 0)
+		return ret;
+	ret = pdump_validate_flags(flags);
+	if (ret < 0)
+		return ret;
+	ret = pdump_validate_sample(conf);
+	if (ret < 0)
+		return ret;
+
+	ret = pdump_prepare_client_request(device_id, queue, flags,
+						ENABLE, ring, mp, NULL, conf);
 
 	return ret;
 }
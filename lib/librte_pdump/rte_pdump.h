@@ -13,6 +13,7 @@
  */
 
 #include <stdint.h>
+#include <rte_compat.h>
 #include <rte_mempool.h>
 #include <rte_ring.h>
 
@@ -29,6 +30,50 @@ enum {
 	RTE_PDUMP_FLAG_RXTX = (RTE_PDUMP_FLAG_RX|RTE_PDUMP_FLAG_TX)
 };
 
+struct rte_bpf_prm;
+
+/**
+ * Packet sampling modes.
+ */
+enum rte_pdump_sample_mode {
+	/**
+	 * Capture one packet every rate packets matching the filter on
+	 * each queue.
+	 */
+	RTE_PDUMP_SAMPLE_COUNT,
+	/**
+	 * Capture all the packets of one flow every rate flows, selected by
+	 * the RSS hash of the mbuf. Packets without PKT_RX_RSS_HASH flag
+	 * are not captured.
+	 */
+	RTE_PDUMP_SAMPLE_FLOW_HASH,
+};
+
+/**
+ * Sampling configuration of a packet capture.
+ *
+ * The packets are selected, filtered and truncated in the data path
+ * before being copied, so that a capture only costs the copy of the
+ * sampled bytes.
+ */
+struct rte_pdump_sample_conf {
+	/** Sampling mode. */
+	enum rte_pdump_sample_mode mode;
+	/** Sample one packet or flow in rate, 0 or 1 to capture all. */
+	uint32_t rate;
+	/** Number of bytes copied from each packet, 0 for whole packets. */
+	uint32_t snaplen;
+	/**
+	 * BPF program filtering the packets to capture, or NULL.
+	 * The packets for which it returns 0 are not captured.
+	 * Its argument type must be RTE_BPF_ARG_PTR, the packet data, or
+	 * RTE_BPF_ARG_PTR_MBUF, the mbuf. The parameters and instructions
+	 * must be in memory shared with the primary process, e.g. allocated
+	 * with rte_malloc(), and the program cannot use external symbols.
+	 */
+	const struct rte_bpf_prm *prm;
+};
+
 /**
  * Initialize packet capturing handling
  *
@@ -153,6 +198,76 @@ int
 rte_pdump_disable_by_deviceid(char *device_id, uint16_t queue,
 				uint32_t flags);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enables sampled packet capturing on given port and queue.
+ *
+ * Packet capturing is disabled with rte_pdump_disable().
+ *
+ * @param port
+ *  port on which packet capturing should be enabled.
+ * @param queue
+ *  queue of a given port on which packet capturing should be enabled.
+ *  users should pass on value UINT16_MAX to enable packet capturing on all
+ *  queues of a given port.
+ * @param flags
+ *  flags specifies RTE_PDUMP_FLAG_RX/RTE_PDUMP_FLAG_TX/RTE_PDUMP_FLAG_RXTX
+ *  on which packet capturing should be enabled for a given port and queue.
+ * @param conf
+ *  sampling, filtering and truncation of the captured packets.
+ * @param ring
+ *  ring on which captured packets will be enqueued for user.
+ * @param mp
+ *  mempool on to which the captured packets will be copied.
+ *
+ * @return
+ *    0 on success, -1 on error, rte_errno is set accordingly.
+ */
+__rte_experimental
+int
+rte_pdump_enable_sample(uint16_t port, uint16_t queue, uint32_t flags,
+		const struct rte_pdump_sample_conf *conf,
+		struct rte_ring *ring,
+		struct rte_mempool *mp);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enables sampled packet capturing on given device id and queue.
+ * device_id can be name or pci address of device.
+ *
+ * Packet capturing is disabled with rte_pdump_disable_by_deviceid().
+ *
+ * @param device_id
+ *  device id on which packet capturing should be enabled.
+ * @param queue
+ *  queue of a given device id on which packet capturing should be enabled.
+ *  users should pass on value UINT16_MAX to enable packet capturing on all
+ *  queues of a given device id.
+ * @param flags
+ *  flags specifies RTE_PDUMP_FLAG_RX/RTE_PDUMP_FLAG_TX/RTE_PDUMP_FLAG_RXTX
+ *  on which packet capturing should be enabled for a given port and queue.
+ * @param conf
+ *  sampling, filtering and truncation of the captured packets.
+ * @param ring
+ *  ring on which captured packets will be enqueued for user.
+ * @param mp
+ *  mempool on to which the captured packets will be copied.
+ *
+ * @return
+ *    0 on success, -1 on error, rte_errno is set accordingly.
+ */
+__rte_experimental
+int
+rte_pdump_enable_sample_by_deviceid(char *device_id, uint16_t queue,
+		uint32_t flags,
+		const struct rte_pdump_sample_conf *conf,
+		struct rte_ring *ring,
+		struct rte_mempool *mp);
+
 #ifdef __cplusplus
 }
 #endif
@@ -47,6 +47,9 @@
  */
 #define RTE_SCHED_TIME_SHIFT		      8
 
+/* Port credits taken at once by a worker, in maximum sized packets */
+#define RTE_SCHED_WORKER_CREDITS_PKTS         32
+
 struct rte_sched_pipe_profile {
 	/* Token bucket (TB) */
 	uint64_t tb_period;
@@ -183,6 +186,9 @@ struct rte_sched_subport {
 	uint32_t pipe_loop;
 	uint32_t pipe_exhaustion;
 
+	/* Worker scheduling the subport */
+	struct rte_sched_port_worker *worker;
+
 	/* Bitmap */
 	struct rte_bitmap *bmp;
 	uint32_t grinder_base_bmp_pos[RTE_SCHED_PORT_N_GRINDERS] __rte_aligned_16;
@@ -204,6 +210,26 @@ struct rte_sched_subport {
 	uint8_t memory[0] __rte_cache_aligned;
 } __rte_cache_aligned;
 
+struct rte_sched_port_worker {
+	struct rte_sched_port *port;
+	uint32_t first_subport;
+	uint32_t n_subports;
+
+	/* Port credits left, only when sharing the port with other workers */
+	uint32_t shared;
+	uint64_t credits;
+
+	/* Timing */
+	uint64_t time_cpu_cycles;     /* Current CPU time measured in CPU cyles */
+	uint64_t time_cpu_bytes;      /* Current CPU time measured in bytes */
+	uint64_t time;                /* Current NIC TX time measured in bytes */
+
+	/* Grinders */
+	struct rte_mbuf **pkts_out;
+	uint32_t n_pkts_out;
+	uint32_t subport_id;
+} __rte_cache_aligned;
+
 struct rte_sched_port {
 	/* User parameters */
 	uint32_t n_subports_per_port;
@@ -218,16 +244,15 @@ struct rte_sched_port {
 	int socket;
 
 	/* Timing */
-	uint64_t time_cpu_cycles;     /* Current CPU time measured in CPU cyles */
-	uint64_t time_cpu_bytes;      /* Current CPU time measured in bytes */
-	uint64_t time;                /* Current NIC TX time measured in bytes */
 	struct rte_reciprocal inv_cycles_per_byte; /* CPU cycles per byte */
 	uint64_t cycles_per_byte;
 
-	/* Grinders */
-	struct rte_mbuf **pkts_out;
-	uint32_t n_pkts_out;
-	uint32_t subport_id;
+	/* Worker of the subports scheduled by rte_sched_port_dequeue() */
+	struct rte_sched_port_worker worker;
+
+	/* Workers sharing the port, theoretical arrival time of their credits */
+	uint32_t n_workers;
+	uint64_t worker_tat __rte_cache_aligned;
 
 	/* Large data structures */
 	struct rte_sched_subport *subports[0] __rte_cache_aligned;
@@ -846,9 +871,9 @@ rte_sched_port_config(struct rte_sched_port_params *params)
 	port->frame_overhead = params->frame_overhead;
 
 	/* Timing */
-	port->time_cpu_cycles = rte_get_tsc_cycles();
-	port->time_cpu_bytes = 0;
-	port->time = 0;
+	port->worker.time_cpu_cycles = rte_get_tsc_cycles();
+	port->worker.time_cpu_bytes = 0;
+	port->worker.time = 0;
 
 	cycles_per_byte = (rte_get_tsc_hz() << RTE_SCHED_TIME_SHIFT)
 		/ params->rate;
@@ -856,9 +881,16 @@ rte_sched_port_config(struct rte_sched_port_params *params)
 	port->cycles_per_byte = cycles_per_byte;
 
 	/* Grinders */
-	port->pkts_out = NULL;
-	port->n_pkts_out = 0;
-	port->subport_id = 0;
+	port->worker.port = port;
+	port->worker.first_subport = 0;
+	port->worker.n_subports = port->n_subports_per_port;
+	port->worker.pkts_out = NULL;
+	port->worker.n_pkts_out = 0;
+	port->worker.subport_id = 0;
+
+	/* Workers */
+	port->n_workers = 0;
+	port->worker_tat = 0;
 
 	return port;
 }
@@ -902,6 +934,14 @@ rte_sched_port_free(struct rte_sched_port *port)
 	if (port == NULL)
 		return;
 
+	/* Free the workers left, which hands their subports back */
+	for (i = 0; i < port->n_subports_per_port; i++) {
+		struct rte_sched_subport *s = port->subports[i];
+
+		if (s != NULL && s->worker != &port->worker)
+			rte_sched_port_worker_free(s->worker);
+	}
+
 	for (i = 0; i < port->n_subports_per_port; i++)
 		rte_sched_subport_free(port, port->subports[i]);
 
@@ -990,6 +1030,14 @@ rte_sched_subport_config(struct rte_sched_port *port,
 		return -EINVAL;
 	}
 
+	if (port->subports[subport_id] != NULL &&
+	    port->subports[subport_id]->worker != &port->worker) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Subport %u belongs to a worker\n", __func__,
+			subport_id);
+		return -EBUSY;
+	}
+
 	status = rte_sched_subport_check_params(params,
 		port->n_pipes_per_subport,
 		port->rate);
@@ -1035,7 +1083,7 @@ rte_sched_subport_config(struct rte_sched_port *port,
 	}
 
 	s->tb_size = params->tb_size;
-	s->tb_time = port->time;
+	s->tb_time = port->worker.time;
 	s->tb_credits = s->tb_size / 2;
 
 	/* Traffic Classes (TCs) */
@@ -1046,7 +1094,7 @@ rte_sched_subport_config(struct rte_sched_port *port,
 				= rte_sched_time_ms_to_bytes(params->tc_period,
 					params->tc_rate[i]);
 	}
-	s->tc_time = port->time + s->tc_period;
+	s->tc_time = port->worker.time + s->tc_period;
 	for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++)
 		if (params->qsize[i])
 			s->tc_credits[i] = s->tc_credits_per_period[i];
@@ -1092,6 +1140,9 @@ rte_sched_subport_config(struct rte_sched_port *port,
 	s->pipe_loop = RTE_SCHED_PIPE_INVALID;
 	s->pipe_exhaustion = 0;
 
+	/* Worker */
+	s->worker = &port->worker;
+
 	/* Grinders */
 	s->busy_grinders = 0;
 
@@ -1236,11 +1287,11 @@ rte_sched_pipe_config(struct rte_sched_port *port,
 	params = s->pipe_profiles + p->profile;
 
 	/* Token Bucket (TB) */
-	p->tb_time = port->time;
+	p->tb_time = s->worker->time;
 	p->tb_credits = params->tb_size / 2;
 
 	/* Traffic Classes (TCs) */
-	p->tc_time = port->time + params->tc_period;
+	p->tc_time = s->worker->time + params->tc_period;
 
 	for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++)
 		if (s->qsize[i])
@@ -1601,17 +1652,18 @@ rte_sched_port_red_drop(struct rte_sched_port *port,
 	qe = subport->queue_extra + qindex;
 	red = &qe->red;
 
-	return rte_red_enqueue(red_cfg, red, qlen, port->time);
+	return rte_red_enqueue(red_cfg, red, qlen, subport->worker->time);
 }
 
 static inline void
-rte_sched_port_set_queue_empty_timestamp(struct rte_sched_port *port,
+rte_sched_port_set_queue_empty_timestamp(
+	struct rte_sched_port *port __rte_unused,
 	struct rte_sched_subport *subport, uint32_t qindex)
 {
 	struct rte_sched_queue_extra *qe = subport->queue_extra + qindex;
 	struct rte_red *red = &qe->red;
 
-	rte_red_mark_queue_empty(red, port->time);
+	rte_red_mark_queue_empty(red, subport->worker->time);
 }
 
 #else
@@ -1966,41 +2018,42 @@ rte_sched_port_enqueue(struct rte_sched_port *port, struct rte_mbuf **pkts,
 #ifndef RTE_SCHED_SUBPORT_TC_OV
 
 static inline void
-grinder_credits_update(struct rte_sched_port *port,
+grinder_credits_update(struct rte_sched_port *port __rte_unused,
 	struct rte_sched_subport *subport, uint32_t pos)
 {
 	struct rte_sched_grinder *grinder = subport->grinder + pos;
 	struct rte_sched_pipe *pipe = grinder->pipe;
 	struct rte_sched_pipe_profile *params = grinder->pipe_params;
+	uint64_t time = subport->worker->time;
 	uint64_t n_periods;
 	uint32_t i;
 
 	/* Subport TB */
-	n_periods = (port->time - subport->tb_time) / subport->tb_period;
+	n_periods = (time - subport->tb_time) / subport->tb_period;
 	subport->tb_credits += n_periods * subport->tb_credits_per_period;
 	subport->tb_credits = RTE_MIN(subport->tb_credits, subport->tb_size);
 	subport->tb_time += n_periods * subport->tb_period;
 
 	/* Pipe TB */
-	n_periods = (port->time - pipe->tb_time) / params->tb_period;
+	n_periods = (time - pipe->tb_time) / params->tb_period;
 	pipe->tb_credits += n_periods * params->tb_credits_per_period;
 	pipe->tb_credits = RTE_MIN(pipe->tb_credits, params->tb_size);
 	pipe->tb_time += n_periods * params->tb_period;
 
 	/* Subport TCs */
-	if (unlikely(port->time >= subport->tc_time)) {
+	if (unlikely(time >= subport->tc_time)) {
 		for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++)
 			subport->tc_credits[i] = subport->tc_credits_per_period[i];
 
-		subport->tc_time = port->time + subport->tc_period;
+		subport->tc_time = time + subport->tc_period;
 	}
 
 	/* Pipe TCs */
-	if (unlikely(port->time >= pipe->tc_time)) {
+	if (unlikely(time >= pipe->tc_time)) {
 		for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++)
 			pipe->tc_credits[i] = params->tc_credits_per_period[i];
 
-		pipe->tc_time = port->time + params->tc_period;
+		pipe->tc_time = time + params->tc_period;
 	}
 }
 
@@ -2055,37 +2108,38 @@ grinder_credits_update(struct rte_sched_port *port,
 	struct rte_sched_grinder *grinder = subport->grinder + pos;
 	struct rte_sched_pipe *pipe = grinder->pipe;
 	struct rte_sched_pipe_profile *params = grinder->pipe_params;
+	uint64_t time = subport->worker->time;
 	uint64_t n_periods;
 	uint32_t i;
 
 	/* Subport TB */
-	n_periods = (port->time - subport->tb_time) / subport->tb_period;
+	n_periods = (time - subport->tb_time) / subport->tb_period;
 	subport->tb_credits += n_periods * subport->tb_credits_per_period;
 	subport->tb_credits = RTE_MIN(subport->tb_credits, subport->tb_size);
 	subport->tb_time += n_periods * subport->tb_period;
 
 	/* Pipe TB */
-	n_periods = (port->time - pipe->tb_time) / params->tb_period;
+	n_periods = (time - pipe->tb_time) / params->tb_period;
 	pipe->tb_credits += n_periods * params->tb_credits_per_period;
 	pipe->tb_credits = RTE_MIN(pipe->tb_credits, params->tb_size);
 	pipe->tb_time += n_periods * params->tb_period;
 
 	/* Subport TCs */
-	if (unlikely(port->time >= subport->tc_time)) {
+	if (unlikely(time >= subport->tc_time)) {
 		subport->tc_ov_wm = grinder_tc_ov_credits_update(port, subport);
 
 		for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++)
 			subport->tc_credits[i] = subport->tc_credits_per_period[i];
 
-		subport->tc_time = port->time + subport->tc_period;
+		subport->tc_time = time + subport->tc_period;
 		subport->tc_ov_period_id++;
 	}
 
 	/* Pipe TCs */
-	if (unlikely(port->time >= pipe->tc_time)) {
+	if (unlikely(time >= pipe->tc_time)) {
 		for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++)
 			pipe->tc_credits[i] = params->tc_credits_per_period[i];
-		pipe->tc_time = port->time + params->tc_period;
+		pipe->tc_time = time + params->tc_period;
 	}
 
 	/* Pipe TCs - Oversubscription */
@@ -2185,24 +2239,66 @@ grinder_credits_check(struct rte_sched_port *port,
 #endif /* RTE_SCHED_SUBPORT_TC_OV */
 
 
+/*
+ * Make sure a worker sharing the port with other workers holds enough port
+ * credits to send a packet.
+ *
+ * The workers draw the port credits in chunks from a single token bucket
+ * implemented as a Generic Cell Rate Algorithm: the theoretical arrival
+ * time of the next chunk advances by the chunk size on each draw and
+ * cannot run ahead of the CPU time by more than one chunk per worker,
+ * rte_sched_port_dequeue() counting as one more worker.
+ * It is updated with a compare and swap, so no worker ever waits on
+ * another one.
+ */
+static inline int
+rte_sched_worker_credits_get(struct rte_sched_port *port,
+	struct rte_sched_port_worker *w, uint32_t pkt_len)
+{
+	uint64_t chunk = (uint64_t)port->mtu * RTE_SCHED_WORKER_CREDITS_PKTS;
+	uint64_t limit, tat, new_tat;
+
+	if (likely(w->credits >= pkt_len))
+		return 1;
+
+	limit = w->time_cpu_bytes + chunk *
+		(__atomic_load_n(&port->n_workers, __ATOMIC_RELAXED) + 1);
+	tat = __atomic_load_n(&port->worker_tat, __ATOMIC_RELAXED);
+	do {
+		new_tat = RTE_MAX(tat, w->time_cpu_bytes) + chunk;
+		if (new_tat > limit)
+			return 0;
+	} while (!__atomic_compare_exchange_n(&port->worker_tat, &tat,
+			new_tat, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+	w->credits += chunk;
+	return 1;
+}
+
 static inline int
 grinder_schedule(struct rte_sched_port *port,
 	struct rte_sched_subport *subport, uint32_t pos)
 {
+	struct rte_sched_port_worker *w = subport->worker;
 	struct rte_sched_grinder *grinder = subport->grinder + pos;
 	struct rte_sched_queue *queue = grinder->queue[grinder->qpos];
 	struct rte_mbuf *pkt = grinder->pkt;
 	uint32_t pkt_len = pkt->pkt_len + port->frame_overhead;
 	uint32_t be_tc_active;
 
+	if (w->shared && !rte_sched_worker_credits_get(port, w, pkt_len))
+		return 0;
+
 	if (!grinder_credits_check(port, subport, pos))
 		return 0;
 
 	/* Advance port time */
-	port->time += pkt_len;
+	w->time += pkt_len;
+	if (w->shared)
+		w->credits -= pkt_len;
 
 	/* Send packet */
-	port->pkts_out[port->n_pkts_out++] = pkt;
+	w->pkts_out[w->n_pkts_out++] = pkt;
 	queue->qr++;
 
 	be_tc_active = (grinder->tc_index == RTE_SCHED_TRAFFIC_CLASS_BE) ? ~0x0 : 0x0;
@@ -2672,31 +2768,33 @@ grinder_handle(struct rte_sched_port *port,
 }
 
 static inline void
-rte_sched_port_time_resync(struct rte_sched_port *port)
+rte_sched_port_time_resync(struct rte_sched_port *port,
+	struct rte_sched_port_worker *w)
 {
 	uint64_t cycles = rte_get_tsc_cycles();
 	uint64_t cycles_diff;
 	uint64_t bytes_diff;
 	uint32_t i;
 
-	if (cycles < port->time_cpu_cycles)
-		port->time_cpu_cycles = 0;
+	if (cycles < w->time_cpu_cycles)
+		w->time_cpu_cycles = 0;
 
-	cycles_diff = cycles - port->time_cpu_cycles;
+	cycles_diff = cycles - w->time_cpu_cycles;
 	/* Compute elapsed time in bytes */
 	bytes_diff = rte_reciprocal_divide(cycles_diff << RTE_SCHED_TIME_SHIFT,
 					   port->inv_cycles_per_byte);
 
 	/* Advance port time */
-	port->time_cpu_cycles +=
+	w->time_cpu_cycles +=
 		(bytes_diff * port->cycles_per_byte) >> RTE_SCHED_TIME_SHIFT;
-	port->time_cpu_bytes += bytes_diff;
-	if (port->time < port->time_cpu_bytes)
-		port->time = port->time_cpu_bytes;
+	w->time_cpu_bytes += bytes_diff;
+	if (w->time < w->time_cpu_bytes)
+		w->time = w->time_cpu_bytes;
 
 	/* Reset pipe loop detection */
-	for (i = 0; i < port->n_subports_per_port; i++)
-		port->subports[i]->pipe_loop = RTE_SCHED_PIPE_INVALID;
+	for (i = w->first_subport; i < w->first_subport + w->n_subports; i++)
+		if (port->subports[i]->worker == w)
+			port->subports[i]->pipe_loop = RTE_SCHED_PIPE_INVALID;
 }
 
 static inline int
@@ -2714,32 +2812,42 @@ rte_sched_port_exceptions(struct rte_sched_subport *subport, int second_pass)
 	return exceptions;
 }
 
-int
-rte_sched_port_dequeue(struct rte_sched_port *port, struct rte_mbuf **pkts, uint32_t n_pkts)
+static inline uint32_t
+rte_sched_worker_dequeue(struct rte_sched_port *port,
+	struct rte_sched_port_worker *w, struct rte_mbuf **pkts, uint32_t n_pkts)
 {
 	struct rte_sched_subport *subport;
-	uint32_t subport_id = port->subport_id;
+	uint32_t last_subport = w->first_subport + w->n_subports;
+	uint32_t subport_id = w->subport_id;
 	uint32_t i, n_subports = 0, count;
 
-	port->pkts_out = pkts;
-	port->n_pkts_out = 0;
+	w->pkts_out = pkts;
+	w->n_pkts_out = 0;
 
-	rte_sched_port_time_resync(port);
+	rte_sched_port_time_resync(port, w);
 
 	/* Take each queue in the grinder one step further */
 	for (i = 0, count = 0; ; i++)  {
 		subport = port->subports[subport_id];
 
+		/* Skip the subports given to another worker */
+		if (unlikely(subport->worker != w)) {
+			i = 0;
+			subport_id++;
+			n_subports++;
+			goto next_subport;
+		}
+
 		count += grinder_handle(port, subport,
 				i & (RTE_SCHED_PORT_N_GRINDERS - 1));
 
 		if (count == n_pkts) {
 			subport_id++;
 
-			if (subport_id == port->n_subports_per_port)
-				subport_id = 0;
+			if (subport_id == last_subport)
+				subport_id = w->first_subport;
 
-			port->subport_id = subport_id;
+			w->subport_id = subport_id;
 			break;
 		}
 
@@ -2749,14 +2857,128 @@ rte_sched_port_dequeue(struct rte_sched_port *port, struct rte_mbuf **pkts, uint
 			n_subports++;
 		}
 
-		if (subport_id == port->n_subports_per_port)
-			subport_id = 0;
+next_subport:
+		if (subport_id == last_subport)
+			subport_id = w->first_subport;
 
-		if (n_subports == port->n_subports_per_port) {
-			port->subport_id = subport_id;
+		if (n_subports == w->n_subports) {
+			w->subport_id = subport_id;
 			break;
 		}
 	}
 
 	return count;
 }
+
+int
+rte_sched_port_dequeue(struct rte_sched_port *port, struct rte_mbuf **pkts, uint32_t n_pkts)
+{
+	struct rte_sched_port_worker *w = &port->worker;
+
+	/* The subports left to the port share its rate with the workers */
+	w->shared = __atomic_load_n(&port->n_workers, __ATOMIC_RELAXED) != 0;
+	if (!w->shared)
+		w->credits = 0;
+
+	return rte_sched_worker_dequeue(port, w, pkts, n_pkts);
+}
+
+struct rte_sched_port_worker *
+rte_sched_port_worker_create(struct rte_sched_port *port,
+	uint32_t first_subport, uint32_t n_subports)
+{
+	struct rte_sched_port_worker *w;
+	uint32_t i;
+
+	/* Check user parameters */
+	if (port == NULL) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for parameter port\n", __func__);
+		return NULL;
+	}
+
+	if (n_subports == 0 || first_subport >= port->n_subports_per_port ||
+	    n_subports > port->n_subports_per_port - first_subport) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for subport range\n", __func__);
+		return NULL;
+	}
+
+	for (i = first_subport; i < first_subport + n_subports; i++) {
+		struct rte_sched_subport *s = port->subports[i];
+
+		if (s == NULL) {
+			RTE_LOG(ERR, SCHED,
+				"%s: Subport %u is not configured\n", __func__, i);
+			return NULL;
+		}
+
+		if (s->worker != &port->worker) {
+			RTE_LOG(ERR, SCHED,
+				"%s: Subport %u already has a worker\n", __func__, i);
+			return NULL;
+		}
+	}
+
+	w = rte_zmalloc_socket("sched_worker", sizeof(*w), RTE_CACHE_LINE_SIZE,
+		port->socket);
+	if (w == NULL) {
+		RTE_LOG(ERR, SCHED, "%s: Memory allocation fails\n", __func__);
+		return NULL;
+	}
+
+	w->port = port;
+	w->first_subport = first_subport;
+	w->n_subports = n_subports;
+	w->shared = 1;
+	w->credits = 0;
+
+	/* Same time base as the port, which the subport and pipe TBs use */
+	w->time_cpu_cycles = port->worker.time_cpu_cycles;
+	w->time_cpu_bytes = port->worker.time_cpu_bytes;
+	w->time = port->worker.time;
+
+	w->pkts_out = NULL;
+	w->n_pkts_out = 0;
+	w->subport_id = first_subport;
+
+	for (i = first_subport; i < first_subport + n_subports; i++)
+		port->subports[i]->worker = w;
+
+	__atomic_fetch_add(&port->n_workers, 1, __ATOMIC_RELAXED);
+
+	return w;
+}
+
+void
+rte_sched_port_worker_free(struct rte_sched_port_worker *w)
+{
+	struct rte_sched_port *port;
+	uint32_t i;
+
+	if (w == NULL)
+		return;
+
+	port = w->port;
+
+	/* The port time must not go back for the subports handed back */
+	if (port->worker.time < w->time) {
+		port->worker.time_cpu_cycles = w->time_cpu_cycles;
+		port->worker.time_cpu_bytes = w->time_cpu_bytes;
+		port->worker.time = w->time;
+	}
+
+	for (i = w->first_subport; i < w->first_subport + w->n_subports; i++)
+		port->subports[i]->worker = &port->worker;
+
+	__atomic_fetch_sub(&port->n_workers, 1, __ATOMIC_RELAXED);
+
+	rte_free(w);
+}
+
+int
+rte_sched_port_worker_dequeue(struct rte_sched_port_worker *w,
+	struct rte_mbuf **pkts, uint32_t n_pkts)
+{
+	return rte_sched_worker_dequeue(w->port, w, pkts, n_pkts);
+}
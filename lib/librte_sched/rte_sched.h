@@ -281,6 +281,8 @@ rte_sched_port_config(struct rte_sched_port_params *params);
 /**
  * Hierarchical scheduler port free
  *
+ * The workers of the port which are left are freed too.
+ *
  * @param port
  *   Handle to port scheduler instance
  */
@@ -507,6 +509,89 @@ rte_sched_port_enqueue(struct rte_sched_port *port, struct rte_mbuf **pkts, uint
 int
 rte_sched_port_dequeue(struct rte_sched_port *port, struct rte_mbuf **pkts, uint32_t n_pkts);
 
+/*
+ * Multi-core scheduling
+ *
+ ***/
+
+/** Port scheduler worker, scheduling a range of subports. */
+struct rte_sched_port_worker;
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Hierarchical scheduler port worker create
+ *
+ * Give a range of subports to a worker, so that the port can be scheduled
+ * by several lcores, each one dequeuing the subports of its own worker with
+ * rte_sched_port_worker_dequeue(). The workers never take a lock: the
+ * subports, with their pipes and queues, are only written by the lcore of
+ * their worker, while the port rate is shared by the workers through a
+ * token bucket they update with atomic operations, drawing credits for
+ * several packets at a time.
+ *
+ * Once the worker is created, rte_sched_port_dequeue() skips its subports,
+ * which cannot be configured again until the worker is freed, and the
+ * packets of its subports must be enqueued from the lcore of the worker.
+ * While the port has workers, rte_sched_port_dequeue() draws the credits
+ * of the subports left to it from the same token bucket.
+ *
+ * @param port
+ *   Handle to port scheduler instance
+ * @param first_subport
+ *   First subport of the worker
+ * @param n_subports
+ *   Number of subports of the worker. The subports have to be configured
+ *   and must not belong to another worker.
+ * @return
+ *   Handle to the worker upon success or NULL otherwise.
+ */
+__rte_experimental
+struct rte_sched_port_worker *
+rte_sched_port_worker_create(struct rte_sched_port *port,
+	uint32_t first_subport, uint32_t n_subports);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Hierarchical scheduler port worker free
+ *
+ * Hand the subports of the worker back to rte_sched_port_dequeue(). No
+ * worker of the port may be dequeuing at the same time.
+ *
+ * @param worker
+ *   Handle to port scheduler worker
+ */
+__rte_experimental
+void
+rte_sched_port_worker_free(struct rte_sched_port_worker *worker);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Hierarchical scheduler port worker dequeue. Same as
+ * rte_sched_port_dequeue(), for the subports of the worker only. Each
+ * worker has to be used by one lcore at a time, while different workers
+ * of the port can dequeue in parallel.
+ *
+ * @param worker
+ *   Handle to port scheduler worker
+ * @param pkts
+ *   Pre-allocated packet descriptor array where the packets dequeued
+ *   from the worker subports should be stored
+ * @param n_pkts
+ *   Number of packets to dequeue from the worker subports
+ * @return
+ *   Number of packets successfully dequeued and placed in the pkts array
+ */
+__rte_experimental
+int
+rte_sched_port_worker_dequeue(struct rte_sched_port_worker *worker,
+	struct rte_mbuf **pkts, uint32_t n_pkts);
+
 #ifdef __cplusplus
 }
 #endif
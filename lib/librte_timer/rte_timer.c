@@ -53,9 +53,40 @@ struct priv_timer {
 #endif
 } __rte_cache_aligned;
 
+/* Geometry of the hierarchical timer wheel */
+#define WHEEL_LEVELS		6
+#define WHEEL_SLOT_BITS		6
+#define WHEEL_SLOTS		(1 << WHEEL_SLOT_BITS)
+#define WHEEL_SLOT_MASK		(WHEEL_SLOTS - 1)
+/* ticks covered by the wheel, later timers are parked in its last slot */
+#define WHEEL_SPAN_MASK	((UINT64_C(1) << (WHEEL_LEVELS * WHEEL_SLOT_BITS)) - 1)
+
+/**
+ * Per-lcore hierarchical timer wheel.
+ *
+ * A pending timer is stored at the level of the highest WHEEL_SLOT_BITS
+ * group in which its expiry tick differs from the current tick, in the slot
+ * indexed by the expiry tick bits of that group. Timers of a slot are
+ * chained through sl_next[0], and sl_next[1] points to the previous timer
+ * or to the slot head seen as a timer, so that they can be unlinked in O(1).
+ */
+struct wheel_lcore {
+	uint64_t now;			/**< next tick to expire */
+	uint64_t next_tick;		/**< no timer expires before this tick */
+	uint64_t occupied[WHEEL_LEVELS];
+	/**< bitmap of the slots that may hold timers, per level */
+	struct rte_timer *slots[WHEEL_LEVELS][WHEEL_SLOTS];
+} __rte_cache_aligned;
+
+struct timer_wheel {
+	unsigned int shift;		/**< log2 of the timer cycles per tick */
+	struct wheel_lcore lcore[RTE_MAX_LCORE];
+};
+
 #define FL_ALLOCATED	(1 << 0)
 struct rte_timer_data {
 	struct priv_timer priv_timer[RTE_MAX_LCORE];
+	struct timer_wheel *wheel;	/**< NULL when using the skiplist */
 	uint8_t internal_flags;
 };
 
@@ -91,18 +122,69 @@ timer_data_valid(uint32_t id)
 	timer_data = &rte_timer_data_arr[id];				\
 } while (0)
 
+/* allocate a timer wheel with the given tick length in timer cycles */
+static struct timer_wheel *
+timer_wheel_create(uint64_t tick)
+{
+	struct timer_wheel *wheel;
+	uint64_t now;
+	int lcore_id;
+
+	if (tick == 0)
+		tick = rte_get_timer_hz() / US_PER_S;
+
+	wheel = rte_zmalloc("rte_timer_wheel", sizeof(*wheel),
+			    RTE_CACHE_LINE_SIZE);
+	if (wheel == NULL)
+		return NULL;
+
+	wheel->shift = rte_log2_u64(tick);
+	now = rte_get_timer_cycles() >> wheel->shift;
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		wheel->lcore[lcore_id].now = now;
+		wheel->lcore[lcore_id].next_tick = UINT64_MAX;
+	}
+
+	return wheel;
+}
+
 int
 rte_timer_data_alloc(uint32_t *id_ptr)
+{
+	return rte_timer_data_alloc_ext(id_ptr, NULL);
+}
+
+int
+rte_timer_data_alloc_ext(uint32_t *id_ptr,
+			 const struct rte_timer_data_params *params)
 {
 	int i;
 	struct rte_timer_data *data;
+	struct timer_wheel *wheel = NULL;
 
 	if (!rte_timer_subsystem_initialized)
 		return -ENOMEM;
 
+	if (params != NULL) {
+		switch (params->backend) {
+		case RTE_TIMER_BACKEND_SKIPLIST:
+			break;
+		case RTE_TIMER_BACKEND_WHEEL:
+			if (params->wheel_tick > (UINT64_C(1) << 63))
+				return -EINVAL;
+			wheel = timer_wheel_create(params->wheel_tick);
+			if (wheel == NULL)
+				return -ENOMEM;
+			break;
+		default:
+			return -EINVAL;
+		}
+	}
+
 	for (i = 0; i < RTE_MAX_DATA_ELS; i++) {
 		data = &rte_timer_data_arr[i];
 		if (!(data->internal_flags & FL_ALLOCATED)) {
+			data->wheel = wheel;
 			data->internal_flags |= FL_ALLOCATED;
 
 			if (id_ptr)
@@ -112,6 +194,7 @@ rte_timer_data_alloc(uint32_t *id_ptr)
 		}
 	}
 
+	rte_free(wheel);
 	return -ENOSPC;
 }
 
@@ -122,6 +205,8 @@ rte_timer_data_dealloc(uint32_t id)
 	TIMER_DATA_VALID_GET_OR_ERR_RET(id, timer_data, -EINVAL);
 
 	timer_data->internal_flags &= ~(FL_ALLOCATED);
+	rte_free(timer_data->wheel);
+	timer_data->wheel = NULL;
 
 	return 0;
 }
@@ -389,6 +474,187 @@ timer_get_prev_entries_for_node(struct rte_timer *tim, unsigned tim_lcore,
 	}
 }
 
+/* return the slot head of a timer wheel as a timer whose sl_next[0] is the
+ * head itself, so that the first timer of a slot has a previous entry
+ */
+static inline struct rte_timer *
+wheel_slot_head(struct rte_timer **slot)
+{
+	return (struct rte_timer *)((char *)slot -
+			offsetof(struct rte_timer, sl_next));
+}
+
+/* return the first tick at or after the given time in timer cycles */
+static inline uint64_t
+wheel_tick(const struct timer_wheel *wheel, uint64_t time)
+{
+	uint64_t tick = time >> wheel->shift;
+
+	if (time & ((UINT64_C(1) << wheel->shift) - 1))
+		tick++;
+	return tick;
+}
+
+/* call with lock held as necessary
+ * add in the wheel slot matching the timer expiry
+ */
+static void
+wheel_add(struct timer_wheel *wheel, struct wheel_lcore *wl,
+	  struct rte_timer *tim)
+{
+	uint64_t tick = wheel_tick(wheel, tim->expire);
+	uint64_t diff;
+	unsigned int level, slot;
+	struct rte_timer **head;
+
+	/* expired timers go to the slot of the next tick to expire */
+	if (tick < wl->now)
+		tick = wl->now;
+
+	diff = tick ^ wl->now;
+	if (diff > WHEEL_SPAN_MASK) {
+		/* beyond the wheel span: park in the last slot, it will be
+		 * added again when that slot expires
+		 */
+		tick = wl->now | WHEEL_SPAN_MASK;
+		diff = tick ^ wl->now;
+	}
+
+	level = (diff == 0) ? 0 : (rte_fls_u64(diff) - 1) / WHEEL_SLOT_BITS;
+	slot = (tick >> (level * WHEEL_SLOT_BITS)) & WHEEL_SLOT_MASK;
+	head = &wl->slots[level][slot];
+
+	tim->sl_next[0] = *head;
+	tim->sl_next[1] = wheel_slot_head(head);
+	if (*head != NULL)
+		(*head)->sl_next[1] = tim;
+	*head = tim;
+
+	wl->occupied[level] |= UINT64_C(1) << slot;
+	/* read outside the lock by timer_get_expired() */
+	if (tick < wl->next_tick)
+		__atomic_store_n(&wl->next_tick, tick, __ATOMIC_RELAXED);
+}
+
+/* call with lock held as necessary
+ * remove from its wheel slot, the slot bit is cleared when the slot expires
+ */
+static void
+wheel_del(struct rte_timer *tim)
+{
+	struct rte_timer *prev = tim->sl_next[1];
+	struct rte_timer *next = tim->sl_next[0];
+
+	/* already taken out of the wheel by the timer manager */
+	if (prev == NULL)
+		return;
+
+	prev->sl_next[0] = next;
+	if (next != NULL)
+		next->sl_next[1] = prev;
+	tim->sl_next[1] = NULL;
+}
+
+/* take all timers out of a wheel slot and return them */
+static struct rte_timer *
+wheel_slot_take(struct wheel_lcore *wl, unsigned int level, unsigned int slot)
+{
+	struct rte_timer *tim = wl->slots[level][slot];
+
+	wl->slots[level][slot] = NULL;
+	wl->occupied[level] &= ~(UINT64_C(1) << slot);
+	return tim;
+}
+
+/*
+ * Move the wheel to the next tick that may have timers to expire, without
+ * going past last + 1. Upper level slots starting at the new tick are
+ * cascaded down to the lower levels.
+ */
+static void
+wheel_advance(struct timer_wheel *wheel, struct wheel_lcore *wl,
+	      uint64_t last)
+{
+	struct rte_timer *tim, *next_tim;
+	uint64_t next_tick = UINT64_MAX;
+	uint64_t bits;
+	unsigned int level, shift, idx;
+
+	/* lower levels hold the earlier timers, and the slots of a level
+	 * up to the current tick ones are always empty
+	 */
+	for (level = 0; level < WHEEL_LEVELS; level++) {
+		shift = level * WHEEL_SLOT_BITS;
+		idx = (wl->now >> shift) & WHEEL_SLOT_MASK;
+		bits = wl->occupied[level] & ~((UINT64_C(2) << idx) - 1);
+		if (bits == 0)
+			continue;
+
+		next_tick = wl->now &
+			~((UINT64_C(1) << (shift + WHEEL_SLOT_BITS)) - 1);
+		next_tick |= (uint64_t)rte_bsf64(bits) << shift;
+		break;
+	}
+
+	__atomic_store_n(&wl->next_tick, next_tick, __ATOMIC_RELAXED);
+	wl->now = RTE_MIN(next_tick, last + 1);
+
+	for (level = WHEEL_LEVELS - 1; level > 0; level--) {
+		shift = level * WHEEL_SLOT_BITS;
+		if (wl->now & ((UINT64_C(1) << shift) - 1))
+			continue;
+
+		idx = (wl->now >> shift) & WHEEL_SLOT_MASK;
+		for (tim = wheel_slot_take(wl, level, idx); tim != NULL;
+		     tim = next_tim) {
+			next_tim = tim->sl_next[0];
+			wheel_add(wheel, wl, tim);
+		}
+	}
+}
+
+/*
+ * Take the timers expired at time cur_time out of the wheel of an lcore,
+ * and return them linked through sl_next[0]. Call with lock held.
+ */
+static struct rte_timer *
+wheel_get_expired(struct timer_wheel *wheel, struct wheel_lcore *wl,
+		  uint64_t cur_time)
+{
+	const uint64_t last = cur_time >> wheel->shift;
+	struct rte_timer *run_first_tim = NULL, **pprev = &run_first_tim;
+	struct rte_timer *parked = NULL;
+	struct rte_timer *tim, *next_tim;
+
+	while (wl->now <= last) {
+		tim = wheel_slot_take(wl, 0, wl->now & WHEEL_SLOT_MASK);
+		for ( ; tim != NULL; tim = next_tim) {
+			next_tim = tim->sl_next[0];
+			tim->sl_next[1] = NULL;
+
+			/* timer parked beyond the wheel span */
+			if (wheel_tick(wheel, tim->expire) > wl->now) {
+				tim->sl_next[0] = parked;
+				parked = tim;
+				continue;
+			}
+
+			*pprev = tim;
+			pprev = &tim->sl_next[0];
+		}
+
+		wheel_advance(wheel, wl, last);
+	}
+	*pprev = NULL;
+
+	for (tim = parked; tim != NULL; tim = next_tim) {
+		next_tim = tim->sl_next[0];
+		wheel_add(wheel, wl, tim);
+	}
+
+	return run_first_tim;
+}
+
 /* call with lock held as necessary
  * add in list
  * timer must be in config state
@@ -396,10 +662,17 @@ timer_get_prev_entries_for_node(struct rte_timer *tim, unsigned tim_lcore,
  */
 static void
 timer_add(struct rte_timer *tim, unsigned int tim_lcore,
-	  struct priv_timer *priv_timer)
+	  struct rte_timer_data *timer_data)
 {
 	unsigned lvl;
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH+1];
+	struct priv_timer *priv_timer = timer_data->priv_timer;
+
+	if (timer_data->wheel != NULL) {
+		wheel_add(timer_data->wheel,
+			  &timer_data->wheel->lcore[tim_lcore], tim);
+		return;
+	}
 
 	/* find where exactly this element goes in the list of elements
 	 * for each depth. */
@@ -433,12 +706,13 @@ timer_add(struct rte_timer *tim, unsigned int tim_lcore,
  */
 static void
 timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
-	  int local_is_locked, struct priv_timer *priv_timer)
+	  int local_is_locked, struct rte_timer_data *timer_data)
 {
 	unsigned lcore_id = rte_lcore_id();
 	unsigned prev_owner = prev_status.owner;
 	int i;
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH+1];
+	struct priv_timer *priv_timer = timer_data->priv_timer;
 
 	/* if timer needs is pending another core, we need to lock the
 	 * list; if it is on local core, we need to lock if we are not
@@ -446,6 +720,11 @@ timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
 	if (prev_owner != lcore_id || !local_is_locked)
 		rte_spinlock_lock(&priv_timer[prev_owner].list_lock);
 
+	if (timer_data->wheel != NULL) {
+		wheel_del(tim);
+		goto unlock;
+	}
+
 	/* save the lowest list entry into the expire field of the dummy hdr.
 	 * NOTE: this is not atomic on 32-bit */
 	if (tim == priv_timer[prev_owner].pending_head.sl_next[0])
@@ -466,6 +745,7 @@ timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
 		else
 			break;
 
+unlock:
 	if (prev_owner != lcore_id || !local_is_locked)
 		rte_spinlock_unlock(&priv_timer[prev_owner].list_lock);
 }
@@ -511,7 +791,7 @@ __rte_timer_reset(struct rte_timer *tim, uint64_t expire,
 
 	/* remove it from list */
 	if (prev_status.state == RTE_TIMER_PENDING) {
-		timer_del(tim, prev_status, local_is_locked, priv_timer);
+		timer_del(tim, prev_status, local_is_locked, timer_data);
 		__TIMER_STAT_ADD(priv_timer, pending, -1);
 	}
 
@@ -528,7 +808,7 @@ __rte_timer_reset(struct rte_timer *tim, uint64_t expire,
 		rte_spinlock_lock(&priv_timer[tim_lcore].list_lock);
 
 	__TIMER_STAT_ADD(priv_timer, pending, 1);
-	timer_add(tim, tim_lcore, priv_timer);
+	timer_add(tim, tim_lcore, timer_data);
 
 	/* update state: as we are in CONFIG state, only us can modify
 	 * the state so we don't need to use cmpset() here */
@@ -609,7 +889,7 @@ __rte_timer_stop(struct rte_timer *tim, int local_is_locked,
 
 	/* remove it from list */
 	if (prev_status.state == RTE_TIMER_PENDING) {
-		timer_del(tim, prev_status, local_is_locked, priv_timer);
+		timer_del(tim, prev_status, local_is_locked, timer_data);
 		__TIMER_STAT_ADD(priv_timer, pending, -1);
 	}
 
@@ -657,59 +937,81 @@ rte_timer_pending(struct rte_timer *tim)
 				__ATOMIC_RELAXED) == RTE_TIMER_PENDING;
 }
 
-/* must be called periodically, run all timer that expired */
-static void
-__rte_timer_manage(struct rte_timer_data *timer_data)
+/*
+ * Take the expired timers out of the pending list of an lcore, mark them as
+ * running and return them linked through sl_next[0].
+ */
+static struct rte_timer *
+timer_get_expired(struct rte_timer_data *timer_data, unsigned int lcore_id)
 {
-	union rte_timer_status status;
+	struct priv_timer *privp = &timer_data->priv_timer[lcore_id];
+	struct timer_wheel *wheel = timer_data->wheel;
 	struct rte_timer *tim, *next_tim;
 	struct rte_timer *run_first_tim, **pprev;
-	unsigned lcore_id = rte_lcore_id();
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH + 1];
-	uint64_t cur_time;
+	uint64_t cur_time, next_tick;
 	int i, ret;
-	struct priv_timer *priv_timer = timer_data->priv_timer;
 
-	/* timer manager only runs on EAL thread with valid lcore_id */
-	assert(lcore_id < RTE_MAX_LCORE);
+	if (wheel != NULL) {
+		/* the next tick to check is updated atomically, so we can
+		 * consult it for a quick check here outside the lock
+		 */
+		next_tick = __atomic_load_n(&wheel->lcore[lcore_id].next_tick,
+					    __ATOMIC_RELAXED);
+		/* optimize for the case where per-cpu wheel is empty */
+		if (next_tick == UINT64_MAX)
+			return NULL;
+		cur_time = rte_get_timer_cycles();
+		if (likely((cur_time >> wheel->shift) < next_tick))
+			return NULL;
 
-	__TIMER_STAT_ADD(priv_timer, manage, 1);
-	/* optimize for the case where per-cpu list is empty */
-	if (priv_timer[lcore_id].pending_head.sl_next[0] == NULL)
-		return;
-	cur_time = rte_get_timer_cycles();
+		rte_spinlock_lock(&privp->list_lock);
+		tim = wheel_get_expired(wheel, &wheel->lcore[lcore_id],
+					cur_time);
+	} else {
+		/* optimize for the case where per-cpu list is empty */
+		if (privp->pending_head.sl_next[0] == NULL)
+			return NULL;
+		cur_time = rte_get_timer_cycles();
 
 #ifdef RTE_ARCH_64
-	/* on 64-bit the value cached in the pending_head.expired will be
-	 * updated atomically, so we can consult that for a quick check here
-	 * outside the lock */
-	if (likely(priv_timer[lcore_id].pending_head.expire > cur_time))
-		return;
+		/* on 64-bit the value cached in the pending_head.expired will
+		 * be updated atomically, so we can consult that for a quick
+		 * check here outside the lock
+		 */
+		if (likely(privp->pending_head.expire > cur_time))
+			return NULL;
 #endif
 
-	/* browse ordered list, add expired timers in 'expired' list */
-	rte_spinlock_lock(&priv_timer[lcore_id].list_lock);
+		/* browse ordered list, add expired timers in 'expired' list */
+		rte_spinlock_lock(&privp->list_lock);
 
-	/* if nothing to do just unlock and return */
-	if (priv_timer[lcore_id].pending_head.sl_next[0] == NULL ||
-	    priv_timer[lcore_id].pending_head.sl_next[0]->expire > cur_time) {
-		rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
-		return;
-	}
+		/* if nothing to do just unlock and return */
+		if (privp->pending_head.sl_next[0] == NULL ||
+		    privp->pending_head.sl_next[0]->expire > cur_time) {
+			rte_spinlock_unlock(&privp->list_lock);
+			return NULL;
+		}
 
-	/* save start of list of expired timers */
-	tim = priv_timer[lcore_id].pending_head.sl_next[0];
+		/* save start of list of expired timers */
+		tim = privp->pending_head.sl_next[0];
 
-	/* break the existing list at current time point */
-	timer_get_prev_entries(cur_time, lcore_id, prev, priv_timer);
-	for (i = priv_timer[lcore_id].curr_skiplist_depth -1; i >= 0; i--) {
-		if (prev[i] == &priv_timer[lcore_id].pending_head)
-			continue;
-		priv_timer[lcore_id].pending_head.sl_next[i] =
-		    prev[i]->sl_next[i];
-		if (prev[i]->sl_next[i] == NULL)
-			priv_timer[lcore_id].curr_skiplist_depth--;
-		prev[i] ->sl_next[i] = NULL;
+		/* break the existing list at current time point */
+		timer_get_prev_entries(cur_time, lcore_id, prev,
+				       timer_data->priv_timer);
+		for (i = privp->curr_skiplist_depth - 1; i >= 0; i--) {
+			if (prev[i] == &privp->pending_head)
+				continue;
+			privp->pending_head.sl_next[i] = prev[i]->sl_next[i];
+			if (prev[i]->sl_next[i] == NULL)
+				privp->curr_skiplist_depth--;
+			prev[i]->sl_next[i] = NULL;
+		}
+
+		/* update the next to expire timer value */
+		privp->pending_head.expire =
+		    (privp->pending_head.sl_next[0] == NULL) ? 0 :
+			privp->pending_head.sl_next[0]->expire;
 	}
 
 	/* transition run-list from PENDING to RUNNING */
@@ -730,12 +1032,27 @@ __rte_timer_manage(struct rte_timer_data *timer_data)
 		}
 	}
 
-	/* update the next to expire timer value */
-	priv_timer[lcore_id].pending_head.expire =
-	    (priv_timer[lcore_id].pending_head.sl_next[0] == NULL) ? 0 :
-		priv_timer[lcore_id].pending_head.sl_next[0]->expire;
+	rte_spinlock_unlock(&privp->list_lock);
 
-	rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
+	return run_first_tim;
+}
+
+/* must be called periodically, run all timer that expired */
+static void
+__rte_timer_manage(struct rte_timer_data *timer_data)
+{
+	union rte_timer_status status;
+	struct rte_timer *tim, *next_tim;
+	struct rte_timer *run_first_tim;
+	unsigned lcore_id = rte_lcore_id();
+	struct priv_timer *priv_timer = timer_data->priv_timer;
+
+	/* timer manager only runs on EAL thread with valid lcore_id */
+	assert(lcore_id < RTE_MAX_LCORE);
+
+	__TIMER_STAT_ADD(priv_timer, manage, 1);
+
+	run_first_tim = timer_get_expired(timer_data, lcore_id);
 
 	/* now scan expired list and call callbacks */
 	for (tim = run_first_tim; tim != NULL; tim = next_tim) {
@@ -804,16 +1121,12 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 {
 	unsigned int default_poll_lcores[] = {rte_lcore_id()};
 	union rte_timer_status status;
-	struct rte_timer *tim, *next_tim, **pprev;
+	struct rte_timer *tim;
 	struct rte_timer *run_first_tims[RTE_MAX_LCORE];
 	unsigned int this_lcore = rte_lcore_id();
-	struct rte_timer *prev[MAX_SKIPLIST_DEPTH + 1];
-	uint64_t cur_time;
-	int i, j, ret;
+	int i;
 	int nb_runlists = 0;
 	struct rte_timer_data *data;
-	struct priv_timer *privp;
-	uint32_t poll_lcore;
 
 	TIMER_DATA_VALID_GET_OR_ERR_RET(timer_data_id, data, -EINVAL);
 
@@ -828,75 +1141,9 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 	}
 
 	for (i = 0; i < nb_poll_lcores; i++) {
-		poll_lcore = poll_lcores[i];
-		privp = &data->priv_timer[poll_lcore];
-
-		/* optimize for the case where per-cpu list is empty */
-		if (privp->pending_head.sl_next[0] == NULL)
-			continue;
-		cur_time = rte_get_timer_cycles();
-
-#ifdef RTE_ARCH_64
-		/* on 64-bit the value cached in the pending_head.expired will
-		 * be updated atomically, so we can consult that for a quick
-		 * check here outside the lock
-		 */
-		if (likely(privp->pending_head.expire > cur_time))
-			continue;
-#endif
-
-		/* browse ordered list, add expired timers in 'expired' list */
-		rte_spinlock_lock(&privp->list_lock);
-
-		/* if nothing to do just unlock and return */
-		if (privp->pending_head.sl_next[0] == NULL ||
-		    privp->pending_head.sl_next[0]->expire > cur_time) {
-			rte_spinlock_unlock(&privp->list_lock);
-			continue;
-		}
-
-		/* save start of list of expired timers */
-		tim = privp->pending_head.sl_next[0];
-
-		/* break the existing list at current time point */
-		timer_get_prev_entries(cur_time, poll_lcore, prev,
-				       data->priv_timer);
-		for (j = privp->curr_skiplist_depth - 1; j >= 0; j--) {
-			if (prev[j] == &privp->pending_head)
-				continue;
-			privp->pending_head.sl_next[j] =
-				prev[j]->sl_next[j];
-			if (prev[j]->sl_next[j] == NULL)
-				privp->curr_skiplist_depth--;
-
-			prev[j]->sl_next[j] = NULL;
-		}
-
-		/* transition run-list from PENDING to RUNNING */
-		run_first_tims[nb_runlists] = tim;
-		pprev = &run_first_tims[nb_runlists];
-		nb_runlists++;
-
-		for ( ; tim != NULL; tim = next_tim) {
-			next_tim = tim->sl_next[0];
-
-			ret = timer_set_running_state(tim);
-			if (likely(ret == 0)) {
-				pprev = &tim->sl_next[0];
-			} else {
-				/* another core is trying to re-config this one,
-				 * remove it from local expired list
-				 */
-				*pprev = next_tim;
-			}
-		}
-
-		/* update the next to expire timer value */
-		privp->pending_head.expire =
-		    (privp->pending_head.sl_next[0] == NULL) ? 0 :
-			privp->pending_head.sl_next[0]->expire;
-
-		rte_spinlock_unlock(&privp->list_lock);
+		tim = timer_get_expired(data, poll_lcores[i]);
+		if (tim != NULL)
+			run_first_tims[nb_runlists++] = tim;
 	}
 
 	/* Now process the run lists */
@@ -976,6 +1223,31 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 	return 0;
 }
 
+/* Walk the wheel of an lcore, stopping timers with the lock held */
+static void
+wheel_stop_all(struct rte_timer_data *timer_data, unsigned int walk_lcore,
+	       rte_timer_stop_all_cb_t f, void *f_arg)
+{
+	struct wheel_lcore *wl = &timer_data->wheel->lcore[walk_lcore];
+	struct rte_timer *tim, *next_tim;
+	unsigned int level, slot;
+
+	for (level = 0; level < WHEEL_LEVELS; level++) {
+		for (slot = 0; slot < WHEEL_SLOTS; slot++) {
+			for (tim = wl->slots[level][slot];
+			     tim != NULL;
+			     tim = next_tim) {
+				next_tim = tim->sl_next[0];
+
+				__rte_timer_stop(tim, 1, timer_data);
+
+				if (f)
+					f(tim, f_arg);
+			}
+		}
+	}
+}
+
 /* Walk pending lists, stopping timers and calling user-specified function */
 int
 rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
@@ -996,6 +1268,12 @@ rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
 
 		rte_spinlock_lock(&priv_timer->list_lock);
 
+		if (timer_data->wheel != NULL) {
+			wheel_stop_all(timer_data, walk_lcore, f, f_arg);
+			rte_spinlock_unlock(&priv_timer->list_lock);
+			continue;
+		}
+
 		for (tim = priv_timer->pending_head.sl_next[0];
 		     tim != NULL;
 		     tim = next_tim) {
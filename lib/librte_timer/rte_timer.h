@@ -166,6 +166,56 @@ int rte_timer_data_alloc(uint32_t *id_ptr);
 __rte_experimental
 int rte_timer_data_dealloc(uint32_t id);
 
+/**
+ * Data structure used to track the pending timers of a timer data instance.
+ */
+enum rte_timer_backend {
+	/** Skiplist ordered by expiry time, O(log n) add and remove. */
+	RTE_TIMER_BACKEND_SKIPLIST = 0,
+	/** Hierarchical timer wheel, O(1) add and remove. */
+	RTE_TIMER_BACKEND_WHEEL,
+};
+
+/**
+ * Parameters of a timer data instance, see rte_timer_data_alloc_ext().
+ */
+struct rte_timer_data_params {
+	enum rte_timer_backend backend; /**< Pending timers data structure. */
+	uint64_t wheel_tick;
+	/**< Timer cycles per tick of the wheel backend, rounded up to a power
+	 * of 2. Timers expire at the first tick following their expiry time.
+	 * 0 selects a tick of about one microsecond.
+	 */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Allocate a timer data instance in shared memory to track a set of pending
+ * timer lists, using the data structure selected in params.
+ *
+ * With the RTE_TIMER_BACKEND_WHEEL backend, arming, resetting and stopping a
+ * timer take constant time, and rte_timer_alt_manage() expires whole wheel
+ * slots at once. Timers expiring within the same tick run in no particular
+ * order.
+ *
+ * @param id_ptr
+ *   Pointer to variable into which to write the identifier of the allocated
+ *   timer data instance.
+ * @param params
+ *   Parameters of the timer data instance, NULL selects the skiplist.
+ *
+ * @return
+ *   - 0: Success
+ *   - -EINVAL: invalid parameters
+ *   - -ENOMEM: unable to allocate the timer wheel
+ *   - -ENOSPC: maximum number of timer data instances already allocated
+ */
+__rte_experimental
+int rte_timer_data_alloc_ext(uint32_t *id_ptr,
+			     const struct rte_timer_data_params *params);
+
 /**
  * Initialize the timer library.
  *